@@ -0,0 +1,534 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "virtualadapter.h"
+#include "virtualgattprofile.h"
+#include "virtualsppprofile.h"
+#include "virtualdeferredcall.h"
+#include "virtualtracereplay.h"
+
+#define VIRTUAL_ADAPTER_ADDRESS "02:00:00:00:00:01"
+
+VirtualAdapter::VirtualAdapter(const VirtualControllerConfig &config) :
+	mConfig(config),
+	mAddress(VIRTUAL_ADAPTER_ADDRESS),
+	mName("webOS virtual controller"),
+	mPowered(false),
+	mDiscovering(false),
+	mDiscoverable(false),
+	mPairable(false),
+	mDiscoveryTimeout(0),
+	mFoundCount(0),
+	mNextScanId(1),
+	mDiscoveryTimer(0),
+	mRssiTimer(0),
+	mGatt(new VirtualGattProfile(this, config)),
+	mSpp(new VirtualSppProfile(this, config)),
+	mReplay(0)
+{
+	// Interleave both kinds so a partial discovery still sees a mix
+	unsigned int brEdrIndex = 0;
+	unsigned int leIndex = 0;
+	while (brEdrIndex < mConfig.brEdrDevices || leIndex < mConfig.leDevices)
+	{
+		if (brEdrIndex < mConfig.brEdrDevices)
+			mDevices.push_back(new VirtualDevice(brEdrIndex++, BLUETOOTH_DEVICE_TYPE_BREDR, mConfig));
+		if (leIndex < mConfig.leDevices)
+			mDevices.push_back(new VirtualDevice(leIndex++, BLUETOOTH_DEVICE_TYPE_BLE, mConfig));
+	}
+
+	g_message("Virtual controller with %u BR/EDR and %u LE devices", mConfig.brEdrDevices, mConfig.leDevices);
+
+	if (!mConfig.replayTrace.empty())
+		mReplay = new VirtualTraceReplay(this, mConfig.replayTrace, mConfig.replaySpeed);
+}
+
+VirtualAdapter::~VirtualAdapter()
+{
+	stopTimers();
+
+	delete mReplay;
+	delete mGatt;
+	delete mSpp;
+
+	for (auto device : mDevices)
+		delete device;
+	mDevices.clear();
+}
+
+void VirtualAdapter::stopTimers()
+{
+	if (mDiscoveryTimer)
+	{
+		g_source_remove(mDiscoveryTimer);
+		mDiscoveryTimer = 0;
+	}
+
+	if (mRssiTimer)
+	{
+		g_source_remove(mRssiTimer);
+		mRssiTimer = 0;
+	}
+}
+
+BluetoothError VirtualAdapter::enable()
+{
+	if (mPowered)
+		return BLUETOOTH_ERROR_NONE;
+
+	mPowered = true;
+	if (mConfig.rssiInterval > 0)
+		mRssiTimer = g_timeout_add(mConfig.rssiInterval, &VirtualAdapter::handleRssiTimeout, this);
+
+	if (observer)
+		observer->adapterStateChanged(true);
+
+	if (mReplay)
+		mReplay->start();
+
+	return BLUETOOTH_ERROR_NONE;
+}
+
+BluetoothError VirtualAdapter::disable()
+{
+	if (!mPowered)
+		return BLUETOOTH_ERROR_NONE;
+
+	if (mReplay)
+		mReplay->stop();
+
+	setDiscovering(false);
+	stopTimers();
+	mPowered = false;
+
+	if (observer)
+		observer->adapterStateChanged(false);
+
+	return BLUETOOTH_ERROR_NONE;
+}
+
+BluetoothProperty VirtualAdapter::buildProperty(BluetoothProperty::Type type) const
+{
+	switch (type)
+	{
+	case BluetoothProperty::Type::NAME:
+	case BluetoothProperty::Type::ALIAS:
+		return BluetoothProperty(type, mName);
+	case BluetoothProperty::Type::STACK_NAME:
+		return BluetoothProperty(type, std::string("virtual"));
+	case BluetoothProperty::Type::STACK_VERSION:
+		return BluetoothProperty(type, std::string("1.0"));
+	case BluetoothProperty::Type::BDADDR:
+		return BluetoothProperty(type, mAddress);
+	case BluetoothProperty::Type::CLASS_OF_DEVICE:
+		return BluetoothProperty(type, (uint32_t) 0x20041c);
+	case BluetoothProperty::Type::DISCOVERY_TIMEOUT:
+		return BluetoothProperty(type, mDiscoveryTimeout);
+	case BluetoothProperty::Type::DISCOVERABLE:
+		return BluetoothProperty(type, mDiscoverable);
+	case BluetoothProperty::Type::PAIRABLE:
+		return BluetoothProperty(type, mPairable);
+	case BluetoothProperty::Type::UUIDS:
+	{
+		std::vector<std::string> uuids;
+		uuids.push_back("00001801-0000-1000-8000-00805f9b34fb");
+		uuids.push_back("00001101-0000-1000-8000-00805f9b34fb");
+		return BluetoothProperty(type, uuids);
+	}
+	default:
+		return BluetoothProperty();
+	}
+}
+
+BluetoothPropertiesList VirtualAdapter::buildProperties() const
+{
+	BluetoothPropertiesList properties;
+
+	properties.push_back(buildProperty(BluetoothProperty::Type::NAME));
+	properties.push_back(buildProperty(BluetoothProperty::Type::STACK_NAME));
+	properties.push_back(buildProperty(BluetoothProperty::Type::STACK_VERSION));
+	properties.push_back(buildProperty(BluetoothProperty::Type::BDADDR));
+	properties.push_back(buildProperty(BluetoothProperty::Type::CLASS_OF_DEVICE));
+	properties.push_back(buildProperty(BluetoothProperty::Type::DISCOVERY_TIMEOUT));
+	properties.push_back(buildProperty(BluetoothProperty::Type::DISCOVERABLE));
+	properties.push_back(buildProperty(BluetoothProperty::Type::PAIRABLE));
+	properties.push_back(buildProperty(BluetoothProperty::Type::UUIDS));
+
+	return properties;
+}
+
+void VirtualAdapter::getAdapterProperties(BluetoothPropertiesResultCallback callback)
+{
+	BluetoothPropertiesList properties = buildProperties();
+	VirtualDeferredCall::schedule(0, [callback, properties]() {
+		callback(BLUETOOTH_ERROR_NONE, properties);
+	});
+}
+
+void VirtualAdapter::getAdapterProperty(BluetoothProperty::Type type, BluetoothPropertyResultCallback callback)
+{
+	BluetoothProperty property = buildProperty(type);
+	VirtualDeferredCall::schedule(0, [callback, property]() {
+		callback(property.getType() == BluetoothProperty::Type::UNKNOWN ? BLUETOOTH_ERROR_PARAM_INVALID : BLUETOOTH_ERROR_NONE, property);
+	});
+}
+
+void VirtualAdapter::applyProperty(const BluetoothProperty &property)
+{
+	switch (property.getType())
+	{
+	case BluetoothProperty::Type::NAME:
+	case BluetoothProperty::Type::ALIAS:
+		mName = property.getValue<std::string>();
+		break;
+	case BluetoothProperty::Type::DISCOVERY_TIMEOUT:
+		mDiscoveryTimeout = property.getValue<uint32_t>();
+		break;
+	case BluetoothProperty::Type::DISCOVERABLE:
+		mDiscoverable = property.getValue<bool>();
+		break;
+	case BluetoothProperty::Type::PAIRABLE:
+		mPairable = property.getValue<bool>();
+		break;
+	default:
+		break;
+	}
+}
+
+void VirtualAdapter::setAdapterProperty(const BluetoothProperty &property, BluetoothResultCallback callback)
+{
+	applyProperty(property);
+
+	BluetoothPropertiesList changed;
+	changed.push_back(buildProperty(property.getType()));
+	notifyPropertiesChanged(changed);
+
+	VirtualDeferredCall::schedule(0, [callback]() {
+		callback(BLUETOOTH_ERROR_NONE);
+	});
+}
+
+void VirtualAdapter::setAdapterProperties(const BluetoothPropertiesList &properties, BluetoothResultCallback callback)
+{
+	BluetoothPropertiesList changed;
+	for (auto property : properties)
+	{
+		applyProperty(property);
+		changed.push_back(buildProperty(property.getType()));
+	}
+	notifyPropertiesChanged(changed);
+
+	VirtualDeferredCall::schedule(0, [callback]() {
+		callback(BLUETOOTH_ERROR_NONE);
+	});
+}
+
+void VirtualAdapter::notifyPropertiesChanged(const BluetoothPropertiesList &properties)
+{
+	if (observer)
+		observer->adapterPropertiesChanged(properties);
+}
+
+void VirtualAdapter::getDeviceProperties(const std::string &address, BluetoothPropertiesResultCallback callback)
+{
+	VirtualDevice *device = findDevice(address);
+	BluetoothPropertiesList properties;
+	if (device)
+		properties = device->getProperties();
+
+	VirtualDeferredCall::schedule(0, [callback, device, properties]() {
+		callback(device ? BLUETOOTH_ERROR_NONE : BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE, properties);
+	});
+}
+
+void VirtualAdapter::setDeviceProperty(const std::string &address, const BluetoothProperty &property, BluetoothResultCallback callback)
+{
+	BluetoothPropertiesList properties;
+	properties.push_back(property);
+	setDeviceProperties(address, properties, callback);
+}
+
+void VirtualAdapter::setDeviceProperties(const std::string &address, const BluetoothPropertiesList &properties, BluetoothResultCallback callback)
+{
+	// Trusted/blocked and aliases don't influence the simulation
+	BluetoothError error = findDevice(address) ? BLUETOOTH_ERROR_NONE : BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE;
+	if (error == BLUETOOTH_ERROR_NONE && observer)
+		observer->devicePropertiesChanged(address, properties);
+
+	VirtualDeferredCall::schedule(0, [callback, error]() {
+		callback(error);
+	});
+}
+
+void VirtualAdapter::setDiscovering(bool discovering)
+{
+	if (mDiscovering == discovering)
+		return;
+
+	mDiscovering = discovering;
+
+	if (mDiscoveryTimer)
+	{
+		g_source_remove(mDiscoveryTimer);
+		mDiscoveryTimer = 0;
+	}
+
+	if (discovering)
+		mDiscoveryTimer = g_timeout_add(mConfig.discoveryInterval > 0 ? mConfig.discoveryInterval : 1,
+		                                &VirtualAdapter::handleDiscoveryTimeout, this);
+
+	if (observer)
+		observer->discoveryStateChanged(discovering);
+}
+
+BluetoothError VirtualAdapter::startDiscovery()
+{
+	if (!mPowered)
+		return BLUETOOTH_ERROR_NOT_READY;
+
+	// Every discovery reports all devices again, like a real inquiry
+	mFoundCount = 0;
+	setDiscovering(true);
+
+	return BLUETOOTH_ERROR_NONE;
+}
+
+void VirtualAdapter::cancelDiscovery(BluetoothResultCallback callback)
+{
+	setDiscovering(false);
+
+	VirtualDeferredCall::schedule(0, [callback]() {
+		callback(BLUETOOTH_ERROR_NONE);
+	});
+}
+
+int32_t VirtualAdapter::addLeDiscoveryFilter(const BluetoothLeDiscoveryFilter &filter)
+{
+	// Scan ids are handed out in order starting at 1
+	return mNextScanId++;
+}
+
+BluetoothError VirtualAdapter::startLeDiscovery()
+{
+	// Scans are accepted so clients can subscribe to them; no devices are
+	// reported by scan id
+	if (!mPowered)
+		return BLUETOOTH_ERROR_NOT_READY;
+
+	return BLUETOOTH_ERROR_NONE;
+}
+
+gboolean VirtualAdapter::handleDiscoveryTimeout(gpointer userData)
+{
+	VirtualAdapter *adapter = static_cast<VirtualAdapter*>(userData);
+
+	if (adapter->mFoundCount >= adapter->mDevices.size())
+	{
+		adapter->mDiscoveryTimer = 0;
+		adapter->setDiscovering(false);
+		return FALSE;
+	}
+
+	VirtualDevice *device = adapter->mDevices[adapter->mFoundCount++];
+	if (adapter->observer)
+		adapter->observer->deviceFound(device->getProperties());
+
+	return TRUE;
+}
+
+gboolean VirtualAdapter::handleRssiTimeout(gpointer userData)
+{
+	VirtualAdapter *adapter = static_cast<VirtualAdapter*>(userData);
+	if (!adapter->observer)
+		return TRUE;
+
+	for (auto device : adapter->mDevices)
+	{
+		BluetoothPropertiesList properties;
+		properties.push_back(BluetoothProperty(BluetoothProperty::Type::RSSI, device->updateRssi()));
+		adapter->observer->devicePropertiesChanged(device->getAddress(), properties);
+	}
+
+	return TRUE;
+}
+
+void VirtualAdapter::pair(const std::string &address, BluetoothResultCallback callback)
+{
+	VirtualDevice *device = findDevice(address);
+	if (!device)
+	{
+		VirtualDeferredCall::schedule(0, [callback]() {
+			callback(BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE);
+		});
+		return;
+	}
+
+	// Pairing always succeeds without any user interaction
+	VirtualDeferredCall::schedule(mConfig.serviceDiscoveryDelay, [this, device, callback]() {
+		device->setPaired(true);
+
+		BluetoothPropertiesList properties;
+		properties.push_back(BluetoothProperty(BluetoothProperty::Type::PAIRED, true));
+		if (observer)
+			observer->devicePropertiesChanged(device->getAddress(), properties);
+
+		callback(BLUETOOTH_ERROR_NONE);
+	});
+}
+
+BluetoothError VirtualAdapter::supplyPairingConfirmation(const std::string &address, bool accept)
+{
+	return BLUETOOTH_ERROR_NONE;
+}
+
+BluetoothError VirtualAdapter::supplyPairingSecret(const std::string &address, BluetoothPasskey passkey)
+{
+	return BLUETOOTH_ERROR_NONE;
+}
+
+BluetoothError VirtualAdapter::supplyPairingSecret(const std::string &address, const std::string &pin)
+{
+	return BLUETOOTH_ERROR_NONE;
+}
+
+void VirtualAdapter::cancelPairing(const std::string &address, BluetoothResultCallback callback)
+{
+	VirtualDeferredCall::schedule(0, [callback]() {
+		callback(BLUETOOTH_ERROR_NONE);
+	});
+}
+
+void VirtualAdapter::unpair(const std::string &address, BluetoothResultCallback callback)
+{
+	VirtualDevice *device = findDevice(address);
+	BluetoothError error = device ? BLUETOOTH_ERROR_NONE : BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE;
+
+	if (device)
+	{
+		device->setPaired(false);
+
+		BluetoothPropertiesList properties;
+		properties.push_back(BluetoothProperty(BluetoothProperty::Type::PAIRED, false));
+		if (observer)
+			observer->devicePropertiesChanged(address, properties);
+	}
+
+	VirtualDeferredCall::schedule(0, [callback, error]() {
+		callback(error);
+	});
+}
+
+BluetoothProfile* VirtualAdapter::getProfile(const std::string &profileId)
+{
+	if (profileId == "GATT")
+		return mGatt;
+	else if (profileId == "SPP")
+		return mSpp;
+
+	return 0;
+}
+
+VirtualDevice* VirtualAdapter::findDevice(const std::string &address)
+{
+	gchar *lowerAddress = g_ascii_strdown(address.c_str(), -1);
+	std::string key = lowerAddress;
+	g_free(lowerAddress);
+
+	for (auto device : mDevices)
+	{
+		if (device->getAddress() == key)
+			return device;
+	}
+
+	return 0;
+}
+
+void VirtualAdapter::setDeviceConnected(VirtualDevice *device, bool connected)
+{
+	if (device->getConnected() == connected)
+		return;
+
+	device->setConnected(connected);
+
+	BluetoothPropertiesList properties;
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::CONNECTED, connected));
+	if (observer)
+		observer->devicePropertiesChanged(device->getAddress(), properties);
+}
+
+void VirtualAdapter::replay(const BluetoothSilTraceRecord &record)
+{
+	switch (record.event)
+	{
+	case BLUETOOTH_SIL_TRACE_EVENT_DISCOVERY_STATE_CHANGED:
+		if (observer)
+			observer->discoveryStateChanged(record.state);
+		break;
+	case BLUETOOTH_SIL_TRACE_EVENT_DEVICE_FOUND:
+		if (observer && record.address.empty())
+			observer->deviceFound(record.properties);
+		else if (observer)
+			observer->deviceFound(record.address, record.properties);
+		break;
+	case BLUETOOTH_SIL_TRACE_EVENT_DEVICE_PROPERTIES_CHANGED:
+		if (observer)
+			observer->devicePropertiesChanged(record.address, record.properties);
+		break;
+	case BLUETOOTH_SIL_TRACE_EVENT_DEVICE_REMOVED:
+		if (observer)
+			observer->deviceRemoved(record.address);
+		break;
+	case BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_FOUND:
+		if (observer)
+			observer->leDeviceFound(record.address, record.properties);
+		break;
+	case BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_PROPERTIES_CHANGED:
+		if (observer)
+			observer->leDevicePropertiesChanged(record.address, record.properties);
+		break;
+	case BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_REMOVED:
+		if (observer)
+			observer->leDeviceRemoved(record.address);
+		break;
+	case BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_FOUND_BY_SCAN_ID:
+		if (observer)
+			observer->leDeviceFoundByScanId(record.id, record.properties);
+		break;
+	case BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_PROPERTIES_CHANGED_BY_SCAN_ID:
+		if (observer)
+			observer->leDevicePropertiesChangedByScanId(record.id, record.address, record.properties);
+		break;
+	case BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_REMOVED_BY_SCAN_ID:
+		if (observer)
+			observer->leDeviceRemovedByScanId(record.id, record.address);
+		break;
+	case BLUETOOTH_SIL_TRACE_EVENT_CHARACTERISTIC_VALUE_CHANGED:
+	case BLUETOOTH_SIL_TRACE_EVENT_GATT_CONNECTION_STATE_CHANGED:
+	case BLUETOOTH_SIL_TRACE_EVENT_GATT_SERVICE_FOUND:
+	case BLUETOOTH_SIL_TRACE_EVENT_GATT_SERVICE_LOST:
+		mGatt->replay(record);
+		break;
+	case BLUETOOTH_SIL_TRACE_EVENT_SPP_CHANNEL_STATE_CHANGED:
+	case BLUETOOTH_SIL_TRACE_EVENT_SPP_DATA_RECEIVED:
+		mSpp->replay(record);
+		break;
+	default:
+		// Power and adapter properties stay under control of the virtual adapter
+		break;
+	}
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef VIRTUALADAPTER_H
+#define VIRTUALADAPTER_H
+
+#include <string>
+#include <vector>
+#include <glib.h>
+#include <bluetooth-sil-api.h>
+#include <bluetoothsiltrace.h>
+
+#include "virtualcontrollerconfig.h"
+#include "virtualdevice.h"
+
+class VirtualGattProfile;
+class VirtualSppProfile;
+class VirtualTraceReplay;
+
+/*
+ * Adapter of the virtual controller. Discovery reports the configured
+ * BR/EDR and LE devices one per discovery interval, and the signal
+ * strength of every device found keeps changing while powered.
+ */
+class VirtualAdapter : public BluetoothAdapter
+{
+public:
+	VirtualAdapter(const VirtualControllerConfig &config);
+	VirtualAdapter(const VirtualAdapter &other) = delete;
+	~VirtualAdapter();
+
+	BluetoothError enable();
+	BluetoothError disable();
+
+	void getAdapterProperties(BluetoothPropertiesResultCallback callback);
+	void getAdapterProperty(BluetoothProperty::Type type, BluetoothPropertyResultCallback callback);
+	void setAdapterProperty(const BluetoothProperty &property, BluetoothResultCallback callback);
+	void setAdapterProperties(const BluetoothPropertiesList &properties, BluetoothResultCallback callback);
+
+	void getDeviceProperties(const std::string &address, BluetoothPropertiesResultCallback callback);
+	void setDeviceProperty(const std::string &address, const BluetoothProperty &property, BluetoothResultCallback callback);
+	void setDeviceProperties(const std::string &address, const BluetoothPropertiesList &properties, BluetoothResultCallback callback);
+
+	BluetoothError startDiscovery();
+	void cancelDiscovery(BluetoothResultCallback callback);
+
+	int32_t addLeDiscoveryFilter(const BluetoothLeDiscoveryFilter &filter);
+	BluetoothError startLeDiscovery();
+
+	void pair(const std::string &address, BluetoothResultCallback callback);
+	BluetoothError supplyPairingConfirmation(const std::string &address, bool accept);
+	BluetoothError supplyPairingSecret(const std::string &address, BluetoothPasskey passkey);
+	BluetoothError supplyPairingSecret(const std::string &address, const std::string &pin);
+	void cancelPairing(const std::string &address, BluetoothResultCallback callback);
+	void unpair(const std::string &address, BluetoothResultCallback callback);
+
+	BluetoothProfile* getProfile(const std::string &profileId);
+
+	std::string getAddress() const { return mAddress; }
+	VirtualDevice* findDevice(const std::string &address);
+	void setDeviceConnected(VirtualDevice *device, bool connected);
+	void replay(const BluetoothSilTraceRecord &record);
+
+private:
+	VirtualControllerConfig mConfig;
+	std::string mAddress;
+	std::string mName;
+	bool mPowered;
+	bool mDiscovering;
+	bool mDiscoverable;
+	bool mPairable;
+	uint32_t mDiscoveryTimeout;
+	std::vector<VirtualDevice*> mDevices;
+	unsigned int mFoundCount;
+	uint32_t mNextScanId;
+	guint mDiscoveryTimer;
+	guint mRssiTimer;
+	VirtualGattProfile *mGatt;
+	VirtualSppProfile *mSpp;
+	VirtualTraceReplay *mReplay;
+
+	BluetoothPropertiesList buildProperties() const;
+	BluetoothProperty buildProperty(BluetoothProperty::Type type) const;
+	void applyProperty(const BluetoothProperty &property);
+	void notifyPropertiesChanged(const BluetoothPropertiesList &properties);
+	void setDiscovering(bool discovering);
+	void stopTimers();
+
+	static gboolean handleDiscoveryTimeout(gpointer userData);
+	static gboolean handleRssiTimeout(gpointer userData);
+};
+
+#endif // VIRTUALADAPTER_H
@@ -0,0 +1,93 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <glib.h>
+
+#include "virtualcontrollerconfig.h"
+
+#define VIRTUAL_CONTROLLER_GROUP "Controller"
+
+static void readValue(GKeyFile *keyFile, const char *key, unsigned int &value)
+{
+	GError *error = 0;
+	gint number = g_key_file_get_integer(keyFile, VIRTUAL_CONTROLLER_GROUP, key, &error);
+	if (error)
+	{
+		g_error_free(error);
+		return;
+	}
+
+	if (number >= 0)
+		value = number;
+}
+
+static void readValue(GKeyFile *keyFile, const char *key, std::string &value)
+{
+	gchar *string = g_key_file_get_string(keyFile, VIRTUAL_CONTROLLER_GROUP, key, 0);
+	if (!string)
+		return;
+
+	value = string;
+	g_free(string);
+}
+
+VirtualControllerConfig::VirtualControllerConfig() :
+	brEdrDevices(4),
+	leDevices(16),
+	discoveryInterval(50),
+	rssiInterval(1000),
+	serviceDiscoveryDelay(200),
+	gattCharacteristics(8),
+	notifyInterval(100),
+	notifyValueSize(20),
+	sppRate(65536),
+	sppChunkSize(990),
+	sppLoopback(0),
+	replaySpeed(1)
+{
+}
+
+void VirtualControllerConfig::load(const std::string &path)
+{
+	GKeyFile *keyFile = g_key_file_new();
+	GError *error = 0;
+
+	if (!g_key_file_load_from_file(keyFile, path.c_str(), G_KEY_FILE_NONE, &error))
+	{
+		g_warning("Failed to load virtual controller configuration %s: %s", path.c_str(), error->message);
+		g_error_free(error);
+		g_key_file_free(keyFile);
+		return;
+	}
+
+	readValue(keyFile, "BrEdrDevices", brEdrDevices);
+	readValue(keyFile, "LeDevices", leDevices);
+	readValue(keyFile, "DiscoveryInterval", discoveryInterval);
+	readValue(keyFile, "RssiInterval", rssiInterval);
+	readValue(keyFile, "ServiceDiscoveryDelay", serviceDiscoveryDelay);
+	readValue(keyFile, "GattCharacteristics", gattCharacteristics);
+	readValue(keyFile, "NotifyInterval", notifyInterval);
+	readValue(keyFile, "NotifyValueSize", notifyValueSize);
+	readValue(keyFile, "SppRate", sppRate);
+	readValue(keyFile, "SppChunkSize", sppChunkSize);
+	readValue(keyFile, "SppLoopback", sppLoopback);
+	readValue(keyFile, "ReplayTrace", replayTrace);
+	readValue(keyFile, "ReplaySpeed", replaySpeed);
+
+	g_key_file_free(keyFile);
+}
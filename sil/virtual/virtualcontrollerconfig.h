@@ -0,0 +1,51 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef VIRTUALCONTROLLERCONFIG_H
+#define VIRTUALCONTROLLERCONFIG_H
+
+#include <string>
+
+/*
+ * Load profile of the virtual controller. Defaults can be overridden through
+ * the [Controller] group of the key file named by
+ * WEBOS_BLUETOOTH_VIRTUAL_SIL_CONFIG. All intervals are in milliseconds.
+ */
+class VirtualControllerConfig
+{
+public:
+	VirtualControllerConfig();
+
+	void load(const std::string &path);
+
+	unsigned int brEdrDevices;
+	unsigned int leDevices;
+	unsigned int discoveryInterval;
+	unsigned int rssiInterval;
+	unsigned int serviceDiscoveryDelay;
+	unsigned int gattCharacteristics;
+	unsigned int notifyInterval;
+	unsigned int notifyValueSize;
+	unsigned int sppRate;
+	unsigned int sppChunkSize;
+	unsigned int sppLoopback;
+	std::string replayTrace;
+	unsigned int replaySpeed;
+};
+
+#endif // VIRTUALCONTROLLERCONFIG_H
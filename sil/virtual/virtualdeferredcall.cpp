@@ -0,0 +1,42 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "virtualdeferredcall.h"
+
+void VirtualDeferredCall::schedule(unsigned int delay, std::function<void(void)> function)
+{
+	if (!function)
+		return;
+
+	VirtualDeferredCall *call = new VirtualDeferredCall(function);
+
+	if (delay == 0)
+		g_idle_add(&VirtualDeferredCall::handleTimeout, call);
+	else
+		g_timeout_add(delay, &VirtualDeferredCall::handleTimeout, call);
+}
+
+gboolean VirtualDeferredCall::handleTimeout(gpointer userData)
+{
+	VirtualDeferredCall *call = static_cast<VirtualDeferredCall*>(userData);
+
+	call->mFunction();
+	delete call;
+
+	return FALSE;
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef VIRTUALDEFERREDCALL_H
+#define VIRTUALDEFERREDCALL_H
+
+#include <functional>
+#include <glib.h>
+
+/*
+ * Runs a function from the main loop after the given delay. Results of the
+ * virtual controller are delivered this way so callers see the same
+ * asynchronous behaviour as with a real stack.
+ */
+class VirtualDeferredCall
+{
+public:
+	static void schedule(unsigned int delay, std::function<void(void)> function);
+
+private:
+	VirtualDeferredCall(std::function<void(void)> function) :
+		mFunction(function)
+	{
+	}
+
+	std::function<void(void)> mFunction;
+
+	static gboolean handleTimeout(gpointer userData);
+};
+
+#endif // VIRTUALDEFERREDCALL_H
@@ -0,0 +1,205 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <glib.h>
+
+#include "virtualdevice.h"
+
+#define VIRTUAL_RSSI_MIN -95
+#define VIRTUAL_RSSI_MAX -35
+
+VirtualDevice::VirtualDevice(unsigned int index, BluetoothDeviceType type, const VirtualControllerConfig &config) :
+	mType(type),
+	mRssi(g_random_int_range(VIRTUAL_RSSI_MIN, VIRTUAL_RSSI_MAX + 1)),
+	mPaired(false),
+	mConnected(false)
+{
+	// Locally administered addresses, second byte tells BR/EDR and LE apart
+	gchar *address = g_strdup_printf("02:%02x:00:00:%02x:%02x", type == BLUETOOTH_DEVICE_TYPE_BLE ? 0x1e : 0xbe,
+	                                 (index >> 8) & 0xff, index & 0xff);
+	mAddress = address;
+	g_free(address);
+
+	gchar *name = g_strdup_printf("Virtual %s %u", type == BLUETOOTH_DEVICE_TYPE_BLE ? "LE" : "BR/EDR", index);
+	mName = name;
+	g_free(name);
+
+	if (type == BLUETOOTH_DEVICE_TYPE_BLE)
+		buildServices(config.gattCharacteristics);
+}
+
+BluetoothPropertiesList VirtualDevice::getProperties() const
+{
+	BluetoothPropertiesList properties;
+
+	std::vector<std::string> uuids;
+	if (mType == BLUETOOTH_DEVICE_TYPE_BLE)
+	{
+		uuids.push_back(VIRTUAL_BATTERY_SERVICE_UUID);
+		uuids.push_back(VIRTUAL_LOAD_SERVICE_UUID);
+	}
+	else
+	{
+		uuids.push_back("00001101-0000-1000-8000-00805f9b34fb");
+	}
+
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::BDADDR, mAddress));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::NAME, mName));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::TYPE_OF_DEVICE, (uint32_t) mType));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::CLASS_OF_DEVICE, (uint32_t) (mType == BLUETOOTH_DEVICE_TYPE_BLE ? 0 : 0x1f00)));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::UUIDS, uuids));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::RSSI, mRssi));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::PAIRED, mPaired));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::CONNECTED, mConnected));
+
+	return properties;
+}
+
+int VirtualDevice::updateRssi()
+{
+	// Random walk so consumers see gradual rather than jumping values
+	mRssi += g_random_int_range(-3, 4);
+	mRssi = CLAMP(mRssi, VIRTUAL_RSSI_MIN, VIRTUAL_RSSI_MAX);
+
+	return mRssi;
+}
+
+void VirtualDevice::buildServices(unsigned int characteristics)
+{
+	uint16_t handle = 1;
+
+	BluetoothGattService battery;
+	battery.setUuid(BluetoothUuid(VIRTUAL_BATTERY_SERVICE_UUID));
+	battery.setType(BluetoothGattService::PRIMARY);
+	battery.setHandle(handle++);
+
+	BluetoothGattCharacteristic level(BluetoothUuid(VIRTUAL_BATTERY_LEVEL_UUID),
+	                                  BluetoothGattCharacteristic::PROPERTY_READ | BluetoothGattCharacteristic::PROPERTY_NOTIFY,
+	                                  BluetoothGattPermission::PERMISSION_READ);
+	level.setHandle(handle++);
+	level.setServiceHandle(battery.getHandle());
+	level.setValue(BluetoothGattValue(1, 100));
+
+	BluetoothGattDescriptor levelConfiguration(BluetoothUuid(VIRTUAL_CLIENT_CONFIGURATION_UUID),
+	                                           BluetoothGattPermission::PERMISSION_READ | BluetoothGattPermission::PERMISSION_WRITE);
+	levelConfiguration.setHandle(handle++);
+	levelConfiguration.setValue(BluetoothGattValue(2, 0));
+	level.addDescriptor(levelConfiguration);
+
+	battery.addCharacteristic(level);
+	mServices.push_back(battery);
+
+	BluetoothGattService load;
+	load.setUuid(BluetoothUuid(VIRTUAL_LOAD_SERVICE_UUID));
+	load.setType(BluetoothGattService::PRIMARY);
+	load.setHandle(handle++);
+
+	for (unsigned int i = 0; i < characteristics; i++)
+	{
+		gchar *uuid = g_strdup_printf(VIRTUAL_LOAD_CHARACTERISTIC_FORMAT, i + 1);
+		BluetoothGattCharacteristic characteristic(BluetoothUuid(uuid),
+		                                           BluetoothGattCharacteristic::PROPERTY_READ | BluetoothGattCharacteristic::PROPERTY_WRITE |
+		                                           BluetoothGattCharacteristic::PROPERTY_WRITE_WITHOUT_RESPONSE | BluetoothGattCharacteristic::PROPERTY_NOTIFY,
+		                                           BluetoothGattPermission::PERMISSION_READ | BluetoothGattPermission::PERMISSION_WRITE);
+		g_free(uuid);
+
+		characteristic.setHandle(handle++);
+		characteristic.setServiceHandle(load.getHandle());
+
+		BluetoothGattDescriptor configuration(BluetoothUuid(VIRTUAL_CLIENT_CONFIGURATION_UUID),
+		                                      BluetoothGattPermission::PERMISSION_READ | BluetoothGattPermission::PERMISSION_WRITE);
+		configuration.setHandle(handle++);
+		configuration.setValue(BluetoothGattValue(2, 0));
+		characteristic.addDescriptor(configuration);
+
+		load.addCharacteristic(characteristic);
+	}
+
+	mServices.push_back(load);
+}
+
+bool VirtualDevice::findCharacteristic(const BluetoothUuid &service, const BluetoothUuid &characteristic,
+                                       BluetoothGattCharacteristic &result, BluetoothUuid &serviceUuid) const
+{
+	for (auto gattService : mServices)
+	{
+		if (gattService.getUuid() != service || !gattService.isCharacteristicAvailable(characteristic))
+			continue;
+
+		result = gattService.getCharacteristic(characteristic);
+		serviceUuid = gattService.getUuid();
+		return true;
+	}
+
+	return false;
+}
+
+bool VirtualDevice::findCharacteristic(uint16_t handle, BluetoothGattCharacteristic &result, BluetoothUuid &serviceUuid) const
+{
+	for (auto gattService : mServices)
+	{
+		if (!gattService.isCharacteristicAvailable(handle))
+			continue;
+
+		result = gattService.getCharacteristic(handle);
+		serviceUuid = gattService.getUuid();
+		return true;
+	}
+
+	return false;
+}
+
+bool VirtualDevice::findDescriptor(uint16_t handle, BluetoothGattDescriptor &result, uint16_t &characteristicHandle) const
+{
+	for (auto gattService : mServices)
+	{
+		for (auto characteristic : gattService.getCharacteristics())
+		{
+			if (!characteristic.isDescriptorAvailable(handle))
+				continue;
+
+			result = characteristic.getDescriptor(handle);
+			characteristicHandle = characteristic.getHandle();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool VirtualDevice::updateCharacteristicValue(uint16_t handle, const BluetoothGattValue &value)
+{
+	for (auto &gattService : mServices)
+	{
+		if (gattService.updateCharacteristicValue(handle, value))
+			return true;
+	}
+
+	return false;
+}
+
+bool VirtualDevice::updateDescriptorValue(uint16_t handle, const BluetoothGattValue &value)
+{
+	for (auto &gattService : mServices)
+	{
+		if (gattService.updateDescriptorValue(handle, value))
+			return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef VIRTUALDEVICE_H
+#define VIRTUALDEVICE_H
+
+#include <string>
+#include <bluetooth-sil-api.h>
+
+#include "virtualcontrollerconfig.h"
+
+#define VIRTUAL_BATTERY_SERVICE_UUID        "0000180f-0000-1000-8000-00805f9b34fb"
+#define VIRTUAL_BATTERY_LEVEL_UUID          "00002a19-0000-1000-8000-00805f9b34fb"
+#define VIRTUAL_CLIENT_CONFIGURATION_UUID   "00002902-0000-1000-8000-00805f9b34fb"
+// Characteristics of the load service are numbered in the first field
+#define VIRTUAL_LOAD_SERVICE_UUID           "5e1d0000-7a5c-4b8e-9c6f-7669727475a1"
+#define VIRTUAL_LOAD_CHARACTERISTIC_FORMAT  "5e1d%04x-7a5c-4b8e-9c6f-7669727475a1"
+
+/*
+ * A simulated remote device. LE devices expose a battery service and a
+ * load service with a configurable number of notifying characteristics;
+ * BR/EDR devices offer a serial port.
+ */
+class VirtualDevice
+{
+public:
+	VirtualDevice(unsigned int index, BluetoothDeviceType type, const VirtualControllerConfig &config);
+	VirtualDevice(const VirtualDevice &other) = delete;
+
+	std::string getAddress() const { return mAddress; }
+	BluetoothDeviceType getType() const { return mType; }
+	int getRssi() const { return mRssi; }
+	bool getPaired() const { return mPaired; }
+	bool getConnected() const { return mConnected; }
+	void setPaired(bool paired) { mPaired = paired; }
+	void setConnected(bool connected) { mConnected = connected; }
+
+	BluetoothPropertiesList getProperties() const;
+	int updateRssi();
+
+	BluetoothGattServiceList getServices() const { return mServices; }
+	bool findCharacteristic(const BluetoothUuid &service, const BluetoothUuid &characteristic,
+	                        BluetoothGattCharacteristic &result, BluetoothUuid &serviceUuid) const;
+	bool findCharacteristic(uint16_t handle, BluetoothGattCharacteristic &result, BluetoothUuid &serviceUuid) const;
+	bool findDescriptor(uint16_t handle, BluetoothGattDescriptor &result, uint16_t &characteristicHandle) const;
+	bool updateCharacteristicValue(uint16_t handle, const BluetoothGattValue &value);
+	bool updateDescriptorValue(uint16_t handle, const BluetoothGattValue &value);
+
+private:
+	std::string mAddress;
+	std::string mName;
+	BluetoothDeviceType mType;
+	int mRssi;
+	bool mPaired;
+	bool mConnected;
+	BluetoothGattServiceList mServices;
+
+	void buildServices(unsigned int characteristics);
+};
+
+#endif // VIRTUALDEVICE_H
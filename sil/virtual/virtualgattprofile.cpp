@@ -0,0 +1,780 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <algorithm>
+
+#include "virtualgattprofile.h"
+#include "virtualadapter.h"
+#include "virtualdevice.h"
+#include "virtualdeferredcall.h"
+
+VirtualGattProfile::VirtualGattProfile(VirtualAdapter *adapter, const VirtualControllerConfig &config) :
+	mAdapter(adapter),
+	mConfig(config),
+	mNextAppId(1),
+	mNextConnectId(1),
+	mNextLocalHandle(0x100),
+	mNotificationCounter(0),
+	mSentNotificationCount(0),
+	mNotifyTimer(0)
+{
+}
+
+VirtualGattProfile::~VirtualGattProfile()
+{
+	if (mNotifyTimer)
+		g_source_remove(mNotifyTimer);
+}
+
+void VirtualGattProfile::complete(BluetoothResultCallback callback, BluetoothError error)
+{
+	VirtualDeferredCall::schedule(0, [callback, error]() {
+		if (callback)
+			callback(error);
+	});
+}
+
+VirtualDevice* VirtualGattProfile::findConnectedDevice(const std::string &address)
+{
+	VirtualDevice *device = mAdapter->findDevice(address);
+	if (!device || device->getType() != BLUETOOTH_DEVICE_TYPE_BLE || !device->getConnected())
+		return 0;
+
+	return device;
+}
+
+std::string VirtualGattProfile::findAddress(uint16_t connectId) const
+{
+	for (auto connectIter : mConnectIds)
+	{
+		if (connectIter.second == connectId)
+			return connectIter.first;
+	}
+
+	return std::string();
+}
+
+bool VirtualGattProfile::isDiscovered(const std::string &address) const
+{
+	return std::find(mDiscovered.begin(), mDiscovered.end(), address) != mDiscovered.end();
+}
+
+void VirtualGattProfile::setConnected(VirtualDevice *device, bool connected)
+{
+	std::string address = device->getAddress();
+
+	if (!connected)
+	{
+		mConnectIds.erase(address);
+		mDiscovered.erase(std::remove(mDiscovered.begin(), mDiscovered.end(), address), mDiscovered.end());
+		mWatches.erase(std::remove_if(mWatches.begin(), mWatches.end(), [&address](const Watch &watch) {
+			return watch.address == address;
+		}), mWatches.end());
+		updateNotifyTimer();
+	}
+
+	mAdapter->setDeviceConnected(device, connected);
+
+	BluetoothPropertiesList properties;
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::CONNECTED, connected));
+	if (getObserver())
+		getObserver()->propertiesChanged(address, properties);
+	if (getGattObserver())
+		getGattObserver()->connectionStateChanged(address, connected);
+}
+
+void VirtualGattProfile::getProperties(const std::string &address, BluetoothPropertiesResultCallback callback)
+{
+	VirtualDevice *device = mAdapter->findDevice(address);
+
+	BluetoothPropertiesList properties;
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::CONNECTED, device && device->getConnected()));
+
+	VirtualDeferredCall::schedule(0, [callback, properties]() {
+		callback(BLUETOOTH_ERROR_NONE, properties);
+	});
+}
+
+void VirtualGattProfile::getProperty(const std::string &address, BluetoothProperty::Type type, BluetoothPropertyResultCallback callback)
+{
+	VirtualDevice *device = mAdapter->findDevice(address);
+
+	BluetoothProperty property(type);
+	if (type == BluetoothProperty::Type::CONNECTED)
+		property.setValue<bool>(device && device->getConnected());
+
+	VirtualDeferredCall::schedule(0, [callback, property]() {
+		callback(BLUETOOTH_ERROR_NONE, property);
+	});
+}
+
+void VirtualGattProfile::connect(const std::string &address, BluetoothResultCallback callback)
+{
+	VirtualDevice *device = mAdapter->findDevice(address);
+	if (!device || device->getType() != BLUETOOTH_DEVICE_TYPE_BLE)
+	{
+		complete(callback, BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE);
+		return;
+	}
+
+	VirtualDeferredCall::schedule(mConfig.serviceDiscoveryDelay, [this, device, callback]() {
+		if (mConnectIds.find(device->getAddress()) == mConnectIds.end())
+			mConnectIds[device->getAddress()] = mNextConnectId++;
+
+		setConnected(device, true);
+		callback(BLUETOOTH_ERROR_NONE);
+	});
+}
+
+void VirtualGattProfile::disconnect(const std::string &address, BluetoothResultCallback callback)
+{
+	VirtualDevice *device = findConnectedDevice(address);
+	if (!device)
+	{
+		complete(callback, BLUETOOTH_ERROR_NOT_ALLOWED);
+		return;
+	}
+
+	setConnected(device, false);
+	complete(callback, BLUETOOTH_ERROR_NONE);
+}
+
+uint16_t VirtualGattProfile::addApplication(const BluetoothUuid &appUuid, ApplicationType type)
+{
+	return mNextAppId++;
+}
+
+bool VirtualGattProfile::removeApplication(uint16_t appId, ApplicationType type)
+{
+	for (auto appIter = mAppIds.begin(); appIter != mAppIds.end();)
+	{
+		if (appIter->second == appId)
+			appIter = mAppIds.erase(appIter);
+		else
+			appIter++;
+	}
+
+	return true;
+}
+
+void VirtualGattProfile::connectGatt(uint16_t appId, bool autoConnection, const std::string &address, BluetoothConnectCallback callback)
+{
+	VirtualDevice *device = mAdapter->findDevice(address);
+	if (!device || device->getType() != BLUETOOTH_DEVICE_TYPE_BLE)
+	{
+		VirtualDeferredCall::schedule(0, [callback]() {
+			callback(BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE, 0);
+		});
+		return;
+	}
+
+	VirtualDeferredCall::schedule(mConfig.serviceDiscoveryDelay, [this, device, appId, callback]() {
+		std::string address = device->getAddress();
+		if (mConnectIds.find(address) == mConnectIds.end())
+			mConnectIds[address] = mNextConnectId++;
+		mAppIds[address] = appId;
+
+		uint16_t connectId = mConnectIds[address];
+		callback(BLUETOOTH_ERROR_NONE, connectId);
+		setConnected(device, true);
+	});
+}
+
+void VirtualGattProfile::disconnectGatt(uint16_t appId, uint16_t connectId, const std::string &address, BluetoothResultCallback callback)
+{
+	disconnect(address, callback);
+}
+
+uint16_t VirtualGattProfile::getConnectId(const std::string &address)
+{
+	auto connectIter = mConnectIds.find(address);
+	return connectIter != mConnectIds.end() ? connectIter->second : 0;
+}
+
+uint16_t VirtualGattProfile::getAppId(const std::string &address)
+{
+	auto appIter = mAppIds.find(address);
+	return appIter != mAppIds.end() ? appIter->second : 0;
+}
+
+void VirtualGattProfile::discoverServices(BluetoothResultCallback callback)
+{
+	complete(callback, BLUETOOTH_ERROR_NONE);
+}
+
+void VirtualGattProfile::discoverServices(const std::string &address, BluetoothResultCallback callback)
+{
+	if (!findConnectedDevice(address))
+	{
+		complete(callback, BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE);
+		return;
+	}
+
+	VirtualDeferredCall::schedule(mConfig.serviceDiscoveryDelay, [this, address, callback]() {
+		// The device may have gone away while "discovering"
+		VirtualDevice *device = findConnectedDevice(address);
+		if (!device)
+		{
+			callback(BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE);
+			return;
+		}
+
+		if (!isDiscovered(address))
+			mDiscovered.push_back(address);
+
+		if (getGattObserver())
+		{
+			for (auto service : device->getServices())
+				getGattObserver()->serviceFound(address, service);
+		}
+
+		callback(BLUETOOTH_ERROR_NONE);
+	});
+}
+
+BluetoothGattServiceList VirtualGattProfile::getServices(const std::string &address)
+{
+	VirtualDevice *device = findConnectedDevice(address);
+	if (!device || !isDiscovered(address))
+		return BluetoothGattServiceList();
+
+	return device->getServices();
+}
+
+BluetoothGattService VirtualGattProfile::getService(const std::string &address, const BluetoothUuid &service)
+{
+	for (auto gattService : getServices(address))
+	{
+		if (gattService.getUuid() == service)
+			return gattService;
+	}
+
+	return BluetoothGattService();
+}
+
+void VirtualGattProfile::readCharacteristicByUuid(const std::string &address, const BluetoothUuid &service,
+                                                  const BluetoothUuid &characteristic, BluetoothGattReadCharacteristicCallback callback)
+{
+	VirtualDevice *device = findConnectedDevice(address);
+	BluetoothGattCharacteristic result;
+	BluetoothUuid serviceUuid;
+	BluetoothError error = BLUETOOTH_ERROR_NONE;
+
+	if (!device)
+		error = BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE;
+	else if (!device->findCharacteristic(service, characteristic, result, serviceUuid))
+		error = BLUETOOTH_ERROR_PARAM_INVALID;
+
+	VirtualDeferredCall::schedule(0, [callback, error, result]() {
+		callback(error, result);
+	});
+}
+
+void VirtualGattProfile::readCharacteristicByHandle(const std::string &address, uint16_t handle, BluetoothGattReadCharacteristicCallback callback)
+{
+	VirtualDevice *device = findConnectedDevice(address);
+	BluetoothGattCharacteristic result;
+	BluetoothUuid serviceUuid;
+	BluetoothError error = BLUETOOTH_ERROR_NONE;
+
+	if (!device)
+		error = BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE;
+	else if (!device->findCharacteristic(handle, result, serviceUuid))
+		error = BLUETOOTH_ERROR_PARAM_INVALID;
+
+	VirtualDeferredCall::schedule(0, [callback, error, result]() {
+		callback(error, result);
+	});
+}
+
+void VirtualGattProfile::readCharacteristic(uint16_t connectId, const BluetoothUuid &service, const BluetoothUuid &characteristic,
+                                            BluetoothGattReadCharacteristicCallback callback)
+{
+	readCharacteristicByUuid(findAddress(connectId), service, characteristic, callback);
+}
+
+void VirtualGattProfile::readCharacteristic(uint16_t connectId, const uint16_t &characteristicHandle, BluetoothGattReadCharacteristicCallback callback)
+{
+	readCharacteristicByHandle(findAddress(connectId), characteristicHandle, callback);
+}
+
+void VirtualGattProfile::readCharacteristic(const std::string &address, const BluetoothUuid &service, const BluetoothUuid &characteristic,
+                                            BluetoothGattReadCharacteristicCallback callback)
+{
+	readCharacteristicByUuid(address, service, characteristic, callback);
+}
+
+void VirtualGattProfile::readCharacteristic(const std::string &address, const uint16_t &characteristicHandle, BluetoothGattReadCharacteristicCallback callback)
+{
+	readCharacteristicByHandle(address, characteristicHandle, callback);
+}
+
+void VirtualGattProfile::readCharacteristics(uint16_t connectId, const BluetoothUuid &service, const BluetoothUuidList &characteristics,
+                                             BluetoothGattReadCharacteristicsCallback callback)
+{
+	readCharacteristics(findAddress(connectId), service, characteristics, callback);
+}
+
+void VirtualGattProfile::readCharacteristics(const std::string &address, const BluetoothUuid &service, const BluetoothUuidList &characteristics,
+                                             BluetoothGattReadCharacteristicsCallback callback)
+{
+	VirtualDevice *device = findConnectedDevice(address);
+	BluetoothGattCharacteristicList results;
+	BluetoothError error = device ? BLUETOOTH_ERROR_NONE : BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE;
+
+	for (auto characteristic : characteristics)
+	{
+		if (error != BLUETOOTH_ERROR_NONE)
+			break;
+
+		BluetoothGattCharacteristic result;
+		BluetoothUuid serviceUuid;
+		if (!device->findCharacteristic(service, characteristic, result, serviceUuid))
+			error = BLUETOOTH_ERROR_PARAM_INVALID;
+		else
+			results.push_back(result);
+	}
+
+	VirtualDeferredCall::schedule(0, [callback, error, results]() {
+		callback(error, results);
+	});
+}
+
+void VirtualGattProfile::writeCharacteristicValue(const std::string &address, const BluetoothGattCharacteristic &characteristic,
+                                                  BluetoothResultCallback callback)
+{
+	VirtualDevice *device = findConnectedDevice(address);
+	if (!device)
+	{
+		complete(callback, BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE);
+		return;
+	}
+
+	complete(callback, device->updateCharacteristicValue(characteristic.getHandle(), characteristic.getValue()) ?
+	         BLUETOOTH_ERROR_NONE : BLUETOOTH_ERROR_PARAM_INVALID);
+}
+
+void VirtualGattProfile::writeCharacteristic(uint16_t connectId, const BluetoothUuid &service, const BluetoothGattCharacteristic &characteristic,
+                                             BluetoothResultCallback callback)
+{
+	writeCharacteristic(findAddress(connectId), service, characteristic, callback);
+}
+
+void VirtualGattProfile::writeCharacteristic(uint16_t connectId, const BluetoothGattCharacteristic &characteristic, BluetoothResultCallback callback)
+{
+	writeCharacteristicValue(findAddress(connectId), characteristic, callback);
+}
+
+void VirtualGattProfile::writeCharacteristic(const std::string &address, const BluetoothUuid &service, const BluetoothGattCharacteristic &characteristic,
+                                             BluetoothResultCallback callback)
+{
+	// Callers may only know the uuid of the characteristic
+	VirtualDevice *device = findConnectedDevice(address);
+	BluetoothGattCharacteristic stored;
+	BluetoothUuid serviceUuid;
+	if (device && device->findCharacteristic(service, characteristic.getUuid(), stored, serviceUuid))
+	{
+		stored.setValue(characteristic.getValue());
+		writeCharacteristicValue(address, stored, callback);
+		return;
+	}
+
+	writeCharacteristicValue(address, characteristic, callback);
+}
+
+void VirtualGattProfile::writeCharacteristic(const std::string &address, const BluetoothGattCharacteristic &characteristic, BluetoothResultCallback callback)
+{
+	writeCharacteristicValue(address, characteristic, callback);
+}
+
+void VirtualGattProfile::readDescriptorByHandle(const std::string &address, uint16_t handle, BluetoothGattReadDescriptorCallback callback)
+{
+	VirtualDevice *device = findConnectedDevice(address);
+	BluetoothGattDescriptor result;
+	uint16_t characteristicHandle = 0;
+	BluetoothError error = BLUETOOTH_ERROR_NONE;
+
+	if (!device)
+		error = BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE;
+	else if (!device->findDescriptor(handle, result, characteristicHandle))
+		error = BLUETOOTH_ERROR_PARAM_INVALID;
+
+	VirtualDeferredCall::schedule(0, [callback, error, result]() {
+		callback(error, result);
+	});
+}
+
+void VirtualGattProfile::readDescriptorByUuid(const std::string &address, const BluetoothUuid &service, const BluetoothUuid &characteristic,
+                                              const BluetoothUuid &descriptor, BluetoothGattReadDescriptorCallback callback)
+{
+	VirtualDevice *device = findConnectedDevice(address);
+	BluetoothGattCharacteristic stored;
+	BluetoothUuid serviceUuid;
+	BluetoothGattDescriptor result;
+	BluetoothError error = BLUETOOTH_ERROR_NONE;
+
+	if (!device)
+		error = BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE;
+	else if (!device->findCharacteristic(service, characteristic, stored, serviceUuid) || !stored.isDescriptorAvailable(descriptor))
+		error = BLUETOOTH_ERROR_PARAM_INVALID;
+	else
+		result = stored.getDescriptor(descriptor);
+
+	VirtualDeferredCall::schedule(0, [callback, error, result]() {
+		callback(error, result);
+	});
+}
+
+void VirtualGattProfile::readDescriptor(uint16_t connectId, const BluetoothUuid &service, const BluetoothUuid &characteristic,
+                                        const BluetoothUuid &descriptor, BluetoothGattReadDescriptorCallback callback)
+{
+	readDescriptorByUuid(findAddress(connectId), service, characteristic, descriptor, callback);
+}
+
+void VirtualGattProfile::readDescriptor(uint16_t connectId, const uint16_t &descriptorHandle, BluetoothGattReadDescriptorCallback callback)
+{
+	readDescriptorByHandle(findAddress(connectId), descriptorHandle, callback);
+}
+
+void VirtualGattProfile::readDescriptor(const std::string &address, const BluetoothUuid &service, const BluetoothUuid &characteristic,
+                                        const BluetoothUuid &descriptor, BluetoothGattReadDescriptorCallback callback)
+{
+	readDescriptorByUuid(address, service, characteristic, descriptor, callback);
+}
+
+void VirtualGattProfile::readDescriptor(const std::string &address, const uint16_t &descriptorHandle, BluetoothGattReadDescriptorCallback callback)
+{
+	readDescriptorByHandle(address, descriptorHandle, callback);
+}
+
+void VirtualGattProfile::readDescriptors(uint16_t connectId, const BluetoothUuid &service, const BluetoothUuid &characteristic,
+                                         const BluetoothUuidList &descriptors, BluetoothGattReadDescriptorsCallback callback)
+{
+	readDescriptors(findAddress(connectId), service, characteristic, descriptors, callback);
+}
+
+void VirtualGattProfile::readDescriptors(const std::string &address, const BluetoothUuid &service, const BluetoothUuid &characteristic,
+                                         const BluetoothUuidList &descriptors, BluetoothGattReadDescriptorsCallback callback)
+{
+	VirtualDevice *device = findConnectedDevice(address);
+	BluetoothGattCharacteristic stored;
+	BluetoothUuid serviceUuid;
+	BluetoothGattDescriptorList results;
+	BluetoothError error = BLUETOOTH_ERROR_NONE;
+
+	if (!device)
+		error = BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE;
+	else if (!device->findCharacteristic(service, characteristic, stored, serviceUuid))
+		error = BLUETOOTH_ERROR_PARAM_INVALID;
+
+	for (auto descriptor : descriptors)
+	{
+		if (error != BLUETOOTH_ERROR_NONE)
+			break;
+
+		if (!stored.isDescriptorAvailable(descriptor))
+			error = BLUETOOTH_ERROR_PARAM_INVALID;
+		else
+			results.push_back(stored.getDescriptor(descriptor));
+	}
+
+	VirtualDeferredCall::schedule(0, [callback, error, results]() {
+		callback(error, results);
+	});
+}
+
+void VirtualGattProfile::writeDescriptorValue(const std::string &address, const BluetoothGattDescriptor &descriptor, BluetoothResultCallback callback)
+{
+	VirtualDevice *device = findConnectedDevice(address);
+	BluetoothGattDescriptor stored;
+	uint16_t characteristicHandle = 0;
+
+	if (!device)
+	{
+		complete(callback, BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE);
+		return;
+	}
+
+	if (!device->findDescriptor(descriptor.getHandle(), stored, characteristicHandle))
+	{
+		complete(callback, BLUETOOTH_ERROR_PARAM_INVALID);
+		return;
+	}
+
+	device->updateDescriptorValue(descriptor.getHandle(), descriptor.getValue());
+
+	// Writing the client configuration is how notifications get enabled
+	if (stored.getUuid() == BluetoothUuid(VIRTUAL_CLIENT_CONFIGURATION_UUID))
+	{
+		BluetoothGattValue value = descriptor.getValue();
+		BluetoothGattCharacteristic characteristic;
+		BluetoothUuid serviceUuid;
+		device->findCharacteristic(characteristicHandle, characteristic, serviceUuid);
+		changeWatch(address, serviceUuid, characteristicHandle, !value.empty() && (value[0] & 0x03));
+	}
+
+	complete(callback, BLUETOOTH_ERROR_NONE);
+}
+
+void VirtualGattProfile::writeDescriptor(uint16_t connectId, const BluetoothUuid &service, const BluetoothUuid &characteristic,
+                                         const BluetoothGattDescriptor &descriptor, BluetoothResultCallback callback)
+{
+	writeDescriptor(findAddress(connectId), service, characteristic, descriptor, callback);
+}
+
+void VirtualGattProfile::writeDescriptor(uint16_t connectId, const BluetoothGattDescriptor &descriptor, BluetoothResultCallback callback)
+{
+	writeDescriptorValue(findAddress(connectId), descriptor, callback);
+}
+
+void VirtualGattProfile::writeDescriptor(const std::string &address, const BluetoothUuid &service, const BluetoothUuid &characteristic,
+                                         const BluetoothGattDescriptor &descriptor, BluetoothResultCallback callback)
+{
+	VirtualDevice *device = findConnectedDevice(address);
+	BluetoothGattCharacteristic stored;
+	BluetoothUuid serviceUuid;
+	if (device && device->findCharacteristic(service, characteristic, stored, serviceUuid) &&
+	    stored.isDescriptorAvailable(descriptor.getUuid()))
+	{
+		BluetoothGattDescriptor target = stored.getDescriptor(descriptor.getUuid());
+		target.setValue(descriptor.getValue());
+		writeDescriptorValue(address, target, callback);
+		return;
+	}
+
+	writeDescriptorValue(address, descriptor, callback);
+}
+
+void VirtualGattProfile::writeDescriptor(const std::string &address, const BluetoothGattDescriptor &descriptor, BluetoothResultCallback callback)
+{
+	writeDescriptorValue(address, descriptor, callback);
+}
+
+BluetoothError VirtualGattProfile::changeWatch(const std::string &address, const BluetoothUuid &service, uint16_t handle, bool enabled)
+{
+	auto watchIter = std::find_if(mWatches.begin(), mWatches.end(), [&address, handle](const Watch &watch) {
+		return watch.address == address && watch.handle == handle;
+	});
+
+	if (enabled && watchIter == mWatches.end())
+	{
+		Watch watch;
+		watch.address = address;
+		watch.service = service;
+		watch.handle = handle;
+		mWatches.push_back(watch);
+	}
+	else if (!enabled && watchIter != mWatches.end())
+	{
+		mWatches.erase(watchIter);
+	}
+
+	updateNotifyTimer();
+
+	return BLUETOOTH_ERROR_NONE;
+}
+
+void VirtualGattProfile::changeCharacteristicWatchStatus(const std::string &address, const BluetoothUuid &service, const BluetoothUuid &characteristic,
+                                                         bool enabled, BluetoothResultCallback callback)
+{
+	VirtualDevice *device = findConnectedDevice(address);
+	BluetoothGattCharacteristic stored;
+	BluetoothUuid serviceUuid;
+
+	if (!device || !device->findCharacteristic(service, characteristic, stored, serviceUuid))
+	{
+		complete(callback, device ? BLUETOOTH_ERROR_PARAM_INVALID : BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE);
+		return;
+	}
+
+	complete(callback, changeWatch(address, serviceUuid, stored.getHandle(), enabled));
+}
+
+void VirtualGattProfile::changeCharacteristicWatchStatus(const std::string &address, const uint16_t &characteristicHandle, bool enabled,
+                                                         BluetoothResultCallback callback)
+{
+	VirtualDevice *device = findConnectedDevice(address);
+	BluetoothGattCharacteristic stored;
+	BluetoothUuid serviceUuid;
+
+	if (!device || !device->findCharacteristic(characteristicHandle, stored, serviceUuid))
+	{
+		complete(callback, device ? BLUETOOTH_ERROR_PARAM_INVALID : BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE);
+		return;
+	}
+
+	complete(callback, changeWatch(address, serviceUuid, characteristicHandle, enabled));
+}
+
+void VirtualGattProfile::changeCharacteristicWatchStatus(const std::string &address, uint16_t appId, const BluetoothUuid &service,
+                                                         const BluetoothUuid &characteristic, bool enabled, BluetoothResultCallback callback)
+{
+	changeCharacteristicWatchStatus(address, service, characteristic, enabled, callback);
+}
+
+void VirtualGattProfile::changeCharacteristicWatchStatus(const std::string &address, uint16_t appId, const uint16_t &characteristicHandle,
+                                                         bool enabled, BluetoothResultCallback callback)
+{
+	changeCharacteristicWatchStatus(address, characteristicHandle, enabled, callback);
+}
+
+void VirtualGattProfile::updateNotifyTimer()
+{
+	if (mWatches.empty() || mConfig.notifyInterval == 0)
+	{
+		if (mNotifyTimer)
+		{
+			g_source_remove(mNotifyTimer);
+			mNotifyTimer = 0;
+		}
+		return;
+	}
+
+	if (!mNotifyTimer)
+		mNotifyTimer = g_timeout_add(mConfig.notifyInterval, &VirtualGattProfile::handleNotifyTimeout, this);
+}
+
+gboolean VirtualGattProfile::handleNotifyTimeout(gpointer userData)
+{
+	VirtualGattProfile *profile = static_cast<VirtualGattProfile*>(userData);
+
+	// Copy, observers may change the watches while being notified
+	std::vector<Watch> watches = profile->mWatches;
+	for (auto watch : watches)
+	{
+		VirtualDevice *device = profile->findConnectedDevice(watch.address);
+		if (!device)
+			continue;
+
+		// A running counter at the start lets consumers spot lost notifications
+		uint32_t counter = profile->mNotificationCounter++;
+		BluetoothGattValue value(std::max(profile->mConfig.notifyValueSize, 4u), 0);
+		for (size_t i = 0; i < value.size(); i++)
+			value[i] = (i < 4) ? (counter >> (8 * i)) & 0xff : (uint8_t) i;
+
+		device->updateCharacteristicValue(watch.handle, value);
+
+		BluetoothGattCharacteristic characteristic;
+		BluetoothUuid serviceUuid;
+		if (!device->findCharacteristic(watch.handle, characteristic, serviceUuid))
+			continue;
+
+		profile->mSentNotificationCount++;
+		if (profile->getGattObserver())
+			profile->getGattObserver()->characteristicValueChanged(watch.address, serviceUuid, characteristic);
+	}
+
+	return TRUE;
+}
+
+void VirtualGattProfile::addService(uint16_t appId, const BluetoothGattService &service, BluetoothGattAddCallback callback)
+{
+	uint16_t serviceId = mNextLocalHandle++;
+	VirtualDeferredCall::schedule(0, [callback, serviceId]() {
+		callback(BLUETOOTH_ERROR_NONE, serviceId);
+	});
+}
+
+void VirtualGattProfile::addService(const BluetoothGattService &service, BluetoothResultCallback callback)
+{
+	complete(callback, BLUETOOTH_ERROR_NONE);
+}
+
+void VirtualGattProfile::removeService(uint16_t appId, uint16_t serviceId, BluetoothResultCallback callback)
+{
+	complete(callback, BLUETOOTH_ERROR_NONE);
+}
+
+void VirtualGattProfile::removeService(const BluetoothUuid &service, BluetoothResultCallback callback)
+{
+	complete(callback, BLUETOOTH_ERROR_NONE);
+}
+
+void VirtualGattProfile::addCharacteristic(uint16_t appId, uint16_t serviceId, const BluetoothGattCharacteristic &characteristic,
+                                           BluetoothGattAddCallback callback)
+{
+	uint16_t handle = mNextLocalHandle++;
+	VirtualDeferredCall::schedule(0, [callback, handle]() {
+		callback(BLUETOOTH_ERROR_NONE, handle);
+	});
+}
+
+void VirtualGattProfile::addDescriptor(uint16_t appId, uint16_t serviceId, const BluetoothGattDescriptor &descriptor,
+                                       BluetoothGattAddCallback callback)
+{
+	uint16_t handle = mNextLocalHandle++;
+	VirtualDeferredCall::schedule(0, [callback, handle]() {
+		callback(BLUETOOTH_ERROR_NONE, handle);
+	});
+}
+
+void VirtualGattProfile::startService(uint16_t appId, uint16_t serviceId, BluetoothGattTransportMode mode, BluetoothResultCallback callback)
+{
+	complete(callback, BLUETOOTH_ERROR_NONE);
+}
+
+void VirtualGattProfile::notifyCharacteristicValueChanged(uint16_t serviceId, const BluetoothGattCharacteristic &characteristic,
+                                                          uint16_t characteristicId)
+{
+	// No simulated central subscribes to local characteristics
+	mSentNotificationCount++;
+}
+
+void VirtualGattProfile::notifyCharacteristicValueChanged(uint16_t appId, uint16_t serviceId, const BluetoothGattCharacteristic &characteristic,
+                                                          uint16_t characteristicId)
+{
+	mSentNotificationCount++;
+}
+
+void VirtualGattProfile::characteristicValueReadResponse(uint32_t requestId, BluetoothError error, const BluetoothGattValue &value)
+{
+}
+
+void VirtualGattProfile::characteristicValueWriteResponse(uint32_t requestId, BluetoothError error, const BluetoothGattValue &value)
+{
+}
+
+void VirtualGattProfile::replay(const BluetoothSilTraceRecord &record)
+{
+	if (!getGattObserver())
+		return;
+
+	// Replayed connections and services are only reported, the simulated
+	// devices keep their own state and database
+	switch (record.event)
+	{
+	case BLUETOOTH_SIL_TRACE_EVENT_GATT_CONNECTION_STATE_CHANGED:
+		getGattObserver()->connectionStateChanged(record.address, record.state);
+		break;
+	case BLUETOOTH_SIL_TRACE_EVENT_GATT_SERVICE_FOUND:
+		getGattObserver()->serviceFound(record.address, record.service);
+		break;
+	case BLUETOOTH_SIL_TRACE_EVENT_GATT_SERVICE_LOST:
+		getGattObserver()->serviceLost(record.address, record.service);
+		break;
+	default:
+	{
+		BluetoothGattCharacteristic characteristic(BluetoothUuid(record.characteristicUuid));
+		characteristic.setHandle(record.handle);
+		characteristic.setValue(record.data);
+
+		getGattObserver()->characteristicValueChanged(record.address, BluetoothUuid(record.uuid), characteristic);
+		break;
+	}
+	}
+}
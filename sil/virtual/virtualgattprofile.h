@@ -0,0 +1,149 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef VIRTUALGATTPROFILE_H
+#define VIRTUALGATTPROFILE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <glib.h>
+#include <bluetooth-sil-api.h>
+#include <bluetoothsiltrace.h>
+
+#include "virtualcontrollerconfig.h"
+
+class VirtualAdapter;
+class VirtualDevice;
+
+/*
+ * GATT client and server of the virtual controller. Remote databases come
+ * from the simulated devices; every characteristic with notifications
+ * enabled gets a new value each notify interval. Local services are only
+ * bookkept so the service can register them.
+ */
+class VirtualGattProfile : public BluetoothProfile, public BluetoothGattProfile
+{
+public:
+	VirtualGattProfile(VirtualAdapter *adapter, const VirtualControllerConfig &config);
+	VirtualGattProfile(const VirtualGattProfile &other) = delete;
+	~VirtualGattProfile();
+
+	void getProperties(const std::string &address, BluetoothPropertiesResultCallback callback);
+	void getProperty(const std::string &address, BluetoothProperty::Type type, BluetoothPropertyResultCallback callback);
+	void connect(const std::string &address, BluetoothResultCallback callback);
+	void disconnect(const std::string &address, BluetoothResultCallback callback);
+
+	uint16_t addApplication(const BluetoothUuid &appUuid, ApplicationType type);
+	bool removeApplication(uint16_t appId, ApplicationType type);
+	void connectGatt(uint16_t appId, bool autoConnection, const std::string &address, BluetoothConnectCallback callback);
+	void disconnectGatt(uint16_t appId, uint16_t connectId, const std::string &address, BluetoothResultCallback callback);
+	uint16_t getConnectId(const std::string &address);
+	uint16_t getAppId(const std::string &address);
+
+	void discoverServices(BluetoothResultCallback callback);
+	void discoverServices(const std::string &address, BluetoothResultCallback callback);
+	BluetoothGattServiceList getServices(const std::string &address);
+	BluetoothGattService getService(const std::string &address, const BluetoothUuid &service);
+
+	void readCharacteristic(uint16_t connectId, const BluetoothUuid &service, const BluetoothUuid &characteristic, BluetoothGattReadCharacteristicCallback callback);
+	void readCharacteristic(uint16_t connectId, const uint16_t &characteristicHandle, BluetoothGattReadCharacteristicCallback callback);
+	void readCharacteristic(const std::string &address, const BluetoothUuid &service, const BluetoothUuid &characteristic, BluetoothGattReadCharacteristicCallback callback);
+	void readCharacteristic(const std::string &address, const uint16_t &characteristicHandle, BluetoothGattReadCharacteristicCallback callback);
+	void readCharacteristics(uint16_t connectId, const BluetoothUuid &service, const BluetoothUuidList &characteristics, BluetoothGattReadCharacteristicsCallback callback);
+	void readCharacteristics(const std::string &address, const BluetoothUuid &service, const BluetoothUuidList &characteristics, BluetoothGattReadCharacteristicsCallback callback);
+
+	void writeCharacteristic(uint16_t connectId, const BluetoothUuid &service, const BluetoothGattCharacteristic &characteristic, BluetoothResultCallback callback);
+	void writeCharacteristic(uint16_t connectId, const BluetoothGattCharacteristic &characteristic, BluetoothResultCallback callback);
+	void writeCharacteristic(const std::string &address, const BluetoothUuid &service, const BluetoothGattCharacteristic &characteristic, BluetoothResultCallback callback);
+	void writeCharacteristic(const std::string &address, const BluetoothGattCharacteristic &characteristic, BluetoothResultCallback callback);
+
+	void readDescriptor(uint16_t connectId, const BluetoothUuid &service, const BluetoothUuid &characteristic, const BluetoothUuid &descriptor, BluetoothGattReadDescriptorCallback callback);
+	void readDescriptor(uint16_t connectId, const uint16_t &descriptorHandle, BluetoothGattReadDescriptorCallback callback);
+	void readDescriptor(const std::string &address, const BluetoothUuid &service, const BluetoothUuid &characteristic, const BluetoothUuid &descriptor, BluetoothGattReadDescriptorCallback callback);
+	void readDescriptor(const std::string &address, const uint16_t &descriptorHandle, BluetoothGattReadDescriptorCallback callback);
+	void readDescriptors(uint16_t connectId, const BluetoothUuid &service, const BluetoothUuid &characteristic, const BluetoothUuidList &descriptors, BluetoothGattReadDescriptorsCallback callback);
+	void readDescriptors(const std::string &address, const BluetoothUuid &service, const BluetoothUuid &characteristic, const BluetoothUuidList &descriptors, BluetoothGattReadDescriptorsCallback callback);
+
+	void writeDescriptor(uint16_t connectId, const BluetoothUuid &service, const BluetoothUuid &characteristic, const BluetoothGattDescriptor &descriptor, BluetoothResultCallback callback);
+	void writeDescriptor(uint16_t connectId, const BluetoothGattDescriptor &descriptor, BluetoothResultCallback callback);
+	void writeDescriptor(const std::string &address, const BluetoothUuid &service, const BluetoothUuid &characteristic, const BluetoothGattDescriptor &descriptor, BluetoothResultCallback callback);
+	void writeDescriptor(const std::string &address, const BluetoothGattDescriptor &descriptor, BluetoothResultCallback callback);
+
+	void changeCharacteristicWatchStatus(const std::string &address, const BluetoothUuid &service, const BluetoothUuid &characteristic, bool enabled, BluetoothResultCallback callback);
+	void changeCharacteristicWatchStatus(const std::string &address, const uint16_t &characteristicHandle, bool enabled, BluetoothResultCallback callback);
+	void changeCharacteristicWatchStatus(const std::string &address, uint16_t appId, const BluetoothUuid &service, const BluetoothUuid &characteristic, bool enabled, BluetoothResultCallback callback);
+	void changeCharacteristicWatchStatus(const std::string &address, uint16_t appId, const uint16_t &characteristicHandle, bool enabled, BluetoothResultCallback callback);
+
+	void addService(uint16_t appId, const BluetoothGattService &service, BluetoothGattAddCallback callback);
+	void addService(const BluetoothGattService &service, BluetoothResultCallback callback);
+	void removeService(uint16_t appId, uint16_t serviceId, BluetoothResultCallback callback);
+	void removeService(const BluetoothUuid &service, BluetoothResultCallback callback);
+	void addCharacteristic(uint16_t appId, uint16_t serviceId, const BluetoothGattCharacteristic &characteristic, BluetoothGattAddCallback callback);
+	void addDescriptor(uint16_t appId, uint16_t serviceId, const BluetoothGattDescriptor &descriptor, BluetoothGattAddCallback callback);
+	void startService(uint16_t appId, uint16_t serviceId, BluetoothGattTransportMode mode, BluetoothResultCallback callback);
+	void notifyCharacteristicValueChanged(uint16_t serviceId, const BluetoothGattCharacteristic &characteristic, uint16_t characteristicId);
+	void notifyCharacteristicValueChanged(uint16_t appId, uint16_t serviceId, const BluetoothGattCharacteristic &characteristic, uint16_t characteristicId);
+	void characteristicValueReadResponse(uint32_t requestId, BluetoothError error, const BluetoothGattValue &value);
+	void characteristicValueWriteResponse(uint32_t requestId, BluetoothError error, const BluetoothGattValue &value);
+
+	void replay(const BluetoothSilTraceRecord &record);
+
+	unsigned int getSentNotificationCount() const { return mSentNotificationCount; }
+
+private:
+	class Watch
+	{
+	public:
+		std::string address;
+		BluetoothUuid service;
+		uint16_t handle;
+	};
+
+	VirtualAdapter *mAdapter;
+	VirtualControllerConfig mConfig;
+	std::unordered_map<std::string, uint16_t> mConnectIds;
+	std::unordered_map<std::string, uint16_t> mAppIds;
+	std::vector<std::string> mDiscovered;
+	std::vector<Watch> mWatches;
+	uint16_t mNextAppId;
+	uint16_t mNextConnectId;
+	uint16_t mNextLocalHandle;
+	uint32_t mNotificationCounter;
+	unsigned int mSentNotificationCount;
+	guint mNotifyTimer;
+
+	VirtualDevice* findConnectedDevice(const std::string &address);
+	std::string findAddress(uint16_t connectId) const;
+	bool isDiscovered(const std::string &address) const;
+	void setConnected(VirtualDevice *device, bool connected);
+
+	void readCharacteristicByUuid(const std::string &address, const BluetoothUuid &service, const BluetoothUuid &characteristic, BluetoothGattReadCharacteristicCallback callback);
+	void readCharacteristicByHandle(const std::string &address, uint16_t handle, BluetoothGattReadCharacteristicCallback callback);
+	void writeCharacteristicValue(const std::string &address, const BluetoothGattCharacteristic &characteristic, BluetoothResultCallback callback);
+	void readDescriptorByHandle(const std::string &address, uint16_t handle, BluetoothGattReadDescriptorCallback callback);
+	void readDescriptorByUuid(const std::string &address, const BluetoothUuid &service, const BluetoothUuid &characteristic, const BluetoothUuid &descriptor, BluetoothGattReadDescriptorCallback callback);
+	void writeDescriptorValue(const std::string &address, const BluetoothGattDescriptor &descriptor, BluetoothResultCallback callback);
+	BluetoothError changeWatch(const std::string &address, const BluetoothUuid &service, uint16_t handle, bool enabled);
+	void updateNotifyTimer();
+
+	static void complete(BluetoothResultCallback callback, BluetoothError error);
+	static gboolean handleNotifyTimeout(gpointer userData);
+};
+
+#endif // VIRTUALGATTPROFILE_H
@@ -0,0 +1,51 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <stdlib.h>
+
+#include "virtualsil.h"
+#include "virtualadapter.h"
+
+VirtualSIL::VirtualSIL(const VirtualControllerConfig &config) :
+	mAdapter(new VirtualAdapter(config))
+{
+}
+
+VirtualSIL::~VirtualSIL()
+{
+	delete mAdapter;
+}
+
+BluetoothAdapter* VirtualSIL::getDefaultAdapter()
+{
+	return mAdapter;
+}
+
+extern "C" BluetoothSIL* createBluetoothSIL(unsigned int version, BluetoothPairingIOCapability capability)
+{
+	if (version != BLUETOOTH_SIL_API_VERSION)
+		return 0;
+
+	VirtualControllerConfig config;
+
+	const char *configPath = getenv("WEBOS_BLUETOOTH_VIRTUAL_SIL_CONFIG");
+	if (configPath)
+		config.load(configPath);
+
+	return new VirtualSIL(config);
+}
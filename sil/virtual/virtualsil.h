@@ -0,0 +1,46 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef VIRTUALSIL_H
+#define VIRTUALSIL_H
+
+#include <bluetooth-sil-api.h>
+
+#include "virtualcontrollerconfig.h"
+
+class VirtualAdapter;
+
+/*
+ * SIL without any hardware behind it. It drives the service with a
+ * configurable population of simulated devices so the service can be
+ * profiled and load tested on any machine.
+ */
+class VirtualSIL : public BluetoothSIL
+{
+public:
+	VirtualSIL(const VirtualControllerConfig &config);
+	VirtualSIL(const VirtualSIL &other) = delete;
+	~VirtualSIL();
+
+	BluetoothAdapter* getDefaultAdapter();
+
+private:
+	VirtualAdapter *mAdapter;
+};
+
+#endif // VIRTUALSIL_H
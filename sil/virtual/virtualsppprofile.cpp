@@ -0,0 +1,332 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <algorithm>
+
+#include "virtualsppprofile.h"
+#include "virtualadapter.h"
+#include "virtualdevice.h"
+#include "virtualdeferredcall.h"
+
+// Period of the data stream towards connected channels
+#define VIRTUAL_SPP_STREAM_INTERVAL 10
+
+VirtualSppProfile::VirtualSppProfile(VirtualAdapter *adapter, const VirtualControllerConfig &config) :
+	mAdapter(adapter),
+	mConfig(config),
+	mNextChannelId(1),
+	mSentBytes(0),
+	mReceivedBytes(0),
+	mStreamTimer(0)
+{
+	mChunk.resize(mConfig.sppChunkSize > 0 ? mConfig.sppChunkSize : 1);
+	for (size_t i = 0; i < mChunk.size(); i++)
+		mChunk[i] = i & 0xff;
+}
+
+VirtualSppProfile::~VirtualSppProfile()
+{
+	if (mStreamTimer)
+		g_source_remove(mStreamTimer);
+}
+
+void VirtualSppProfile::getProperties(const std::string &address, BluetoothPropertiesResultCallback callback)
+{
+	BluetoothPropertiesList properties;
+	bool connected = false;
+
+	for (auto channelIter : mChannels)
+	{
+		if (channelIter.second.address == address)
+			connected = true;
+	}
+
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::CONNECTED, connected));
+
+	VirtualDeferredCall::schedule(0, [callback, properties]() {
+		callback(BLUETOOTH_ERROR_NONE, properties);
+	});
+}
+
+void VirtualSppProfile::getProperty(const std::string &address, BluetoothProperty::Type type, BluetoothPropertyResultCallback callback)
+{
+	getProperties(address, [type, callback](BluetoothError error, BluetoothPropertiesList properties) {
+		for (auto property : properties)
+		{
+			if (property.getType() == type)
+			{
+				callback(error, property);
+				return;
+			}
+		}
+
+		callback(error, BluetoothProperty(type));
+	});
+}
+
+void VirtualSppProfile::connect(const std::string &address, BluetoothResultCallback callback)
+{
+	// Channels are connected per uuid through connectUuid
+	VirtualDeferredCall::schedule(0, [callback]() {
+		callback(BLUETOOTH_ERROR_UNSUPPORTED);
+	});
+}
+
+void VirtualSppProfile::disconnect(const std::string &address, BluetoothResultCallback callback)
+{
+	std::vector<BluetoothSppChannelId> channelIds;
+	for (auto channelIter : mChannels)
+	{
+		if (channelIter.second.address == address)
+			channelIds.push_back(channelIter.first);
+	}
+
+	for (auto channelId : channelIds)
+		closeChannel(channelId);
+
+	VirtualDeferredCall::schedule(0, [callback]() {
+		callback(BLUETOOTH_ERROR_NONE);
+	});
+}
+
+bool VirtualSppProfile::findChannel(const std::string &address, const std::string &uuid, BluetoothSppChannelId &channelId) const
+{
+	for (auto channelIter : mChannels)
+	{
+		if (channelIter.second.address == address && channelIter.second.uuid == uuid)
+		{
+			channelId = channelIter.first;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void VirtualSppProfile::connectUuid(const std::string &address, const std::string &uuid,
+                                    std::function<void(BluetoothError, BluetoothSppChannelId)> callback)
+{
+	VirtualDevice *device = mAdapter->findDevice(address);
+	if (!device || device->getType() != BLUETOOTH_DEVICE_TYPE_BREDR)
+	{
+		VirtualDeferredCall::schedule(0, [callback]() {
+			callback(BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE, 0);
+		});
+		return;
+	}
+
+	VirtualDeferredCall::schedule(mConfig.serviceDiscoveryDelay, [this, device, uuid, callback]() {
+		std::string address = device->getAddress();
+
+		BluetoothSppChannelId channelId = 0;
+		if (findChannel(address, uuid, channelId))
+		{
+			callback(BLUETOOTH_ERROR_BUSY, channelId);
+			return;
+		}
+
+		channelId = mNextChannelId++;
+		mChannels[channelId].address = address;
+		mChannels[channelId].uuid = uuid;
+
+		mAdapter->setDeviceConnected(device, true);
+
+		if (getSppObserver())
+			getSppObserver()->channelStateChanged(address, uuid, channelId, true);
+
+		callback(BLUETOOTH_ERROR_NONE, channelId);
+
+		updateStreamTimer();
+	});
+}
+
+void VirtualSppProfile::closeChannel(BluetoothSppChannelId channelId)
+{
+	auto channelIter = mChannels.find(channelId);
+	if (channelIter == mChannels.end())
+		return;
+
+	Channel channel = channelIter->second;
+	mChannels.erase(channelIter);
+
+	bool stillConnected = false;
+	for (auto otherIter : mChannels)
+	{
+		if (otherIter.second.address == channel.address)
+		{
+			stillConnected = true;
+			break;
+		}
+	}
+
+	VirtualDevice *device = mAdapter->findDevice(channel.address);
+	if (device && !stillConnected)
+		mAdapter->setDeviceConnected(device, false);
+
+	if (getSppObserver())
+		getSppObserver()->channelStateChanged(channel.address, channel.uuid, channelId, false);
+
+	updateStreamTimer();
+}
+
+void VirtualSppProfile::disconnectUuid(const BluetoothSppChannelId channelId, BluetoothResultCallback callback)
+{
+	BluetoothError error = mChannels.find(channelId) != mChannels.end() ? BLUETOOTH_ERROR_NONE : BLUETOOTH_ERROR_PARAM_INVALID;
+
+	closeChannel(channelId);
+
+	VirtualDeferredCall::schedule(0, [callback, error]() {
+		callback(error);
+	});
+}
+
+void VirtualSppProfile::getChannelState(const std::string &address, const std::string &uuid, std::function<void(BluetoothError, bool)> callback)
+{
+	BluetoothSppChannelId channelId = 0;
+	bool connected = findChannel(address, uuid, channelId);
+
+	VirtualDeferredCall::schedule(0, [callback, connected]() {
+		callback(BLUETOOTH_ERROR_NONE, connected);
+	});
+}
+
+BluetoothError VirtualSppProfile::createChannel(const std::string &name, const std::string &uuid)
+{
+	for (auto serverUuid : mServerUuids)
+	{
+		if (serverUuid == uuid)
+			return BLUETOOTH_ERROR_PARAM_INVALID;
+	}
+
+	mServerUuids.push_back(uuid);
+
+	return BLUETOOTH_ERROR_NONE;
+}
+
+BluetoothError VirtualSppProfile::removeChannel(const std::string &uuid)
+{
+	for (auto serverIter = mServerUuids.begin(); serverIter != mServerUuids.end(); serverIter++)
+	{
+		if (*serverIter == uuid)
+		{
+			mServerUuids.erase(serverIter);
+			return BLUETOOTH_ERROR_NONE;
+		}
+	}
+
+	return BLUETOOTH_ERROR_PARAM_INVALID;
+}
+
+void VirtualSppProfile::writeData(const BluetoothSppChannelId channelId, const uint8_t *data, const uint32_t size, BluetoothResultCallback callback)
+{
+	BluetoothError error = BLUETOOTH_ERROR_NONE;
+
+	if (mChannels.find(channelId) == mChannels.end())
+		error = BLUETOOTH_ERROR_PARAM_INVALID;
+	else
+		mReceivedBytes += size;
+
+	VirtualDeferredCall::schedule(0, [callback, error]() {
+		callback(error);
+	});
+
+	if (error != BLUETOOTH_ERROR_NONE || !mConfig.sppLoopback)
+		return;
+
+	// Echo the data back on the same channel
+	std::vector<uint8_t> echo(data, data + size);
+	VirtualDeferredCall::schedule(0, [this, channelId, echo]() {
+		if (!getSppObserver() || mChannels.find(channelId) == mChannels.end())
+			return;
+
+		getSppObserver()->dataReceived(channelId, echo.data(), echo.size());
+		mSentBytes += echo.size();
+	});
+}
+
+void VirtualSppProfile::updateStreamTimer()
+{
+	if (mChannels.empty() || mConfig.sppRate == 0)
+	{
+		if (mStreamTimer)
+		{
+			g_source_remove(mStreamTimer);
+			mStreamTimer = 0;
+		}
+		return;
+	}
+
+	if (!mStreamTimer)
+		mStreamTimer = g_timeout_add(VIRTUAL_SPP_STREAM_INTERVAL, &VirtualSppProfile::handleStreamTimeout, this);
+}
+
+gboolean VirtualSppProfile::handleStreamTimeout(gpointer userData)
+{
+	VirtualSppProfile *profile = static_cast<VirtualSppProfile*>(userData);
+	if (!profile->getSppObserver())
+		return TRUE;
+
+	uint32_t budget = (uint64_t) profile->mConfig.sppRate * VIRTUAL_SPP_STREAM_INTERVAL / 1000;
+
+	// Copy, the observer may close channels while receiving data
+	std::vector<BluetoothSppChannelId> channelIds;
+	for (auto channelIter : profile->mChannels)
+		channelIds.push_back(channelIter.first);
+
+	for (auto channelId : channelIds)
+	{
+		uint32_t remaining = budget;
+		while (remaining > 0 && profile->mChannels.find(channelId) != profile->mChannels.end())
+		{
+			uint32_t size = std::min<uint32_t>(remaining, profile->mChunk.size());
+			profile->getSppObserver()->dataReceived(channelId, profile->mChunk.data(), size);
+			profile->mSentBytes += size;
+			remaining -= size;
+		}
+	}
+
+	return TRUE;
+}
+
+void VirtualSppProfile::replay(const BluetoothSilTraceRecord &record)
+{
+	if (!getSppObserver())
+		return;
+
+	if (record.event == BLUETOOTH_SIL_TRACE_EVENT_SPP_CHANNEL_STATE_CHANGED)
+	{
+		// Track replayed channels so the service can write to them
+		if (record.state)
+		{
+			Channel channel;
+			channel.address = record.address;
+			channel.uuid = record.uuid;
+			mChannels[record.id] = channel;
+		}
+		else
+		{
+			mChannels.erase(record.id);
+		}
+
+		getSppObserver()->channelStateChanged(record.address, record.uuid, record.id, record.state);
+		return;
+	}
+
+	getSppObserver()->dataReceived(record.id, record.data.data(), record.data.size());
+	mSentBytes += record.data.size();
+}
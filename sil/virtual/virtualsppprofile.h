@@ -0,0 +1,87 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef VIRTUALSPPPROFILE_H
+#define VIRTUALSPPPROFILE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <glib.h>
+#include <bluetooth-sil-api.h>
+#include <bluetoothsiltrace.h>
+
+#include "virtualcontrollerconfig.h"
+
+class VirtualAdapter;
+
+/*
+ * SPP of the virtual controller. Every connected channel receives data at
+ * the configured rate, split into chunks of the configured size, and all
+ * data written to a channel is swallowed and counted.
+ */
+class VirtualSppProfile : public BluetoothProfile, public BluetoothSppProfile
+{
+public:
+	VirtualSppProfile(VirtualAdapter *adapter, const VirtualControllerConfig &config);
+	VirtualSppProfile(const VirtualSppProfile &other) = delete;
+	~VirtualSppProfile();
+
+	void getProperties(const std::string &address, BluetoothPropertiesResultCallback callback);
+	void getProperty(const std::string &address, BluetoothProperty::Type type, BluetoothPropertyResultCallback callback);
+	void connect(const std::string &address, BluetoothResultCallback callback);
+	void disconnect(const std::string &address, BluetoothResultCallback callback);
+
+	void connectUuid(const std::string &address, const std::string &uuid, std::function<void(BluetoothError, BluetoothSppChannelId)> callback);
+	void disconnectUuid(const BluetoothSppChannelId channelId, BluetoothResultCallback callback);
+	void getChannelState(const std::string &address, const std::string &uuid, std::function<void(BluetoothError, bool)> callback);
+	BluetoothError createChannel(const std::string &name, const std::string &uuid);
+	BluetoothError removeChannel(const std::string &uuid);
+	void writeData(const BluetoothSppChannelId channelId, const uint8_t *data, const uint32_t size, BluetoothResultCallback callback);
+
+	void replay(const BluetoothSilTraceRecord &record);
+
+	uint64_t getSentBytes() const { return mSentBytes; }
+	uint64_t getReceivedBytes() const { return mReceivedBytes; }
+
+private:
+	class Channel
+	{
+	public:
+		std::string address;
+		std::string uuid;
+	};
+
+	VirtualAdapter *mAdapter;
+	VirtualControllerConfig mConfig;
+	std::unordered_map<BluetoothSppChannelId, Channel> mChannels;
+	std::vector<std::string> mServerUuids;
+	BluetoothSppChannelId mNextChannelId;
+	std::vector<uint8_t> mChunk;
+	uint64_t mSentBytes;
+	uint64_t mReceivedBytes;
+	guint mStreamTimer;
+
+	bool findChannel(const std::string &address, const std::string &uuid, BluetoothSppChannelId &channelId) const;
+	void closeChannel(BluetoothSppChannelId channelId);
+	void updateStreamTimer();
+
+	static gboolean handleStreamTimeout(gpointer userData);
+};
+
+#endif // VIRTUALSPPPROFILE_H
@@ -0,0 +1,134 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <bluetoothsiltracereader.h>
+
+#include "virtualtracereplay.h"
+#include "virtualadapter.h"
+
+// Records replayed per main loop iteration at speed 0
+#define VIRTUAL_TRACE_REPLAY_BATCH 256
+
+VirtualTraceReplay::VirtualTraceReplay(VirtualAdapter *adapter, const std::string &path, unsigned int speed) :
+	mAdapter(adapter),
+	mSpeed(speed),
+	mNextRecord(0),
+	mRunning(false),
+	mStartTime(0),
+	mTimer(0)
+{
+	BluetoothSilTraceReader reader;
+	if (!reader.open(path))
+	{
+		g_warning("Failed to open SIL trace %s", path.c_str());
+		return;
+	}
+
+	BluetoothSilTraceRecord record;
+	while (reader.read(record))
+		mRecords.push_back(record);
+
+	g_message("Loaded %zu records from SIL trace %s", mRecords.size(), path.c_str());
+}
+
+VirtualTraceReplay::~VirtualTraceReplay()
+{
+	stop();
+}
+
+void VirtualTraceReplay::start()
+{
+	stop();
+
+	if (mRecords.empty())
+		return;
+
+	mNextRecord = 0;
+	mStartTime = g_get_monotonic_time();
+	mRunning = true;
+	scheduleNext();
+}
+
+void VirtualTraceReplay::stop()
+{
+	mRunning = false;
+
+	if (!mTimer)
+		return;
+
+	g_source_remove(mTimer);
+	mTimer = 0;
+}
+
+void VirtualTraceReplay::scheduleNext()
+{
+	if (mNextRecord >= mRecords.size())
+	{
+		mRunning = false;
+		g_message("Replayed %zu records of the SIL trace", mRecords.size());
+		return;
+	}
+
+	if (mSpeed == 0)
+	{
+		mTimer = g_idle_add(&VirtualTraceReplay::handleTimeout, this);
+		return;
+	}
+
+	// Timestamps are relative to the first record of the trace
+	int64_t due = (mRecords[mNextRecord].timestamp - mRecords[0].timestamp) / mSpeed;
+	int64_t elapsed = g_get_monotonic_time() - mStartTime;
+	guint delay = due > elapsed ? (due - elapsed) / 1000 : 0;
+
+	mTimer = g_timeout_add(delay, &VirtualTraceReplay::handleTimeout, this);
+}
+
+gboolean VirtualTraceReplay::handleTimeout(gpointer userData)
+{
+	VirtualTraceReplay *replay = static_cast<VirtualTraceReplay*>(userData);
+	replay->mTimer = 0;
+
+	int64_t elapsed = g_get_monotonic_time() - replay->mStartTime;
+	unsigned int count = 0;
+
+	while (replay->mNextRecord < replay->mRecords.size())
+	{
+		const BluetoothSilTraceRecord &record = replay->mRecords[replay->mNextRecord];
+
+		if (replay->mSpeed == 0)
+		{
+			if (count++ >= VIRTUAL_TRACE_REPLAY_BATCH)
+				break;
+		}
+		else if ((int64_t) (record.timestamp - replay->mRecords[0].timestamp) / replay->mSpeed > elapsed)
+		{
+			break;
+		}
+
+		replay->mNextRecord++;
+		replay->mAdapter->replay(record);
+
+		// The observer may have powered the adapter off, or off and on again
+		if (!replay->mRunning || replay->mTimer)
+			return FALSE;
+	}
+
+	replay->scheduleNext();
+
+	return FALSE;
+}
@@ -0,0 +1,59 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef VIRTUALTRACEREPLAY_H
+#define VIRTUALTRACEREPLAY_H
+
+#include <string>
+#include <vector>
+#include <glib.h>
+
+#include <bluetoothsiltrace.h>
+
+class VirtualAdapter;
+
+/*
+ * Feeds the callbacks of a recorded SIL trace back into the service with
+ * their original spacing, divided by the configured speed. A speed of 0
+ * replays the trace as fast as the main loop allows.
+ */
+class VirtualTraceReplay
+{
+public:
+	VirtualTraceReplay(VirtualAdapter *adapter, const std::string &path, unsigned int speed);
+	VirtualTraceReplay(const VirtualTraceReplay &other) = delete;
+	~VirtualTraceReplay();
+
+	void start();
+	void stop();
+
+private:
+	VirtualAdapter *mAdapter;
+	unsigned int mSpeed;
+	std::vector<BluetoothSilTraceRecord> mRecords;
+	size_t mNextRecord;
+	bool mRunning;
+	int64_t mStartTime;
+	guint mTimer;
+
+	void scheduleNext();
+
+	static gboolean handleTimeout(gpointer userData);
+};
+
+#endif // VIRTUALTRACEREPLAY_H
@@ -30,9 +30,9 @@ BluetoothA2dpProfileService::BluetoothA2dpProfileService(BluetoothManagerService
         mAptxConfigurationInfo(0)
 {
 	LS_CREATE_CATEGORY_BEGIN(BluetoothProfileService, base)
-		LS_CATEGORY_METHOD(connect)
-		LS_CATEGORY_METHOD(disconnect)
-		LS_CATEGORY_METHOD(getStatus)
+		BT_CATEGORY_METHOD(connect)
+		BT_CATEGORY_METHOD(disconnect)
+		BT_CATEGORY_METHOD(getStatus)
 	LS_CREATE_CATEGORY_END
 
 	LS_CREATE_CATEGORY_BEGIN(BluetoothProfileService, internal)
@@ -41,8 +41,8 @@ BluetoothA2dpProfileService::BluetoothA2dpProfileService(BluetoothManagerService
 		LS_CATEGORY_CLASS_METHOD(BluetoothA2dpProfileService, getAudioPath)
 		LS_CATEGORY_CLASS_METHOD(BluetoothA2dpProfileService, setSbcEncoderBitpool)
 		LS_CATEGORY_CLASS_METHOD(BluetoothA2dpProfileService, getCodecConfiguration)
-		LS_CATEGORY_METHOD(enable)
-		LS_CATEGORY_METHOD(disable)
+		BT_CATEGORY_METHOD(enable)
+		BT_CATEGORY_METHOD(disable)
 	LS_CREATE_CATEGORY_END
 
 	manager->registerCategory("/a2dp", LS_CATEGORY_TABLE_NAME(base), NULL, NULL);
@@ -43,9 +43,9 @@ BluetoothAvrcpProfileService::BluetoothAvrcpProfileService(BluetoothManagerServi
 	 mMediaMetaData(0)
 {
 	LS_CREATE_CATEGORY_BEGIN(BluetoothProfileService, base)
-		LS_CATEGORY_METHOD(connect)
-		LS_CATEGORY_METHOD(disconnect)
-		LS_CATEGORY_METHOD(getStatus)
+		BT_CATEGORY_METHOD(connect)
+		BT_CATEGORY_METHOD(disconnect)
+		BT_CATEGORY_METHOD(getStatus)
 		LS_CATEGORY_CLASS_METHOD(BluetoothAvrcpProfileService, awaitMediaMetaDataRequest)
 		LS_CATEGORY_CLASS_METHOD(BluetoothAvrcpProfileService, supplyMediaMetaData)
 		LS_CATEGORY_CLASS_METHOD(BluetoothAvrcpProfileService, awaitMediaPlayStatusRequest)
@@ -61,8 +61,8 @@ BluetoothAvrcpProfileService::BluetoothAvrcpProfileService(BluetoothManagerServi
 	LS_CREATE_CATEGORY_END
 
 	LS_CREATE_CATEGORY_BEGIN(BluetoothProfileService, internal)
-		LS_CATEGORY_METHOD(enable)
-		LS_CATEGORY_METHOD(disable)
+		BT_CATEGORY_METHOD(enable)
+		BT_CATEGORY_METHOD(disable)
 		LS_CATEGORY_CLASS_METHOD(BluetoothAvrcpProfileService, getSupportedNotificationEvents)
 		LS_CATEGORY_CLASS_METHOD(BluetoothAvrcpProfileService, getRemoteFeatures)
 	LS_CREATE_CATEGORY_END
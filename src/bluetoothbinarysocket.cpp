@@ -15,21 +15,25 @@
 // SPDX-License-Identifier: Apache-2.0
 
 
+#include <errno.h>
+
 #include "bluetoothbinarysocket.h"
 #include "logging.h"
 
 BluetoothBinarySocket::BluetoothBinarySocket() :
 	mBufferSize(0),
-	mRetryData(NULL),
-	mRetryDataSize(0),
-	mRetryTimeout(0),
-	mRetryCount(0),
+	mPendingWriteOffset(0),
+	mPendingWriteSize(0),
+	mWriteWatch(0),
+	mDropWhenBehind(false),
 	mServerSocketFd(-1),
 	mClientSocketFd(-1),
 	mWriting(false),
 	mServerIoChannel(NULL),
-	mClientIoChannel(NULL)
+	mClientIoChannel(NULL),
+	mClientWatch(0)
 {
+	mSocketFileName[0] = '\0';
 }
 
 BluetoothBinarySocket::~BluetoothBinarySocket()
@@ -84,8 +88,46 @@ bool BluetoothBinarySocket::createBinarySocket(const std::string &name)
 	return true;
 }
 
+void BluetoothBinarySocket::setWriting(bool writing)
+{
+	if (mWriting == writing)
+		return;
+
+	mWriting = writing;
+
+	/*
+	 * Stop watching the client socket while the data read last is still
+	 * being written. Otherwise the watch keeps firing for the unread data
+	 * and spins the main loop until the write completes.
+	 */
+	if (NULL == mClientIoChannel)
+		return;
+
+	if (mWriting && mClientWatch)
+	{
+		g_source_remove(mClientWatch);
+		mClientWatch = 0;
+	}
+	else if (!mWriting && !mClientWatch)
+	{
+		addClientWatch();
+	}
+}
+
+void BluetoothBinarySocket::addClientWatch()
+{
+	mClientWatch = g_io_add_watch(mClientIoChannel, (GIOCondition)(G_IO_IN | G_IO_ERR | G_IO_HUP | G_IO_NVAL),
+					&getReceiveRequest, this);
+}
+
 void BluetoothBinarySocket::removeBinarySocket(void)
 {
+	if (mClientWatch)
+	{
+		g_source_remove(mClientWatch);
+		mClientWatch = 0;
+	}
+
 	if (NULL != mServerIoChannel)
 	{
 		g_io_channel_shutdown(mServerIoChannel, TRUE, NULL);
@@ -118,8 +160,7 @@ void BluetoothBinarySocket::removeBinarySocket(void)
 	if (access(mSocketFileName, F_OK) == 0)
 		unlink(mSocketFileName);
 
-	if (mRetryTimeout)
-		g_source_remove(mRetryTimeout);
+	clearPendingWrites();
 }
 
 bool BluetoothBinarySocket::registerReceiveDataWatch(BluetoothBinarySocketReceiveCallback callback)
@@ -147,51 +188,88 @@ bool BluetoothBinarySocket::sendData(const uint8_t *data, const uint32_t size)
 		return true;
 	}
 
-	if (write(mClientSocketFd, data, size) <= 0)
-		retrySendData(data, size);
+	// Keep the order of the data while earlier writes are still pending.
+	// When the client falls too far behind, a framed stream drops whole
+	// writes so it stays in sync.
+	if (!mPendingWrites.empty())
+	{
+		if (mDropWhenBehind && mPendingWriteSize + size > MAX_PENDING_WRITE_SIZE)
+			return false;
+
+		queuePendingWrite(data, size);
+		return true;
+	}
+
+	ssize_t written = write(mClientSocketFd, data, size);
+	if (written < 0)
+	{
+		if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+			return false;
+
+		written = 0;
+	}
+
+	// The rest of a partially written block is always kept
+	if ((uint32_t) written < size)
+		queuePendingWrite(data + written, size - written);
 
 	return true;
 }
 
-void BluetoothBinarySocket::retrySendData(const uint8_t *data, const uint32_t size)
+void BluetoothBinarySocket::queuePendingWrite(const uint8_t *data, const uint32_t size)
 {
-	/*
-	 * This logic is the migration from bluetooth-manager.
-	 * It avoids to drop the data which is sent from the stack to the socket.
-	 * MAX_WRITE_RETRY_COUNT and WRITE_RETRY_SLEEP_TIME are configured with the
-	 * socket client side. (i.e. watchmanager and mashupmanager)
-	 */
+	mPendingWrites.push_back(std::vector<uint8_t>(data, data + size));
+	mPendingWriteSize += size;
 
-	auto retrySendDataCallback = [] (gpointer userData) -> gboolean {
-		if (NULL == userData)
-			return FALSE;
+	if (!mWriteWatch && mClientIoChannel)
+		mWriteWatch = g_io_add_watch(mClientIoChannel, (GIOCondition)(G_IO_OUT | G_IO_ERR | G_IO_HUP | G_IO_NVAL),
+		                             &handleWritable, this);
+}
 
-		BluetoothBinarySocket *binarySocket = static_cast<BluetoothBinarySocket *>(userData);
-		if (NULL == binarySocket || binarySocket->mRetryCount > MAX_WRITE_RETRY_COUNT
-									|| binarySocket->mClientSocketFd < 0)
-		{
-			if ( binarySocket == NULL ) // 	Either the condition 'NULL==binarySocket' is redundant or there is possible null pointer dereference: binarySocket.
-				BT_INFO("BINSOCKET", 0, "binarySocket is NULL ");
-			else
-				binarySocket->mRetryTimeout = 0;
-			return FALSE;
-		}
+void BluetoothBinarySocket::clearPendingWrites()
+{
+	if (mWriteWatch)
+	{
+		g_source_remove(mWriteWatch);
+		mWriteWatch = 0;
+	}
 
-		if (write(binarySocket->mClientSocketFd, binarySocket->mRetryData, binarySocket->mRetryDataSize) <= 0)
-		{
-			binarySocket->mRetryCount++;
-			return TRUE;
-		}
+	mPendingWrites.clear();
+	mPendingWriteOffset = 0;
+	mPendingWriteSize = 0;
+}
+
+gboolean BluetoothBinarySocket::handleWritable(GIOChannel *io, GIOCondition cond, gpointer userData)
+{
+	BluetoothBinarySocket *binarySocket = static_cast<BluetoothBinarySocket *>(userData);
 
-		binarySocket->mRetryTimeout = 0;
+	if ((cond & (G_IO_NVAL | G_IO_ERR | G_IO_HUP)) || binarySocket->mClientSocketFd < 0)
+	{
+		binarySocket->mWriteWatch = 0;
+		binarySocket->clearPendingWrites();
 		return FALSE;
-	};
+	}
+
+	while (!binarySocket->mPendingWrites.empty())
+	{
+		std::vector<uint8_t> &pending = binarySocket->mPendingWrites.front();
+
+		ssize_t written = write(binarySocket->mClientSocketFd, pending.data() + binarySocket->mPendingWriteOffset,
+		                        pending.size() - binarySocket->mPendingWriteOffset);
+		if (written <= 0)
+			return TRUE;
+
+		binarySocket->mPendingWriteOffset += written;
+		if (binarySocket->mPendingWriteOffset < pending.size())
+			return TRUE;
 
-	mRetryData = data;
-	mRetryDataSize = size;
-	mRetryCount = 0;
+		binarySocket->mPendingWriteSize -= pending.size();
+		binarySocket->mPendingWriteOffset = 0;
+		binarySocket->mPendingWrites.pop_front();
+	}
 
-	g_timeout_add(WRITE_RETRY_SLEEP_TIME, retrySendDataCallback, this);
+	binarySocket->mWriteWatch = 0;
+	return FALSE;
 }
 
 void BluetoothBinarySocket::storeSendDataToBuffer(const uint8_t *data, const uint32_t size)
@@ -211,8 +289,8 @@ void BluetoothBinarySocket::sendBufferData()
 {
 	if (mBufferSize > 0)
 	{
-		if (write(mClientSocketFd, mBufferData, mBufferSize) > 0)
-			mBufferSize = 0;
+		sendData((const uint8_t *) mBufferData, mBufferSize);
+		mBufferSize = 0;
 	}
 }
 
@@ -238,13 +316,14 @@ gboolean BluetoothBinarySocket::getAcceptRequest(GIOChannel *io, GIOCondition co
 	if ((binarySocket->mClientSocketFd) < 0)
 		return FALSE;
 
-	binarySocket->sendBufferData();
-
 	binarySocket->mClientIoChannel = g_io_channel_unix_new(binarySocket->mClientSocketFd);
 	g_io_channel_set_flags(binarySocket->mClientIoChannel, G_IO_FLAG_NONBLOCK, NULL);
 	g_io_channel_set_close_on_unref(binarySocket->mClientIoChannel, TRUE);
-	g_io_add_watch(binarySocket->mClientIoChannel, (GIOCondition)(G_IO_IN | G_IO_ERR | G_IO_HUP | G_IO_NVAL),
-					&getReceiveRequest, userData);
+	if (!binarySocket->isWriting())
+		binarySocket->addClientWatch();
+
+	// Needs the channel for a pending write watch
+	binarySocket->sendBufferData();
 
 	return TRUE;
 }
@@ -257,10 +336,16 @@ gboolean BluetoothBinarySocket::getReceiveRequest(GIOChannel *io, GIOCondition c
 	BluetoothBinarySocket *binarySocket = static_cast<BluetoothBinarySocket *>(userData);
 
 	if (cond & (G_IO_NVAL | G_IO_ERR))
+	{
+		binarySocket->mClientWatch = 0;
 		return FALSE;
+	}
 
 	if (NULL == binarySocket->mClientIoChannel || binarySocket->mClientSocketFd <= 0)
+	{
+		binarySocket->mClientWatch = 0;
 		return FALSE;
+	}
 
 	if (binarySocket->isWriting())
 		return TRUE;
@@ -272,7 +357,10 @@ gboolean BluetoothBinarySocket::getReceiveRequest(GIOChannel *io, GIOCondition c
 		if (NULL != binarySocket->mCallback)
 			binarySocket->mCallback(buf, readBytes);
 	} else if (cond & G_IO_HUP)
+	{
+		binarySocket->mClientWatch = 0;
 		return FALSE;
+	}
 
 	return TRUE;
 }
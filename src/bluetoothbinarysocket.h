@@ -19,6 +19,8 @@
 #define BLUETOOTHBINARYSOCKET_H
 
 #include <string>
+#include <vector>
+#include <deque>
 #include <functional>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -34,8 +36,7 @@
 #define DEFAULT_LISTEN_BACKLOG          5
 #define READ_BUFFER_SIZE                1024
 #define DATA_BUFFER_SIZE                1024*5
-#define MAX_WRITE_RETRY_COUNT           1000
-#define WRITE_RETRY_SLEEP_TIME          10000
+#define MAX_PENDING_WRITE_SIZE          1024*64
 
 typedef std::function<void(guchar *readBuf, gsize readLen)> BluetoothBinarySocketReceiveCallback;
 
@@ -46,7 +47,12 @@ public:
 	~BluetoothBinarySocket();
 
 	bool isWriting() const { return mWriting; }
-	void setWriting(bool writing) { mWriting = writing; }
+	void setWriting(bool writing);
+	// Drop whole writes once MAX_PENDING_WRITE_SIZE is pending instead of
+	// queueing everything. Only for framed streams which stay in sync when
+	// a frame is lost, never for plain byte streams like SPP.
+	void setDropWhenBehind(bool dropWhenBehind) { mDropWhenBehind = dropWhenBehind; }
+	std::string getSocketFileName() const { return mSocketFileName; }
 	bool createBinarySocket(const std::string &name);
 	void removeBinarySocket(void);
 	bool registerReceiveDataWatch(BluetoothBinarySocketReceiveCallback callback);
@@ -56,25 +62,32 @@ private:
 	char mSocketFileName[BINARY_SOCKET_FILE_NAME_SIZE];
 	char mBufferData[DATA_BUFFER_SIZE];
 	uint32_t mBufferSize;
-	const uint8_t *mRetryData;
-	uint32_t mRetryDataSize;
-	uint32_t mRetryTimeout;
-	uint32_t mRetryCount;
+	// Data the client socket did not accept yet, one entry per sendData call
+	std::deque<std::vector<uint8_t>> mPendingWrites;
+	// Bytes of the first pending write already sent
+	uint32_t mPendingWriteOffset;
+	uint32_t mPendingWriteSize;
+	guint mWriteWatch;
+	bool mDropWhenBehind;
 	int mServerSocketFd;
 	int mClientSocketFd;
 	bool mWriting;
 	GIOChannel *mServerIoChannel;
 	GIOChannel *mClientIoChannel;
+	guint mClientWatch;
 	BluetoothBinarySocketReceiveCallback mCallback;
 
 private:
-	void retrySendData(const uint8_t *data, const uint32_t size);
+	void queuePendingWrite(const uint8_t *data, const uint32_t size);
+	void clearPendingWrites();
 	void storeSendDataToBuffer(const uint8_t *data, const uint32_t size);
 	void sendBufferData();
+	void addClientWatch();
 
 private:
 	static gboolean getAcceptRequest(GIOChannel *io, GIOCondition cond, gpointer userData);
 	static gboolean getReceiveRequest(GIOChannel *io, GIOCondition cond, gpointer userData);
+	static gboolean handleWritable(GIOChannel *io, GIOCondition cond, gpointer userData);
 };
 
 #endif // BLUETOOTHBINARYSOCKET_H
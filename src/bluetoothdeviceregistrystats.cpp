@@ -0,0 +1,80 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "bluetoothdeviceregistrystats.h"
+#include "utils.h"
+
+BluetoothDeviceRegistryStats::Measurement::Measurement(BluetoothDeviceRegistryStats &stats, BluetoothDeviceRegistryEvent event) :
+	mStats(stats),
+	mPreviousEvent(stats.mCurrentEvent),
+	mStartTime(getThreadCpuTime())
+{
+	mStats.mCurrentEvent = event;
+}
+
+BluetoothDeviceRegistryStats::Measurement::~Measurement()
+{
+	uint64_t duration = getThreadCpuTime() - mStartTime;
+
+	BluetoothDeviceRegistryEventStats &eventStats = mStats.mEvents[mStats.mCurrentEvent];
+	eventStats.count++;
+	eventStats.cpuTime += duration;
+	if (duration > eventStats.maxCpuTime)
+		eventStats.maxCpuTime = duration;
+
+	mStats.mCurrentEvent = mPreviousEvent;
+}
+
+BluetoothDeviceRegistryStats::BluetoothDeviceRegistryStats() :
+	mCurrentEvent(BLUETOOTH_DEVICE_REGISTRY_EVENT_OTHER)
+{
+}
+
+void BluetoothDeviceRegistryStats::countPayload(size_t size, unsigned int recipients)
+{
+	// Notifications outside of a measured SIL event (pairing, Luna calls)
+	// end up in the "other" bucket
+	BluetoothDeviceRegistryEventStats &eventStats = mEvents[mCurrentEvent];
+	eventStats.notifications += recipients;
+	eventStats.bytes += (uint64_t) size * recipients;
+}
+
+void BluetoothDeviceRegistryStats::reset()
+{
+	for (int event = 0; event < BLUETOOTH_DEVICE_REGISTRY_EVENT_MAX; event++)
+		mEvents[event] = BluetoothDeviceRegistryEventStats();
+}
+
+std::string BluetoothDeviceRegistryStats::eventToString(BluetoothDeviceRegistryEvent event)
+{
+	switch (event)
+	{
+	case BLUETOOTH_DEVICE_REGISTRY_EVENT_DEVICE_FOUND:
+		return "deviceFound";
+	case BLUETOOTH_DEVICE_REGISTRY_EVENT_DEVICE_PROPERTIES_CHANGED:
+		return "devicePropertiesChanged";
+	case BLUETOOTH_DEVICE_REGISTRY_EVENT_DEVICE_REMOVED:
+		return "deviceRemoved";
+	case BLUETOOTH_DEVICE_REGISTRY_EVENT_LE_DEVICE_FOUND_BY_SCAN_ID:
+		return "leDeviceFoundByScanId";
+	case BLUETOOTH_DEVICE_REGISTRY_EVENT_LE_DEVICE_PROPERTIES_CHANGED_BY_SCAN_ID:
+		return "leDevicePropertiesChangedByScanId";
+	default:
+		return "other";
+	}
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef BLUETOOTHDEVICEREGISTRYSTATS_H
+#define BLUETOOTHDEVICEREGISTRYSTATS_H
+
+#include <string>
+#include <stdint.h>
+
+enum BluetoothDeviceRegistryEvent
+{
+	BLUETOOTH_DEVICE_REGISTRY_EVENT_DEVICE_FOUND = 0,
+	BLUETOOTH_DEVICE_REGISTRY_EVENT_DEVICE_PROPERTIES_CHANGED,
+	BLUETOOTH_DEVICE_REGISTRY_EVENT_DEVICE_REMOVED,
+	BLUETOOTH_DEVICE_REGISTRY_EVENT_LE_DEVICE_FOUND_BY_SCAN_ID,
+	BLUETOOTH_DEVICE_REGISTRY_EVENT_LE_DEVICE_PROPERTIES_CHANGED_BY_SCAN_ID,
+	BLUETOOTH_DEVICE_REGISTRY_EVENT_OTHER,
+	BLUETOOTH_DEVICE_REGISTRY_EVENT_MAX
+};
+
+class BluetoothDeviceRegistryEventStats
+{
+public:
+	BluetoothDeviceRegistryEventStats() :
+		count(0),
+		cpuTime(0),
+		maxCpuTime(0),
+		notifications(0),
+		bytes(0)
+	{
+	}
+
+	uint64_t count;
+	uint64_t cpuTime;
+	uint64_t maxCpuTime;
+	uint64_t notifications;
+	uint64_t bytes;
+};
+
+/*
+ * Cost of keeping the device registry subscribers up to date. Every SIL
+ * device event is measured in thread CPU time (microseconds) together with
+ * the notifications and payload bytes it produced, so the cost per event
+ * can be compared across registry sizes and subscriber counts.
+ */
+class BluetoothDeviceRegistryStats
+{
+public:
+	class Measurement
+	{
+	public:
+		Measurement(BluetoothDeviceRegistryStats &stats, BluetoothDeviceRegistryEvent event);
+		Measurement(const Measurement &other) = delete;
+		~Measurement();
+
+	private:
+		BluetoothDeviceRegistryStats &mStats;
+		BluetoothDeviceRegistryEvent mPreviousEvent;
+		uint64_t mStartTime;
+	};
+
+	BluetoothDeviceRegistryStats();
+
+	void countPayload(size_t size, unsigned int recipients);
+	void reset();
+
+	const BluetoothDeviceRegistryEventStats& getEventStats(BluetoothDeviceRegistryEvent event) const { return mEvents[event]; }
+
+	static std::string eventToString(BluetoothDeviceRegistryEvent event);
+
+private:
+	BluetoothDeviceRegistryEventStats mEvents[BLUETOOTH_DEVICE_REGISTRY_EVENT_MAX];
+	BluetoothDeviceRegistryEvent mCurrentEvent;
+};
+
+#endif // BLUETOOTHDEVICEREGISTRYSTATS_H
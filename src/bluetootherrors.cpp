@@ -230,6 +230,17 @@ static std::map<BluetoothErrorCode, std::string> bluetoothErrorTextTable =
 	{BT_ERR_GATT_READ_DESCRIPTOR_FAIL, "Failed to read descriptor"},
 	{BT_ERR_GATT_INSTANCE_ID_NOT_SUPPORTED, "'instanceId' is not supported"},
 	{BT_ERR_CLIENTID_PARAM_MISSING, "Required 'clientId' parameter is not supplied"},
+	{BT_ERR_GATT_WRITE_WITHOUT_RESPONSE_NOT_SUPPORTED, "Characteristic doesn't support write without response"},
+	{BT_ERR_GATT_WRITE_STREAM_FAIL, "Failed to open GATT write stream"},
+	{BT_ERR_GATT_MONITOR_SOCKET_FAIL, "Failed to create characteristic notification socket"},
+	{BT_ERR_GATT_READ_REQUEST_NOT_FOUND, "Read request is unknown or was already answered"},
+	{BT_ERR_ANCS_QUERY_TIMEOUT, "ANCS notification query timed out"},
+	{BT_ERR_ANCS_QUERY_QUEUE_FULL, "Too many ANCS notification queries pending for the device"},
+	{BT_ERR_ANCS_APPID_PARAM_MISSING, "Required 'appIdentifier' parameter is not supplied"},
+	{BT_ERR_SIL_RECORDING_OPEN_FAIL, "Failed to open the SIL recording file"},
+	{BT_ERR_METRICS_DUMP_FAIL, "Failed to write the metrics dump file"},
+	{BT_ERR_FILE_NAME_PARAM_MISSING, "Required 'fileName' parameter is not supplied"},
+	{BT_ERR_INVALID_FILE_NAME, "'fileName' must be a file name without a directory"},
 };
 
 void appendErrorResponse(pbnjson::JValue &obj, BluetoothError errorCode)
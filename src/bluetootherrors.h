@@ -207,6 +207,17 @@ enum BluetoothErrorCode
 	BT_ERR_CLIENTID_PARAM_MISSING = 283,
 	BT_ERR_BLE_ADV_EXCEED_SIZE_LIMIT = 284,
 	BT_ERR_GATT_INSTANCE_ID_NOT_SUPPORTED = 285,
+	BT_ERR_GATT_WRITE_WITHOUT_RESPONSE_NOT_SUPPORTED = 286,
+	BT_ERR_GATT_WRITE_STREAM_FAIL = 287,
+	BT_ERR_GATT_MONITOR_SOCKET_FAIL = 288,
+	BT_ERR_GATT_READ_REQUEST_NOT_FOUND = 289,
+	BT_ERR_ANCS_QUERY_TIMEOUT = 290,
+	BT_ERR_ANCS_QUERY_QUEUE_FULL = 291,
+	BT_ERR_ANCS_APPID_PARAM_MISSING = 292,
+	BT_ERR_SIL_RECORDING_OPEN_FAIL = 294,
+	BT_ERR_METRICS_DUMP_FAIL = 295,
+	BT_ERR_FILE_NAME_PARAM_MISSING = 296,
+	BT_ERR_INVALID_FILE_NAME = 297,
 };
 
 void appendErrorResponse(pbnjson::JValue &obj, BluetoothError errorCode);
@@ -0,0 +1,175 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+
+#include "bluetootheventtrace.h"
+
+static BluetoothEventTrace eventTrace;
+
+BluetoothEventTrace& getEventTrace()
+{
+	return eventTrace;
+}
+
+static const char *eventTraceTypeNames[BLUETOOTH_EVENT_TRACE_MAX] = {
+	"deviceFound",
+	"characteristicValueChanged",
+	"gattOperationComplete",
+	"hidSendData",
+	"sppDataReceived",
+	"sppWriteData"
+};
+
+BluetoothEventTrace::BluetoothEventTrace() :
+	mPosition(0)
+{
+	memset(mEntries, 0, sizeof(mEntries));
+	for (int slot = 0; slot < EVENT_TRACE_SIZE; slot++)
+		mSequences[slot].store(0, std::memory_order_relaxed);
+}
+
+BluetoothEventTraceEntry* BluetoothEventTrace::begin(uint64_t &position)
+{
+	position = mPosition.fetch_add(1, std::memory_order_relaxed);
+
+	unsigned int slot = position & (EVENT_TRACE_SIZE - 1);
+	// Mark the slot as being written before touching the entry
+	mSequences[slot].store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	return &mEntries[slot];
+}
+
+void BluetoothEventTrace::commit(uint64_t position)
+{
+	mSequences[position & (EVENT_TRACE_SIZE - 1)].store(position + 1, std::memory_order_release);
+}
+
+void BluetoothEventTrace::record(BluetoothEventTraceType type, const std::string &address, uint32_t handle,
+                                 uint32_t size, uint32_t latency)
+{
+	uint64_t position;
+	BluetoothEventTraceEntry *entry = begin(position);
+
+	entry->timestamp = g_get_monotonic_time();
+	entry->size = size;
+	entry->latency = latency;
+	entry->type = type;
+	entry->handle = handle;
+
+	// Addresses are "xx:xx:xx:xx:xx:xx"; anything else is stored as zeros
+	const char *text = address.c_str();
+	for (int n = 0; n < 6; n++)
+	{
+		uint8_t value = 0;
+		if (address.length() == 17)
+		{
+			for (int digit = 0; digit < 2; digit++)
+			{
+				char c = text[n * 3 + digit];
+				value <<= 4;
+				if (c >= '0' && c <= '9')
+					value |= c - '0';
+				else if (c >= 'a' && c <= 'f')
+					value |= c - 'a' + 10;
+				else if (c >= 'A' && c <= 'F')
+					value |= c - 'A' + 10;
+			}
+		}
+		entry->address[n] = value;
+	}
+
+	commit(position);
+}
+
+void BluetoothEventTrace::record(BluetoothEventTraceType type, uint32_t handle, uint32_t size, uint32_t latency)
+{
+	uint64_t position;
+	BluetoothEventTraceEntry *entry = begin(position);
+
+	entry->timestamp = g_get_monotonic_time();
+	entry->size = size;
+	entry->latency = latency;
+	entry->type = type;
+	entry->handle = handle;
+	memset(entry->address, 0, sizeof(entry->address));
+
+	commit(position);
+}
+
+uint64_t BluetoothEventTrace::snapshot(uint64_t since, std::vector<BluetoothEventTraceEntry> &entries, uint64_t &dropped) const
+{
+	uint64_t end = getPosition();
+	uint64_t position = since;
+
+	dropped = 0;
+
+	if (position > end)
+		position = end;
+	else if (end - position > EVENT_TRACE_SIZE)
+	{
+		dropped = end - position - EVENT_TRACE_SIZE;
+		position = end - EVENT_TRACE_SIZE;
+	}
+
+	for (; position < end; position++)
+	{
+		unsigned int slot = position & (EVENT_TRACE_SIZE - 1);
+
+		// A sequence other than position + 1 means the slot is still being
+		// written or already holds a newer entry
+		uint64_t sequence = mSequences[slot].load(std::memory_order_acquire);
+		if (sequence != position + 1)
+		{
+			dropped++;
+			continue;
+		}
+
+		BluetoothEventTraceEntry entry = mEntries[slot];
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (mSequences[slot].load(std::memory_order_relaxed) != sequence)
+		{
+			dropped++;
+			continue;
+		}
+
+		entries.push_back(entry);
+	}
+
+	return end;
+}
+
+std::string BluetoothEventTrace::typeToString(uint16_t type)
+{
+	if (type >= BLUETOOTH_EVENT_TRACE_MAX)
+		return "unknown";
+
+	return eventTraceTypeNames[type];
+}
+
+std::string BluetoothEventTrace::addressToString(const uint8_t *address)
+{
+	char text[18];
+	snprintf(text, sizeof(text), "%02x:%02x:%02x:%02x:%02x:%02x",
+	         address[0], address[1], address[2], address[3], address[4], address[5]);
+
+	return text;
+}
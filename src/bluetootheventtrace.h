@@ -0,0 +1,92 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef BLUETOOTHEVENTTRACE_H
+#define BLUETOOTHEVENTTRACE_H
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <stdint.h>
+
+// Number of entries kept, must be a power of two
+#define EVENT_TRACE_SIZE 4096
+
+enum BluetoothEventTraceType
+{
+	BLUETOOTH_EVENT_TRACE_DEVICE_FOUND = 0,
+	BLUETOOTH_EVENT_TRACE_CHARACTERISTIC_VALUE_CHANGED,
+	BLUETOOTH_EVENT_TRACE_GATT_OPERATION_COMPLETE,
+	BLUETOOTH_EVENT_TRACE_HID_SEND_DATA,
+	BLUETOOTH_EVENT_TRACE_SPP_DATA_RECEIVED,
+	BLUETOOTH_EVENT_TRACE_SPP_WRITE_DATA,
+	BLUETOOTH_EVENT_TRACE_MAX
+};
+
+typedef struct
+{
+	// Monotonic time in microseconds
+	int64_t timestamp;
+	uint32_t size;
+	// Microseconds, for events which complete an earlier request
+	uint32_t latency;
+	// GATT attribute handle or SPP channel id
+	uint32_t handle;
+	uint16_t type;
+	uint8_t address[6];
+} BluetoothEventTraceEntry;
+
+/*
+ * Fixed size ring of binary trace entries, cheap enough to stay enabled on
+ * hot paths where formatting a log message is not. Writers claim a slot
+ * with a single atomic increment and never block; every slot carries a
+ * sequence number so readers can skip entries which were overwritten while
+ * they copied them.
+ */
+class BluetoothEventTrace
+{
+public:
+	BluetoothEventTrace();
+	BluetoothEventTrace(const BluetoothEventTrace &other) = delete;
+
+	void record(BluetoothEventTraceType type, const std::string &address, uint32_t handle = 0,
+	            uint32_t size = 0, uint32_t latency = 0);
+	void record(BluetoothEventTraceType type, uint32_t handle, uint32_t size = 0, uint32_t latency = 0);
+
+	// Total number of entries recorded, also the position of the next one
+	uint64_t getPosition() const { return mPosition.load(std::memory_order_acquire); }
+
+	// Copies the entries recorded from position since on, oldest first, and
+	// returns the position to continue from. Entries already overwritten
+	// are counted in dropped.
+	uint64_t snapshot(uint64_t since, std::vector<BluetoothEventTraceEntry> &entries, uint64_t &dropped) const;
+
+	static std::string typeToString(uint16_t type);
+	static std::string addressToString(const uint8_t *address);
+
+private:
+	BluetoothEventTraceEntry mEntries[EVENT_TRACE_SIZE];
+	std::atomic<uint64_t> mSequences[EVENT_TRACE_SIZE];
+	std::atomic<uint64_t> mPosition;
+
+	BluetoothEventTraceEntry* begin(uint64_t &position);
+	void commit(uint64_t position);
+};
+
+BluetoothEventTrace& getEventTrace();
+
+#endif // BLUETOOTHEVENTTRACE_H
@@ -0,0 +1,162 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "bluetoothgattancsattributecache.h"
+#include "logging.h"
+
+BluetoothGattAncsAttributeCache::BluetoothGattAncsAttributeCache(unsigned int capacity) :
+	mCapacity(capacity),
+	mHitCount(0),
+	mMissCount(0),
+	mEvictedCount(0)
+{
+}
+
+BluetoothGattAncsAttributeCache::~BluetoothGattAncsAttributeCache()
+{
+	for (auto entry : mEntries)
+		delete entry;
+	mEntries.clear();
+	mIndex.clear();
+}
+
+std::string BluetoothGattAncsAttributeCache::buildNotificationKey(const std::string &address, int32_t notificationId, uint8_t attrId)
+{
+	return address + "/n/" + std::to_string(notificationId) + "/" + std::to_string(attrId);
+}
+
+std::string BluetoothGattAncsAttributeCache::buildAppKey(const std::string &address, const std::string &appIdentifier, uint8_t attrId)
+{
+	return address + "/a/" + appIdentifier + "/" + std::to_string(attrId);
+}
+
+bool BluetoothGattAncsAttributeCache::lookup(const std::string &key, uint16_t maxLength, std::string &value)
+{
+	auto indexIter = mIndex.find(key);
+	if (indexIter == mIndex.end())
+	{
+		mMissCount++;
+		return false;
+	}
+
+	AncsCachedAttribute *entry = *indexIter->second;
+
+	// A value fetched with a smaller length limit may be cut short
+	if (entry->maxLength != 0 && (maxLength == 0 || maxLength > entry->maxLength) &&
+	    entry->value.length() >= entry->maxLength)
+	{
+		mMissCount++;
+		return false;
+	}
+
+	mEntries.splice(mEntries.begin(), mEntries, indexIter->second);
+	mHitCount++;
+
+	value = entry->value;
+	if (maxLength != 0 && value.length() > maxLength)
+		value.resize(maxLength);
+
+	return true;
+}
+
+void BluetoothGattAncsAttributeCache::store(AncsCachedAttribute *entry)
+{
+	auto indexIter = mIndex.find(entry->key);
+	if (indexIter != mIndex.end())
+		erase(indexIter->second);
+
+	mEntries.push_front(entry);
+	mIndex[entry->key] = mEntries.begin();
+
+	while (mEntries.size() > mCapacity)
+	{
+		erase(std::prev(mEntries.end()));
+		mEvictedCount++;
+	}
+}
+
+void BluetoothGattAncsAttributeCache::erase(std::list<AncsCachedAttribute*>::iterator entryIter)
+{
+	AncsCachedAttribute *entry = *entryIter;
+
+	mIndex.erase(entry->key);
+	mEntries.erase(entryIter);
+	delete entry;
+}
+
+bool BluetoothGattAncsAttributeCache::lookupNotificationAttribute(const std::string &address, int32_t notificationId, uint8_t attrId,
+                                                                  uint16_t maxLength, std::string &value)
+{
+	return lookup(buildNotificationKey(address, notificationId, attrId), maxLength, value);
+}
+
+void BluetoothGattAncsAttributeCache::storeNotificationAttribute(const std::string &address, int32_t notificationId, uint8_t attrId,
+                                                                 uint16_t maxLength, const std::string &value)
+{
+	AncsCachedAttribute *entry = new AncsCachedAttribute();
+	entry->key = buildNotificationKey(address, notificationId, attrId);
+	entry->address = address;
+	entry->notificationId = notificationId;
+	entry->attrId = attrId;
+	entry->maxLength = maxLength;
+	entry->value = value;
+
+	store(entry);
+}
+
+bool BluetoothGattAncsAttributeCache::lookupAppAttribute(const std::string &address, const std::string &appIdentifier, uint8_t attrId,
+                                                         uint16_t maxLength, std::string &value)
+{
+	return lookup(buildAppKey(address, appIdentifier, attrId), maxLength, value);
+}
+
+void BluetoothGattAncsAttributeCache::storeAppAttribute(const std::string &address, const std::string &appIdentifier, uint8_t attrId,
+                                                        uint16_t maxLength, const std::string &value)
+{
+	AncsCachedAttribute *entry = new AncsCachedAttribute();
+	entry->key = buildAppKey(address, appIdentifier, attrId);
+	entry->address = address;
+	entry->appIdentifier = appIdentifier;
+	entry->attrId = attrId;
+	entry->maxLength = maxLength;
+	entry->value = value;
+
+	store(entry);
+}
+
+void BluetoothGattAncsAttributeCache::removeNotification(const std::string &address, int32_t notificationId)
+{
+	for (auto entryIter = mEntries.begin(); entryIter != mEntries.end();)
+	{
+		AncsCachedAttribute *entry = *entryIter++;
+		if (entry->address == address && entry->appIdentifier.empty() && entry->notificationId == notificationId)
+			erase(std::prev(entryIter));
+	}
+}
+
+void BluetoothGattAncsAttributeCache::removeDevice(const std::string &address)
+{
+	for (auto entryIter = mEntries.begin(); entryIter != mEntries.end();)
+	{
+		AncsCachedAttribute *entry = *entryIter++;
+		if (entry->address == address)
+			erase(std::prev(entryIter));
+	}
+
+	BT_DEBUG("Dropped cached ANCS attributes of %s", address.c_str());
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef BLUETOOTHGATTANCSATTRIBUTECACHE_H
+#define BLUETOOTHGATTANCSATTRIBUTECACHE_H
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <stdint.h>
+
+#define ANCS_ATTRIBUTE_CACHE_SIZE 256
+
+/*
+ * One attribute value fetched from an iOS device. Notification attributes
+ * have the notification UID set, app attributes the app identifier.
+ * maxLength is the length limit the value was requested with, 0 when it
+ * was requested without one.
+ */
+class AncsCachedAttribute
+{
+public:
+	AncsCachedAttribute() :
+		notificationId(0),
+		attrId(0),
+		maxLength(0)
+	{
+	}
+
+	std::string key;
+	std::string address;
+	int32_t notificationId;
+	std::string appIdentifier;
+	uint8_t attrId;
+	uint16_t maxLength;
+	std::string value;
+};
+
+/*
+ * Least recently used cache of ANCS notification and app attributes, so
+ * repeated queries for the same notification or app are answered without
+ * another round trip to the phone.
+ */
+class BluetoothGattAncsAttributeCache
+{
+public:
+	BluetoothGattAncsAttributeCache(unsigned int capacity = ANCS_ATTRIBUTE_CACHE_SIZE);
+	BluetoothGattAncsAttributeCache(const BluetoothGattAncsAttributeCache &other) = delete;
+	~BluetoothGattAncsAttributeCache();
+
+	bool lookupNotificationAttribute(const std::string &address, int32_t notificationId, uint8_t attrId,
+	                                 uint16_t maxLength, std::string &value);
+	void storeNotificationAttribute(const std::string &address, int32_t notificationId, uint8_t attrId,
+	                                uint16_t maxLength, const std::string &value);
+	bool lookupAppAttribute(const std::string &address, const std::string &appIdentifier, uint8_t attrId,
+	                        uint16_t maxLength, std::string &value);
+	void storeAppAttribute(const std::string &address, const std::string &appIdentifier, uint8_t attrId,
+	                       uint16_t maxLength, const std::string &value);
+
+	void removeNotification(const std::string &address, int32_t notificationId);
+	void removeDevice(const std::string &address);
+
+	unsigned int getSize() const { return mEntries.size(); }
+	unsigned int getHitCount() const { return mHitCount; }
+	unsigned int getMissCount() const { return mMissCount; }
+	unsigned int getEvictedCount() const { return mEvictedCount; }
+
+private:
+	unsigned int mCapacity;
+	// Most recently used first
+	std::list<AncsCachedAttribute*> mEntries;
+	std::unordered_map<std::string, std::list<AncsCachedAttribute*>::iterator> mIndex;
+
+	unsigned int mHitCount;
+	unsigned int mMissCount;
+	unsigned int mEvictedCount;
+
+	bool lookup(const std::string &key, uint16_t maxLength, std::string &value);
+	void store(AncsCachedAttribute *entry);
+	void erase(std::list<AncsCachedAttribute*>::iterator entryIter);
+
+	static std::string buildNotificationKey(const std::string &address, int32_t notificationId, uint8_t attrId);
+	static std::string buildAppKey(const std::string &address, const std::string &appIdentifier, uint8_t attrId);
+};
+
+#endif // BLUETOOTHGATTANCSATTRIBUTECACHE_H
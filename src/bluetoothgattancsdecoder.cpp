@@ -0,0 +1,84 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "bluetoothgattancsdecoder.h"
+
+BluetoothGattAncsDecoder::BluetoothGattAncsDecoder() :
+	mState(STATE_ATTRIBUTE_ID),
+	mAttrId(0),
+	mLength(0),
+	mRemaining(0),
+	mDecodedAttributes(0)
+{
+}
+
+void BluetoothGattAncsDecoder::reset()
+{
+	mState = STATE_ATTRIBUTE_ID;
+	mAttrId = 0;
+	mLength = 0;
+	mRemaining = 0;
+}
+
+void BluetoothGattAncsDecoder::feed(const uint8_t *data, size_t length, BluetoothGattAncsAttributeSink &sink)
+{
+	size_t index = 0;
+
+	while (index < length)
+	{
+		switch (mState)
+		{
+		case STATE_ATTRIBUTE_ID:
+			mAttrId = data[index++];
+			mState = STATE_LENGTH_LOW;
+			break;
+		case STATE_LENGTH_LOW:
+			mLength = data[index++];
+			mState = STATE_LENGTH_HIGH;
+			break;
+		case STATE_LENGTH_HIGH:
+			mLength |= data[index++] << 8;
+			mRemaining = mLength;
+			sink.attributeStarted(mAttrId, mLength);
+			mState = STATE_VALUE;
+			break;
+		case STATE_VALUE:
+		{
+			size_t chunk = length - index;
+			if (chunk > mRemaining)
+				chunk = mRemaining;
+
+			if (chunk > 0)
+				sink.attributeData(mAttrId, data + index, chunk);
+
+			index += chunk;
+			mRemaining -= chunk;
+			break;
+		}
+		}
+
+		// Checked outside the switch so that empty values, which have no
+		// data byte left to trigger another round, complete as well
+		if (mState == STATE_VALUE && mRemaining == 0)
+		{
+			sink.attributeCompleted(mAttrId);
+			mDecodedAttributes++;
+			mState = STATE_ATTRIBUTE_ID;
+		}
+	}
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef BLUETOOTHGATTANCSDECODER_H
+#define BLUETOOTHGATTANCSDECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Receives the attributes found by BluetoothGattAncsDecoder. data points
+ * into the block being decoded and is only valid during the call.
+ */
+class BluetoothGattAncsAttributeSink
+{
+public:
+	virtual ~BluetoothGattAncsAttributeSink() {}
+
+	virtual void attributeStarted(uint8_t attrId, uint16_t length) = 0;
+	virtual void attributeData(uint8_t attrId, const uint8_t *data, size_t length) = 0;
+	virtual void attributeCompleted(uint8_t attrId) = 0;
+};
+
+/*
+ * Streaming decoder for the attribute list of an ANCS Data Source answer
+ * ([AttributeID][Length LE16][Value]...). Blocks can be fed in pieces of
+ * any size; an attribute id, either length byte or the value may end up
+ * in a different block than the rest of the attribute. The decoder keeps
+ * only a few bytes of state and never allocates.
+ */
+class BluetoothGattAncsDecoder
+{
+public:
+	BluetoothGattAncsDecoder();
+
+	void reset();
+	void feed(const uint8_t *data, size_t length, BluetoothGattAncsAttributeSink &sink);
+
+	bool isBetweenAttributes() const { return mState == STATE_ATTRIBUTE_ID; }
+	unsigned int getDecodedAttributeCount() const { return mDecodedAttributes; }
+
+private:
+	enum State
+	{
+		STATE_ATTRIBUTE_ID = 0,
+		STATE_LENGTH_LOW,
+		STATE_LENGTH_HIGH,
+		STATE_VALUE
+	};
+
+	State mState;
+	uint8_t mAttrId;
+	uint16_t mLength;
+	uint16_t mRemaining;
+	unsigned int mDecodedAttributes;
+};
+
+#endif // BLUETOOTHGATTANCSDECODER_H
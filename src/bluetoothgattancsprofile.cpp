@@ -24,8 +24,6 @@
 #include "ls2utils.h"
 #include "logging.h"
 #include <iostream>
-#include <sstream>
-#include <iterator>
 #include <ctime>
 
 using namespace std::placeholders;
@@ -65,10 +63,60 @@ static std::unordered_map<int, std::string> ancsCategory =
 		//12 - 255 - Reserved
 };
 
+NotificationAttr* NotificationIdQueryInfo::findAttribute(uint8_t attrId)
+{
+	for (auto &attr : attrList)
+	{
+		if (attr.attrId == attrId)
+			return &attr;
+	}
+
+	return nullptr;
+}
+
+bool NotificationIdQueryInfo::hasAllAttributes() const
+{
+	for (auto &attr : attrList)
+	{
+		if (!attr.found)
+			return false;
+	}
+
+	return true;
+}
+
+void NotificationIdQueryInfo::attributeStarted(uint8_t attrId, uint16_t length)
+{
+	NotificationAttr *attr = findAttribute(attrId);
+	if (!attr)
+		return;
+
+	attr->value.clear();
+	attr->value.reserve(length);
+}
+
+void NotificationIdQueryInfo::attributeData(uint8_t attrId, const uint8_t *data, size_t length)
+{
+	NotificationAttr *attr = findAttribute(attrId);
+	if (!attr)
+		return;
+
+	attr->value.append(reinterpret_cast<const char*>(data), length);
+}
+
+void NotificationIdQueryInfo::attributeCompleted(uint8_t attrId)
+{
+	NotificationAttr *attr = findAttribute(attrId);
+	if (!attr)
+		return;
+
+	attr->found = true;
+	BT_DEBUG("attributeId %d, value %s", attrId, attr->value.c_str());
+}
+
 BluetoothGattAncsProfile::BluetoothGattAncsProfile (BluetoothManagerService *manager,
 		BluetoothGattProfileService *btGattSrvHandle) :
 		BluetoothGattProfileService(manager, "GATT","00001801-0000-1000-8000-00805f9b34fb"),
-		mNotificationQueryInfo(0),
 		mAncsUuid(BluetoothUuid(ANCS_UUID))
 {
 	LS_CREATE_CLASS_CATEGORY_BEGIN(BluetoothGattAncsProfile, base)
@@ -92,7 +140,9 @@ BluetoothGattAncsProfile::BluetoothGattAncsProfile (BluetoothManagerService *man
 
 BluetoothGattAncsProfile::~BluetoothGattAncsProfile()
 {
-
+	for (auto queueIter : mQueryQueues)
+		delete queueIter.second;
+	mQueryQueues.clear();
 }
 
 /**
@@ -325,10 +375,12 @@ bool BluetoothGattAncsProfile::connectCallback(LSMessage *requestMessage, const
 	}
 	if (request.isSubscription())
 	{
-		uint16_t appId = 0;
-		uint16_t connectId = 0;
+		// ANCS connects through the plain profile interface, not through the
+		// GATT connection pool, so the watch is keyed by address
 		auto watch = new LSUtils::ClientWatch(getManager()->get(), requestMessage,
-				std::bind(&BluetoothGattAncsProfile::handleConnectClientDisappeared, this, appId, connectId, adapterAddress, address));
+				[this, adapterAddress, address]() {
+					BluetoothProfileService::handleConnectClientDisappeared(adapterAddress, address);
+				});
 		mConnectWatches.insert(std::pair<std::string, LSUtils::ClientWatch*>(address, watch));
 	}
 
@@ -438,6 +490,9 @@ void BluetoothGattAncsProfile::disconnectCallback(LSMessage *requestMessage, con
 		getManager()->getDefaultAdapter()->unpair(address, unpairCallback);
 	}
 
+	failNotificationQueries(address, BT_ERR_PROFILE_NOT_CONNECTED);
+	mAttributeCache.removeDevice(address);
+
 	markDeviceAsNotConnecting(address);
 	markDeviceAsNotConnected(address);
 	if (!quietDisconnect)
@@ -459,6 +514,14 @@ pbnjson::JValue BluetoothGattAncsProfile::buildGetStatusResp(bool connected, boo
 	pbnjson::JValue responseObj = pbnjson::Object();
 	appendCommonProfileStatus(responseObj, connected, connecting, subscribed,
 	                          returnValue, adapterAddress, deviceAddress);
+
+	pbnjson::JValue cacheObj = pbnjson::Object();
+	cacheObj.put("entries", (int32_t) mAttributeCache.getSize());
+	cacheObj.put("hits", (int32_t) mAttributeCache.getHitCount());
+	cacheObj.put("misses", (int32_t) mAttributeCache.getMissCount());
+	cacheObj.put("evicted", (int32_t) mAttributeCache.getEvictedCount());
+	responseObj.put("attributeCache", cacheObj);
+
 	return responseObj;
 }
 
@@ -539,6 +602,12 @@ bool BluetoothGattAncsProfile::awaitConnectionRequest(LSMessage &message)
 
 void BluetoothGattAncsProfile::incomingLeConnectionRequest(const std::string &address, bool state)
 {
+	if (!state)
+	{
+		failNotificationQueries(address, BT_ERR_PROFILE_NOT_CONNECTED);
+		mAttributeCache.removeDevice(address);
+	}
+
 	if (mGetConnectionRequestSubscriptions.getSubscribersCount() != 0)
 	{
 		pbnjson::JValue responseObj = pbnjson::Object();
@@ -741,13 +810,18 @@ void BluetoothGattAncsProfile::characteristicValueChanged(const std::string &add
 	BT_INFO("ANCS", 0, "characteristic %s", characteristic.getUuid().toString().c_str());
 	if ((characteristic.getUuid() == BluetoothUuid(NOTIFICATION_SOURCE_UUID)) && (service == mAncsUuid))
 	{
+		BluetoothGattValue values = characteristic.getValue();
+
+		// Cached attributes of a changed or dismissed notification are stale
+		if (values.size() >= 8 && (values[0] == ANCS_EVENT_ID_NOTIFICATION_MODIFIED || values[0] == ANCS_EVENT_ID_NOTIFICATION_REMOVED))
+			mAttributeCache.removeNotification(address, values[4] | (values[5] << 8) | (values[6] << 16) | (values[7] << 24));
+
 	//Value change is for awaitNotifications
 		auto notificationIter = mAwaitNotificationSubscriptions.find(address);
 		//Value change is for awaitNotifications
 		if (notificationIter != mAwaitNotificationSubscriptions.end())
 		{
 			LS::SubscriptionPoint *subscriptionPoint = notificationIter->second;
-			BluetoothGattValue values = characteristic.getValue();
 			BT_DEBUG("Found notification source characteristic value of size %d", values.size());
 
 			int eventID = (int32_t) values[0];
@@ -802,162 +876,280 @@ void BluetoothGattAncsProfile::characteristicValueChanged(const std::string &add
 	else if ((service == mAncsUuid) && (characteristic.getUuid() == BluetoothUuid(DATA_SOURCE_UUID)))
 	{
 		BluetoothGattValue values = characteristic.getValue();
-		int32_t vSize = values.size();
-		BT_DEBUG("ANCS data source characteristic value len:%d ", vSize);
-		std::stringstream buffer;
-		std::copy (values.begin(), values.end(), std::ostream_iterator<uint8_t>(buffer, ", "));
-		BT_DEBUG ("values %s", buffer.str().c_str());
-		int index = 0;
-		if (!mNotificationQueryInfo)
+		BT_DEBUG("ANCS data source characteristic value len:%d ", values.size());
+
+		BluetoothGattAncsQueryQueue *queue = findQueryQueue(address);
+		if (!queue)
 		{
-			BT_DEBUG("ANCS QueryInfo object empty");
+			BT_DEBUG("No ANCS query pending for %s", address.c_str());
 			return;
 		}
-		//Ancs block sizes are roughly 155 bytes long. When queried for multiple notification attributes,  the combined response length can
-		//exceed this block size or message size may be longer than max block size.
-		//Ancs chunks the response with only the first block containing the COMMAND_ID, and subsequent blocks containing only contiguous data
-		//To handle responses spanning multiple blocks, we maintain required information in mNotificationQueryInfo object.
-		//which is updated after reading a complete attribute or when a new block is received.
-		if (values[index] == COMMAND_ID_GET_NOTIFICATION_ATTRIBUTES)
-		{
-			//Case 1:Incoming block format [0:CommandId], [1-4: NotificationId],[5-vSize : attr1]
-			if (vSize < 8)
-			{
-				BT_DEBUG("ANCS data source characteristic value  has no attribute");
-				return;
-			}
-			int32_t notificationId = values[index + 1] | (values[index + 2] << 8) | (values[index + 3] << 16) | (values[index + 4] << 24);
-			index += 5;
-			BT_DEBUG("ANCS notificationId=%d", notificationId);
 
-		}
-		else if (mNotificationQueryInfo->remainingLen == -1 && mNotificationQueryInfo->readingAttr != MAX_UINT16)
+		NotificationIdQueryInfo *query = queue->processDataSourceValue(values);
+		if (query)
+			completeNotificationQuery(address, query);
+	}
+}
+
+BluetoothGattAncsQueryQueue* BluetoothGattAncsProfile::findQueryQueue(const std::string &address)
+{
+	auto queueIter = mQueryQueues.find(address);
+	if (queueIter == mQueryQueues.end())
+		return nullptr;
+
+	return queueIter->second;
+}
+
+void BluetoothGattAncsProfile::dispatchNotificationQueries(const std::string &address)
+{
+	BluetoothGattAncsQueryQueue *queue = findQueryQueue(address);
+	if (!queue)
+		return;
+
+	if (queue->isEmpty())
+	{
+		mQueryQueues.erase(address);
+		if (queue->getDataSourceWatchState() == ANCS_DATA_SOURCE_WATCH_ENABLED)
 		{
-			if (mNotificationQueryInfo->attrLenByte1 == MAX_UINT16)
-			{
-				//Case 3:Previous block: [0 to n :attr1-id-data][n+1 to (vSize -2): attr2 id and data][vsize-1: attr3 Id]
-				//		 Current block:  [0 and 1: attr3 len_bytes_1_2][[1-n: attr3 data]....
-				mNotificationQueryInfo->remainingLen = values[index] | (values[index + 1] << 8);
-				index += 2;
-			}
-			else
+			BT_DEBUG("[%s](%d) getImpl->changeCharacteristicWatchStatus\n", __FUNCTION__, __LINE__);
+			getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(address, mAncsUuid, BluetoothUuid(DATA_SOURCE_UUID), false, [this](BluetoothError error)
 			{
-				//Case 2:Previous block: [0 to n :attr1-id-data][n+1 to (vSize -2): attr2 id and data][vsize-2: attr3Id] [vsize-1: attr3 len_1st_byte]
-				//		 Current block:  [0 :attr3 len_2nd_byte][1-n: attr3 data]....
-				mNotificationQueryInfo->remainingLen = mNotificationQueryInfo->attrLenByte1 | values[index++] <<8;
-				mNotificationQueryInfo->attrLenByte1 = MAX_UINT16;
-			}
+				BT_DEBUG("All ANCS queries answered. Remove CharacteristicWatch for DATA_SOURCE_UUID");
+			});
 		}
-		if (mNotificationQueryInfo->remainingLen > 0  && mNotificationQueryInfo->readingAttr != MAX_UINT16)
-		{
-			//Case 4: [0 - x: data overflowed from previous block] [x+1 - vSize :attrN]
-			//Continuation of case 2 and case 3
-			for (auto attrStatus = mNotificationQueryInfo->attrList.begin(); attrStatus!=mNotificationQueryInfo->attrList.end(); attrStatus++)
-			{
-				if (attrStatus->attrId == mNotificationQueryInfo->readingAttr)
-				{
-					size_t len = mNotificationQueryInfo->remainingLen;
-					if (len > values.size())
-					{
-						mNotificationQueryInfo->remainingLen = len - values.size();
-						len = values.size();
-					}
-					else
-					{
-						mNotificationQueryInfo->remainingLen = -1;
-						attrStatus->found = true;
-						mNotificationQueryInfo->readingAttr = MAX_UINT16;
-					}
+		delete queue;
+		return;
+	}
 
-					attrStatus->value.append(values.begin() + index , values.begin()+ index + len);
-					index = index+len;
-					break;
-				}
-			}
-		}
+	// The Data Source has to be watched before the first command is written,
+	// otherwise the beginning of the answer is lost
+	if (queue->getDataSourceWatchState() == ANCS_DATA_SOURCE_WATCH_ENABLING)
+		return;
 
-		while(index < vSize)
+	if (queue->getDataSourceWatchState() == ANCS_DATA_SOURCE_WATCH_DISABLED)
+	{
+		queue->setDataSourceWatchState(ANCS_DATA_SOURCE_WATCH_ENABLING);
+
+		auto monitorCallback = [this, address] (BluetoothError error)
 		{
-			int32_t attrId = values[index++];
-			mNotificationQueryInfo->readingAttr = attrId;
-			if (index+1 >= vSize)
+			BT_INFO("ANCS", 0, "monitorCallback called with error %d for dataSourceUuid ", error);
+			BluetoothGattAncsQueryQueue *queue = findQueryQueue(address);
+			if (!queue)
 			{
-				//last byte was 1st byte of attrLen
-				mNotificationQueryInfo->attrLenByte1 = values[index++];
-				break;
+				// All queries failed while the watch was being enabled
+				if (error == BLUETOOTH_ERROR_NONE)
+					getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(address, mAncsUuid, BluetoothUuid(DATA_SOURCE_UUID), false, [](BluetoothError error) {});
+				return;
 			}
-			if (index >= vSize)
-			{ //last byte was attrId
-				break;
+
+			if (error != BLUETOOTH_ERROR_NONE)
+			{
+				queue->setDataSourceWatchState(ANCS_DATA_SOURCE_WATCH_DISABLED);
+				failNotificationQueries(address, BT_ERR_GATT_MONITOR_CHARACTERISTIC_FAIL);
+				return;
 			}
-			int32_t attributeLen = values[index] | (values[index + 1] << 8);
-			index += 2;
 
-			BT_DEBUG("attrId %d attributeLen %d", attrId, attributeLen);
+			queue->setDataSourceWatchState(ANCS_DATA_SOURCE_WATCH_ENABLED);
+			dispatchNotificationQueries(address);
+		};
 
-			std::string attrValue;
-			int valLen = (index + attributeLen >= vSize) ? (vSize - index) : attributeLen;
-			attrValue.assign(values.begin() + index, values.begin() + index + valLen);
+		BT_DEBUG("[%s](%d) getImpl->changeCharacteristicWatchStatus\n", __FUNCTION__, __LINE__);
+		getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(address, mAncsUuid, BluetoothUuid(DATA_SOURCE_UUID), true, monitorCallback);
+		return;
+	}
 
-			index = index + valLen;
+	NotificationIdQueryInfo *query = nullptr;
+	while ((query = queue->takeNextToWrite()))
+		writeNotificationQuery(address, query);
+}
 
-			for (auto attrStatus = mNotificationQueryInfo->attrList.begin(); attrStatus != mNotificationQueryInfo->attrList.end(); attrStatus++)
-			{
-				if (attrStatus->attrId == attrId)
-				{
-					attrStatus->value = attrValue;
-					if (valLen == attributeLen)
-					{
-						attrStatus->found = true;
-						mNotificationQueryInfo->readingAttr = MAX_UINT16;
-						BT_DEBUG("attributeId %d, value %s", attrId, attrValue.c_str());
-					}
-					mNotificationQueryInfo->remainingLen = attributeLen - valLen;
-					break;
-				}
-			}
-		}
-		//compose the response
-		bool foundAllAttributes = true;
-		for (auto attrStatus = mNotificationQueryInfo->attrList.begin(); attrStatus != mNotificationQueryInfo->attrList.end(); attrStatus++)
+bool BluetoothGattAncsProfile::parseQueryAttributes(pbnjson::JValue attributesObj, NotificationIdQueryInfo *query)
+{
+	for (int j = 0; j < attributesObj.arraySize(); j++)
+	{
+		auto attr = attributesObj[j];
+		int32_t id = attr["attributeId"].asNumber<int32_t>();
+		if (id < 0 || id > MAX_CHAR)
+			return false;
+
+		int32_t len = 0;
+		if (attr.hasKey("length"))
 		{
-			if (!attrStatus->found)
-			{
-				foundAllAttributes = false;
-			}
+			len = attr["length"].asNumber<int32_t>();
+			if (len < 0 || len > MAX_UINT16)
+				return false;
 		}
+		query->attrList.push_back(NotificationAttr(id, len));
+	}
 
-		if (foundAllAttributes)
-		{
-			pbnjson::JValue attributeListObj = pbnjson::Array();
-			for (auto attrStatus = mNotificationQueryInfo->attrList.begin(); attrStatus != mNotificationQueryInfo->attrList.end(); attrStatus++)
-			{
-				pbnjson::JValue attrObj = pbnjson::Object();
-				attrObj.put("attributeId", attrStatus->attrId);
-				attrObj.put("value", attrStatus->value);
-				attributeListObj.append(attrObj);
-			}
-			pbnjson::JValue responseObj = pbnjson::Object();
-			responseObj.put("returnValue", true);
-			responseObj.put("adapterAddress", getManager()->getAddress());
-			responseObj.put("address", address);
-			responseObj.put("attributes", attributeListObj);
-			responseObj.put("subscribed", false);
+	return true;
+}
 
-			LSUtils::postToClient(mNotificationQueryInfo->requestMessage, responseObj);
+bool BluetoothGattAncsProfile::resolveCachedAttributes(NotificationIdQueryInfo *query)
+{
+	bool foundAllAttributes = true;
 
-			LSMessageUnref(mNotificationQueryInfo->requestMessage);
-			DELETE_OBJ(mNotificationQueryInfo)
+	for (auto &attr : query->attrList)
+	{
+		if (query->commandId == COMMAND_ID_GET_APP_ATTRIBUTES)
+			attr.cached = mAttributeCache.lookupAppAttribute(query->deviceAddress, query->appIdentifier, attr.attrId, attr.maxLength, attr.value);
+		else
+			attr.cached = mAttributeCache.lookupNotificationAttribute(query->deviceAddress, query->notificationId, attr.attrId, attr.maxLength, attr.value);
 
-			BT_DEBUG("[%s](%d) getImpl->changeCharacteristicWatchStatus\n", __FUNCTION__, __LINE__);
-			getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus (address, mAncsUuid, BluetoothUuid(DATA_SOURCE_UUID), false, [this](BluetoothError error)
-			{
-			      BT_DEBUG("Found all attributes. Remove CharacteristicWatch for DATA_SOURCE_UUID");
-			});
+		attr.found = attr.cached;
+		if (!attr.found)
+			foundAllAttributes = false;
+	}
+
+	return foundAllAttributes;
+}
+
+void BluetoothGattAncsProfile::buildQueryCommand(NotificationIdQueryInfo *query)
+{
+	query->command.clear();
+	query->command.push_back(query->commandId);
+
+	if (query->commandId == COMMAND_ID_GET_APP_ATTRIBUTES)
+	{
+		query->command.insert(query->command.end(), query->appIdentifier.begin(), query->appIdentifier.end());
+		query->command.push_back(0);
+	}
+	else
+	{
+		query->command.push_back(query->notificationId & 0xff);
+		query->command.push_back(query->notificationId >> 8 & 0xff);
+		query->command.push_back(query->notificationId >> 16 & 0xff);
+		query->command.push_back(query->notificationId >> 24 & 0xff);
+	}
+
+	// Attributes answered from the cache are not asked for again
+	for (auto &attr : query->attrList)
+	{
+		if (attr.found)
+			continue;
+
+		query->command.push_back(attr.attrId);
+		if (attr.maxLength)
+		{
+			query->command.push_back(attr.maxLength & 0xff);
+			query->command.push_back((attr.maxLength >> 8) & 0xff);
 		}
 	}
 }
 
+void BluetoothGattAncsProfile::enqueueNotificationQuery(NotificationIdQueryInfo *query)
+{
+	std::string address = query->deviceAddress;
+
+	BluetoothGattAncsQueryQueue *queue = findQueryQueue(address);
+	if (!queue)
+	{
+		queue = new BluetoothGattAncsQueryQueue(address,
+				std::bind(&BluetoothGattAncsProfile::handleNotificationQueryTimeout, this, address, _1));
+		mQueryQueues.insert(std::pair<std::string, BluetoothGattAncsQueryQueue*>(address, queue));
+	}
+	queue->push(query);
+
+	dispatchNotificationQueries(address);
+}
+
+void BluetoothGattAncsProfile::writeNotificationQuery(const std::string &address, NotificationIdQueryInfo *query)
+{
+	BluetoothGattCharacteristic controlPointCharacteristic;
+	controlPointCharacteristic.setUuid(BluetoothUuid(CONTROL_POINT_UUID));
+	controlPointCharacteristic.setValue(query->command);
+
+	int32_t notificationId = query->notificationId;
+
+	auto writeCharacteristicCallback = [this, address, notificationId](BluetoothError error)
+	{
+		BT_INFO("ANCS", 0, "writeCharacteristicCallback called with error %d for notification %d", error, notificationId);
+		if (error == BLUETOOTH_ERROR_NONE)
+			return;
+
+		BluetoothGattAncsQueryQueue *queue = findQueryQueue(address);
+		if (!queue)
+			return;
+
+		// The query might have been answered or timed out in the meantime
+		NotificationIdQueryInfo *query = queue->find(notificationId);
+		if (!query || !query->written)
+			return;
+
+		queue->remove(query);
+		failNotificationQuery(query, BT_ERR_GATT_WRITE_CHARACTERISTIC_FAIL);
+		dispatchNotificationQueries(address);
+	};
+
+	BT_DEBUG("[%s](%d) getImpl->writeCharacteristic\n", __FUNCTION__, __LINE__);
+	getImpl<BluetoothGattProfile>()->writeCharacteristic(address, mAncsUuid, controlPointCharacteristic, writeCharacteristicCallback);
+}
+
+void BluetoothGattAncsProfile::completeNotificationQuery(const std::string &address, NotificationIdQueryInfo *query)
+{
+	pbnjson::JValue attributeListObj = pbnjson::Array();
+	for (auto attrStatus = query->attrList.begin(); attrStatus != query->attrList.end(); attrStatus++)
+	{
+		pbnjson::JValue attrObj = pbnjson::Object();
+		attrObj.put("attributeId", attrStatus->attrId);
+		attrObj.put("value", attrStatus->value);
+		attributeListObj.append(attrObj);
+
+		if (attrStatus->cached)
+			continue;
+
+		if (query->commandId == COMMAND_ID_GET_APP_ATTRIBUTES)
+			mAttributeCache.storeAppAttribute(address, query->appIdentifier, attrStatus->attrId, attrStatus->maxLength, attrStatus->value);
+		else
+			mAttributeCache.storeNotificationAttribute(address, query->notificationId, attrStatus->attrId, attrStatus->maxLength, attrStatus->value);
+	}
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("adapterAddress", getManager()->getAddress());
+	responseObj.put("address", address);
+	responseObj.put("attributes", attributeListObj);
+	if (query->commandId == COMMAND_ID_GET_APP_ATTRIBUTES)
+		responseObj.put("appIdentifier", query->appIdentifier);
+	else
+		responseObj.put("subscribed", false);
+
+	LSUtils::postToClient(query->requestMessage, responseObj);
+
+	LSMessageUnref(query->requestMessage);
+	DELETE_OBJ(query)
+
+	dispatchNotificationQueries(address);
+}
+
+void BluetoothGattAncsProfile::failNotificationQuery(NotificationIdQueryInfo *query, BluetoothErrorCode errorCode)
+{
+	LSUtils::respondWithError(query->requestMessage, errorCode, true);
+
+	LSMessageUnref(query->requestMessage);
+	DELETE_OBJ(query)
+}
+
+void BluetoothGattAncsProfile::failNotificationQueries(const std::string &address, BluetoothErrorCode errorCode)
+{
+	BluetoothGattAncsQueryQueue *queue = findQueryQueue(address);
+	if (!queue)
+		return;
+
+	mQueryQueues.erase(address);
+
+	NotificationIdQueryInfo *query = nullptr;
+	while ((query = queue->takeFirst()))
+		failNotificationQuery(query, errorCode);
+
+	delete queue;
+}
+
+void BluetoothGattAncsProfile::handleNotificationQueryTimeout(const std::string &address, NotificationIdQueryInfo *query)
+{
+	failNotificationQuery(query, BT_ERR_ANCS_QUERY_TIMEOUT);
+	dispatchNotificationQueries(address);
+}
+
 /**
  This method will monitor for any notifications added, modified or removed on the connected iOS device.
 
@@ -1059,38 +1251,31 @@ bool BluetoothGattAncsProfile::queryNotificationAttributes(LSMessage &message)
 
 	std::string deviceAddress = requestObj["address"].asString();
 
-	if (mNotificationQueryInfo)
+	if (!isDeviceConnected(deviceAddress))
 	{
-		time_t currTime;
-		time(&currTime);
-		if (difftime(currTime, mNotificationQueryInfo->startTime) > MESSAGE_TIMEOUT)
-		{
-			//Notify other Query Subscriber of the timeout by setting subscribe status to false
-			pbnjson::JValue responseObj = pbnjson::Object();
-			responseObj.put("returnValue", false);
-			responseObj.put("subscribed", false);
-			responseObj.put("adapterAddress", getManager()->getAddress());
-			responseObj.put("address", deviceAddress);
-			LSUtils::postToSubscriptionPoint(&mQueryNotificationSubscription, responseObj);
+		LSUtils::respondWithError(request, BT_ERR_PROFILE_NOT_CONNECTED);
+		return true;
+	}
 
-			LSMessageUnref(mNotificationQueryInfo->requestMessage);
-			DELETE_OBJ(mNotificationQueryInfo)
-		}
-		else
+	int32_t notificationId = requestObj["notificationId"].asNumber<int32_t>();
+
+	BluetoothGattAncsQueryQueue *queue = findQueryQueue(deviceAddress);
+	if (queue)
+	{
+		// Answers are told apart by their notification UID only
+		if (queue->find(notificationId))
 		{
 			LSUtils::respondWithError(request, BT_ERR_ALLOW_ONE_ANCS_QUERY);
 			return true;
 		}
-	}
 
-	if (!isDeviceConnected(deviceAddress))
-	{
-		LSUtils::respondWithError(request, BT_ERR_PROFILE_NOT_CONNECTED);
-		return true;
+		if (queue->getDepth() >= ANCS_MAX_PENDING_QUERIES)
+		{
+			LSUtils::respondWithError(request, BT_ERR_ANCS_QUERY_QUEUE_FULL);
+			return true;
+		}
 	}
 
-	int32_t notificationId = requestObj["notificationId"].asNumber<int32_t>();
-
 	pbnjson::JValue attributesObj;
 	if (requestObj.hasKey("attributes"))
 	{
@@ -1103,113 +1288,17 @@ bool BluetoothGattAncsProfile::queryNotificationAttributes(LSMessage &message)
 		return true;
 	}
 
-	BluetoothGattValue value;
-	value.push_back(COMMAND_ID_GET_NOTIFICATION_ATTRIBUTES);
-	//TODO: is &0xff necessary?
-
-	value.push_back(notificationId & 0xff);
-	value.push_back(notificationId >> 8 & 0xff);
-	value.push_back(notificationId >> 16 & 0xff);
-	value.push_back(notificationId >> 24 & 0xff);
-
-	mNotificationQueryInfo = new NotificationIdQueryInfo();
-	mNotificationQueryInfo->readingAttr = MAX_UINT16;
-	mNotificationQueryInfo->attrLenByte1 = MAX_UINT16;
-	mNotificationQueryInfo->deviceAddress = deviceAddress;
-	mNotificationQueryInfo->notificationId = notificationId;
-	mNotificationQueryInfo->remainingLen = -1;
+	NotificationIdQueryInfo *query = new NotificationIdQueryInfo();
+	query->deviceAddress = deviceAddress;
+	query->notificationId = notificationId;
 
-	for (int j = 0; j < attributesObj.arraySize(); j++)
+	if (!parseQueryAttributes(attributesObj, query))
 	{
-		auto attr = attributesObj[j];
-		int32_t id = attr["attributeId"].asNumber<int32_t>();
-		if (id > MAX_CHAR)
-		{
-			LSUtils::respondWithError(request, BT_ERR_ANCS_ATTRIBUTE_PARAM_INVAL);
-			DELETE_OBJ(mNotificationQueryInfo)
-			return true;
-		}
-		value.push_back(id);
-
-		if (attr.hasKey("length"))
-		{
-			int32_t len = attr["length"].asNumber<int32_t>();
-			if (len > MAX_UINT16)
-			{
-				LSUtils::respondWithError(request, BT_ERR_ANCS_ATTRIBUTE_PARAM_INVAL);
-				DELETE_OBJ(mNotificationQueryInfo)
-				return true;
-			}
-			value.push_back(len & 0xff);
-			value.push_back((len >> 8) & 0xff);
-		}
-		mNotificationQueryInfo->attrList.push_back(NotificationAttr(id));
+		LSUtils::respondWithError(request, BT_ERR_ANCS_ATTRIBUTE_PARAM_INVAL);
+		DELETE_OBJ(query)
+		return true;
 	}
 
-	BluetoothGattCharacteristic controlPointCharacteristic;
-	controlPointCharacteristic.setUuid(BluetoothUuid(CONTROL_POINT_UUID));
-	controlPointCharacteristic.setValue(value);
-
-	LSMessage *requestMessage = request.get();
-	LSMessageRef(requestMessage);
-
-	auto monitorCallback = [this, requestMessage, adapterAddress, deviceAddress] (BluetoothError error)
-		{
-			BT_INFO("ANCS", 0, "monitorCallback called with error %d for dataSourceUuid ", error);
-			if (error != BLUETOOTH_ERROR_NONE)
-			{
-				LSUtils::respondWithError(requestMessage, retrieveErrorText(BT_ERR_GATT_MONITOR_CHARACTERISTIC_FAIL) + DATA_SOURCE_UUID, BT_ERR_GATT_MONITOR_CHARACTERISTIC_FAIL, true);
-			}
-			LSMessageUnref(requestMessage);
-
-		    return;
-
-	};
-	BT_DEBUG("[%s](%d) getImpl->changeCharacteristicWatchStatus\n", __FUNCTION__, __LINE__);
-	getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(deviceAddress, mAncsUuid, BluetoothUuid(DATA_SOURCE_UUID), true, monitorCallback);
-
-	time(&mNotificationQueryInfo->startTime);
-	mNotificationQueryInfo->requestMessage = request.get();
-	LSMessageRef(mNotificationQueryInfo->requestMessage);
-
-
-	AncsServiceCheckTimeout *timeoutData = new AncsServiceCheckTimeout();
-	timeoutData->serviceRef = this;
-	timeoutData->requestMessage = request.get();
-	LSMessageRef(timeoutData->requestMessage);
-	timeoutData->adapterAddress = adapterAddress;
-	timeoutData->address = deviceAddress;
-	timeoutData->characteristic = BluetoothGattCharacteristic (controlPointCharacteristic);
-
-	auto serviceTimeoutCallback = [] (gpointer timeout_data) -> gboolean
-		{
-			BT_INFO("ANCS", 0, "ANCS Gatt serviceTimeoutCallback");
-			AncsServiceCheckTimeout* timeoutData = static_cast<AncsServiceCheckTimeout*>(timeout_data);
-			BluetoothGattAncsProfile* thisRef = static_cast<BluetoothGattAncsProfile*>(timeoutData->serviceRef);
-
-			auto writeCharacteristicCallback = [timeoutData](BluetoothError error)
-			{
-				BT_INFO("ANCS", 0, "writeCharacteristicCallback called with error %d for characteristic %s", error, timeoutData->characteristic.getUuid().toString().c_str());
-				if (error != BLUETOOTH_ERROR_NONE)
-				{
-					LSUtils::respondWithError(timeoutData->requestMessage, BT_ERR_GATT_WRITE_CHARACTERISTIC_FAIL);
-
-					LSMessageUnref(timeoutData->serviceRef->mNotificationQueryInfo->requestMessage);
-					DELETE_OBJ (timeoutData->serviceRef->mNotificationQueryInfo)
-				}
-
-				LSMessageUnref(timeoutData->requestMessage);
-				delete timeoutData;
-			};
-
-			BT_DEBUG("[%s](%d) getImpl->writeCharacteristic\n", __FUNCTION__, __LINE__);
-			thisRef->getImpl<BluetoothGattProfile>()->writeCharacteristic(timeoutData->address, thisRef->mAncsUuid, timeoutData->characteristic, writeCharacteristicCallback);
-
-			return true;
-		};
-
-	g_timeout_add_seconds(WRITE_TIMEOUT, (GSourceFunc) serviceTimeoutCallback, (gpointer) timeoutData);
-
 	mQueryNotificationSubscription.setServiceHandle(getManager());
 	mQueryNotificationSubscription.subscribe(request);
 
@@ -1220,6 +1309,18 @@ bool BluetoothGattAncsProfile::queryNotificationAttributes(LSMessage &message)
 
 	LSUtils::postToClient(request, responseObj);
 
+	query->requestMessage = request.get();
+	LSMessageRef(query->requestMessage);
+
+	if (resolveCachedAttributes(query))
+	{
+		completeNotificationQuery(deviceAddress, query);
+		return true;
+	}
+
+	buildQueryCommand(query);
+	enqueueNotificationQuery(query);
+
 	return true;
 }
 
@@ -1335,8 +1436,142 @@ bool BluetoothGattAncsProfile::performNotificationAction(LSMessage &message)
 }
 
 
+/**
+ Query attributes of an app installed on the connected iOS device, e.g. its display name.
+
+ @par Parameters
+
+ Name | Required | Type | Description
+ -----|--------|------|----------
+ adapterAddress | No | String | Address of the adapter executing this method.
+ address | Yes | String | The address (bdaddr) of the remote device.
+ appIdentifier | Yes | String | App identifier as returned by the notification attribute 0 (AppIdentifier).
+ attributes| Yes | Array of bluetooth2ANCSAttributeRequestObject
+
+ @par Returns(Call)
+
+ Name | Required | Type | Description
+ -----|--------|------|----------
+ returnValue | Yes | Boolean | Value is true if the attributes could be retrieved, false otherwise.
+ adapterAddress | Yes | String | Address of the adapter executing this method.
+ address | Yes | String | The address (bdaddr) of the remote device.
+ appIdentifier | Yes | String | App identifier being queried.
+ attributes| Yes | bluetooth2ANCSAttributeResponseObject | Value of attribute being queried.
+ errorText | No | String | errorText contains the error text if the method fails. The method will return errorText only if it fails.
+ errorCode | No | Number | errorCode contains the error code if the method fails. The method will return errorCode only if it fails.
+
+ @par Returns(Subscription)
+
+ Not applicable.
+
+ */
 bool BluetoothGattAncsProfile::queryAppAttributes(LSMessage &message)
 {
+	BT_INFO("ANCS", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!mImpl)
+	{
+		LSUtils::respondWithError(request, BT_ERR_PROFILE_UNAVAIL);
+		return true;
+	}
+	const std::string schema = STRICT_SCHEMA(PROPS_4(PROP(address, string), PROP(adapterAddress, string), PROP(appIdentifier, string),
+			           OBJARRAY(attributes, OBJSCHEMA_2(PROP(attributeId, integer), PROP(length, integer))))
+			           REQUIRED_3(address, appIdentifier, attributes));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+
+		else if (!requestObj.hasKey("address"))
+			LSUtils::respondWithError(request, BT_ERR_ADDR_PARAM_MISSING);
+
+		else if (!requestObj.hasKey("appIdentifier"))
+			LSUtils::respondWithError(request, BT_ERR_ANCS_APPID_PARAM_MISSING);
+
+		else if (!requestObj.hasKey("attributes"))
+			LSUtils::respondWithError(request, BT_ERR_ANCS_ATTRIBUTELIST_PARAM_MISSING);
+
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	if (requestObj.hasKey("adapterAddress"))
+	{
+		std::string adapterAddress = requestObj["adapterAddress"].asString();
+		if (!getManager()->isAdapterAvailable(adapterAddress))
+		{
+			LSUtils::respondWithError(request, BT_ERR_INVALID_ADAPTER_ADDRESS);
+			return true;
+		}
+	}
+
+	std::string deviceAddress = requestObj["address"].asString();
+	if (!isDeviceConnected(deviceAddress))
+	{
+		LSUtils::respondWithError(request, BT_ERR_PROFILE_NOT_CONNECTED);
+		return true;
+	}
+
+	std::string appIdentifier = requestObj["appIdentifier"].asString();
+	if (appIdentifier.empty())
+	{
+		LSUtils::respondWithError(request, BT_ERR_ANCS_APPID_PARAM_MISSING);
+		return true;
+	}
+
+	BluetoothGattAncsQueryQueue *queue = findQueryQueue(deviceAddress);
+	if (queue)
+	{
+		if (queue->findApp(appIdentifier))
+		{
+			LSUtils::respondWithError(request, BT_ERR_ALLOW_ONE_ANCS_QUERY);
+			return true;
+		}
+
+		if (queue->getDepth() >= ANCS_MAX_PENDING_QUERIES)
+		{
+			LSUtils::respondWithError(request, BT_ERR_ANCS_QUERY_QUEUE_FULL);
+			return true;
+		}
+	}
+
+	pbnjson::JValue attributesObj = requestObj["attributes"];
+	if (attributesObj.arraySize() < 1)
+	{
+		LSUtils::respondWithError(request, BT_ERR_ANCS_ATTRIBUTELIST_PARAM_MISSING);
+		return true;
+	}
+
+	NotificationIdQueryInfo *query = new NotificationIdQueryInfo();
+	query->deviceAddress = deviceAddress;
+	query->commandId = COMMAND_ID_GET_APP_ATTRIBUTES;
+	query->appIdentifier = appIdentifier;
+
+	if (!parseQueryAttributes(attributesObj, query))
+	{
+		LSUtils::respondWithError(request, BT_ERR_ANCS_ATTRIBUTE_PARAM_INVAL);
+		DELETE_OBJ(query)
+		return true;
+	}
+
+	query->requestMessage = request.get();
+	LSMessageRef(query->requestMessage);
+
+	if (resolveCachedAttributes(query))
+	{
+		completeNotificationQuery(deviceAddress, query);
+		return true;
+	}
+
+	buildQueryCommand(query);
+	enqueueNotificationQuery(query);
+
 	return true;
 }
 
@@ -19,6 +19,9 @@
 #define BLUETOOTHGATTANCSPROFILE_H_
 
 #include "bluetoothgattprofileservice.h"
+#include "bluetoothgattancsqueryqueue.h"
+#include "bluetoothgattancsdecoder.h"
+#include "bluetoothgattancsattributecache.h"
 #include <bluetooth-sil-api.h>
 #include <luna-service2/lunaservice.hpp>
 
@@ -29,6 +32,9 @@
 #define CONTROL_POINT_UUID        "69d1d8f3-45e1-49a8-9821-9bbdfdaad9d9"
 #define DATA_SOURCE_UUID          "22eac6e9-24d6-4bb5-be44-b36ace7c7bfb"
 
+#define ANCS_EVENT_ID_NOTIFICATION_MODIFIED 1
+#define ANCS_EVENT_ID_NOTIFICATION_REMOVED  2
+
 #define ANCS_STATUS_MIN_RESERVED_VALUE 3
 #define ANCS_STATUS_MAX_RESERVED_VALUE 255
 
@@ -58,20 +64,46 @@ public:
 	uint8_t attrId;
 	std::string value;
 	bool found =false;
-	NotificationAttr(uint8_t id) : attrId(id), found(false) {}
+	// Length limit sent with the attribute id, 0 if there is none
+	uint16_t maxLength;
+	bool cached;
+	NotificationAttr(uint8_t id, uint16_t length = 0) : attrId(id), found(false), maxLength(length), cached(false) {}
 };
 
-class NotificationIdQueryInfo
+class NotificationIdQueryInfo : public BluetoothGattAncsAttributeSink
 {
 public:
+	NotificationIdQueryInfo() :
+		commandId(COMMAND_ID_GET_NOTIFICATION_ATTRIBUTES),
+		notificationId(0),
+		startTime(0),
+		written(false),
+		requestMessage(nullptr)
+	{
+	}
+
+	bool hasAllAttributes() const;
+
+	void attributeStarted(uint8_t attrId, uint16_t length);
+	void attributeData(uint8_t attrId, const uint8_t *data, size_t length);
+	void attributeCompleted(uint8_t attrId);
+
 	std::string deviceAddress;
+	// Get Notification Attributes or Get App Attributes
+	uint8_t commandId;
 	int32_t notificationId;
+	std::string appIdentifier;
 	std::vector <NotificationAttr> attrList;
-	uint16_t readingAttr;
-	uint16_t attrLenByte1;
-	int remainingLen;
+	// Reassembly state of the answer on the Data Source
+	BluetoothGattAncsDecoder decoder;
 	time_t startTime;
+	// Get Notification Attributes command for the Control Point
+	BluetoothGattValue command;
+	bool written;
 	LSMessage *requestMessage;
+
+private:
+	NotificationAttr* findAttribute(uint8_t attrId);
 } ;
 
 class BluetoothGattAncsProfile: public BluetoothGattProfileService {
@@ -104,6 +136,17 @@ private:
 	bool isAncsServiceSupported(LSMessage *message, std::string adapterAddress, std::string address);
 
 	void handleNotificationClientDisappeared(const std::string &adapterAddress, const std::string &address);
+	BluetoothGattAncsQueryQueue* findQueryQueue(const std::string &address);
+	bool parseQueryAttributes(pbnjson::JValue attributesObj, NotificationIdQueryInfo *query);
+	bool resolveCachedAttributes(NotificationIdQueryInfo *query);
+	void buildQueryCommand(NotificationIdQueryInfo *query);
+	void enqueueNotificationQuery(NotificationIdQueryInfo *query);
+	void dispatchNotificationQueries(const std::string &address);
+	void writeNotificationQuery(const std::string &address, NotificationIdQueryInfo *query);
+	void completeNotificationQuery(const std::string &address, NotificationIdQueryInfo *query);
+	void failNotificationQuery(NotificationIdQueryInfo *query, BluetoothErrorCode errorCode);
+	void failNotificationQueries(const std::string &address, BluetoothErrorCode errorCode);
+	void handleNotificationQueryTimeout(const std::string &address, NotificationIdQueryInfo *query);
 
 	//Observer callback
 	void incomingLeConnectionRequest(const std::string &address, bool state);
@@ -114,7 +157,8 @@ private:
 	LS::SubscriptionPoint mQueryNotificationSubscription;
 	std::unordered_map<std::string, LSUtils::ClientWatch*> mNotificationWatches;
 	std::unordered_map<std::string, LS::SubscriptionPoint*> mAwaitNotificationSubscriptions;
-	NotificationIdQueryInfo *mNotificationQueryInfo;
+	std::unordered_map<std::string, BluetoothGattAncsQueryQueue*> mQueryQueues;
+	BluetoothGattAncsAttributeCache mAttributeCache;
 	BluetoothUuid mAncsUuid;
 };
 
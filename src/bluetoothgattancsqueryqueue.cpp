@@ -0,0 +1,259 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "bluetoothgattancsqueryqueue.h"
+#include "bluetoothgattancsprofile.h"
+#include "logging.h"
+
+#include <algorithm>
+#include <ctime>
+
+BluetoothGattAncsQueryQueue::BluetoothGattAncsQueryQueue(const std::string &address, AncsQueryTimeoutCallback timeoutCallback) :
+	mAddress(address),
+	mTimeoutCallback(timeoutCallback),
+	mInFlight(0),
+	mReceiving(nullptr),
+	mDataSourceWatchState(ANCS_DATA_SOURCE_WATCH_DISABLED),
+	mTimeout(0)
+{
+}
+
+BluetoothGattAncsQueryQueue::~BluetoothGattAncsQueryQueue()
+{
+	if (mTimeout)
+		g_source_remove(mTimeout);
+
+	for (auto query : mQueries)
+	{
+		LSMessageUnref(query->requestMessage);
+		delete query;
+	}
+	mQueries.clear();
+}
+
+void BluetoothGattAncsQueryQueue::push(NotificationIdQueryInfo *query)
+{
+	mQueries.push_back(query);
+
+	BT_DEBUG("Queued ANCS query for notification %d of %s (depth %zu)", query->notificationId, mAddress.c_str(), mQueries.size());
+}
+
+NotificationIdQueryInfo* BluetoothGattAncsQueryQueue::find(int32_t notificationId) const
+{
+	for (auto query : mQueries)
+	{
+		if (query->commandId == COMMAND_ID_GET_NOTIFICATION_ATTRIBUTES && query->notificationId == notificationId)
+			return query;
+	}
+
+	return nullptr;
+}
+
+NotificationIdQueryInfo* BluetoothGattAncsQueryQueue::findApp(const std::string &appIdentifier) const
+{
+	for (auto query : mQueries)
+	{
+		if (query->commandId == COMMAND_ID_GET_APP_ATTRIBUTES && query->appIdentifier == appIdentifier)
+			return query;
+	}
+
+	return nullptr;
+}
+
+NotificationIdQueryInfo* BluetoothGattAncsQueryQueue::takeNextToWrite()
+{
+	if (mInFlight >= ANCS_QUERY_PIPELINE_DEPTH)
+		return nullptr;
+
+	for (auto query : mQueries)
+	{
+		if (query->written)
+			continue;
+
+		query->written = true;
+		time(&query->startTime);
+		mInFlight++;
+
+		if (!mTimeout)
+			restartTimeout();
+
+		return query;
+	}
+
+	return nullptr;
+}
+
+void BluetoothGattAncsQueryQueue::remove(NotificationIdQueryInfo *query)
+{
+	for (auto queryIter = mQueries.begin(); queryIter != mQueries.end(); queryIter++)
+	{
+		if (*queryIter != query)
+			continue;
+
+		mQueries.erase(queryIter);
+		if (query->written)
+			mInFlight--;
+		if (mReceiving == query)
+			mReceiving = nullptr;
+
+		break;
+	}
+
+	if (mInFlight == 0 && mTimeout)
+	{
+		g_source_remove(mTimeout);
+		mTimeout = 0;
+	}
+}
+
+NotificationIdQueryInfo* BluetoothGattAncsQueryQueue::takeFirst()
+{
+	if (mQueries.empty())
+		return nullptr;
+
+	NotificationIdQueryInfo *query = mQueries.front();
+	remove(query);
+
+	return query;
+}
+
+void BluetoothGattAncsQueryQueue::restartTimeout()
+{
+	if (mTimeout)
+		g_source_remove(mTimeout);
+
+	mTimeout = g_timeout_add_seconds(MESSAGE_TIMEOUT, &BluetoothGattAncsQueryQueue::handleQueryTimeout, this);
+}
+
+gboolean BluetoothGattAncsQueryQueue::handleQueryTimeout(gpointer userData)
+{
+	BluetoothGattAncsQueryQueue *queue = static_cast<BluetoothGattAncsQueryQueue*>(userData);
+	if (!queue)
+		return FALSE;
+
+	queue->mTimeout = 0;
+
+	// Answers arrive in the order the commands were written, so the
+	// oldest written query is the one the phone got stuck on
+	NotificationIdQueryInfo *query = nullptr;
+	for (auto pending : queue->mQueries)
+	{
+		if (pending->written)
+		{
+			query = pending;
+			break;
+		}
+	}
+
+	if (!query)
+		return FALSE;
+
+	BT_WARNING(MSGID_GATT_OPERATION_TIMEOUT, 0, "ANCS query for notification %d of %s timed out",
+	           query->notificationId, queue->mAddress.c_str());
+
+	queue->remove(query);
+	if (queue->mInFlight > 0)
+		queue->restartTimeout();
+
+	if (queue->mTimeoutCallback)
+		queue->mTimeoutCallback(query);
+
+	return FALSE;
+}
+
+NotificationIdQueryInfo* BluetoothGattAncsQueryQueue::matchResponseStart(const BluetoothGattValue &values, int32_t &index) const
+{
+	// In the middle of an attribute the block can only be a continuation
+	if (values.empty() || (mReceiving && !mReceiving->decoder.isBetweenAttributes()))
+		return nullptr;
+
+	if (values[0] == COMMAND_ID_GET_NOTIFICATION_ATTRIBUTES && values.size() >= 5)
+	{
+		int32_t notificationId = values[1] | (values[2] << 8) | (values[3] << 16) | (values[4] << 24);
+		NotificationIdQueryInfo *query = find(notificationId);
+		if (!query || !query->written)
+			return nullptr;
+
+		index = 5;
+		return query;
+	}
+
+	if (values[0] == COMMAND_ID_GET_APP_ATTRIBUTES)
+	{
+		// [0: CommandId] [1-n: AppIdentifier] [n+1: NUL]
+		auto identifierBegin = values.begin() + 1;
+		auto terminator = std::find(identifierBegin, values.end(), 0);
+		if (terminator == values.end())
+			return nullptr;
+
+		size_t identifierLen = terminator - identifierBegin;
+		for (auto query : mQueries)
+		{
+			if (query->commandId != COMMAND_ID_GET_APP_ATTRIBUTES || !query->written ||
+			    query->appIdentifier.length() != identifierLen ||
+			    !std::equal(identifierBegin, terminator, query->appIdentifier.begin()))
+				continue;
+
+			index = terminator - values.begin() + 1;
+			return query;
+		}
+	}
+
+	return nullptr;
+}
+
+/*
+ * Answers are longer than one ATT notification in most cases; only the
+ * first block starts with the command id and the notification UID or app
+ * identifier, the following ones carry the rest of the attribute list,
+ * which the decoder of the receiving query picks up where the previous
+ * block ended.
+ */
+NotificationIdQueryInfo* BluetoothGattAncsQueryQueue::processDataSourceValue(const BluetoothGattValue &values)
+{
+	int32_t index = 0;
+
+	NotificationIdQueryInfo *started = matchResponseStart(values, index);
+	if (started)
+	{
+		mReceiving = started;
+		mReceiving->decoder.reset();
+
+		BT_DEBUG("ANCS answer for notification %d (app '%s') of %s started", mReceiving->notificationId,
+		         mReceiving->appIdentifier.c_str(), mAddress.c_str());
+	}
+	else if (!mReceiving)
+	{
+		BT_DEBUG("Dropping ANCS data source block of %s without a pending query", mAddress.c_str());
+		return nullptr;
+	}
+
+	NotificationIdQueryInfo *query = mReceiving;
+	query->decoder.feed(values.data() + index, values.size() - index, *query);
+
+	if (!query->hasAllAttributes())
+		return nullptr;
+
+	remove(query);
+
+	// The phone made progress, give the remaining queries a fresh timeout
+	if (mInFlight > 0)
+		restartTimeout();
+
+	return query;
+}
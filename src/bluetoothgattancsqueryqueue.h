@@ -0,0 +1,91 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef BLUETOOTHGATTANCSQUERYQUEUE_H
+#define BLUETOOTHGATTANCSQUERYQUEUE_H
+
+#include <string>
+#include <deque>
+#include <functional>
+#include <bluetooth-sil-api.h>
+#include <glib.h>
+
+// Number of Get Notification Attributes commands written to the Control
+// Point before the first of them is answered on the Data Source
+#define ANCS_QUERY_PIPELINE_DEPTH 4
+#define ANCS_MAX_PENDING_QUERIES  32
+
+class NotificationIdQueryInfo;
+
+enum AncsDataSourceWatchState
+{
+	ANCS_DATA_SOURCE_WATCH_DISABLED = 0,
+	ANCS_DATA_SOURCE_WATCH_ENABLING,
+	ANCS_DATA_SOURCE_WATCH_ENABLED
+};
+
+typedef std::function<void(NotificationIdQueryInfo *query)> AncsQueryTimeoutCallback;
+
+/*
+ * Pending notification attribute queries of one iOS device. Up to
+ * ANCS_QUERY_PIPELINE_DEPTH commands are outstanding at a time. The phone
+ * answers them one after the other on the Data Source; the first block of
+ * an answer carries the notification UID (or app identifier) and selects
+ * the query the following blocks are reassembled into.
+ */
+class BluetoothGattAncsQueryQueue
+{
+public:
+	BluetoothGattAncsQueryQueue(const std::string &address, AncsQueryTimeoutCallback timeoutCallback);
+	BluetoothGattAncsQueryQueue(const BluetoothGattAncsQueryQueue &other) = delete;
+	~BluetoothGattAncsQueryQueue();
+
+	void push(NotificationIdQueryInfo *query);
+	NotificationIdQueryInfo* find(int32_t notificationId) const;
+	NotificationIdQueryInfo* findApp(const std::string &appIdentifier) const;
+	NotificationIdQueryInfo* takeNextToWrite();
+	void remove(NotificationIdQueryInfo *query);
+	NotificationIdQueryInfo* takeFirst();
+
+	NotificationIdQueryInfo* processDataSourceValue(const BluetoothGattValue &values);
+
+	std::string getAddress() const { return mAddress; }
+	bool isEmpty() const { return mQueries.empty(); }
+	unsigned int getDepth() const { return mQueries.size(); }
+	unsigned int getInFlightCount() const { return mInFlight; }
+
+	AncsDataSourceWatchState getDataSourceWatchState() const { return mDataSourceWatchState; }
+	void setDataSourceWatchState(AncsDataSourceWatchState state) { mDataSourceWatchState = state; }
+
+private:
+	std::string mAddress;
+	AncsQueryTimeoutCallback mTimeoutCallback;
+	// Queries in the order they were requested, written ones first
+	std::deque<NotificationIdQueryInfo*> mQueries;
+	unsigned int mInFlight;
+	NotificationIdQueryInfo *mReceiving;
+	AncsDataSourceWatchState mDataSourceWatchState;
+	guint mTimeout;
+
+	NotificationIdQueryInfo* matchResponseStart(const BluetoothGattValue &values, int32_t &index) const;
+	void restartTimeout();
+
+	static gboolean handleQueryTimeout(gpointer userData);
+};
+
+#endif // BLUETOOTHGATTANCSQUERYQUEUE_H
@@ -0,0 +1,131 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "bluetoothgattconnectionpool.h"
+#include "logging.h"
+
+BluetoothGattConnectionPool::BluetoothGattConnectionPool() :
+	mNextClientId(GATT_VIRTUAL_CLIENT_ID_BASE),
+	mStackConnectCount(0),
+	mSharedConnectCount(0)
+{
+}
+
+BluetoothGattConnectionPool::~BluetoothGattConnectionPool()
+{
+	for (auto connectionIter : mConnections)
+	{
+		for (auto requestMessage : connectionIter.second->pendingRequests)
+			LSMessageUnref(requestMessage);
+
+		delete connectionIter.second;
+	}
+
+	mConnections.clear();
+	mClients.clear();
+}
+
+BluetoothGattPooledConnection* BluetoothGattConnectionPool::add(const std::string &address, uint16_t appId, bool ownsApplication)
+{
+	BluetoothGattPooledConnection *connection = find(address);
+	if (connection)
+		return connection;
+
+	connection = new BluetoothGattPooledConnection(address, appId, ownsApplication);
+	mConnections.insert(std::pair<std::string, BluetoothGattPooledConnection*>(address, connection));
+
+	if (ownsApplication)
+		mStackConnectCount++;
+
+	return connection;
+}
+
+void BluetoothGattConnectionPool::remove(const std::string &address)
+{
+	auto connectionIter = mConnections.find(address);
+	if (connectionIter == mConnections.end())
+		return;
+
+	BluetoothGattPooledConnection *connection = connectionIter->second;
+	for (auto clientId : connection->clientIds)
+		mClients.erase(clientId);
+
+	for (auto requestMessage : connection->pendingRequests)
+		LSMessageUnref(requestMessage);
+
+	mConnections.erase(connectionIter);
+	delete connection;
+}
+
+BluetoothGattPooledConnection* BluetoothGattConnectionPool::find(const std::string &address)
+{
+	auto connectionIter = mConnections.find(address);
+	if (connectionIter == mConnections.end())
+		return nullptr;
+
+	return connectionIter->second;
+}
+
+BluetoothGattPooledConnection* BluetoothGattConnectionPool::findByClientId(uint16_t clientId)
+{
+	auto clientIter = mClients.find(clientId);
+	if (clientIter == mClients.end())
+		return nullptr;
+
+	return clientIter->second;
+}
+
+uint16_t BluetoothGattConnectionPool::addClient(BluetoothGattPooledConnection *connection)
+{
+	if (!connection)
+		return 0;
+
+	// Skip ids which are still in use after wrapping around
+	while (mClients.find(mNextClientId) != mClients.end())
+		mNextClientId = (mNextClientId == UINT16_MAX) ? GATT_VIRTUAL_CLIENT_ID_BASE : mNextClientId + 1;
+
+	uint16_t clientId = mNextClientId;
+	mNextClientId = (mNextClientId == UINT16_MAX) ? GATT_VIRTUAL_CLIENT_ID_BASE : mNextClientId + 1;
+
+	if (!connection->clientIds.empty())
+		mSharedConnectCount++;
+
+	connection->clientIds.insert(clientId);
+	mClients.insert(std::pair<uint16_t, BluetoothGattPooledConnection*>(clientId, connection));
+
+	BT_DEBUG("[%s](%d) client %d added to connection with %s (%zu clients)", __FUNCTION__, __LINE__,
+	         clientId, connection->address.c_str(), connection->clientIds.size());
+
+	return clientId;
+}
+
+unsigned int BluetoothGattConnectionPool::removeClient(uint16_t clientId)
+{
+	auto clientIter = mClients.find(clientId);
+	if (clientIter == mClients.end())
+		return 0;
+
+	BluetoothGattPooledConnection *connection = clientIter->second;
+	connection->clientIds.erase(clientId);
+	mClients.erase(clientIter);
+
+	BT_DEBUG("[%s](%d) client %d removed from connection with %s (%zu clients)", __FUNCTION__, __LINE__,
+	         clientId, connection->address.c_str(), connection->clientIds.size());
+
+	return connection->clientIds.size();
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef BLUETOOTHGATTCONNECTIONPOOL_H
+#define BLUETOOTHGATTCONNECTIONPOOL_H
+
+#include <string>
+#include <set>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <luna-service2/lunaservice.h>
+
+// Virtual client ids are handed out above the range used by the stack for
+// its application ids so both can live in the same lookup table.
+#define GATT_VIRTUAL_CLIENT_ID_BASE 0x8000
+
+/*
+ * One stack level GATT client connection (a registered client application
+ * plus the link to the remote device) which is shared by every Luna client
+ * connected to the same device. Each Luna client gets its own virtual
+ * client id; the connection is torn down when the last one is released.
+ */
+class BluetoothGattPooledConnection
+{
+public:
+	BluetoothGattPooledConnection(const std::string &address, uint16_t appId, bool ownsApplication) :
+		address(address),
+		appId(appId),
+		connectId(0),
+		connected(false),
+		ownsApplication(ownsApplication)
+	{
+	}
+
+	std::string address;
+	uint16_t appId;
+	uint16_t connectId;
+	bool connected;
+	// Whether the client application was registered by us and has to be
+	// removed again once the connection is released
+	bool ownsApplication;
+	std::set<uint16_t> clientIds;
+	// Connect requests waiting for the stack connection to be established
+	std::vector<LSMessage*> pendingRequests;
+};
+
+class BluetoothGattConnectionPool
+{
+public:
+	BluetoothGattConnectionPool();
+	BluetoothGattConnectionPool(const BluetoothGattConnectionPool &other) = delete;
+	~BluetoothGattConnectionPool();
+
+	BluetoothGattPooledConnection* add(const std::string &address, uint16_t appId, bool ownsApplication);
+	void remove(const std::string &address);
+	BluetoothGattPooledConnection* find(const std::string &address);
+	BluetoothGattPooledConnection* findByClientId(uint16_t clientId);
+
+	uint16_t addClient(BluetoothGattPooledConnection *connection);
+	unsigned int removeClient(uint16_t clientId);
+
+	const std::unordered_map<std::string, BluetoothGattPooledConnection*>& getConnections() const { return mConnections; }
+	unsigned int getClientCount() const { return mClients.size(); }
+	unsigned int getStackConnectCount() const { return mStackConnectCount; }
+	unsigned int getSharedConnectCount() const { return mSharedConnectCount; }
+
+private:
+	std::unordered_map<std::string, BluetoothGattPooledConnection*> mConnections;
+	std::unordered_map<uint16_t, BluetoothGattPooledConnection*> mClients;
+	uint16_t mNextClientId;
+
+	unsigned int mStackConnectCount;
+	unsigned int mSharedConnectCount;
+};
+
+#endif // BLUETOOTHGATTCONNECTIONPOOL_H
@@ -0,0 +1,369 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "bluetoothgattdiscoveryscheduler.h"
+#include "logging.h"
+
+BluetoothGattDiscoveryScheduler::BluetoothGattDiscoveryScheduler(unsigned int maxConcurrent, BluetoothGattDiscoveryStartFunction startFunction,
+                                                                 BluetoothGattDiscoveryStateFunction stateFunction) :
+	mMaxConcurrent(maxConcurrent > 0 ? maxConcurrent : 1),
+	mStartFunction(startFunction),
+	mStateFunction(stateFunction),
+	mRunningCount(0),
+	mMaxQueuedCount(0),
+	mNextDiscoveryId(1),
+	mDispatching(false)
+{
+}
+
+BluetoothGattDiscoveryScheduler::~BluetoothGattDiscoveryScheduler()
+{
+	for (auto discoveryIter : mDiscoveries)
+	{
+		if (discoveryIter.second->timeout)
+			g_source_remove(discoveryIter.second->timeout);
+		delete discoveryIter.second;
+	}
+	mDiscoveries.clear();
+
+	for (auto discoveryIter : mTimedOut)
+		delete discoveryIter.second;
+	mTimedOut.clear();
+
+	for (int priority = 0; priority < BLUETOOTH_GATT_OPERATION_PRIORITY_MAX; priority++)
+		mQueued[priority].clear();
+}
+
+unsigned int BluetoothGattDiscoveryScheduler::getQueuedCount() const
+{
+	unsigned int count = 0;
+	for (int priority = 0; priority < BLUETOOTH_GATT_OPERATION_PRIORITY_MAX; priority++)
+		count += mQueued[priority].size();
+
+	return count;
+}
+
+bool BluetoothGattDiscoveryScheduler::isDiscovering(const std::string &address) const
+{
+	return mDiscoveries.find(address) != mDiscoveries.end();
+}
+
+bool BluetoothGattDiscoveryScheduler::isRunning(const std::string &address) const
+{
+	auto discoveryIter = mDiscoveries.find(address);
+	return discoveryIter != mDiscoveries.end() && discoveryIter->second->running;
+}
+
+BluetoothGattOperationPriority BluetoothGattDiscoveryScheduler::getPriority(const std::string &address) const
+{
+	auto discoveryIter = mDiscoveries.find(address);
+	if (discoveryIter == mDiscoveries.end())
+		return BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL;
+
+	return discoveryIter->second->priority;
+}
+
+void BluetoothGattDiscoveryScheduler::schedule(const std::string &address, BluetoothGattOperationPriority priority,
+                                               BluetoothResultCallback callback)
+{
+	if (priority >= BLUETOOTH_GATT_OPERATION_PRIORITY_MAX)
+		priority = BLUETOOTH_GATT_OPERATION_PRIORITY_BACKGROUND;
+
+	auto discoveryIter = mDiscoveries.find(address);
+	if (discoveryIter != mDiscoveries.end())
+	{
+		Discovery *discovery = discoveryIter->second;
+		if (callback)
+			discovery->callbacks.push_back(callback);
+
+		// A more urgent request moves a waiting discovery ahead
+		if (!discovery->running && priority < discovery->priority)
+		{
+			std::deque<Discovery*> &queue = mQueued[discovery->priority];
+			for (auto queueIter = queue.begin(); queueIter != queue.end(); queueIter++)
+			{
+				if (*queueIter == discovery)
+				{
+					queue.erase(queueIter);
+					break;
+				}
+			}
+
+			discovery->priority = priority;
+			mQueued[priority].push_back(discovery);
+		}
+
+		BT_DEBUG("[%s](%d) joined %s discovery of %s", __FUNCTION__, __LINE__,
+		         discovery->running ? "running" : "queued", address.c_str());
+		return;
+	}
+
+	Discovery *discovery = new Discovery();
+	discovery->id = mNextDiscoveryId++;
+	discovery->address = address;
+	discovery->priority = priority;
+	discovery->queuedTime = g_get_monotonic_time();
+	discovery->scheduler = this;
+	if (callback)
+		discovery->callbacks.push_back(callback);
+
+	mDiscoveries.insert(std::pair<std::string, Discovery*>(address, discovery));
+	mQueued[priority].push_back(discovery);
+
+	// Make the device show up in the statistics while its first discovery waits
+	findStats(address);
+
+	unsigned int queued = getQueuedCount();
+	if (queued > mMaxQueuedCount)
+		mMaxQueuedCount = queued;
+
+	BT_DEBUG("[%s](%d) queued discovery %u of %s with priority %s (%u running, %u queued)", __FUNCTION__, __LINE__,
+	         discovery->id, address.c_str(), BluetoothGattOperationQueue::priorityToString(priority).c_str(),
+	         mRunningCount, queued);
+
+	if (mStateFunction)
+		mStateFunction(address, true);
+
+	dispatch();
+}
+
+void BluetoothGattDiscoveryScheduler::cancel(const std::string &address, BluetoothError error)
+{
+	// Called when the link is gone. The stack ends its discoveries of the
+	// device with it, so their slots are given back right away and a late
+	// result is ignored by complete().
+	for (auto discoveryIter = mTimedOut.begin(); discoveryIter != mTimedOut.end();)
+	{
+		if (discoveryIter->second->address != address)
+		{
+			discoveryIter++;
+			continue;
+		}
+
+		Discovery *discovery = discoveryIter->second;
+		discoveryIter = mTimedOut.erase(discoveryIter);
+		mRunningCount--;
+		delete discovery;
+	}
+
+	auto discoveryIter = mDiscoveries.find(address);
+	if (discoveryIter == mDiscoveries.end())
+	{
+		dispatch();
+		return;
+	}
+
+	Discovery *discovery = discoveryIter->second;
+	if (!discovery->running)
+	{
+		std::deque<Discovery*> &queue = mQueued[discovery->priority];
+		for (auto queueIter = queue.begin(); queueIter != queue.end(); queueIter++)
+		{
+			if (*queueIter == discovery)
+			{
+				queue.erase(queueIter);
+				break;
+			}
+		}
+	}
+
+	complete(address, discovery->id, error);
+}
+
+bool BluetoothGattDiscoveryScheduler::isTimedOut(const std::string &address) const
+{
+	for (auto discoveryIter : mTimedOut)
+	{
+		if (discoveryIter.second->address == address)
+			return true;
+	}
+
+	return false;
+}
+
+BluetoothGattDiscoveryStats& BluetoothGattDiscoveryScheduler::findStats(const std::string &address)
+{
+	auto statsIter = mStats.find(address);
+	if (statsIter != mStats.end())
+		return statsIter->second;
+
+	// Forget the oldest device which is not being discovered
+	if (mStats.size() >= GATT_DISCOVERY_MAX_STATS)
+	{
+		for (auto orderIter = mStatsOrder.begin(); orderIter != mStatsOrder.end(); orderIter++)
+		{
+			if (mDiscoveries.find(*orderIter) == mDiscoveries.end())
+			{
+				mStats.erase(*orderIter);
+				mStatsOrder.erase(orderIter);
+				break;
+			}
+		}
+	}
+
+	mStatsOrder.push_back(address);
+	return mStats[address];
+}
+
+BluetoothGattDiscoveryScheduler::Discovery* BluetoothGattDiscoveryScheduler::takeNext()
+{
+	for (int priority = 0; priority < BLUETOOTH_GATT_OPERATION_PRIORITY_MAX; priority++)
+	{
+		std::deque<Discovery*> &queue = mQueued[priority];
+		for (auto queueIter = queue.begin(); queueIter != queue.end(); queueIter++)
+		{
+			// Never run a second discovery on a device the stack is still busy with
+			if (!mTimedOut.empty() && isTimedOut((*queueIter)->address))
+				continue;
+
+			Discovery *discovery = *queueIter;
+			queue.erase(queueIter);
+			return discovery;
+		}
+	}
+
+	return nullptr;
+}
+
+void BluetoothGattDiscoveryScheduler::dispatch()
+{
+	// The stack may fail a discovery synchronously; complete() then lands
+	// here again and the loop below starts the next one.
+	if (mDispatching)
+		return;
+
+	mDispatching = true;
+
+	while (mRunningCount < mMaxConcurrent)
+	{
+		Discovery *discovery = takeNext();
+		if (!discovery)
+			break;
+
+		discovery->running = true;
+		discovery->startTime = g_get_monotonic_time();
+		discovery->timeout = g_timeout_add_seconds(GATT_DISCOVERY_TIMEOUT, &BluetoothGattDiscoveryScheduler::handleDiscoveryTimeout, discovery);
+		mRunningCount++;
+
+		BT_DEBUG("[%s](%d) starting discovery %u of %s after %lld ms in queue", __FUNCTION__, __LINE__, discovery->id,
+		         discovery->address.c_str(), (long long) (discovery->startTime - discovery->queuedTime) / 1000);
+
+		std::string address = discovery->address;
+		uint32_t discoveryId = discovery->id;
+		mStartFunction(address, [this, address, discoveryId](BluetoothError error) {
+			complete(address, discoveryId, error);
+		});
+	}
+
+	mDispatching = false;
+}
+
+void BluetoothGattDiscoveryScheduler::complete(const std::string &address, uint32_t discoveryId, BluetoothError error)
+{
+	// Late result of a discovery which already timed out; its slot is free now
+	auto timedOutIter = mTimedOut.find(discoveryId);
+	if (timedOutIter != mTimedOut.end())
+	{
+		Discovery *discovery = timedOutIter->second;
+		mTimedOut.erase(timedOutIter);
+		mRunningCount--;
+
+		BT_DEBUG("[%s](%d) timed out discovery %u of %s finished with error %d after %lld ms", __FUNCTION__, __LINE__,
+		         discovery->id, address.c_str(), error, (long long) (g_get_monotonic_time() - discovery->startTime) / 1000);
+
+		delete discovery;
+		dispatch();
+		return;
+	}
+
+	auto discoveryIter = mDiscoveries.find(address);
+	if (discoveryIter == mDiscoveries.end() || discoveryIter->second->id != discoveryId)
+		return;
+
+	Discovery *discovery = discoveryIter->second;
+	mDiscoveries.erase(discoveryIter);
+
+	BluetoothGattDiscoveryStats &stats = findStats(address);
+	if (error == BLUETOOTH_ERROR_NONE)
+		stats.completedCount++;
+	else
+		stats.failedCount++;
+
+	if (discovery->running)
+	{
+		mRunningCount--;
+
+		if (discovery->timeout)
+			g_source_remove(discovery->timeout);
+
+		gint64 now = g_get_monotonic_time();
+		stats.lastQueueTime = (discovery->startTime - discovery->queuedTime) / 1000;
+		stats.lastDuration = (now - discovery->startTime) / 1000;
+		if (stats.lastDuration > stats.maxDuration)
+			stats.maxDuration = stats.lastDuration;
+
+		BT_DEBUG("[%s](%d) discovery %u of %s finished with error %d after %u ms (%u ms in queue)", __FUNCTION__, __LINE__,
+		         discovery->id, address.c_str(), error, stats.lastDuration, stats.lastQueueTime);
+	}
+
+	std::vector<BluetoothResultCallback> callbacks = discovery->callbacks;
+	delete discovery;
+
+	finish(address, callbacks, error);
+	dispatch();
+}
+
+void BluetoothGattDiscoveryScheduler::timeOut(Discovery *discovery)
+{
+	BT_WARNING(MSGID_GATT_OPERATION_TIMEOUT, 0, "GATT service discovery of %s timed out", discovery->address.c_str());
+
+	// The stack still works on it, so it keeps its slot until the result
+	// arrives. Requesters are answered now and new requests start over.
+	std::string address = discovery->address;
+	std::vector<BluetoothResultCallback> callbacks = discovery->callbacks;
+	discovery->callbacks.clear();
+
+	mDiscoveries.erase(address);
+	mTimedOut.insert(std::pair<uint32_t, Discovery*>(discovery->id, discovery));
+	findStats(address).failedCount++;
+
+	finish(address, callbacks, BLUETOOTH_ERROR_FAIL);
+}
+
+void BluetoothGattDiscoveryScheduler::finish(const std::string &address, const std::vector<BluetoothResultCallback> &callbacks,
+                                             BluetoothError error)
+{
+	if (mStateFunction)
+		mStateFunction(address, false);
+
+	for (auto callback : callbacks)
+		callback(error);
+}
+
+gboolean BluetoothGattDiscoveryScheduler::handleDiscoveryTimeout(gpointer userData)
+{
+	Discovery *discovery = static_cast<Discovery*>(userData);
+	if (!discovery || !discovery->scheduler)
+		return FALSE;
+
+	// timeOut() keeps the discovery until the stack reports back
+	discovery->timeout = 0;
+	discovery->scheduler->timeOut(discovery);
+
+	return FALSE;
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef BLUETOOTHGATTDISCOVERYSCHEDULER_H
+#define BLUETOOTHGATTDISCOVERYSCHEDULER_H
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <glib.h>
+
+#include <bluetooth-sil-api.h>
+
+#include "bluetoothgattoperationqueue.h"
+
+// Upper bound for a complete primary/secondary service discovery of one device
+#define GATT_DISCOVERY_TIMEOUT 60
+// Number of devices for which discovery statistics are kept
+#define GATT_DISCOVERY_MAX_STATS 64
+
+typedef std::function<void(const std::string&, BluetoothResultCallback)> BluetoothGattDiscoveryStartFunction;
+typedef std::function<void(const std::string&, bool)> BluetoothGattDiscoveryStateFunction;
+
+class BluetoothGattDiscoveryStats
+{
+public:
+	BluetoothGattDiscoveryStats() :
+		completedCount(0),
+		failedCount(0),
+		lastQueueTime(0),
+		lastDuration(0),
+		maxDuration(0)
+	{
+	}
+
+	unsigned int completedCount;
+	unsigned int failedCount;
+	// All times in milliseconds
+	unsigned int lastQueueTime;
+	unsigned int lastDuration;
+	unsigned int maxDuration;
+};
+
+/*
+ * Controllers only handle a limited number of parallel service discoveries
+ * before the link layer starts to stall. At most maxConcurrent discoveries
+ * are run at once; further devices wait in priority order. Requests for a
+ * device which is already queued or running join that discovery.
+ *
+ * The SIL has no way to abort a discovery. One which times out is answered
+ * with an error but keeps its slot until the stack reports back or the
+ * device disconnects, so the controller never runs more than maxConcurrent.
+ */
+class BluetoothGattDiscoveryScheduler
+{
+public:
+	BluetoothGattDiscoveryScheduler(unsigned int maxConcurrent, BluetoothGattDiscoveryStartFunction startFunction,
+	                                BluetoothGattDiscoveryStateFunction stateFunction);
+	BluetoothGattDiscoveryScheduler(const BluetoothGattDiscoveryScheduler &other) = delete;
+	~BluetoothGattDiscoveryScheduler();
+
+	void schedule(const std::string &address, BluetoothGattOperationPriority priority, BluetoothResultCallback callback);
+	void cancel(const std::string &address, BluetoothError error);
+
+	bool isDiscovering(const std::string &address) const;
+	bool isRunning(const std::string &address) const;
+	BluetoothGattOperationPriority getPriority(const std::string &address) const;
+
+	unsigned int getMaxConcurrent() const { return mMaxConcurrent; }
+	unsigned int getRunningCount() const { return mRunningCount; }
+	unsigned int getQueuedCount() const;
+	unsigned int getMaxQueuedCount() const { return mMaxQueuedCount; }
+	const std::unordered_map<std::string, BluetoothGattDiscoveryStats>& getStats() const { return mStats; }
+
+private:
+	class Discovery
+	{
+	public:
+		Discovery() :
+			id(0),
+			priority(BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL),
+			running(false),
+			queuedTime(0),
+			startTime(0),
+			timeout(0),
+			scheduler(nullptr)
+		{
+		}
+
+		uint32_t id;
+		std::string address;
+		BluetoothGattOperationPriority priority;
+		bool running;
+		gint64 queuedTime;
+		gint64 startTime;
+		guint timeout;
+		std::vector<BluetoothResultCallback> callbacks;
+		BluetoothGattDiscoveryScheduler *scheduler;
+	};
+
+	unsigned int mMaxConcurrent;
+	BluetoothGattDiscoveryStartFunction mStartFunction;
+	BluetoothGattDiscoveryStateFunction mStateFunction;
+	std::unordered_map<std::string, Discovery*> mDiscoveries;
+	std::deque<Discovery*> mQueued[BLUETOOTH_GATT_OPERATION_PRIORITY_MAX];
+	std::unordered_map<uint32_t, Discovery*> mTimedOut;
+	std::unordered_map<std::string, BluetoothGattDiscoveryStats> mStats;
+	std::deque<std::string> mStatsOrder;
+	unsigned int mRunningCount;
+	unsigned int mMaxQueuedCount;
+	uint32_t mNextDiscoveryId;
+	bool mDispatching;
+
+	Discovery *takeNext();
+	void dispatch();
+	void complete(const std::string &address, uint32_t discoveryId, BluetoothError error);
+	void timeOut(Discovery *discovery);
+	void finish(const std::string &address, const std::vector<BluetoothResultCallback> &callbacks, BluetoothError error);
+	bool isTimedOut(const std::string &address) const;
+	BluetoothGattDiscoveryStats& findStats(const std::string &address);
+
+	static gboolean handleDiscoveryTimeout(gpointer userData);
+};
+
+#endif // BLUETOOTHGATTDISCOVERYSCHEDULER_H
@@ -0,0 +1,201 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "bluetoothgattnotifyengine.h"
+#include "logging.h"
+
+BluetoothGattNotifyEngine::BluetoothGattNotifyEngine(BluetoothGattNotifyFunction notifyFunction) :
+	mNotifyFunction(notifyFunction),
+	mFlushTimeout(0),
+	mEnqueuedCount(0),
+	mSentCount(0),
+	mCoalescedCount(0),
+	mBatchCount(0),
+	mMaxBatchSize(0)
+{
+}
+
+BluetoothGattNotifyEngine::~BluetoothGattNotifyEngine()
+{
+	if (mFlushTimeout)
+		g_source_remove(mFlushTimeout);
+
+	for (auto centralIter : mCentrals)
+		delete centralIter.second;
+	mCentrals.clear();
+}
+
+void BluetoothGattNotifyEngine::addCentral(const std::string &address)
+{
+	if (mCentrals.find(address) != mCentrals.end())
+		return;
+
+	BT_DEBUG("[%s](%d) central %s connected", __FUNCTION__, __LINE__, address.c_str());
+	mCentrals.insert(std::pair<std::string, BluetoothGattNotifyCentral*>(address, new BluetoothGattNotifyCentral(address)));
+}
+
+void BluetoothGattNotifyEngine::removeCentral(const std::string &address)
+{
+	auto centralIter = mCentrals.find(address);
+	if (centralIter == mCentrals.end())
+		return;
+
+	BT_DEBUG("[%s](%d) central %s disconnected (sent %u, coalesced %u)", __FUNCTION__, __LINE__,
+	         address.c_str(), centralIter->second->sent, centralIter->second->coalesced);
+
+	delete centralIter->second;
+	mCentrals.erase(centralIter);
+}
+
+void BluetoothGattNotifyEngine::setConfiguration(const std::string &address, uint16_t handle, uint16_t configuration)
+{
+	addCentral(address);
+	BluetoothGattNotifyCentral *central = mCentrals[address];
+
+	if (configuration == 0)
+		central->configurations.erase(handle);
+	else
+		central->configurations[handle] = configuration;
+}
+
+void BluetoothGattNotifyEngine::removeHandle(uint16_t handle)
+{
+	discard(handle);
+
+	for (auto centralIter : mCentrals)
+		centralIter.second->configurations.erase(handle);
+}
+
+unsigned int BluetoothGattNotifyEngine::getSubscriberCount(uint16_t handle) const
+{
+	unsigned int count = 0;
+	for (auto centralIter : mCentrals)
+	{
+		if (centralIter.second->isSubscribed(handle))
+			count++;
+	}
+
+	return count;
+}
+
+void BluetoothGattNotifyEngine::enqueue(uint16_t handle, const BluetoothGattValue &value)
+{
+	mEnqueuedCount++;
+
+	auto pendingIter = mPendingValues.find(handle);
+	if (pendingIter != mPendingValues.end())
+	{
+		// Centrals only ever need the latest value
+		pendingIter->second = value;
+		mCoalescedCount++;
+
+		for (auto centralIter : mCentrals)
+		{
+			if (centralIter.second->isSubscribed(handle))
+				centralIter.second->coalesced++;
+		}
+
+		return;
+	}
+
+	mPendingHandles.push_back(handle);
+	mPendingValues.insert(std::make_pair(handle, value));
+
+	for (auto centralIter : mCentrals)
+	{
+		BluetoothGattNotifyCentral *central = centralIter.second;
+		if (!central->isSubscribed(handle))
+			continue;
+
+		central->depth++;
+		if (central->depth > central->maxDepth)
+			central->maxDepth = central->depth;
+	}
+
+	if (!mFlushTimeout)
+		mFlushTimeout = g_timeout_add(GATT_NOTIFY_BATCH_INTERVAL, &BluetoothGattNotifyEngine::handleFlushTimeout, this);
+}
+
+void BluetoothGattNotifyEngine::discard(uint16_t handle)
+{
+	if (!mPendingValues.erase(handle))
+		return;
+
+	for (auto handleIter = mPendingHandles.begin(); handleIter != mPendingHandles.end(); handleIter++)
+	{
+		if (*handleIter == handle)
+		{
+			mPendingHandles.erase(handleIter);
+			break;
+		}
+	}
+
+	for (auto centralIter : mCentrals)
+	{
+		BluetoothGattNotifyCentral *central = centralIter.second;
+		if (central->isSubscribed(handle) && central->depth > 0)
+			central->depth--;
+	}
+}
+
+void BluetoothGattNotifyEngine::flush()
+{
+	if (mFlushTimeout)
+	{
+		g_source_remove(mFlushTimeout);
+		mFlushTimeout = 0;
+	}
+
+	if (mPendingHandles.empty())
+		return;
+
+	// Take the batch first; the notify function may queue further changes
+	std::deque<uint16_t> handles;
+	std::unordered_map<uint16_t, BluetoothGattValue> values;
+	handles.swap(mPendingHandles);
+	values.swap(mPendingValues);
+
+	mBatchCount++;
+	if (handles.size() > mMaxBatchSize)
+		mMaxBatchSize = handles.size();
+
+	for (auto centralIter : mCentrals)
+	{
+		BluetoothGattNotifyCentral *central = centralIter.second;
+		central->sent += central->depth;
+		central->depth = 0;
+	}
+
+	for (auto handle : handles)
+	{
+		mNotifyFunction(handle, values[handle]);
+		mSentCount++;
+	}
+}
+
+gboolean BluetoothGattNotifyEngine::handleFlushTimeout(gpointer userData)
+{
+	BluetoothGattNotifyEngine *engine = static_cast<BluetoothGattNotifyEngine*>(userData);
+	if (!engine)
+		return FALSE;
+
+	engine->mFlushTimeout = 0;
+	engine->flush();
+
+	return FALSE;
+}
@@ -0,0 +1,117 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef BLUETOOTHGATTNOTIFYENGINE_H
+#define BLUETOOTHGATTNOTIFYENGINE_H
+
+#include <string>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <bluetooth-sil-api.h>
+#include <glib.h>
+
+#define GATT_CLIENT_CHARACTERISTIC_CONFIGURATION_UUID "00002902-0000-1000-8000-00805f9b34fb"
+
+// Changes are collected for about one minimum LE connection interval
+// (7.5ms) before they are handed to the stack together
+#define GATT_NOTIFY_BATCH_INTERVAL  8
+
+typedef std::function<void(uint16_t handle, const BluetoothGattValue &value)> BluetoothGattNotifyFunction;
+
+/*
+ * Notification state of one remote device connected to our local GATT
+ * servers: the Client Characteristic Configuration it wrote for each
+ * characteristic and how the notifications for it fared.
+ */
+class BluetoothGattNotifyCentral
+{
+public:
+	BluetoothGattNotifyCentral(const std::string &address) :
+		address(address),
+		depth(0),
+		maxDepth(0),
+		sent(0),
+		coalesced(0)
+	{
+	}
+
+	bool isSubscribed(uint16_t handle) const { return configurations.find(handle) != configurations.end(); }
+
+	std::string address;
+	// Characteristic handle -> CCCD value (bit 0 notify, bit 1 indicate)
+	std::map<uint16_t, uint16_t> configurations;
+	unsigned int depth;
+	unsigned int maxDepth;
+	unsigned int sent;
+	// Changes replaced by a newer value before they were sent
+	unsigned int coalesced;
+};
+
+/*
+ * Sends value changes of local characteristics to the connected centrals.
+ * Only the latest value of each characteristic is kept until the next
+ * flush, GATT_NOTIFY_BATCH_INTERVAL ms after the first pending change, so
+ * a characteristic updated faster than that costs one stack call per
+ * interval. The stack fans each change out to the subscribed connections.
+ * Per central counters are kept for the characteristics it subscribed to.
+ */
+class BluetoothGattNotifyEngine
+{
+public:
+	BluetoothGattNotifyEngine(BluetoothGattNotifyFunction notifyFunction);
+	BluetoothGattNotifyEngine(const BluetoothGattNotifyEngine &other) = delete;
+	~BluetoothGattNotifyEngine();
+
+	void addCentral(const std::string &address);
+	void removeCentral(const std::string &address);
+	void setConfiguration(const std::string &address, uint16_t handle, uint16_t configuration);
+	void removeHandle(uint16_t handle);
+
+	void enqueue(uint16_t handle, const BluetoothGattValue &value);
+	// Forgets a pending change, e.g. when the value was sent another way
+	void discard(uint16_t handle);
+	void flush();
+
+	const std::unordered_map<std::string, BluetoothGattNotifyCentral*>& getCentrals() const { return mCentrals; }
+	unsigned int getDepth() const { return mPendingHandles.size(); }
+	unsigned int getSubscriberCount(uint16_t handle) const;
+	unsigned int getEnqueuedCount() const { return mEnqueuedCount; }
+	unsigned int getSentCount() const { return mSentCount; }
+	unsigned int getCoalescedCount() const { return mCoalescedCount; }
+	unsigned int getBatchCount() const { return mBatchCount; }
+	unsigned int getMaxBatchSize() const { return mMaxBatchSize; }
+
+private:
+	BluetoothGattNotifyFunction mNotifyFunction;
+	std::unordered_map<std::string, BluetoothGattNotifyCentral*> mCentrals;
+	// Handles in the order of their first pending change, and their latest value
+	std::deque<uint16_t> mPendingHandles;
+	std::unordered_map<uint16_t, BluetoothGattValue> mPendingValues;
+	guint mFlushTimeout;
+
+	unsigned int mEnqueuedCount;
+	unsigned int mSentCount;
+	unsigned int mCoalescedCount;
+	unsigned int mBatchCount;
+	unsigned int mMaxBatchSize;
+
+	static gboolean handleFlushTimeout(gpointer userData);
+};
+
+#endif // BLUETOOTHGATTNOTIFYENGINE_H
@@ -0,0 +1,245 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "bluetoothgattoperationqueue.h"
+#include "bluetootheventtrace.h"
+#include "logging.h"
+
+uint32_t BluetoothGattOperationQueue::nextQueueId = 1;
+std::unordered_map<uint32_t, BluetoothGattOperationQueue*> BluetoothGattOperationQueue::queues;
+
+BluetoothGattOperationQueue::BluetoothGattOperationQueue(const std::string &address) :
+	mAddress(address),
+	mId(nextQueueId++),
+	mCurrent(nullptr),
+	mNextOperationId(1),
+	mDispatching(false),
+	mMaxDepth(0),
+	mEnqueuedCount(0),
+	mCompletedCount(0),
+	mTimedOutCount(0),
+	mDeduplicatedCount(0),
+	mCoalescedCount(0)
+{
+	queues.insert(std::pair<uint32_t, BluetoothGattOperationQueue*>(mId, this));
+}
+
+BluetoothGattOperationQueue::~BluetoothGattOperationQueue()
+{
+	queues.erase(mId);
+
+	for (int priority = 0; priority < BLUETOOTH_GATT_OPERATION_PRIORITY_MAX; priority++)
+	{
+		for (auto operation : mOperations[priority])
+			delete operation;
+		mOperations[priority].clear();
+	}
+
+	if (mCurrent)
+	{
+		if (mCurrent->timeout)
+			g_source_remove(mCurrent->timeout);
+		delete mCurrent;
+		mCurrent = nullptr;
+	}
+}
+
+unsigned int BluetoothGattOperationQueue::getDepth() const
+{
+	unsigned int depth = 0;
+	for (int priority = 0; priority < BLUETOOTH_GATT_OPERATION_PRIORITY_MAX; priority++)
+		depth += mOperations[priority].size();
+
+	return depth;
+}
+
+uint32_t BluetoothGattOperationQueue::push(BluetoothGattOperationPriority priority, BluetoothGattOperationHandler handler,
+                                           BluetoothGattOperationTimeoutCallback timeoutCallback)
+{
+	if (!handler)
+		return 0;
+
+	if (priority >= BLUETOOTH_GATT_OPERATION_PRIORITY_MAX)
+		priority = BLUETOOTH_GATT_OPERATION_PRIORITY_BACKGROUND;
+
+	Operation *operation = new Operation();
+	operation->id = mNextOperationId++;
+	operation->priority = priority;
+	operation->handler = handler;
+	operation->timeoutCallback = timeoutCallback;
+
+	mOperations[priority].push_back(operation);
+	mEnqueuedCount++;
+
+	unsigned int depth = getDepth() + (mCurrent ? 1 : 0);
+	if (depth > mMaxDepth)
+		mMaxDepth = depth;
+
+	BT_DEBUG("[%s](%d) queued operation %u for %s with priority %s (depth %u)", __FUNCTION__, __LINE__,
+	         operation->id, mAddress.c_str(), priorityToString(priority).c_str(), depth);
+
+	// The operation may be finished and deleted by dispatch()
+	uint32_t operationId = operation->id;
+	dispatch();
+
+	return operationId;
+}
+
+bool BluetoothGattOperationQueue::raisePriority(uint32_t operationId, BluetoothGattOperationPriority priority)
+{
+	if (priority >= BLUETOOTH_GATT_OPERATION_PRIORITY_MAX)
+		return false;
+
+	for (int lower = priority + 1; lower < BLUETOOTH_GATT_OPERATION_PRIORITY_MAX; lower++)
+	{
+		for (auto operationIter = mOperations[lower].begin(); operationIter != mOperations[lower].end(); operationIter++)
+		{
+			Operation *operation = *operationIter;
+			if (operation->id != operationId)
+				continue;
+
+			mOperations[lower].erase(operationIter);
+			operation->priority = priority;
+			mOperations[priority].push_back(operation);
+
+			BT_DEBUG("[%s](%d) raised operation %u for %s to priority %s", __FUNCTION__, __LINE__,
+			         operationId, mAddress.c_str(), priorityToString(priority).c_str());
+			return true;
+		}
+	}
+
+	return false;
+}
+
+BluetoothGattOperationQueue::Operation* BluetoothGattOperationQueue::takeNext()
+{
+	for (int priority = 0; priority < BLUETOOTH_GATT_OPERATION_PRIORITY_MAX; priority++)
+	{
+		if (mOperations[priority].empty())
+			continue;
+
+		Operation *operation = mOperations[priority].front();
+		mOperations[priority].pop_front();
+		return operation;
+	}
+
+	return nullptr;
+}
+
+void BluetoothGattOperationQueue::dispatch()
+{
+	// A handler may complete synchronously (e.g. the SIL rejects the request
+	// right away). The loop below then picks up the next operation instead
+	// of recursing through complete().
+	if (mDispatching)
+		return;
+
+	mDispatching = true;
+
+	while (!mCurrent)
+	{
+		Operation *operation = takeNext();
+		if (!operation)
+			break;
+
+		mCurrent = operation;
+		mCurrent->startTime = g_get_monotonic_time();
+		mCurrent->timeout = g_timeout_add_seconds(GATT_OPERATION_TIMEOUT, &BluetoothGattOperationQueue::handleOperationTimeout, this);
+
+		// The handler may complete synchronously, which deletes the operation
+		// while the handler is still running; call a copy of it instead.
+		BluetoothGattOperationHandler handler = operation->handler;
+		uint32_t queueId = mId;
+		uint32_t operationId = operation->id;
+		handler([queueId, operationId]() {
+			completeOperation(queueId, operationId);
+		});
+	}
+
+	mDispatching = false;
+}
+
+void BluetoothGattOperationQueue::complete(uint32_t operationId)
+{
+	// Late completion of an operation which already timed out
+	if (!mCurrent || mCurrent->id != operationId)
+		return;
+
+	if (mCurrent->timeout)
+		g_source_remove(mCurrent->timeout);
+
+	getEventTrace().record(BLUETOOTH_EVENT_TRACE_GATT_OPERATION_COMPLETE, mAddress, 0, 0,
+	                       g_get_monotonic_time() - mCurrent->startTime);
+
+	delete mCurrent;
+	mCurrent = nullptr;
+	mCompletedCount++;
+
+	dispatch();
+}
+
+void BluetoothGattOperationQueue::completeOperation(uint32_t queueId, uint32_t operationId)
+{
+	auto queueIter = queues.find(queueId);
+	if (queueIter == queues.end())
+		return;
+
+	queueIter->second->complete(operationId);
+}
+
+gboolean BluetoothGattOperationQueue::handleOperationTimeout(gpointer userData)
+{
+	BluetoothGattOperationQueue *queue = static_cast<BluetoothGattOperationQueue*>(userData);
+	if (!queue || !queue->mCurrent)
+		return FALSE;
+
+	BT_WARNING(MSGID_GATT_OPERATION_TIMEOUT, 0, "GATT operation %u for %s timed out", queue->mCurrent->id, queue->mAddress.c_str());
+
+	queue->mCurrent->timeout = 0;
+	queue->mTimedOutCount++;
+
+	BluetoothGattOperationTimeoutCallback timeoutCallback = queue->mCurrent->timeoutCallback;
+	queue->complete(queue->mCurrent->id);
+
+	if (timeoutCallback)
+		timeoutCallback();
+
+	return FALSE;
+}
+
+BluetoothGattOperationPriority BluetoothGattOperationQueue::priorityFromString(const std::string &priority)
+{
+	if (priority == "high")
+		return BLUETOOTH_GATT_OPERATION_PRIORITY_HIGH;
+	else if (priority == "background")
+		return BLUETOOTH_GATT_OPERATION_PRIORITY_BACKGROUND;
+
+	return BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL;
+}
+
+std::string BluetoothGattOperationQueue::priorityToString(BluetoothGattOperationPriority priority)
+{
+	switch (priority)
+	{
+	case BLUETOOTH_GATT_OPERATION_PRIORITY_HIGH:
+		return "high";
+	case BLUETOOTH_GATT_OPERATION_PRIORITY_BACKGROUND:
+		return "background";
+	default:
+		return "normal";
+	}
+}
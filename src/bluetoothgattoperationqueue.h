@@ -0,0 +1,129 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef BLUETOOTHGATTOPERATIONQUEUE_H
+#define BLUETOOTHGATTOPERATIONQUEUE_H
+
+#include <string>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <glib.h>
+
+// ATT transaction timeout (Core spec Vol 3, Part F, 3.3.3)
+#define GATT_OPERATION_TIMEOUT 30
+
+enum BluetoothGattOperationPriority
+{
+	BLUETOOTH_GATT_OPERATION_PRIORITY_HIGH = 0,
+	BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL,
+	BLUETOOTH_GATT_OPERATION_PRIORITY_BACKGROUND,
+	BLUETOOTH_GATT_OPERATION_PRIORITY_MAX
+};
+
+typedef std::function<void(void)> BluetoothGattOperationCompleteCallback;
+typedef std::function<void(BluetoothGattOperationCompleteCallback)> BluetoothGattOperationHandler;
+typedef std::function<void(void)> BluetoothGattOperationTimeoutCallback;
+
+/*
+ * ATT allows only one outstanding request per bearer. Every remote GATT
+ * read/write for a device goes through its queue: the handler of the first
+ * queued operation is started, and the next one is dispatched as soon as
+ * the handler reports completion (or the operation times out).
+ */
+class BluetoothGattOperationQueue
+{
+public:
+	BluetoothGattOperationQueue(const std::string &address);
+	BluetoothGattOperationQueue(const BluetoothGattOperationQueue &other) = delete;
+	~BluetoothGattOperationQueue();
+
+	// Returns the id of the queued operation
+	uint32_t push(BluetoothGattOperationPriority priority, BluetoothGattOperationHandler handler,
+	              BluetoothGattOperationTimeoutCallback timeoutCallback = nullptr);
+	// Moves an operation which is still waiting to the back of a higher
+	// priority, returns false if it is not waiting (anymore)
+	bool raisePriority(uint32_t operationId, BluetoothGattOperationPriority priority);
+
+	void countDeduplicated() { mDeduplicatedCount++; }
+	void countCoalesced() { mCoalescedCount++; }
+
+	std::string getAddress() const { return mAddress; }
+	bool isBusy() const { return mCurrent != nullptr; }
+	// Nothing queued, running or being dispatched: the queue can be deleted
+	bool isIdle() const { return !mCurrent && !mDispatching && getDepth() == 0; }
+	unsigned int getDepth() const;
+	unsigned int getDepth(BluetoothGattOperationPriority priority) const { return mOperations[priority].size(); }
+	unsigned int getMaxDepth() const { return mMaxDepth; }
+	unsigned int getEnqueuedCount() const { return mEnqueuedCount; }
+	unsigned int getCompletedCount() const { return mCompletedCount; }
+	unsigned int getTimedOutCount() const { return mTimedOutCount; }
+	unsigned int getDeduplicatedCount() const { return mDeduplicatedCount; }
+	unsigned int getCoalescedCount() const { return mCoalescedCount; }
+
+	static BluetoothGattOperationPriority priorityFromString(const std::string &priority);
+	static std::string priorityToString(BluetoothGattOperationPriority priority);
+
+private:
+	class Operation
+	{
+	public:
+		Operation() :
+			id(0),
+			priority(BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL),
+			timeout(0),
+			startTime(0)
+		{
+		}
+
+		uint32_t id;
+		BluetoothGattOperationPriority priority;
+		BluetoothGattOperationHandler handler;
+		BluetoothGattOperationTimeoutCallback timeoutCallback;
+		guint timeout;
+		// Monotonic time the handler was started
+		int64_t startTime;
+	};
+
+	std::string mAddress;
+	uint32_t mId;
+	std::deque<Operation*> mOperations[BLUETOOTH_GATT_OPERATION_PRIORITY_MAX];
+	Operation *mCurrent;
+	uint32_t mNextOperationId;
+	bool mDispatching;
+
+	unsigned int mMaxDepth;
+	unsigned int mEnqueuedCount;
+	unsigned int mCompletedCount;
+	unsigned int mTimedOutCount;
+	unsigned int mDeduplicatedCount;
+	unsigned int mCoalescedCount;
+
+	Operation *takeNext();
+	void dispatch();
+	void complete(uint32_t operationId);
+
+	// Completion callbacks look their queue up by id: a SIL callback can
+	// arrive after its operation timed out and the idle queue was deleted.
+	static uint32_t nextQueueId;
+	static std::unordered_map<uint32_t, BluetoothGattOperationQueue*> queues;
+	static void completeOperation(uint32_t queueId, uint32_t operationId);
+
+	static gboolean handleOperationTimeout(gpointer userData);
+};
+
+#endif // BLUETOOTHGATTOPERATIONQUEUE_H
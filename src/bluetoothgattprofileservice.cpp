@@ -19,19 +19,30 @@
 #include "bluetoothgattancsprofile.h"
 #include "bluetoothmanagerservice.h"
 #include "bluetoothdevice.h"
+#include "bluetoothmainloopwatchdog.h"
+#include "bluetootheventtrace.h"
 #include "bluetootherrors.h"
 #include "ls2utils.h"
 #include "logging.h"
+#include "utils.h"
+#include "config.h"
 
 using namespace std::placeholders;
 
 BluetoothGattProfileService::BluetoothGattProfileService(BluetoothManagerService *manager) :
-	BluetoothProfileService(manager, "GATT", "00001801-0000-1000-8000-00805f9b34fb")
+	BluetoothProfileService(manager, "GATT", "00001801-0000-1000-8000-00805f9b34fb"),
+	mNextPendingOperationId(1),
+	mNextWriteStreamId(1),
+	mNextMonitorSocketId(1),
+	mNotifyEngine(new BluetoothGattNotifyEngine(std::bind(&BluetoothGattProfileService::notifyLocalCharacteristic, this, _1, _2))),
+	mDiscoveryScheduler(new BluetoothGattDiscoveryScheduler(WEBOS_BLUETOOTH_GATT_MAX_CONCURRENT_DISCOVERIES,
+	                    std::bind(&BluetoothGattProfileService::startServiceDiscovery, this, _1, _2),
+	                    std::bind(&BluetoothGattProfileService::discoveryStateChanged, this, _1, _2)))
 {
 	LS_CREATE_CATEGORY_BEGIN(BluetoothProfileService, base)
-		LS_CATEGORY_METHOD(connect)
-		LS_CATEGORY_METHOD(disconnect)
-		LS_CATEGORY_METHOD(getStatus)
+		BT_CATEGORY_METHOD(connect)
+		BT_CATEGORY_METHOD(disconnect)
+		BT_CATEGORY_METHOD(getStatus)
 		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, openServer)
 		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, closeServer)
 		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, discoverServices)
@@ -46,11 +57,26 @@ BluetoothGattProfileService::BluetoothGattProfileService(BluetoothManagerService
 		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, readDescriptorValue)
 		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, readDescriptorValues)
 		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, writeDescriptorValue)
+		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, readCharacteristicValuesBulk)
+		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, writeCharacteristicValues)
+		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, openWriteStream)
+		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, monitorReadRequests)
+		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, respondReadRequest)
+	LS_CREATE_CATEGORY_END
+
+	LS_CREATE_CATEGORY_BEGIN(BluetoothProfileService, internal)
+		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, getOperationQueueStatus)
+		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, getConnectionPoolStatus)
+		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, getNotificationStatus)
+		LS_CATEGORY_CLASS_METHOD(BluetoothGattProfileService, getDiscoveryStatus)
 	LS_CREATE_CATEGORY_END
 
 	manager->registerCategory("/gatt", LS_CATEGORY_TABLE_NAME(base), NULL, NULL);
 	manager->setCategoryData("/gatt", this);
 
+	manager->registerCategory("/gatt/internal", LS_CATEGORY_TABLE_NAME(internal), NULL, NULL);
+	manager->setCategoryData("/gatt/internal", this);
+
 	BT_DEBUG("Gatt Service Created");
 }
 
@@ -77,10 +103,63 @@ std::string idToString(const uint16_t input)
 
 BluetoothGattProfileService::~BluetoothGattProfileService()
 {
+	for (auto streamIter : mWriteStreams)
+	{
+		delete streamIter.second->writeStream;
+		delete streamIter.second->clientWatch;
+		delete streamIter.second;
+	}
+	mWriteStreams.clear();
+
+	for (auto socketIter : mMonitorCharacteristicSockets)
+	{
+		socketIter.second->removeBinarySocket();
+		delete socketIter.second;
+	}
+	mMonitorCharacteristicSockets.clear();
+
+	for (auto watchIter : mCharacteristicWatches)
+		delete watchIter.second;
+	mCharacteristicWatches.clear();
+
+	for (auto queueIter : mOperationQueues)
+		delete queueIter.second;
+	mOperationQueues.clear();
+
+	for (auto pendingIter : mPendingOperations)
+		delete pendingIter.second;
+	mPendingOperations.clear();
+	mPendingOperationKeys.clear();
+
+	for (auto watchIter : mPooledConnectWatches)
+		delete watchIter.second;
+	mPooledConnectWatches.clear();
+
+	for (auto watch : mReadRequestWatches)
+		delete watch;
+	mReadRequestWatches.clear();
+
+	for (auto readIter : mForwardedReadRequests)
+	{
+		if (readIter.second->timeout)
+			g_source_remove(readIter.second->timeout);
+		delete readIter.second;
+	}
+	mForwardedReadRequests.clear();
+
+	delete mNotifyEngine;
+	delete mDiscoveryScheduler;
 }
 
 BluetoothGattProfileService::BluetoothGattProfileService(BluetoothManagerService *manager, const std::string &name, const std::string &uuid):
-		BluetoothProfileService(manager, name, uuid)
+		BluetoothProfileService(manager, name, uuid),
+		mNextPendingOperationId(1),
+		mNextWriteStreamId(1),
+		mNextMonitorSocketId(1),
+		mNotifyEngine(new BluetoothGattNotifyEngine(std::bind(&BluetoothGattProfileService::notifyLocalCharacteristic, this, _1, _2))),
+		mDiscoveryScheduler(new BluetoothGattDiscoveryScheduler(WEBOS_BLUETOOTH_GATT_MAX_CONCURRENT_DISCOVERIES,
+		                    std::bind(&BluetoothGattProfileService::startServiceDiscovery, this, _1, _2),
+		                    std::bind(&BluetoothGattProfileService::discoveryStateChanged, this, _1, _2)))
 {
 	//Constructor to override ls registration when Gatt sub Service class is instantiated.
 }
@@ -124,7 +203,7 @@ pbnjson::JValue BluetoothGattProfileService::buildGetStatusResp(bool connected,
 	appendCommonProfileStatus(responseObj, connected, connecting, subscribed,
 	                          returnValue, adapterAddress, deviceAddress);
 
-	responseObj.put("discoveringServices", mDiscoveringServices[deviceAddress]);
+	responseObj.put("discoveringServices", mDiscoveryScheduler->isDiscovering(deviceAddress));
 
 	return responseObj;
 }
@@ -135,12 +214,16 @@ void BluetoothGattProfileService::serviceFound(const std::string &address, const
 	std::string adapterAddress;
 	std::string deviceAddress;
 
+	getManager()->getSilTraceWriter()->recordGattService(BLUETOOTH_SIL_TRACE_EVENT_GATT_SERVICE_FOUND, address, service);
+
 	for (auto obsIter = mGattObservers.begin(); obsIter != mGattObservers.end(); obsIter++)
 	{
 		(*obsIter)->serviceFound(address, service);
 		BT_INFO("BLE", 0, "address:%s service:%s Found\n", address.c_str(), service.getUuid().toString().c_str());
 	}
 
+	mServicesPayloadCache.invalidate(address);
+
 	BluetoothGattServiceList serviceList;
 	serviceList.push_back(service);
 	if(getManager()->isAdapterAvailable(address))
@@ -156,12 +239,15 @@ void BluetoothGattProfileService::serviceFound(const std::string &address, const
 		deviceAddress = address;
 	}
 
-	notifyGetServicesSubscribers(localAdapterChanged, adapterAddress, deviceAddress, serviceList);
+	notifyGetServicesSubscribers(localAdapterChanged, adapterAddress, deviceAddress, serviceList, false);
 }
 
 void BluetoothGattProfileService::serviceLost(const std::string &address, const BluetoothGattService &service)
 {
 	//TODO: notify getServices subscriptions
+	mServicesPayloadCache.invalidate(address);
+
+	getManager()->getSilTraceWriter()->recordGattService(BLUETOOTH_SIL_TRACE_EVENT_GATT_SERVICE_LOST, address, service);
 
 	for (auto obsIter = mGattObservers.begin(); obsIter != mGattObservers.end(); obsIter++)
 	{
@@ -173,12 +259,33 @@ void BluetoothGattProfileService::serviceLost(const std::string &address, const
 
 void BluetoothGattProfileService::characteristicValueChanged(const std::string &address, const BluetoothUuid &service, const BluetoothGattCharacteristic &characteristic)
 {
-	BT_INFO("BLE", 0, "characteristic value changed for device %s, service %s, characteristics %s", address.c_str(), service.toString().c_str(), characteristic.getUuid().toString().c_str());
+	// Notifications can arrive at a high rate; they go to the event trace and
+	// are only formatted into the log at debug level
+	BT_DEBUG("characteristic value changed for device %s, service %s, characteristics %s", address.c_str(), service.toString().c_str(), characteristic.getUuid().toString().c_str());
+
+	BluetoothLatencyTracker::Event latencyEvent(getManager()->getLatencyTracker(), BLUETOOTH_LATENCY_EVENT_CHARACTERISTIC_VALUE_CHANGED);
+	BluetoothMainLoopWatchdog::Activity activity("SIL characteristicValueChanged");
+
+	getEventTrace().record(BLUETOOTH_EVENT_TRACE_CHARACTERISTIC_VALUE_CHANGED, address, characteristic.getHandle(),
+	                       characteristic.getValue().size());
+
+	getManager()->getSilTraceWriter()->recordCharacteristic(address, service, characteristic);
 
 	for (auto obsIter = mGattObservers.begin(); obsIter != mGattObservers.end(); obsIter++)
 	{
 		(*obsIter)->characteristicValueChanged(address, service, characteristic);
 	}
+
+	mServicesPayloadCache.invalidate(address);
+
+	if (characteristic.getUuid() == BluetoothUuid(GATT_SERVICE_CHANGED_UUID))
+	{
+		BT_INFO("BLE", 0, "Service Changed indicated by %s, dropping cached services", address.c_str());
+		mServiceCache.invalidate(address);
+
+		if (isDeviceConnected(address))
+			revalidateCachedServices(getManager()->getAddress(), address);
+	}
 	for (auto it = mMonitorCharacteristicSubscriptions.begin() ; it != mMonitorCharacteristicSubscriptions.end(); ++it)
 	{
 		auto subscriptionValue = it->second;
@@ -207,6 +314,14 @@ void BluetoothGattProfileService::characteristicValueChanged(const std::string &
 			continue;
 
 		auto monitorCharacteristicsWatch = it->first;
+
+		auto socketIter = mMonitorCharacteristicSockets.find(monitorCharacteristicsWatch);
+		if (socketIter != mMonitorCharacteristicSockets.end())
+		{
+			sendCharacteristicFrame(socketIter->second, characteristic);
+			continue;
+		}
+
 		pbnjson::JValue responseObj = pbnjson::Object();
 		responseObj.put("returnValue", true);
 		responseObj.put("subscribed", true);
@@ -232,7 +347,7 @@ void BluetoothGattProfileService::characteristicValueChanged(const std::string &
 
 void BluetoothGattProfileService::characteristicValueChanged(const BluetoothUuid &service, const BluetoothGattCharacteristic &characteristic)
 {
-	BT_INFO("BLE", 0, "characteristic value changed for local adapter with service %s, characteristics %s", service.toString().c_str(), characteristic.getUuid().toString().c_str());
+	BT_DEBUG("characteristic value changed for local adapter with service %s, characteristics %s", service.toString().c_str(), characteristic.getUuid().toString().c_str());
 
 	for (auto obsIter = mGattObservers.begin(); obsIter != mGattObservers.end(); obsIter++)
 	{
@@ -248,6 +363,7 @@ void BluetoothGattProfileService::characteristicValueChanged(const BluetoothUuid
 		{
 			localService->desc.updateDescriptorValue(characteristic.getUuid(), it->getUuid(), it->getValue());
 		}
+		mServicesPayloadCache.invalidateLocal();
 	}
 
 	for (auto it = mMonitorCharacteristicSubscriptions.begin() ; it != mMonitorCharacteristicSubscriptions.end(); ++it)
@@ -311,12 +427,23 @@ void BluetoothGattProfileService::descriptorValueChanged(const BluetoothUuid &se
 	if (localService)
 	{
 		localService->desc.updateDescriptorValue(characteristic, descriptor.getUuid(), descriptor.getValue());
+		mServicesPayloadCache.invalidateLocal();
 	}
 }
 
+void BluetoothGattProfileService::deviceUnpaired(const std::string &address)
+{
+	mServiceCache.invalidate(address);
+}
+
 void BluetoothGattProfileService::incomingLeConnectionRequest(const std::string &address, bool state)
 {
 	BT_INFO("BLE", 0, "incomingLeConnectionRequest device %s\n", address.c_str());
+	if (state)
+		mNotifyEngine->addCentral(address);
+	else
+		mNotifyEngine->removeCentral(address);
+
 	for (auto obsIter = mGattObservers.begin(); obsIter != mGattObservers.end(); obsIter++)
 	{
 		(*obsIter)->incomingLeConnectionRequest(address, state);
@@ -336,7 +463,8 @@ bool BluetoothGattProfileService::discoverServices(LSMessage &message)
 		return true;
 	}
 
-	const std::string schema = STRICT_SCHEMA(PROPS_2(PROP(adapterAddress, string), PROP(address, string)));
+	const std::string schema = STRICT_SCHEMA(PROPS_3(PROP(adapterAddress, string), PROP(address, string),
+	                                                 PROP_WITH_VAL_3(priority, string, "high", "normal", "background")));
 
 	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
 	{
@@ -365,6 +493,10 @@ bool BluetoothGattProfileService::discoverServices(LSMessage &message)
 		adapterAddress = getManager()->getAddress();
 	}
 
+	BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL;
+	if (requestObj.hasKey("priority"))
+		priority = BluetoothGattOperationQueue::priorityFromString(requestObj["priority"].asString());
+
 	std::string address;
 	bool remoteServiceDiscovery = false;
 	if (requestObj.hasKey("address"))
@@ -382,6 +514,23 @@ bool BluetoothGattProfileService::discoverServices(LSMessage &message)
 			LSUtils::respondWithError(request, BT_ERR_PROFILE_NOT_CONNECTED);
 			return true;
 		}
+
+		// Paired devices rarely change their attribute database. Answer from
+		// the cache right away and check it with a real discovery afterwards.
+		BluetoothGattServiceList cachedServices;
+		if (lookupCachedServices(address, cachedServices))
+		{
+			pbnjson::JValue responseObj = pbnjson::Object();
+			responseObj.put("returnValue", true);
+			responseObj.put("adapterAddress", adapterAddress);
+			responseObj.put("address", address);
+			responseObj.put("cached", true);
+
+			LSUtils::postToClient(request, responseObj);
+
+			revalidateCachedServices(adapterAddress, address);
+			return true;
+		}
 	}
 
 	LSMessage *requestMessage = request.get();
@@ -390,18 +539,16 @@ bool BluetoothGattProfileService::discoverServices(LSMessage &message)
 	auto discoverServicesCallback  = [this, requestMessage, remoteServiceDiscovery, adapterAddress, address](BluetoothError error) {
 		BT_INFO("BLE", 0, "Service discovery process finished for device %s", address.c_str());
 
-		if (mDiscoveringServices[address])
-		{
-			mDiscoveringServices[address] = false;
-			notifyStatusSubscribers(adapterAddress, address, isDeviceConnected(address));
-		}
-
 		if (error != BLUETOOTH_ERROR_NONE)
 		{
 			LSUtils::respondWithError(requestMessage, BT_ERR_GATT_SERVICE_DISCOVERY_FAIL);
 			return;
 		}
 
+		// Subscribers already got the services one by one through serviceFound
+		if (remoteServiceDiscovery)
+			cacheDiscoveredServices(adapterAddress, address, false);
+
 		pbnjson::JValue responseObj = pbnjson::Object();
 		responseObj.put("returnValue", true);
 		responseObj.put("adapterAddress", adapterAddress);
@@ -413,15 +560,7 @@ bool BluetoothGattProfileService::discoverServices(LSMessage &message)
 
 	if (remoteServiceDiscovery)
 	{
-		auto discoveringServicesIter = mDiscoveringServices.find(address);
-		if (discoveringServicesIter == mDiscoveringServices.end())
-			mDiscoveringServices.insert(std::pair<std::string, bool>(address, true));
-		else
-			mDiscoveringServices[address] = true;
-
-		notifyStatusSubscribers(getManager()->getAddress(), address, isDeviceConnected(address));
-		BT_DEBUG("getImpl->discoverServices\n");
-		getImpl<BluetoothGattProfile>()->discoverServices(address, discoverServicesCallback);
+		mDiscoveryScheduler->schedule(address, priority, discoverServicesCallback);
 	}
 	else
 	{
@@ -432,6 +571,108 @@ bool BluetoothGattProfileService::discoverServices(LSMessage &message)
 	return true;
 }
 
+bool BluetoothGattProfileService::lookupCachedServices(const std::string &address, BluetoothGattServiceList &services)
+{
+	// Entries are dropped when the device gets unpaired
+	auto device = getManager()->findDevice(address);
+	if (!device || !device->getPaired())
+		return false;
+
+	if (!mServiceCache.lookup(address, services))
+		return false;
+
+	BT_DEBUG("Serving %zu cached GATT services of %s (%u hits, %u misses)", services.size(), address.c_str(),
+	         mServiceCache.getHitCount(), mServiceCache.getMissCount());
+
+	return true;
+}
+
+BluetoothGattServiceList BluetoothGattProfileService::getRemoteServices(const std::string &address)
+{
+	BluetoothGattServiceList services = getImpl<BluetoothGattProfile>()->getServices(address);
+
+	// discoverServices answers from the cache before the stack has
+	// discovered anything, operations have to resolve against it until then
+	if (services.empty())
+		lookupCachedServices(address, services);
+
+	return services;
+}
+
+BluetoothGattService BluetoothGattProfileService::getRemoteService(const std::string &address, const std::string &serviceUuid)
+{
+	BluetoothGattService service = getImpl<BluetoothGattProfile>()->getService(address, serviceUuid);
+	if (service.isValid())
+		return service;
+
+	BluetoothGattServiceList cachedServices;
+	if (!getImpl<BluetoothGattProfile>()->getServices(address).empty() || !lookupCachedServices(address, cachedServices))
+		return service;
+
+	BluetoothUuid uuid(serviceUuid);
+	for (auto cachedService : cachedServices)
+	{
+		if (cachedService.getUuid() == uuid)
+			return cachedService;
+	}
+
+	return service;
+}
+
+void BluetoothGattProfileService::cacheDiscoveredServices(const std::string &adapterAddress, const std::string &address, bool notifyChanges)
+{
+	auto device = getManager()->findDevice(address);
+	if (!device || !device->getPaired())
+		return;
+
+	BluetoothGattServiceList serviceList = getImpl<BluetoothGattProfile>()->getServices(address);
+	if (serviceList.empty())
+		return;
+
+	if (!mServiceCache.store(address, serviceList) || !notifyChanges)
+		return;
+
+	BT_INFO("BLE", 0, "GATT database of %s differs from the cached one", address.c_str());
+
+	notifyGetServicesSubscribers(false, adapterAddress, address, serviceList, true);
+}
+
+void BluetoothGattProfileService::revalidateCachedServices(const std::string &adapterAddress, const std::string &address)
+{
+	// A discovery which is already scheduled refreshes the cache when it finishes
+	if (mDiscoveryScheduler->isDiscovering(address))
+		return;
+
+	BT_DEBUG("Scheduling discovery to revalidate cached services of %s\n", address.c_str());
+	mDiscoveryScheduler->schedule(address, BLUETOOTH_GATT_OPERATION_PRIORITY_BACKGROUND, [this, adapterAddress, address](BluetoothError error) {
+		if (error != BLUETOOTH_ERROR_NONE)
+		{
+			BT_DEBUG("Revalidating cached services of %s failed with error %d", address.c_str(), error);
+			return;
+		}
+
+		cacheDiscoveredServices(adapterAddress, address, true);
+	});
+}
+
+void BluetoothGattProfileService::startServiceDiscovery(const std::string &address, BluetoothResultCallback callback)
+{
+	if (!getImpl<BluetoothGattProfile>())
+	{
+		callback(BLUETOOTH_ERROR_NOT_READY);
+		return;
+	}
+
+	BT_DEBUG("getImpl->discoverServices\n");
+	getImpl<BluetoothGattProfile>()->discoverServices(address, callback);
+}
+
+void BluetoothGattProfileService::discoveryStateChanged(const std::string &address, bool discovering)
+{
+	BT_DEBUG("Service discovery of %s %s", address.c_str(), discovering ? "scheduled" : "finished");
+	notifyStatusSubscribers(getManager()->getAddress(), address, isDeviceConnected(address));
+}
+
 BluetoothGattService::Type serviceTypeStringToType(const std::string str)
 {
 	BluetoothGattService::Type type = BluetoothGattService::Type::UNKNOWN;
@@ -656,6 +897,7 @@ bool BluetoothGattProfileService::addService(LSMessage &message)
 		responseObj.put("returnValue", true);
 		responseObj.put("serverId", idToString(localServer->id));
 		responseObj.put("adapterAddress", getManager()->getAddress());
+		responseObj.put("registrationTime", (int32_t) (localService->registrationTime / 1000));
 
 		LSUtils::postToClient(requestMessage, responseObj);
 	};
@@ -887,7 +1129,8 @@ std::string serviceTypeToStr(BluetoothGattService::Type type)
 }
 
 void BluetoothGattProfileService::notifyGetServicesSubscribers(bool localAdapterChanged, const std::string &adapterAddress,
-                                                                       const std::string &deviceAddress, BluetoothGattServiceList serviceList)
+                                                                       const std::string &deviceAddress, const BluetoothGattServiceList &serviceList,
+                                                                       bool completeList)
 {
 	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
 	std::string address;
@@ -902,15 +1145,25 @@ void BluetoothGattProfileService::notifyGetServicesSubscribers(bool localAdapter
 
 	LS::SubscriptionPoint *subscriptionPoint = subscriptionIter->second;
 
+	// A complete list is what getServices answers as well, so the following
+	// calls reuse its serialization. Single found services are sent alone.
+	std::string servicesPayload = serializeServices(localAdapterChanged, serviceList);
+	if (completeList)
+		mServicesPayloadCache.store(address, localAdapterChanged, servicesPayload);
+
 	pbnjson::JValue responseObj = pbnjson::Object();
 	responseObj.put("returnValue", true);
 	responseObj.put("subscribed", true);
 	responseObj.put("adapterAddress", adapterAddress);
 	if (!deviceAddress.empty())
 		responseObj.put("address", deviceAddress);
-	appendServiceResponse(localAdapterChanged, responseObj, serviceList);
 
-	LSUtils::postToSubscriptionPoint(subscriptionPoint, responseObj);
+	std::string payload;
+	LSUtils::generatePayload(responseObj, payload);
+	payload.erase(payload.length() - 1);
+	payload += "," + servicesPayload + "}";
+
+	LSUtils::postToSubscriptionPoint(subscriptionPoint, payload);
 }
 
 pbnjson::JValue BluetoothGattProfileService::buildDescriptor(const BluetoothGattDescriptor &descriptor, bool localAdapterServices)
@@ -1084,7 +1337,7 @@ pbnjson::JValue BluetoothGattProfileService::buildCharacteristics(bool localAdap
 	return characteristics;
 }
 
-void BluetoothGattProfileService::appendServiceResponse(bool localAdapterServices, pbnjson::JValue responseObj, BluetoothGattServiceList serviceList)
+void BluetoothGattProfileService::appendServiceResponse(bool localAdapterServices, pbnjson::JValue responseObj, const BluetoothGattServiceList &serviceList)
 {
 	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
 	pbnjson::JValue responseServices = pbnjson::Array();
@@ -1117,6 +1370,18 @@ void BluetoothGattProfileService::appendServiceResponse(bool localAdapterService
 	responseObj.put("services", responseServices);
 }
 
+std::string BluetoothGattProfileService::serializeServices(bool localAdapterServices, const BluetoothGattServiceList &serviceList)
+{
+	pbnjson::JValue servicesObj = pbnjson::Object();
+	appendServiceResponse(localAdapterServices, servicesObj, serviceList);
+
+	// Keep only the "services":[...] member so it can be spliced into any response
+	std::string payload;
+	LSUtils::generatePayload(servicesObj, payload);
+
+	return payload.substr(1, payload.length() - 2);
+}
+
 bool BluetoothGattProfileService::getServices(LSMessage &message)
 {
 	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
@@ -1216,17 +1481,33 @@ bool BluetoothGattProfileService::getServices(LSMessage &message)
 		subscriptionPoint->subscribe(request);
 	}
 
-	BluetoothGattServiceList serviceList;
-	if(localServices)
-	{
-		serviceList = getLocalServices();
-	}
-	else
+	std::string servicesPayload;
+	bool cached = false;
+	if (!mServicesPayloadCache.lookup(address, localServices, servicesPayload))
 	{
-		BT_DEBUG("[%s](%d) getImpl->getServices\n", __FUNCTION__, __LINE__);
-		serviceList = getImpl<BluetoothGattProfile>()->getServices(address);
+		BluetoothGattServiceList serviceList;
+		if(localServices)
+		{
+			serviceList = getLocalServices();
+		}
+		else
+		{
+			BT_DEBUG("[%s](%d) getImpl->getServices\n", __FUNCTION__, __LINE__);
+			serviceList = getImpl<BluetoothGattProfile>()->getServices(address);
+
+			// Nothing discovered yet on this connection
+			if (serviceList.empty())
+				cached = lookupCachedServices(address, serviceList);
+		}
+		BT_DEBUG("Got list of GATT services for address %s", address.c_str());
+
+		servicesPayload = serializeServices(localServices, serviceList);
+
+		// Services restored from the persistent cache are replaced by the
+		// discovered ones soon, so don't keep their serialization around
+		if (!cached)
+			mServicesPayloadCache.store(address, localServices, servicesPayload);
 	}
-	BT_DEBUG("Got list of GATT services for address %s", address.c_str());
 
 	pbnjson::JValue responseObj = pbnjson::Object();
 	responseObj.put("returnValue", true);
@@ -1235,9 +1516,15 @@ bool BluetoothGattProfileService::getServices(LSMessage &message)
 		responseObj.put("subscribed", true);
 	if (!deviceAddress.empty())
 		responseObj.put("address", deviceAddress);
-	appendServiceResponse(localServices, responseObj, serviceList);
+	if (cached)
+		responseObj.put("cached", true);
 
-	LSUtils::postToClient(request, responseObj);
+	std::string payload;
+	LSUtils::generatePayload(responseObj, payload);
+	payload.erase(payload.length() - 1);
+	payload += "," + servicesPayload + "}";
+
+	LSUtils::postToClient(request, payload);
 
 	return true;
 }
@@ -1258,7 +1545,7 @@ bool BluetoothGattProfileService::isCharacteristicValid(const std::string &addre
 	}
 	else
 	{
-		BluetoothGattServiceList services = getImpl<BluetoothGattProfile>()->getServices(address);
+		BluetoothGattServiceList services = getRemoteServices(address);
 		for (auto service : services)
 		{
 			BluetoothGattCharacteristicList characteristicList = service.getCharacteristics();
@@ -1286,7 +1573,7 @@ bool BluetoothGattProfileService::isCharacteristicValid(const std::string &addre
 	if (address.empty())
 		service = getLocalService(serviceUuid);
 	else
-		service = getImpl<BluetoothGattProfile>()->getService(address, serviceUuid);
+		service = getRemoteService(address, serviceUuid);
 
 	BluetoothGattCharacteristicList characteristicList = service.getCharacteristics();
 	for (auto characteristicElement : characteristicList)
@@ -1335,9 +1622,10 @@ bool BluetoothGattProfileService::writeCharacteristicValue(LSMessage &message)
 		return true;
 	}
 
-	const std::string schema = STRICT_SCHEMA(PROPS_7(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
+	const std::string schema = STRICT_SCHEMA(PROPS_8(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
 	                                                 PROP(service, string), PROP(characteristic, string),
 	                                                 PROP(writeType, string),
+	                                                 PROP_WITH_VAL_3(priority, string, "high", "normal", "background"),
 	                                                 OBJECT(value, OBJSCHEMA_3(PROP(string, string),
 	                                                                           PROP(number, integer),
 	                                                                           ARRAY(bytes, integer))))
@@ -1463,6 +1751,10 @@ bool BluetoothGattProfileService::writeCharacteristicValue(LSMessage &message)
 			characteristicToWrite.setWriteType(WriteType::SIGNED);
 	}
 
+	BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL;
+	if (requestObj.hasKey("priority"))
+		priority = BluetoothGattOperationQueue::priorityFromString(requestObj["priority"].asString());
+
 	LSMessage *requestMessage = request.get();
 	LSMessageRef(requestMessage);
 
@@ -1487,20 +1779,10 @@ bool BluetoothGattProfileService::writeCharacteristicValue(LSMessage &message)
 	BT_INFO("BLE", 0, "[%s](%d) getImpl->writeCharacteristic\n", __FUNCTION__, __LINE__);
 	if (!deviceAddress.empty())
 	{
-		if(connectId > 0)
-		{
-			if (!requestObj.hasKey("instanceId"))
-				getImpl<BluetoothGattProfile>()->writeCharacteristic(connectId, serviceUuid, characteristicToWrite, writeCharacteristicCallback);
-			else
-				getImpl<BluetoothGattProfile>()->writeCharacteristic(connectId, characteristicToWrite, writeCharacteristicCallback);
-		}
+		if (!requestObj.hasKey("instanceId"))
+			writeRemoteCharacteristic(deviceAddress, serviceUuid, characteristicToWrite, writeCharacteristicCallback, priority);
 		else
-		{
-			if (!requestObj.hasKey("instanceId"))
-				getImpl<BluetoothGattProfile>()->writeCharacteristic(deviceAddress, serviceUuid, characteristicToWrite, writeCharacteristicCallback);
-			else
-				getImpl<BluetoothGattProfile>()->writeCharacteristic(deviceAddress, characteristicToWrite, writeCharacteristicCallback);
-		}
+			writeRemoteCharacteristic(deviceAddress, BluetoothUuid(), characteristicToWrite, writeCharacteristicCallback, priority);
 	}
 	else
 	{
@@ -1512,127 +1794,408 @@ bool BluetoothGattProfileService::writeCharacteristicValue(LSMessage &message)
 	return true;
 }
 
-bool BluetoothGattProfileService::writeRemoteCharacteristic(const std::string deviceAddress,
-		const BluetoothUuid &serviceUuid, const BluetoothGattCharacteristic &characteristicToWrite,
-		BluetoothResultCallback callback)
+BluetoothGattOperationQueue* BluetoothGattProfileService::getOperationQueue(const std::string &address)
 {
-	uint16_t connectId = getImpl<BluetoothGattProfile>()->getConnectId(deviceAddress);
-	if(connectId > 0)
-	{
-		if (!serviceUuid.toString().empty())
-			getImpl<BluetoothGattProfile>()->writeCharacteristic(connectId, serviceUuid, characteristicToWrite, callback);
-		else
-			getImpl<BluetoothGattProfile>()->writeCharacteristic(connectId, characteristicToWrite, callback);
-	}
-	else
+	auto queueIter = mOperationQueues.find(address);
+	if (queueIter != mOperationQueues.end())
+		return queueIter->second;
+
+	pruneOperationQueues();
+
+	BluetoothGattOperationQueue *queue = new BluetoothGattOperationQueue(address);
+	mOperationQueues.insert(std::pair<std::string, BluetoothGattOperationQueue*>(address, queue));
+
+	return queue;
+}
+
+void BluetoothGattProfileService::pruneOperationQueues()
+{
+	for (auto queueIter = mOperationQueues.begin(); queueIter != mOperationQueues.end();)
 	{
-		if (!serviceUuid.toString().empty())
-			getImpl<BluetoothGattProfile>()->writeCharacteristic(deviceAddress, serviceUuid, characteristicToWrite, callback);
+		if (queueIter->second->isIdle())
+		{
+			delete queueIter->second;
+			queueIter = mOperationQueues.erase(queueIter);
+		}
 		else
-			getImpl<BluetoothGattProfile>()->writeCharacteristic(deviceAddress, characteristicToWrite, callback);
+			queueIter++;
 	}
-	return true;
 }
 
-bool BluetoothGattProfileService::readRemoteCharacteristic(const std::string deviceAddress,
-		const BluetoothUuid &serviceUuid, const BluetoothUuid &characteristicUuid, const uint16_t characteristicHandle,
-		BluetoothGattReadCharacteristicCallback callback)
+std::string BluetoothGattProfileService::buildOperationKey(const std::string &operation, const std::string &address,
+		const BluetoothUuid &serviceUuid, const BluetoothUuid &characteristicUuid, const BluetoothUuid &descriptorUuid, const uint16_t handle)
 {
-	uint16_t connectId = getImpl<BluetoothGattProfile>()->getConnectId(deviceAddress);
+	std::string key = operation + "/" + address + "/";
 
-	if(connectId > 0)
-	{
-		if (!serviceUuid.toString().empty() && !characteristicUuid.toString().empty())
-			getImpl<BluetoothGattProfile>()->readCharacteristic(connectId, serviceUuid, characteristicUuid, callback);
-		else
-			getImpl<BluetoothGattProfile>()->readCharacteristic(connectId, characteristicHandle, callback);
-	}
+	if (handle > 0)
+		key += idToString(handle);
 	else
-	{
-		if (!serviceUuid.toString().empty() && !characteristicUuid.toString().empty())
-			getImpl<BluetoothGattProfile>()->readCharacteristic(deviceAddress, serviceUuid, characteristicUuid, callback);
-		else
-			getImpl<BluetoothGattProfile>()->readCharacteristic(deviceAddress, characteristicHandle, callback);
-	}
-	return true;
+		key += serviceUuid.toString() + "/" + characteristicUuid.toString() + "/" + descriptorUuid.toString();
+
+	return key;
 }
 
-bool BluetoothGattProfileService::readRemoteCharacteristics(const std::string deviceAddress,
-		const BluetoothUuid &serviceUuid, const BluetoothUuidList &characteristicUuids,
-		BluetoothGattReadCharacteristicsCallback callback)
+uint32_t BluetoothGattProfileService::addPendingOperation(const std::string &key)
 {
-	uint16_t connectId = getImpl<BluetoothGattProfile>()->getConnectId(deviceAddress);
-	if(connectId > 0)
-			getImpl<BluetoothGattProfile>()->readCharacteristics(connectId, serviceUuid, characteristicUuids, callback);
-	else
-		getImpl<BluetoothGattProfile>()->readCharacteristics(deviceAddress, serviceUuid, characteristicUuids, callback);
+	uint32_t operationId = mNextPendingOperationId++;
 
-	return true;
+	PendingGattOperation *pendingOperation = new PendingGattOperation();
+	pendingOperation->key = key;
+	mPendingOperations.insert(std::pair<uint32_t, PendingGattOperation*>(operationId, pendingOperation));
+
+	if (!key.empty())
+		mPendingOperationKeys[key] = operationId;
+
+	return operationId;
 }
 
-bool BluetoothGattProfileService::readCharacteristicValue(LSMessage &message)
+PendingGattOperation* BluetoothGattProfileService::findPendingOperation(const std::string &key)
 {
-	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
-	LS::Message request(&message);
-	pbnjson::JValue requestObj;
-	int parseError = 0;
+	auto keyIter = mPendingOperationKeys.find(key);
+	if (keyIter == mPendingOperationKeys.end())
+		return nullptr;
 
-	if (!mImpl && !getImpl<BluetoothGattProfile>())
-	{
-		LSUtils::respondWithError(request, BT_ERR_PROFILE_UNAVAIL);
-		return true;
-	}
+	auto pendingIter = mPendingOperations.find(keyIter->second);
+	if (pendingIter == mPendingOperations.end())
+		return nullptr;
 
-	const std::string schema = STRICT_SCHEMA(PROPS_5(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
-	                                                 PROP(service, string), PROP(characteristic, string)));
+	return pendingIter->second;
+}
 
-	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
-	{
-		if (parseError != JSON_PARSE_SCHEMA_ERROR)
-			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+void BluetoothGattProfileService::queuePendingOperation(BluetoothGattOperationQueue *queue, uint32_t operationId,
+		BluetoothGattOperationPriority priority, BluetoothGattOperationHandler handler, BluetoothGattOperationTimeoutCallback timeoutCallback)
+{
+	mPendingOperations[operationId]->priority = priority;
 
-		else if (requestObj.hasKey("instanceId"))
-			LSUtils::respondWithError(request, BT_ERR_GATT_INSTANCE_ID_NOT_SUPPORTED);
+	uint32_t queueOperationId = queue->push(priority, handler, timeoutCallback);
 
-		else
-			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+	// A handler which completes synchronously already finished the operation
+	auto pendingIter = mPendingOperations.find(operationId);
+	if (pendingIter != mPendingOperations.end())
+		pendingIter->second->queueOperationId = queueOperationId;
+}
 
-		return true;
-	}
+void BluetoothGattProfileService::joinPendingOperation(BluetoothGattOperationQueue *queue, PendingGattOperation *pendingOperation,
+		BluetoothGattOperationPriority priority)
+{
+	// A caller joining an operation which is still waiting must not wait
+	// longer than its own priority asks for
+	if (priority < pendingOperation->priority && queue->raisePriority(pendingOperation->queueOperationId, priority))
+		pendingOperation->priority = priority;
+}
 
-	if (!requestObj.hasKey("instanceId"))
+void BluetoothGattProfileService::forgetPendingOperationKey(const std::string &key)
+{
+	// The operation still runs and answers its callers, but no new caller joins it
+	mPendingOperationKeys.erase(key);
+}
+
+PendingGattOperation* BluetoothGattProfileService::takePendingOperation(uint32_t operationId)
+{
+	// Either the SIL callback or the queue timeout finishes an operation,
+	// whichever comes first. The other one finds nothing here.
+	auto pendingIter = mPendingOperations.find(operationId);
+	if (pendingIter == mPendingOperations.end())
+		return nullptr;
+
+	PendingGattOperation *pendingOperation = pendingIter->second;
+	mPendingOperations.erase(pendingIter);
+
+	auto keyIter = mPendingOperationKeys.find(pendingOperation->key);
+	if (keyIter != mPendingOperationKeys.end() && keyIter->second == operationId)
+		mPendingOperationKeys.erase(keyIter);
+
+	return pendingOperation;
+}
+
+void BluetoothGattProfileService::completeBulkItem(BulkGattRequest *bulkRequest, unsigned int index, pbnjson::JValue result)
+{
+	if (index < bulkRequest->results.size())
+		bulkRequest->results[index] = result;
+
+	if (!result["returnValue"].asBool())
+		bulkRequest->failed++;
+
+	if (--bulkRequest->remaining > 0)
+		return;
+
+	BT_INFO("BLE", 0, "Bulk GATT request complete, %u of %zu items failed", bulkRequest->failed, bulkRequest->results.size());
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", bulkRequest->failed == 0);
+	if (bulkRequest->failed > 0)
 	{
-		if (!requestObj.hasKey("service"))
-		{
-			LSUtils::respondWithError(request, BT_ERR_GATT_SERVICE_NAME_PARAM_MISSING);
-			return true;
-		}
-		else if (!requestObj.hasKey("characteristic"))
-		{
-			LSUtils::respondWithError(request, BT_ERR_GATT_CHARACTERISTIC_PARAM_MISSING);
-			return true;
-		}
-		else if(!requestObj.hasKey("characteristic") && !requestObj.hasKey("service"))
-		{
-			LSUtils::respondWithError(request, BT_ERR_GATT_HANDLES_PARAM_MISSING);
-			return true;
-		}
+		responseObj.put("errorCode", (int) bulkRequest->errorCode);
+		responseObj.put("errorText", retrieveErrorText(bulkRequest->errorCode));
 	}
+	responseObj.put("adapterAddress", bulkRequest->adapterAddress);
 
-	// TODO: Change all inputs for local service to lowercase
+	if (!bulkRequest->deviceAddress.empty())
+		responseObj.put("address", bulkRequest->deviceAddress);
 
-	std::string adapterAddress;
-	if (requestObj.hasKey("adapterAddress"))
-	{
-		adapterAddress = requestObj["adapterAddress"].asString();
-		if (!getManager()->isAdapterAvailable(adapterAddress))
+	pbnjson::JValue resultsArray = pbnjson::Array();
+	for (auto resultObj : bulkRequest->results)
+		resultsArray.append(resultObj);
+	responseObj.put("results", resultsArray);
+
+	LSUtils::postToClient(bulkRequest->requestMessage, responseObj);
+	LSMessageUnref(bulkRequest->requestMessage);
+
+	delete bulkRequest;
+}
+
+bool BluetoothGattProfileService::writeRemoteCharacteristic(const std::string deviceAddress,
+		const BluetoothUuid &serviceUuid, const BluetoothGattCharacteristic &characteristicToWrite,
+		BluetoothResultCallback callback, BluetoothGattOperationPriority priority)
+{
+	BluetoothGattOperationQueue *queue = getOperationQueue(deviceAddress);
+	std::string key;
+
+	// A read issued after this write has to see the written value, so it must
+	// not join a read of the characteristic that was queued before the write.
+	forgetPendingOperationKey(buildOperationKey("readCharacteristic", deviceAddress, serviceUuid, characteristicToWrite.getUuid(),
+	                                            BluetoothUuid(), characteristicToWrite.getHandle()));
+	forgetPendingOperationKey(buildOperationKey("readCharacteristic", deviceAddress, serviceUuid, characteristicToWrite.getUuid(),
+	                                            BluetoothUuid(), 0));
+
+	// Background writes only care about the latest value: a write which is
+	// still waiting in the queue for the same characteristic just takes the
+	// new value, and all callers get the result of that single write.
+	// Normal and high priority writes are often commands to a control point,
+	// where every single write matters, so they are never coalesced.
+	if (priority == BLUETOOTH_GATT_OPERATION_PRIORITY_BACKGROUND)
+	{
+		key = buildOperationKey("writeCharacteristic", deviceAddress, serviceUuid, characteristicToWrite.getUuid(), BluetoothUuid(), characteristicToWrite.getHandle());
+
+		PendingGattOperation *pendingOperation = findPendingOperation(key);
+		if (pendingOperation && !pendingOperation->started)
 		{
-			LSUtils::respondWithError(request, BT_ERR_INVALID_ADAPTER_ADDRESS);
+			pendingOperation->characteristic = characteristicToWrite;
+			pendingOperation->writeCallbacks.push_back(callback);
+			queue->countCoalesced();
 			return true;
 		}
 	}
-	else
-	{
+
+	uint32_t operationId = addPendingOperation(key);
+	mPendingOperations[operationId]->characteristic = characteristicToWrite;
+	mPendingOperations[operationId]->writeCallbacks.push_back(callback);
+
+	auto notifyWriteCallbacks = [this, operationId](BluetoothError error) {
+		PendingGattOperation *pendingOperation = takePendingOperation(operationId);
+		if (!pendingOperation)
+			return;
+
+		for (auto writeCallback : pendingOperation->writeCallbacks)
+			writeCallback(error);
+
+		delete pendingOperation;
+	};
+
+	auto writeHandler = [this, deviceAddress, serviceUuid, operationId, notifyWriteCallbacks](BluetoothGattOperationCompleteCallback complete) {
+		auto pendingIter = mPendingOperations.find(operationId);
+		if (pendingIter == mPendingOperations.end())
+		{
+			complete();
+			return;
+		}
+
+		pendingIter->second->started = true;
+		BluetoothGattCharacteristic characteristic = pendingIter->second->characteristic;
+
+		auto writeCallback = [this, deviceAddress, complete, notifyWriteCallbacks](BluetoothError error) {
+			complete();
+			mServicesPayloadCache.invalidate(deviceAddress);
+			notifyWriteCallbacks(error);
+		};
+
+		uint16_t connectId = getImpl<BluetoothGattProfile>()->getConnectId(deviceAddress);
+		if(connectId > 0)
+		{
+			if (!serviceUuid.toString().empty())
+				getImpl<BluetoothGattProfile>()->writeCharacteristic(connectId, serviceUuid, characteristic, writeCallback);
+			else
+				getImpl<BluetoothGattProfile>()->writeCharacteristic(connectId, characteristic, writeCallback);
+		}
+		else
+		{
+			if (!serviceUuid.toString().empty())
+				getImpl<BluetoothGattProfile>()->writeCharacteristic(deviceAddress, serviceUuid, characteristic, writeCallback);
+			else
+				getImpl<BluetoothGattProfile>()->writeCharacteristic(deviceAddress, characteristic, writeCallback);
+		}
+	};
+
+	queuePendingOperation(queue, operationId, priority, writeHandler, [notifyWriteCallbacks]() {
+		notifyWriteCallbacks(BLUETOOTH_ERROR_FAIL);
+	});
+
+	return true;
+}
+
+bool BluetoothGattProfileService::readRemoteCharacteristic(const std::string deviceAddress,
+		const BluetoothUuid &serviceUuid, const BluetoothUuid &characteristicUuid, const uint16_t characteristicHandle,
+		BluetoothGattReadCharacteristicCallback callback, BluetoothGattOperationPriority priority)
+{
+	BluetoothGattOperationQueue *queue = getOperationQueue(deviceAddress);
+
+	// Identical reads share the result of the one already queued or in flight
+	std::string key = buildOperationKey("readCharacteristic", deviceAddress, serviceUuid, characteristicUuid, BluetoothUuid(), characteristicHandle);
+	PendingGattOperation *pendingOperation = findPendingOperation(key);
+	if (pendingOperation)
+	{
+		pendingOperation->readCharacteristicCallbacks.push_back(callback);
+		joinPendingOperation(queue, pendingOperation, priority);
+		queue->countDeduplicated();
+		return true;
+	}
+
+	uint32_t operationId = addPendingOperation(key);
+	mPendingOperations[operationId]->readCharacteristicCallbacks.push_back(callback);
+
+	auto notifyReadCallbacks = [this, operationId](BluetoothError error, BluetoothGattCharacteristic characteristic) {
+		PendingGattOperation *pendingOperation = takePendingOperation(operationId);
+		if (!pendingOperation)
+			return;
+
+		for (auto readCallback : pendingOperation->readCharacteristicCallbacks)
+			readCallback(error, characteristic);
+
+		delete pendingOperation;
+	};
+
+	auto readHandler = [this, deviceAddress, serviceUuid, characteristicUuid, characteristicHandle, notifyReadCallbacks](BluetoothGattOperationCompleteCallback complete) {
+		auto readCallback = [this, deviceAddress, complete, notifyReadCallbacks](BluetoothError error, BluetoothGattCharacteristic characteristic) {
+			complete();
+			mServicesPayloadCache.invalidate(deviceAddress);
+			notifyReadCallbacks(error, characteristic);
+		};
+
+		uint16_t connectId = getImpl<BluetoothGattProfile>()->getConnectId(deviceAddress);
+		if(connectId > 0)
+		{
+			if (!serviceUuid.toString().empty() && !characteristicUuid.toString().empty())
+				getImpl<BluetoothGattProfile>()->readCharacteristic(connectId, serviceUuid, characteristicUuid, readCallback);
+			else
+				getImpl<BluetoothGattProfile>()->readCharacteristic(connectId, characteristicHandle, readCallback);
+		}
+		else
+		{
+			if (!serviceUuid.toString().empty() && !characteristicUuid.toString().empty())
+				getImpl<BluetoothGattProfile>()->readCharacteristic(deviceAddress, serviceUuid, characteristicUuid, readCallback);
+			else
+				getImpl<BluetoothGattProfile>()->readCharacteristic(deviceAddress, characteristicHandle, readCallback);
+		}
+	};
+
+	queuePendingOperation(queue, operationId, priority, readHandler, [notifyReadCallbacks]() {
+		notifyReadCallbacks(BLUETOOTH_ERROR_FAIL, BluetoothGattCharacteristic());
+	});
+
+	return true;
+}
+
+bool BluetoothGattProfileService::readRemoteCharacteristics(const std::string deviceAddress,
+		const BluetoothUuid &serviceUuid, const BluetoothUuidList &characteristicUuids,
+		BluetoothGattReadCharacteristicsCallback callback, BluetoothGattOperationPriority priority)
+{
+	// Only one of the SIL callback and the queue timeout may answer the caller
+	uint32_t operationId = addPendingOperation(std::string());
+
+	auto notifyReadCallback = [this, operationId, callback](BluetoothError error, BluetoothGattCharacteristicList characteristics) {
+		PendingGattOperation *pendingOperation = takePendingOperation(operationId);
+		if (!pendingOperation)
+			return;
+
+		delete pendingOperation;
+		callback(error, characteristics);
+	};
+
+	auto readHandler = [this, deviceAddress, serviceUuid, characteristicUuids, notifyReadCallback](BluetoothGattOperationCompleteCallback complete) {
+		auto readCallback = [this, deviceAddress, complete, notifyReadCallback](BluetoothError error, BluetoothGattCharacteristicList characteristics) {
+			complete();
+			mServicesPayloadCache.invalidate(deviceAddress);
+			notifyReadCallback(error, characteristics);
+		};
+
+		uint16_t connectId = getImpl<BluetoothGattProfile>()->getConnectId(deviceAddress);
+		if(connectId > 0)
+			getImpl<BluetoothGattProfile>()->readCharacteristics(connectId, serviceUuid, characteristicUuids, readCallback);
+		else
+			getImpl<BluetoothGattProfile>()->readCharacteristics(deviceAddress, serviceUuid, characteristicUuids, readCallback);
+	};
+
+	getOperationQueue(deviceAddress)->push(priority, readHandler, [notifyReadCallback]() {
+		notifyReadCallback(BLUETOOTH_ERROR_FAIL, BluetoothGattCharacteristicList());
+	});
+
+	return true;
+}
+
+bool BluetoothGattProfileService::readCharacteristicValue(LSMessage &message)
+{
+	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!mImpl && !getImpl<BluetoothGattProfile>())
+	{
+		LSUtils::respondWithError(request, BT_ERR_PROFILE_UNAVAIL);
+		return true;
+	}
+
+	const std::string schema = STRICT_SCHEMA(PROPS_6(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
+	                                                 PROP(service, string), PROP(characteristic, string),
+	                                                 PROP_WITH_VAL_3(priority, string, "high", "normal", "background")));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+
+		else if (requestObj.hasKey("instanceId"))
+			LSUtils::respondWithError(request, BT_ERR_GATT_INSTANCE_ID_NOT_SUPPORTED);
+
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	if (!requestObj.hasKey("instanceId"))
+	{
+		if (!requestObj.hasKey("service"))
+		{
+			LSUtils::respondWithError(request, BT_ERR_GATT_SERVICE_NAME_PARAM_MISSING);
+			return true;
+		}
+		else if (!requestObj.hasKey("characteristic"))
+		{
+			LSUtils::respondWithError(request, BT_ERR_GATT_CHARACTERISTIC_PARAM_MISSING);
+			return true;
+		}
+		else if(!requestObj.hasKey("characteristic") && !requestObj.hasKey("service"))
+		{
+			LSUtils::respondWithError(request, BT_ERR_GATT_HANDLES_PARAM_MISSING);
+			return true;
+		}
+	}
+
+	// TODO: Change all inputs for local service to lowercase
+
+	std::string adapterAddress;
+	if (requestObj.hasKey("adapterAddress"))
+	{
+		adapterAddress = requestObj["adapterAddress"].asString();
+		if (!getManager()->isAdapterAvailable(adapterAddress))
+		{
+			LSUtils::respondWithError(request, BT_ERR_INVALID_ADAPTER_ADDRESS);
+			return true;
+		}
+	}
+	else
+	{
 		adapterAddress = getManager()->getAddress();
 	}
 
@@ -1705,9 +2268,13 @@ bool BluetoothGattProfileService::readCharacteristicValue(LSMessage &message)
 		LSUtils::postToClient(requestMessage, responseObj);
 	};
 
+	BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL;
+	if (requestObj.hasKey("priority"))
+		priority = BluetoothGattOperationQueue::priorityFromString(requestObj["priority"].asString());
+
 	BT_DEBUG("[%s](%d) getImpl->readCharacteristics\n", __FUNCTION__, __LINE__);
 	if (!deviceAddress.empty())
-		readRemoteCharacteristic(deviceAddress, serviceUuid, characteristicUuid, characteristicToRead.getHandle(), readCharacteristicCallback);
+		readRemoteCharacteristic(deviceAddress, serviceUuid, characteristicUuid, characteristicToRead.getHandle(), readCharacteristicCallback, priority);
 	else
 		readCharacteristicCallback(BLUETOOTH_ERROR_NONE, characteristicToRead);
 
@@ -1727,8 +2294,9 @@ bool BluetoothGattProfileService::readCharacteristicValues(LSMessage &message)
 		return true;
 	}
 
-	const std::string schema = STRICT_SCHEMA(PROPS_5(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
-	                                                 PROP(service, string), ARRAY(characteristics, string))
+	const std::string schema = STRICT_SCHEMA(PROPS_6(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
+	                                                 PROP(service, string), ARRAY(characteristics, string),
+	                                                 PROP_WITH_VAL_3(priority, string, "high", "normal", "background"))
 													 REQUIRED_2(service, characteristics));
 
 	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
@@ -1827,9 +2395,13 @@ bool BluetoothGattProfileService::readCharacteristicValues(LSMessage &message)
 		LSUtils::postToClient(requestMessage, responseObj);
 	};
 
+	BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL;
+	if (requestObj.hasKey("priority"))
+		priority = BluetoothGattOperationQueue::priorityFromString(requestObj["priority"].asString());
+
 	BT_DEBUG("[%s](%d) getImpl->readCharacteristics\n", __FUNCTION__, __LINE__);
 	if (!deviceAddress.empty())
-		readRemoteCharacteristics(deviceAddress, serviceUuid, characteristicUuids, readCharacteristicCallback);
+		readRemoteCharacteristics(deviceAddress, serviceUuid, characteristicUuids, readCharacteristicCallback, priority);
 	else
 		readLocalCharacteristics(serviceUuid, characteristicUuids, readCharacteristicCallback);
 
@@ -1855,30 +2427,7 @@ void BluetoothGattProfileService::handleMonitorCharacteristicClientDropped(Monit
 			|| (subscriptionInfo.characteristicUuid != candidate.characteristicUuid))
 			continue;
 
-		auto foundWatch = std::find_if(mCharacteristicWatchList.begin(), mCharacteristicWatchList.end(), [subscriptionInfo] (const CharacteristicWatch *watchElement) {
-
-			if ((watchElement->deviceAddress == subscriptionInfo.deviceAddress) && (watchElement->handle == subscriptionInfo.handle))
-				return true;
-
-			else if ((watchElement->deviceAddress == subscriptionInfo.deviceAddress) && (watchElement->serviceId == subscriptionInfo.serviceUuid))
-				return true;
-
-			return false;
-		});
-
-		if (foundWatch != mCharacteristicWatchList.end())
-		{
-			(*foundWatch)->unref();
-			if (!((*foundWatch)->isUsed()))
-			{
-				BT_DEBUG("Disabling characteristic watch to device %s", (*foundWatch)->deviceAddress.c_str());
-
-				getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus((*foundWatch)->deviceAddress, (*foundWatch)->serviceId, (*foundWatch)->characteristicId, false, [this](BluetoothError error) {
-					BT_WARNING(MSGID_SUBSCRIPTION_CLIENT_DROPPED, 0, "No LS2 error response can be issued since subscription client has dropped");
-				});
-				mCharacteristicWatchList.erase(foundWatch);
-			}
-		}
+		unrefCharacteristicWatch(subscriptionInfo.deviceAddress, subscriptionInfo.serviceUuid, subscriptionInfo.characteristicUuid, subscriptionInfo.handle);
 
 		auto monitorSubscriptionWatch = it->first;
 		mMonitorCharacteristicSubscriptions.erase(it);
@@ -1901,38 +2450,135 @@ void BluetoothGattProfileService::handleMonitorCharacteristicsClientDropped(Moni
 			|| (subscriptionInfo.characteristicUuids != candidate.characteristicUuids))
 			continue;
 
-		auto foundWatch = std::find_if(mCharacteristicWatchList.begin(), mCharacteristicWatchList.end(), [subscriptionInfo] (const CharacteristicWatch *watchElement) {
-			if ((watchElement->deviceAddress == subscriptionInfo.deviceAddress) && (watchElement->serviceId == subscriptionInfo.serviceUuid))
-			{
-				auto foundCharacteristic = std::find(subscriptionInfo.characteristicUuids.begin(), subscriptionInfo.characteristicUuids.end(), watchElement->characteristicId);
-				if (foundCharacteristic != subscriptionInfo.characteristicUuids.end())
-					return true;
-			}
-			return false;
-		});
+		for (auto characteristicUuid : subscriptionInfo.characteristicUuids)
+			unrefCharacteristicWatch(subscriptionInfo.deviceAddress, subscriptionInfo.serviceUuid, characteristicUuid, 0);
 
-		if (foundWatch != mCharacteristicWatchList.end())
-		{
-			(*foundWatch)->unref();
-			if (!((*foundWatch)->isUsed()))
-			{
-				BT_DEBUG("Disabling characteristic watch to device %s", (*foundWatch)->deviceAddress.c_str());
+		auto monitorSubscriptionWatch = it->first;
+		mMonitorCharacteristicSubscriptions.erase(it);
 
-				getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus((*foundWatch)->deviceAddress, (*foundWatch)->serviceId, (*foundWatch)->characteristicId, false, [this](BluetoothError error) {
-					BT_WARNING(MSGID_SUBSCRIPTION_CLIENT_DROPPED, 0, "No LS2 error response can be issued since subscription client has dropped");
-				});
-				mCharacteristicWatchList.erase(foundWatch);
-			}
+		auto socketIter = mMonitorCharacteristicSockets.find(monitorSubscriptionWatch);
+		if (socketIter != mMonitorCharacteristicSockets.end())
+		{
+			socketIter->second->removeBinarySocket();
+			delete socketIter->second;
+			mMonitorCharacteristicSockets.erase(socketIter);
 		}
 
-		auto monitorSubscriptionWatch = it->first;
-		mMonitorCharacteristicSubscriptions.erase(it);
 		delete monitorSubscriptionWatch;
 		monitorSubscriptionWatch = 0;
 		break;
 	}
 }
 
+CharacteristicWatch* BluetoothGattProfileService::refCharacteristicWatch(const std::string &deviceAddress, const BluetoothUuid &serviceUuid,
+		const BluetoothUuid &characteristicUuid, uint16_t handle)
+{
+	std::string key = buildOperationKey("watch", deviceAddress, serviceUuid, characteristicUuid, BluetoothUuid(), handle);
+
+	auto watchIter = mCharacteristicWatches.find(key);
+	if (watchIter != mCharacteristicWatches.end())
+	{
+		// The address-service-characteristic combination already exists, so increment the reference count;
+		// this is unref-ed when client subscription is dropped
+		BT_DEBUG("Found watch in the characteristic list, incrementing ref count");
+		watchIter->second->ref();
+		return watchIter->second;
+	}
+
+	BT_DEBUG("Watch element not found in the list, creating new watch to the characteristic list");
+	CharacteristicWatch *watch = new CharacteristicWatch();
+	watch->deviceAddress = deviceAddress;
+	watch->serviceId = serviceUuid;
+	watch->characteristicId = characteristicUuid;
+	watch->handle = handle;
+	watch->ref();
+	mCharacteristicWatches.insert(std::pair<std::string, CharacteristicWatch*>(key, watch));
+
+	return watch;
+}
+
+void BluetoothGattProfileService::unrefCharacteristicWatch(const std::string &deviceAddress, const BluetoothUuid &serviceUuid,
+		const BluetoothUuid &characteristicUuid, uint16_t handle)
+{
+	std::string key = buildOperationKey("watch", deviceAddress, serviceUuid, characteristicUuid, BluetoothUuid(), handle);
+
+	auto watchIter = mCharacteristicWatches.find(key);
+	if (watchIter == mCharacteristicWatches.end())
+		return;
+
+	CharacteristicWatch *watch = watchIter->second;
+	watch->unref();
+	if (watch->isUsed())
+		return;
+
+	if (!watch->deviceAddress.empty())
+	{
+		BT_DEBUG("Disabling characteristic watch to device %s", watch->deviceAddress.c_str());
+
+		auto disableCallback = [this](BluetoothError error) {
+			BT_WARNING(MSGID_SUBSCRIPTION_CLIENT_DROPPED, 0, "No LS2 error response can be issued since subscription client has dropped");
+		};
+
+		if (watch->handle == 0)
+			getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(watch->deviceAddress, watch->serviceId, watch->characteristicId, false, disableCallback);
+		else
+			getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(watch->deviceAddress, watch->handle, false, disableCallback);
+	}
+
+	mCharacteristicWatches.erase(watchIter);
+	delete watch;
+}
+
+void BluetoothGattProfileService::registerCharacteristicWatch(CharacteristicWatch *watch, LSMessage *requestMessage)
+{
+	// Watches already registered (or on their way) are shared as they are
+	if (watch->deviceAddress.empty() || watch->isRegistered() || watch->isRegistering())
+		return;
+
+	BT_DEBUG("Registering a watch with SIL API for device %s, service %s, characteristic %s",
+	          watch->deviceAddress.c_str(), watch->serviceId.toString().c_str(), watch->characteristicId.toString().c_str());
+
+	// The watch may be gone when the SIL answers, so look it up again by key
+	std::string key = buildOperationKey("watch", watch->deviceAddress, watch->serviceId, watch->characteristicId, BluetoothUuid(), watch->handle);
+	std::string characteristicUuid = watch->characteristicId.toString();
+
+	auto monitorCallback = [this, requestMessage, key, characteristicUuid] (BluetoothError error)
+	{
+		auto watchIter = mCharacteristicWatches.find(key);
+
+		if (error != BLUETOOTH_ERROR_NONE)
+		{
+			if (watchIter != mCharacteristicWatches.end())
+				watchIter->second->markRegistrationFailed();
+
+			LSUtils::respondWithError(requestMessage, retrieveErrorText(BT_ERR_GATT_MONITOR_CHARACTERISTIC_FAIL) + characteristicUuid, BT_ERR_GATT_MONITOR_CHARACTERISTIC_FAIL, true);
+			return;
+		}
+
+		if (watchIter != mCharacteristicWatches.end())
+			watchIter->second->markRegistered();
+	};
+
+	watch->markRegistering();
+
+	BT_DEBUG("[%s](%d) getImpl->changeCharacteristicWatchStatus\n", __FUNCTION__, __LINE__);
+	uint16_t appId = getImpl<BluetoothGattProfile>()->getAppId(watch->deviceAddress);
+	if (appId > 0)
+	{
+		if(watch->handle == 0)
+			getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(watch->deviceAddress, appId, watch->serviceId, watch->characteristicId, true, monitorCallback);
+		else
+			getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(watch->deviceAddress, appId, watch->handle, true, monitorCallback);
+	}
+	else
+	{
+		if(watch->handle == 0)
+			getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(watch->deviceAddress, watch->serviceId, watch->characteristicId, true, monitorCallback);
+		else
+			getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(watch->deviceAddress, watch->handle, true, monitorCallback);
+	}
+}
+
 bool BluetoothGattProfileService::monitorCharacteristic(LSMessage &message)
 {
 	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
@@ -2045,7 +2691,7 @@ bool BluetoothGattProfileService::monitorCharacteristic(LSMessage &message)
 		if (deviceAddress.empty())
 			service = getLocalService(serviceUuid);
 		else
-			service = getImpl<BluetoothGattProfile>()->getService(deviceAddress, serviceUuid);
+			service = getRemoteService(deviceAddress, serviceUuid);
 
 		if (!service.isValid())
 		{
@@ -2075,77 +2721,11 @@ bool BluetoothGattProfileService::monitorCharacteristic(LSMessage &message)
 
 	mMonitorCharacteristicSubscriptions.push_back(std::make_pair(monitorCharacteristicsWatch, subscriptionInfo));
 
-	auto foundWatch = std::find_if(mCharacteristicWatchList.begin(), mCharacteristicWatchList.end(), [deviceAddress, subscriptionInfo](const CharacteristicWatch* watchElement)
-	{
-		return ((watchElement->deviceAddress == deviceAddress) &&
-			 (watchElement->handle == subscriptionInfo.handle));
-	});
-
-	if (foundWatch != mCharacteristicWatchList.end())
-	{
-		// The address-service-characteristic combination already exists, so increment the reference count;
-		// this is unref-ed when client subscription is dropped
-		BT_DEBUG("Found watch in the characteristic list, incrementing ref count");
-		(*foundWatch)->ref();
-	}
-	else
-	{
-		BT_DEBUG("Watch element not found in the list, creating new watch to the characteristic list");
-		auto watch = new CharacteristicWatch();
-		watch->deviceAddress = deviceAddress;
-		watch->serviceId = subscriptionInfo.serviceUuid;
-		watch->characteristicId = subscriptionInfo.characteristicUuid;
-		watch->handle = subscriptionInfo.handle;
-		watch->ref();
-		mCharacteristicWatchList.push_back(watch);
-	}
+	CharacteristicWatch *watch = refCharacteristicWatch(deviceAddress, subscriptionInfo.serviceUuid, subscriptionInfo.characteristicUuid, subscriptionInfo.handle);
 
 	LSMessage *requestMessage = request.get();
 	LSMessageRef(requestMessage);
-	BT_DEBUG("Registering with SIL API for %d characteristic watch list elements", mCharacteristicWatchList.size());
-	for (auto characteristicWatch : mCharacteristicWatchList)
-	{
-		//eliminate the watches that are already registered with SIL API changeCharacteristicWatchStatus()
-		if (characteristicWatch->isRegistered())
-			continue;
-
-		BT_DEBUG("Registering a watch with SIL API for device %s, service %s, characteristic %s",
-		          characteristicWatch->deviceAddress.c_str(), characteristicWatch->serviceId.toString().c_str(), characteristicWatch->characteristicId.toString().c_str());
-
-		auto monitorCallback = [this, requestMessage, characteristicWatch] (BluetoothError error)
-		{
-			if (error != BLUETOOTH_ERROR_NONE)
-			{
-				LSUtils::respondWithError(requestMessage, retrieveErrorText(BT_ERR_GATT_MONITOR_CHARACTERISTIC_FAIL) + characteristicWatch->characteristicId.toString(), BT_ERR_GATT_MONITOR_CHARACTERISTIC_FAIL, true);
-				return;
-			}
-			else
-			{
-				characteristicWatch->markRegistered();
-			}
-		};
-
-		BT_DEBUG("[%s](%d) getImpl->changeCharacteristicWatchStatus\n", __FUNCTION__, __LINE__);
-		if (!characteristicWatch->deviceAddress.empty())
-		{
-			uint16_t appId = getImpl<BluetoothGattProfile>()->getAppId(deviceAddress);
-			if (appId > 0)
-			{
-				if(characteristicWatch->handle == 0)
-					getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(characteristicWatch->deviceAddress, appId, characteristicWatch->serviceId, characteristicWatch->characteristicId, true, monitorCallback);
-				else
-					getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(characteristicWatch->deviceAddress, appId, characteristicWatch->handle, true, monitorCallback);
-			}
-			else
-			{
-				if(characteristicWatch->handle == 0)
-					getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(characteristicWatch->deviceAddress, characteristicWatch->serviceId, characteristicWatch->characteristicId, true, monitorCallback);
-				else
-					getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(characteristicWatch->deviceAddress, characteristicWatch->handle, true, monitorCallback);
-			}
-		}
-
-	}
+	registerCharacteristicWatch(watch, requestMessage);
 
 	pbnjson::JValue responseObj = pbnjson::Object();
 	responseObj.put("returnValue", true);
@@ -2171,8 +2751,9 @@ bool BluetoothGattProfileService::monitorCharacteristics(LSMessage &message)
 		return true;
 	}
 
-	const std::string schema = STRICT_SCHEMA(PROPS_6(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
+	const std::string schema = STRICT_SCHEMA(PROPS_7(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
 	                                                 PROP(service, string), ARRAY(characteristics, string),
+	                                                 PROP_WITH_VAL_2(transport, string, "luna", "socket"),
 	                                                 PROP(subscribe, boolean))
 	                                                 REQUIRED_3(subscribe, service, characteristics));
 	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
@@ -2236,7 +2817,7 @@ bool BluetoothGattProfileService::monitorCharacteristics(LSMessage &message)
 	if (deviceAddress.empty())
 		service = getLocalService(serviceUuid);
 	else
-		service = getImpl<BluetoothGattProfile>()->getService(deviceAddress, serviceUuid);
+		service = getRemoteService(deviceAddress, serviceUuid);
 
 	auto characteristicUuidsArray = requestObj["characteristics"];
 	if (!service.isValid())
@@ -2246,6 +2827,7 @@ bool BluetoothGattProfileService::monitorCharacteristics(LSMessage &message)
 	}
 
 	BluetoothUuidList characteristics;
+	pbnjson::JValue frameHandles = pbnjson::Array();
 	for (int i=0; i < characteristicUuidsArray.arraySize(); i++)
 	{
 		BluetoothGattCharacteristic characteristicToMonitor;
@@ -2257,6 +2839,11 @@ bool BluetoothGattProfileService::monitorCharacteristics(LSMessage &message)
 			return true;
 		}
 		characteristics.push_back(BluetoothUuid(characteristicUuid));
+
+		pbnjson::JValue frameHandleObj = pbnjson::Object();
+		frameHandleObj.put("characteristic", characteristicUuid);
+		frameHandleObj.put("handle", (int32_t) characteristicToMonitor.getHandle());
+		frameHandles.append(frameHandleObj);
 	}
 
 	MonitorCharacteristicSubscriptionInfo subscriptionInfo;
@@ -2265,6 +2852,26 @@ bool BluetoothGattProfileService::monitorCharacteristics(LSMessage &message)
 	subscriptionInfo.serviceUuid = serviceUuid;
 	subscriptionInfo.characteristicUuids = characteristics;
 
+	// With the socket transport notifications are written to a per
+	// subscription binary socket instead of being posted as JSON
+	BluetoothBinarySocket *monitorSocket = nullptr;
+	if (requestObj.hasKey("transport") && requestObj["transport"].asString() == "socket")
+	{
+		monitorSocket = new BluetoothBinarySocket();
+		monitorSocket->setDropWhenBehind(true);
+		if (!monitorSocket->createBinarySocket("GattMonitor" + idToString(mNextMonitorSocketId++)) ||
+		    !monitorSocket->registerReceiveDataWatch([](guchar *readBuf, gsize readLen) {}))
+		{
+			monitorSocket->removeBinarySocket();
+			delete monitorSocket;
+			delete monitorCharacteristicsWatch;
+			LSUtils::respondWithError(request, BT_ERR_GATT_MONITOR_SOCKET_FAIL);
+			return true;
+		}
+
+		mMonitorCharacteristicSockets.insert(std::pair<LSUtils::ClientWatch*, BluetoothBinarySocket*>(monitorCharacteristicsWatch, monitorSocket));
+	}
+
 	//Set a callback to see if client dropped. We do it this way because we first need to get the client watch object and pass this
 	//object to the callback. This object is later used to check if the client which dropped has the same client watch created here.
 	//When two apps are registered for monitoring on the same address-service-characteristics combination, there will be
@@ -2275,70 +2882,14 @@ bool BluetoothGattProfileService::monitorCharacteristics(LSMessage &message)
 
 	mMonitorCharacteristicSubscriptions.push_back(std::make_pair(monitorCharacteristicsWatch, subscriptionInfo));
 
-	for (auto characteristic : characteristics)
-	{
-		auto foundWatch = std::find_if(mCharacteristicWatchList.begin(), mCharacteristicWatchList.end(), [deviceAddress, serviceUuid, characteristic](const CharacteristicWatch* watchElement)
-						{
-							return ((watchElement->deviceAddress == deviceAddress) && (watchElement->serviceId == BluetoothUuid(serviceUuid))
-								 && (watchElement->characteristicId == BluetoothUuid(characteristic)));
-						});
-
-		if (foundWatch != mCharacteristicWatchList.end())
-		{
-			// The address-service-characteristic combination already exists, so increment the reference count;
-			// this is unref-ed when client subscription is dropped
-			BT_DEBUG("Found watch in the characteristic list, incrementing ref count");
-			(*foundWatch)->ref();
-		}
-		else
-		{
-			BT_DEBUG("Watch element not found in the list, creating new watch to the characteristic list");
-			auto watch = new CharacteristicWatch();
-			watch->deviceAddress = deviceAddress;
-			watch->serviceId = BluetoothUuid(serviceUuid);
-			watch->characteristicId = BluetoothUuid(characteristic);
-			watch->ref();
-			mCharacteristicWatchList.push_back(watch);
-		}
-	}
-
-
 	LSMessage *requestMessage = request.get();
 	LSMessageRef(requestMessage);
-	BT_DEBUG("Registering with SIL API for %d characteristic watch list elements", mCharacteristicWatchList.size());
-	for (auto characteristicWatch : mCharacteristicWatchList)
-	{
-		//eliminate the watches that are already registered with SIL API changeCharacteristicWatchStatus()
-		if (characteristicWatch->isRegistered())
-			continue;
-
-		BT_DEBUG("Registering a watch with SIL API for device %s, service %s, characteristic %s",
-		          characteristicWatch->deviceAddress.c_str(), characteristicWatch->serviceId.toString().c_str(), characteristicWatch->characteristicId.toString().c_str());
-
-		auto monitorCallback = [this, requestMessage, characteristicWatch] (BluetoothError error)
-		{
-			if (error != BLUETOOTH_ERROR_NONE)
-			{
-				LSUtils::respondWithError(requestMessage, retrieveErrorText(BT_ERR_GATT_MONITOR_CHARACTERISTIC_FAIL) + characteristicWatch->characteristicId.toString(), BT_ERR_GATT_MONITOR_CHARACTERISTIC_FAIL, true);
-				return;
-			}
-			else
-			{
-				characteristicWatch->markRegistered();
-			}
-		};
-
-		BT_DEBUG("[%s](%d) getImpl->changeCharacteristicWatchStatus\n", __FUNCTION__, __LINE__);
-		if (!characteristicWatch->deviceAddress.empty())
-		{
-			uint16_t appId = getImpl<BluetoothGattProfile>()->getAppId(deviceAddress);
-			if (appId > 0)
-				getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(characteristicWatch->deviceAddress, appId, characteristicWatch->serviceId, characteristicWatch->characteristicId, true, monitorCallback);
 
-			else
-				getImpl<BluetoothGattProfile>()->changeCharacteristicWatchStatus(characteristicWatch->deviceAddress, characteristicWatch->serviceId, characteristicWatch->characteristicId, true, monitorCallback);
-
-		}
+	// Only characteristics nobody was monitoring yet are registered with the SIL
+	for (auto characteristic : characteristics)
+	{
+		CharacteristicWatch *watch = refCharacteristicWatch(deviceAddress, serviceUuid, characteristic, 0);
+		registerCharacteristicWatch(watch, requestMessage);
 	}
 
 	pbnjson::JValue responseObj = pbnjson::Object();
@@ -2346,11 +2897,46 @@ bool BluetoothGattProfileService::monitorCharacteristics(LSMessage &message)
 	responseObj.put("subscribed", true);
 	responseObj.put("adapterAddress", adapterAddress);
 	responseObj.put("address", deviceAddress);
+	if (monitorSocket)
+	{
+		responseObj.put("transport", std::string("socket"));
+		responseObj.put("path", monitorSocket->getSocketFileName());
+		responseObj.put("handles", frameHandles);
+	}
 	LSUtils::postToClient(monitorCharacteristicsWatch->getMessage(), responseObj);
 
 	return true;
 }
 
+void BluetoothGattProfileService::sendCharacteristicFrame(BluetoothBinarySocket *binarySocket, const BluetoothGattCharacteristic &characteristic)
+{
+	/*
+	 * Frame layout, all fields little endian:
+	 *   uint16 length of the rest of the frame
+	 *   uint16 characteristic handle
+	 *   uint64 monotonic timestamp in microseconds
+	 *   value bytes
+	 */
+	BluetoothGattValue value = characteristic.getValue();
+	uint16_t handle = characteristic.getHandle();
+	uint64_t timestamp = (uint64_t) g_get_monotonic_time();
+	uint16_t length = sizeof(handle) + sizeof(timestamp) + value.size();
+
+	std::vector<uint8_t> frame;
+	frame.reserve(sizeof(length) + length);
+
+	frame.push_back(length & 0xFF);
+	frame.push_back((length >> 8) & 0xFF);
+	frame.push_back(handle & 0xFF);
+	frame.push_back((handle >> 8) & 0xFF);
+	for (size_t i = 0; i < sizeof(timestamp); i++)
+		frame.push_back((timestamp >> (8 * i)) & 0xFF);
+	frame.insert(frame.end(), value.begin(), value.end());
+
+	if (!binarySocket->sendData(frame.data(), frame.size()))
+		BT_DEBUG("Dropped notification frame for handle %d, socket client is too slow", handle);
+}
+
 bool BluetoothGattProfileService::isDescriptorValid(const std::string &address, const uint16_t &handle,
                                                     BluetoothGattDescriptor &descriptor)
 {
@@ -2366,7 +2952,7 @@ bool BluetoothGattProfileService::isDescriptorValid(const std::string &address,
 	}
 	else
 	{
-		BluetoothGattServiceList services = getImpl<BluetoothGattProfile>()->getServices(address);
+		BluetoothGattServiceList services = getRemoteServices(address);
 		for (auto service : services)
 		{
 			for (auto characteristicElement : service.getCharacteristics())
@@ -2399,7 +2985,7 @@ bool BluetoothGattProfileService::isDescriptorValid(const std::string &address,
 	if (address.empty())
 		service = getLocalService(serviceUuid);
 	else
-		service = getImpl<BluetoothGattProfile>()->getService(address, serviceUuid);
+		service = getRemoteService(address, serviceUuid);
 	if (!service.isValid())
 		return false;
 
@@ -2436,35 +3022,183 @@ bool BluetoothGattProfileService::isDescriptorValid(const std::string &address,
 
 bool BluetoothGattProfileService::readRemoteDescriptor(const std::string deviceAddress,
 		const BluetoothUuid &serviceUuid, const BluetoothUuid &characteristicUuid, const BluetoothUuid &descriptorUuid, const uint16_t descriptorHandle,
-		BluetoothGattReadDescriptorCallback callback)
+		BluetoothGattReadDescriptorCallback callback, BluetoothGattOperationPriority priority)
 {
-	uint16_t connectId = getImpl<BluetoothGattProfile>()->getConnectId(deviceAddress);
-	if(connectId > 0)
+	BluetoothGattOperationQueue *queue = getOperationQueue(deviceAddress);
+
+	// Identical reads share the result of the one already queued or in flight
+	std::string key = buildOperationKey("readDescriptor", deviceAddress, serviceUuid, characteristicUuid, descriptorUuid, descriptorHandle);
+	PendingGattOperation *pendingOperation = findPendingOperation(key);
+	if (pendingOperation)
 	{
-		if (!serviceUuid.toString().empty() && !characteristicUuid.toString().empty() && !descriptorUuid.toString().empty())
-			getImpl<BluetoothGattProfile>()->readDescriptor(connectId, serviceUuid, characteristicUuid, descriptorUuid, callback);
-		else
-			getImpl<BluetoothGattProfile>()->readDescriptor(connectId, descriptorHandle, callback);
+		pendingOperation->readDescriptorCallbacks.push_back(callback);
+		joinPendingOperation(queue, pendingOperation, priority);
+		queue->countDeduplicated();
+		return true;
 	}
-	else
-	{
-		if (!serviceUuid.toString().empty() && !characteristicUuid.toString().empty() && !descriptorUuid.toString().empty())
-			getImpl<BluetoothGattProfile>()->readDescriptor(deviceAddress, serviceUuid, characteristicUuid, descriptorUuid, callback);
+
+	uint32_t operationId = addPendingOperation(key);
+	mPendingOperations[operationId]->readDescriptorCallbacks.push_back(callback);
+
+	auto notifyReadCallbacks = [this, operationId](BluetoothError error, BluetoothGattDescriptor descriptor) {
+		PendingGattOperation *pendingOperation = takePendingOperation(operationId);
+		if (!pendingOperation)
+			return;
+
+		for (auto readCallback : pendingOperation->readDescriptorCallbacks)
+			readCallback(error, descriptor);
+
+		delete pendingOperation;
+	};
+
+	auto readHandler = [this, deviceAddress, serviceUuid, characteristicUuid, descriptorUuid, descriptorHandle, notifyReadCallbacks](BluetoothGattOperationCompleteCallback complete) {
+		auto readCallback = [this, deviceAddress, complete, notifyReadCallbacks](BluetoothError error, BluetoothGattDescriptor descriptor) {
+			complete();
+			mServicesPayloadCache.invalidate(deviceAddress);
+			notifyReadCallbacks(error, descriptor);
+		};
+
+		uint16_t connectId = getImpl<BluetoothGattProfile>()->getConnectId(deviceAddress);
+		if(connectId > 0)
+		{
+			if (!serviceUuid.toString().empty() && !characteristicUuid.toString().empty() && !descriptorUuid.toString().empty())
+				getImpl<BluetoothGattProfile>()->readDescriptor(connectId, serviceUuid, characteristicUuid, descriptorUuid, readCallback);
+			else
+				getImpl<BluetoothGattProfile>()->readDescriptor(connectId, descriptorHandle, readCallback);
+		}
 		else
-			getImpl<BluetoothGattProfile>()->readDescriptor(deviceAddress, descriptorHandle, callback);
-	}
+		{
+			if (!serviceUuid.toString().empty() && !characteristicUuid.toString().empty() && !descriptorUuid.toString().empty())
+				getImpl<BluetoothGattProfile>()->readDescriptor(deviceAddress, serviceUuid, characteristicUuid, descriptorUuid, readCallback);
+			else
+				getImpl<BluetoothGattProfile>()->readDescriptor(deviceAddress, descriptorHandle, readCallback);
+		}
+	};
+
+	queuePendingOperation(queue, operationId, priority, readHandler, [notifyReadCallbacks]() {
+		notifyReadCallbacks(BLUETOOTH_ERROR_FAIL, BluetoothGattDescriptor());
+	});
+
 	return true;
 }
 
 bool BluetoothGattProfileService::readRemoteDescriptors(const std::string deviceAddress,
 		const BluetoothUuid &serviceUuid, const BluetoothUuid &characteristicUuid, const BluetoothUuidList &descriptorUuids,
-		BluetoothGattReadDescriptorsCallback callback)
+		BluetoothGattReadDescriptorsCallback callback, BluetoothGattOperationPriority priority)
 {
-	uint16_t connectId = getImpl<BluetoothGattProfile>()->getConnectId(deviceAddress);
-	if(connectId > 0)
-		getImpl<BluetoothGattProfile>()->readDescriptors(connectId, serviceUuid, characteristicUuid, descriptorUuids, callback);
-	else
-		getImpl<BluetoothGattProfile>()->readDescriptors(deviceAddress, serviceUuid, characteristicUuid, descriptorUuids, callback);
+	// Only one of the SIL callback and the queue timeout may answer the caller
+	uint32_t operationId = addPendingOperation(std::string());
+
+	auto notifyReadCallback = [this, operationId, callback](BluetoothError error, BluetoothGattDescriptorList descriptors) {
+		PendingGattOperation *pendingOperation = takePendingOperation(operationId);
+		if (!pendingOperation)
+			return;
+
+		delete pendingOperation;
+		callback(error, descriptors);
+	};
+
+	auto readHandler = [this, deviceAddress, serviceUuid, characteristicUuid, descriptorUuids, notifyReadCallback](BluetoothGattOperationCompleteCallback complete) {
+		auto readCallback = [this, deviceAddress, complete, notifyReadCallback](BluetoothError error, BluetoothGattDescriptorList descriptors) {
+			complete();
+			mServicesPayloadCache.invalidate(deviceAddress);
+			notifyReadCallback(error, descriptors);
+		};
+
+		uint16_t connectId = getImpl<BluetoothGattProfile>()->getConnectId(deviceAddress);
+		if(connectId > 0)
+			getImpl<BluetoothGattProfile>()->readDescriptors(connectId, serviceUuid, characteristicUuid, descriptorUuids, readCallback);
+		else
+			getImpl<BluetoothGattProfile>()->readDescriptors(deviceAddress, serviceUuid, characteristicUuid, descriptorUuids, readCallback);
+	};
+
+	getOperationQueue(deviceAddress)->push(priority, readHandler, [notifyReadCallback]() {
+		notifyReadCallback(BLUETOOTH_ERROR_FAIL, BluetoothGattDescriptorList());
+	});
+
+	return true;
+}
+
+bool BluetoothGattProfileService::writeRemoteDescriptor(const std::string deviceAddress,
+		const BluetoothUuid &serviceUuid, const BluetoothUuid &characteristicUuid, const BluetoothGattDescriptor &descriptorToWrite,
+		BluetoothResultCallback callback, BluetoothGattOperationPriority priority)
+{
+	BluetoothGattOperationQueue *queue = getOperationQueue(deviceAddress);
+	std::string key;
+
+	// Same as for characteristics: later reads must not join an earlier read,
+	// and queued background writes keep the latest value only
+	forgetPendingOperationKey(buildOperationKey("readDescriptor", deviceAddress, serviceUuid, characteristicUuid,
+	                                            descriptorToWrite.getUuid(), descriptorToWrite.getHandle()));
+	forgetPendingOperationKey(buildOperationKey("readDescriptor", deviceAddress, serviceUuid, characteristicUuid,
+	                                            descriptorToWrite.getUuid(), 0));
+
+	if (priority == BLUETOOTH_GATT_OPERATION_PRIORITY_BACKGROUND)
+	{
+		key = buildOperationKey("writeDescriptor", deviceAddress, serviceUuid, characteristicUuid, descriptorToWrite.getUuid(), descriptorToWrite.getHandle());
+
+		PendingGattOperation *pendingOperation = findPendingOperation(key);
+		if (pendingOperation && !pendingOperation->started)
+		{
+			pendingOperation->descriptor = descriptorToWrite;
+			pendingOperation->writeCallbacks.push_back(callback);
+			queue->countCoalesced();
+			return true;
+		}
+	}
+
+	uint32_t operationId = addPendingOperation(key);
+	mPendingOperations[operationId]->descriptor = descriptorToWrite;
+	mPendingOperations[operationId]->writeCallbacks.push_back(callback);
+
+	auto notifyWriteCallbacks = [this, operationId](BluetoothError error) {
+		PendingGattOperation *pendingOperation = takePendingOperation(operationId);
+		if (!pendingOperation)
+			return;
+
+		for (auto writeCallback : pendingOperation->writeCallbacks)
+			writeCallback(error);
+
+		delete pendingOperation;
+	};
+
+	auto writeHandler = [this, deviceAddress, serviceUuid, characteristicUuid, operationId, notifyWriteCallbacks](BluetoothGattOperationCompleteCallback complete) {
+		auto pendingIter = mPendingOperations.find(operationId);
+		if (pendingIter == mPendingOperations.end())
+		{
+			complete();
+			return;
+		}
+
+		pendingIter->second->started = true;
+		BluetoothGattDescriptor descriptor = pendingIter->second->descriptor;
+
+		auto writeCallback = [this, deviceAddress, complete, notifyWriteCallbacks](BluetoothError error) {
+			complete();
+			mServicesPayloadCache.invalidate(deviceAddress);
+			notifyWriteCallbacks(error);
+		};
+
+		uint16_t connectId = getImpl<BluetoothGattProfile>()->getConnectId(deviceAddress);
+		if (connectId > 0)
+		{
+			if (!serviceUuid.toString().empty() && !characteristicUuid.toString().empty())
+				getImpl<BluetoothGattProfile>()->writeDescriptor(connectId, serviceUuid, characteristicUuid, descriptor, writeCallback);
+			else
+				getImpl<BluetoothGattProfile>()->writeDescriptor(connectId, descriptor, writeCallback);
+		}
+		else
+		{
+			if (!serviceUuid.toString().empty() && !characteristicUuid.toString().empty())
+				getImpl<BluetoothGattProfile>()->writeDescriptor(deviceAddress, serviceUuid, characteristicUuid, descriptor, writeCallback);
+			else
+				getImpl<BluetoothGattProfile>()->writeDescriptor(deviceAddress, descriptor, writeCallback);
+		}
+	};
+
+	queuePendingOperation(queue, operationId, priority, writeHandler, [notifyWriteCallbacks]() {
+		notifyWriteCallbacks(BLUETOOTH_ERROR_FAIL);
+	});
 
 	return true;
 }
@@ -2482,9 +3216,10 @@ bool BluetoothGattProfileService::readDescriptorValue(LSMessage &message)
 		return true;
 	}
 
-	const std::string schema = STRICT_SCHEMA(PROPS_6(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
+	const std::string schema = STRICT_SCHEMA(PROPS_7(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
 	                                                 PROP(service, string), PROP(characteristic, string),
-	                                                 PROP(descriptor, string))
+	                                                 PROP(descriptor, string),
+	                                                 PROP_WITH_VAL_3(priority, string, "high", "normal", "background"))
 	                                                 );
 
 	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
@@ -2614,10 +3349,14 @@ bool BluetoothGattProfileService::readDescriptorValue(LSMessage &message)
 		LSUtils::postToClient(requestMessage, responseObj);
 	};
 
+	BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL;
+	if (requestObj.hasKey("priority"))
+		priority = BluetoothGattOperationQueue::priorityFromString(requestObj["priority"].asString());
+
 	BT_DEBUG("[%s](%d) getImpl->readDescriptors\n", __FUNCTION__, __LINE__);
 
 	if (!deviceAddress.empty())
-		readRemoteDescriptor(deviceAddress, serviceUuid, characteristicUuid, descriptorUuid, descriptorToRead.getHandle(), readDescriptorCallback);
+		readRemoteDescriptor(deviceAddress, serviceUuid, characteristicUuid, descriptorUuid, descriptorToRead.getHandle(), readDescriptorCallback, priority);
 	else
 		readDescriptorCallback(BLUETOOTH_ERROR_NONE, descriptorToRead);
 
@@ -2637,9 +3376,10 @@ bool BluetoothGattProfileService::readDescriptorValues(LSMessage &message)
 		return true;
 	}
 
-	const std::string schema = STRICT_SCHEMA(PROPS_6(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
+	const std::string schema = STRICT_SCHEMA(PROPS_7(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
 	                                                 PROP(service, string), PROP(characteristic, string),
-	                                                 ARRAY(descriptors, string))
+	                                                 ARRAY(descriptors, string),
+	                                                 PROP_WITH_VAL_3(priority, string, "high", "normal", "background"))
 	                                                 REQUIRED_3(service, characteristic, descriptors));
 
 	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
@@ -2742,9 +3482,13 @@ bool BluetoothGattProfileService::readDescriptorValues(LSMessage &message)
 		LSUtils::postToClient(requestMessage, responseObj);
 	};
 
+	BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL;
+	if (requestObj.hasKey("priority"))
+		priority = BluetoothGattOperationQueue::priorityFromString(requestObj["priority"].asString());
+
 	BT_DEBUG("[%s](%d) getImpl->readDescriptors\n", __FUNCTION__, __LINE__);
 	if (!deviceAddress.empty())
-		readRemoteDescriptors(deviceAddress, serviceUuid, characteristicUuid, descriptors, readDescriptorsCallback);
+		readRemoteDescriptors(deviceAddress, serviceUuid, characteristicUuid, descriptors, readDescriptorsCallback, priority);
 	else
 		readLocalDescriptors(serviceUuid, characteristicUuid, descriptors, readDescriptorsCallback);
 
@@ -2764,9 +3508,10 @@ bool BluetoothGattProfileService::writeDescriptorValue(LSMessage &message)
 		return true;
 	}
 
-	const std::string schema = STRICT_SCHEMA(PROPS_8(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
+	const std::string schema = STRICT_SCHEMA(PROPS_9(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
 	                                                 PROP(service, string), PROP(characteristic, string),
 	                                                 PROP(descriptor, string), PROP(writeType, string),
+	                                                 PROP_WITH_VAL_3(priority, string, "high", "normal", "background"),
 	                                                 OBJECT(value, OBJSCHEMA_3(PROP(string, string),
 	                                                                           PROP(number, integer),
 	                                                                           ARRAY(bytes, integer))))
@@ -2900,6 +3645,10 @@ bool BluetoothGattProfileService::writeDescriptorValue(LSMessage &message)
 			descriptorToWrite.setWriteType(WriteType::SIGNED);
 	}
 
+	BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL;
+	if (requestObj.hasKey("priority"))
+		priority = BluetoothGattOperationQueue::priorityFromString(requestObj["priority"].asString());
+
 	LSMessage *requestMessage = request.get();
 	LSMessageRef(requestMessage);
 
@@ -2925,20 +3674,10 @@ bool BluetoothGattProfileService::writeDescriptorValue(LSMessage &message)
 	BT_DEBUG("[%s](%d) getImpl->writeDescriptor\n", __FUNCTION__, __LINE__);
 	if (!deviceAddress.empty())
 	{
-		if (connectId > 0)
-		{
-			if (!requestObj.hasKey("instanceId"))
-				getImpl<BluetoothGattProfile>()->writeDescriptor(connectId, serviceUuid, characteristicUuid, descriptorToWrite, writeDescriptorCallback);
-			else
-				getImpl<BluetoothGattProfile>()->writeDescriptor(connectId, descriptorToWrite, writeDescriptorCallback);
-		}
+		if (!requestObj.hasKey("instanceId"))
+			writeRemoteDescriptor(deviceAddress, serviceUuid, characteristicUuid, descriptorToWrite, writeDescriptorCallback, priority);
 		else
-		{
-			if (!requestObj.hasKey("instanceId"))
-				getImpl<BluetoothGattProfile>()->writeDescriptor(deviceAddress, serviceUuid, characteristicUuid, descriptorToWrite, writeDescriptorCallback);
-			else
-				getImpl<BluetoothGattProfile>()->writeDescriptor(deviceAddress, descriptorToWrite, writeDescriptorCallback);
-		}
+			writeRemoteDescriptor(deviceAddress, BluetoothUuid(), BluetoothUuid(), descriptorToWrite, writeDescriptorCallback, priority);
 	}
 	else
 	{
@@ -2951,200 +3690,1538 @@ bool BluetoothGattProfileService::writeDescriptorValue(LSMessage &message)
 	return true;
 }
 
-#define safe_callback(callback, ...) do { if (callback) callback(__VA_ARGS__); } while(0)
-
-bool BluetoothGattProfileService::addLocalServer(const BluetoothUuid applicationUuid, LocalServer* newServer)
+bool BluetoothGattProfileService::readCharacteristicValuesBulk(LSMessage &message)
 {
-	BT_DEBUG("[%s](%d) getImpl->addApplication\n", __FUNCTION__, __LINE__);
-	uint16_t server_if = getImpl<BluetoothGattProfile>()->addApplication(BluetoothUuid(applicationUuid), ApplicationType::SERVER);
-	if (server_if == static_cast<uint16_t>(0))
-		return false;
-
-	newServer->id = server_if;
-	mLocalServer.insert({applicationUuid, newServer});
-	return true;
-}
+	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
 
-void BluetoothGattProfileService::addLocalService(const BluetoothUuid applicationUuid, const BluetoothGattService &service, BluetoothResultCallback callback)
-{
-	BT_DEBUG("[%s](%d) called\n", __FUNCTION__, __LINE__);
-	auto server = findLocalServer(applicationUuid);
-	if (server == nullptr)
+	if (!mImpl && !getImpl<BluetoothGattProfile>())
 	{
-		BT_ERROR("GATT_SERVER_NOT_FOUND", 0,
-		             "Server %s not exist",
-					 applicationUuid.toString().c_str());
-		LocalServer* newServer = new LocalServer;
-		if(!addLocalServer(applicationUuid, newServer))
-		{
-			BT_ERROR("GATT_SERVICE_ALREADY_REGISTERED", 0, "addLocalServer is failed");
-			safe_callback(callback, BLUETOOTH_ERROR_FAIL);
-			return;
-		}
-		server = newServer;
+		LSUtils::respondWithError(request, BT_ERR_PROFILE_UNAVAIL);
+		return true;
 	}
 
-	if (service.getCharacteristics().size() == 0)
-	{
-		BT_ERROR("GATT_SERVICE_WITHOUT_CHARACTERISTICS", 0,
-		              "Can't register service %s without any characteristics",
-		              service.getUuid().toString().c_str());
-		safe_callback(callback, BLUETOOTH_ERROR_PARAM_INVALID);
-		return;
-	}
+	const std::string schema = STRICT_SCHEMA(PROPS_5(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
+	                                                 PROP_WITH_VAL_3(priority, string, "high", "normal", "background"),
+	                                                 OBJARRAY(characteristics, OBJSCHEMA_3(PROP(service, string),
+	                                                                                       PROP(characteristic, string),
+	                                                                                       PROP(instanceId, string))))
+	                                                 REQUIRED_1(characteristics));
 
-	if (isLocalServiceRegistered(service.getUuid()))
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
 	{
-		BT_ERROR("GATT_SERVICE_ALREADY_REGISTERED", 0,
-		              "Service %s is already registered",
-		              service.getUuid().toString().c_str());
-		safe_callback(callback, BLUETOOTH_ERROR_PARAM_INVALID);
-		return;
-	}
-
-	BT_DEBUG("Starting to register service %s with %d characteristics",
-	              service.getUuid().toString().c_str(),
-	              service.getCharacteristics().size());
-
-	// NOTE: We need to add the service item before we call BSA_BleSeCreateService
-	// as the corresponding event can be recieved while we're still in the call or
-	// afterwards. If we receive it while still in the call and don't have the item
-	// added yet we will never tell our caller the result of the operation.
-	LocalService* newService = new LocalService;
-	newService->desc = service; // TODO: Change to pointer assign
-	newService->addServiceCallback = callback;
-
-	auto addServiceCallback = [this, server, newService](BluetoothError error, uint16_t serviceId) {
-
-		if (error != BLUETOOTH_ERROR_NONE)
-		{
-			safe_callback(newService->addServiceCallback, error);
-			delete newService;
-			return;
-		}
-
-		BT_INFO("BLE", 0, "add serviceId:%d complete\n", serviceId);
-		newService->id = serviceId;
-		initCharacteristic(newService); // iterator
-		addLocalCharacteristic(server, newService);
-	};
-	BT_DEBUG("[%s](%d) getImpl->addService server:%d service:%s\n", __FUNCTION__, __LINE__, server->id, service.getUuid().toString().c_str());
-	// TODO: Needs server_if, uuid, handles, primary
-	getImpl<BluetoothGattProfile>()->addService(server->id, service, addServiceCallback);
-}
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
 
-void BluetoothGattProfileService::initCharacteristic(LocalService* newService)
-{
-	newService->characteristics = newService->desc.getCharacteristics();
-	newService->charIt = newService->characteristics.begin();
-	newService->descriptors.clear();
-	newService->descIt = newService->descriptors.end();
-}
+		else if (!requestObj.hasKey("characteristics"))
+			LSUtils::respondWithError(request, BT_ERR_GATT_CHARACTERISTICS_PARAM_MISSING);
 
-bool BluetoothGattProfileService::hasNext(LocalService* newService)
-{
-	// next descriptor
-	if (newService->descIt == newService->descriptors.end())
-	{
-		newService->descriptors = (*newService->charIt).getDescriptors();
-		newService->descIt = newService->descriptors.begin();
-	}
-	else
-		++newService->descIt;
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
 
-	// has descriptor
-	if (newService->descIt != newService->descriptors.end())
-	{
 		return true;
 	}
 
-	// no more descriptor, next characteristic
-	++newService->charIt;
-
-	// has characteristic
-	if (newService->charIt != newService->characteristics.end())
+	auto itemsArray = requestObj["characteristics"];
+	if (itemsArray.arraySize() == 0)
 	{
+		LSUtils::respondWithError(request, BT_ERR_GATT_CHARACTERISTICS_PARAM_MISSING);
 		return true;
 	}
 
-	// no more characteristic
-	newService->characteristics.clear();
-	newService->descriptors.clear();
-	return false;
-}
-
-void BluetoothGattProfileService::addLocalCharacteristic(LocalServer* server, LocalService* newService)
-{
-	BT_DEBUG("[%s](%d) getImpl->addCharacteristic\n", __FUNCTION__, __LINE__);
-	if (newService->descIt == newService->descriptors.end())
+	std::string adapterAddress;
+	if (requestObj.hasKey("adapterAddress"))
 	{
-		auto characteristic = *newService->charIt;
-		getImpl<BluetoothGattProfile>()->addCharacteristic(
-				server->id,
-				newService->id,
-				characteristic,
-				std::bind(&BluetoothGattProfileService::addCharacteristicCallback, this, server, newService, _1, _2));
+		adapterAddress = requestObj["adapterAddress"].asString();
+		if (!getManager()->isAdapterAvailable(adapterAddress))
+		{
+			LSUtils::respondWithError(request, BT_ERR_INVALID_ADAPTER_ADDRESS);
+			return true;
+		}
 	}
 	else
 	{
-		auto descriptor = *newService->descIt;
-		getImpl<BluetoothGattProfile>()->addDescriptor(
-				server->id,
-				newService->id,
-				descriptor,
-				std::bind(&BluetoothGattProfileService::addCharacteristicCallback, this, server, newService, _1, _2));
+		adapterAddress = getManager()->getAddress();
 	}
-}
 
-void BluetoothGattProfileService::addCharacteristicCallback(LocalServer* server, LocalService* newService, BluetoothError error, uint16_t charId)
-{
-	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
-	auto& service = newService->desc;
+	uint16_t appId = 0;
+	uint16_t connectId = 0;
+	std::string deviceAddress;
 
+	if (requestObj.hasKey("serverId"))
+		appId = idToInt(requestObj["serverId"].asString());
+
+	else if(requestObj.hasKey("clientId"))
+	{
+		appId = idToInt(requestObj["clientId"].asString());
+		if(!getConnectId(appId, connectId, deviceAddress))
+		{
+			LSUtils::respondWithError(request, BT_ERR_DEVICE_NOT_AVAIL);
+			return true;
+		}
+	}
+
+	// Validate every item before the first read is sent so a bad item
+	// never leaves the client with a partially executed batch
+	std::vector<BluetoothGattCharacteristic> characteristicsToRead;
+	std::vector<std::string> serviceUuids;
+	std::vector<std::string> instanceIds;
+	for (int i = 0; i < itemsArray.arraySize(); i++)
+	{
+		auto itemObj = itemsArray[i];
+		BluetoothGattCharacteristic characteristicToRead;
+		std::string serviceUuid;
+		std::string instanceId;
+
+		if (itemObj.hasKey("instanceId"))
+		{
+			instanceId = itemObj["instanceId"].asString();
+			if (!isCharacteristicValid(deviceAddress, idToInt(instanceId), &characteristicToRead))
+			{
+				LSUtils::respondWithError(request, BT_ERR_GATT_INVALID_CHARACTERISTIC);
+				return true;
+			}
+		}
+		else
+		{
+			if (!itemObj.hasKey("service"))
+			{
+				LSUtils::respondWithError(request, BT_ERR_GATT_SERVICE_NAME_PARAM_MISSING);
+				return true;
+			}
+			else if (!itemObj.hasKey("characteristic"))
+			{
+				LSUtils::respondWithError(request, BT_ERR_GATT_CHARACTERISTIC_PARAM_MISSING);
+				return true;
+			}
+
+			serviceUuid = itemObj["service"].asString();
+			if (!isCharacteristicValid(deviceAddress, serviceUuid, itemObj["characteristic"].asString(), &characteristicToRead))
+			{
+				LSUtils::respondWithError(request, BT_ERR_GATT_INVALID_CHARACTERISTIC);
+				return true;
+			}
+		}
+
+		characteristicsToRead.push_back(characteristicToRead);
+		serviceUuids.push_back(serviceUuid);
+		instanceIds.push_back(instanceId);
+	}
+
+	BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL;
+	if (requestObj.hasKey("priority"))
+		priority = BluetoothGattOperationQueue::priorityFromString(requestObj["priority"].asString());
+
+	LSMessage *requestMessage = request.get();
+	LSMessageRef(requestMessage);
+
+	BulkGattRequest *bulkRequest = new BulkGattRequest();
+	bulkRequest->requestMessage = requestMessage;
+	bulkRequest->adapterAddress = adapterAddress;
+	bulkRequest->deviceAddress = deviceAddress;
+	bulkRequest->errorCode = BT_ERR_GATT_READ_CHARACTERISTIC_FAIL;
+	bulkRequest->remaining = characteristicsToRead.size();
+	bulkRequest->results.resize(characteristicsToRead.size());
+
+	// On failure the characteristic passed in is the one which was requested
+	auto itemReadCallback = [this, bulkRequest, deviceAddress, serviceUuids, instanceIds](unsigned int index, BluetoothError error,
+	                                                                                      const BluetoothGattCharacteristic &characteristic) {
+		pbnjson::JValue resultObj = pbnjson::Object();
+		if (error == BLUETOOTH_ERROR_NONE)
+		{
+			resultObj = buildCharacteristic(deviceAddress.empty(), characteristic);
+			resultObj.put("returnValue", true);
+		}
+		else
+		{
+			resultObj.put("characteristic", characteristic.getUuid().toString());
+			resultObj.put("returnValue", false);
+			resultObj.put("errorCode", (int) BT_ERR_GATT_READ_CHARACTERISTIC_FAIL);
+			resultObj.put("errorText", retrieveErrorText(BT_ERR_GATT_READ_CHARACTERISTIC_FAIL));
+		}
+
+		if (!serviceUuids[index].empty())
+			resultObj.put("service", serviceUuids[index]);
+
+		if (!instanceIds[index].empty())
+			resultObj.put("instanceId", instanceIds[index]);
+
+		completeBulkItem(bulkRequest, index, resultObj);
+	};
+
+	if (deviceAddress.empty())
+	{
+		// Local characteristic values are known already, nothing to schedule
+		for (unsigned int index = 0; index < characteristicsToRead.size(); index++)
+			itemReadCallback(index, BLUETOOTH_ERROR_NONE, characteristicsToRead[index]);
+
+		return true;
+	}
+
+	// Characteristics addressed by UUID are read with one request per
+	// service, those addressed by handle with one request each. All of them
+	// are queued back to back on the device's operation queue.
+	std::map<std::string, std::vector<unsigned int>> serviceItems;
+	std::vector<unsigned int> handleItems;
+	for (unsigned int index = 0; index < characteristicsToRead.size(); index++)
+	{
+		if (!instanceIds[index].empty())
+			handleItems.push_back(index);
+		else
+			serviceItems[serviceUuids[index]].push_back(index);
+	}
+
+	for (auto serviceItem : serviceItems)
+	{
+		std::string serviceUuid = serviceItem.first;
+		std::vector<unsigned int> indexes = serviceItem.second;
+		std::vector<BluetoothGattCharacteristic> requestedCharacteristics;
+		BluetoothUuidList characteristicUuids;
+		for (auto index : indexes)
+		{
+			requestedCharacteristics.push_back(characteristicsToRead[index]);
+			characteristicUuids.push_back(characteristicsToRead[index].getUuid());
+		}
+
+		auto readCharacteristicsCallback = [itemReadCallback, indexes, requestedCharacteristics](BluetoothError error, BluetoothGattCharacteristicList characteristicsList) {
+			for (size_t i = 0; i < indexes.size(); i++)
+			{
+				BluetoothGattCharacteristic characteristic = requestedCharacteristics[i];
+				BluetoothError itemError = error;
+
+				if (error == BLUETOOTH_ERROR_NONE)
+				{
+					itemError = BLUETOOTH_ERROR_FAIL;
+					for (auto readCharacteristic : characteristicsList)
+					{
+						if (readCharacteristic.getUuid() == characteristic.getUuid())
+						{
+							characteristic = readCharacteristic;
+							itemError = BLUETOOTH_ERROR_NONE;
+							break;
+						}
+					}
+				}
+
+				itemReadCallback(indexes[i], itemError, characteristic);
+			}
+		};
+
+		readRemoteCharacteristics(deviceAddress, serviceUuid, characteristicUuids, readCharacteristicsCallback, priority);
+	}
+
+	for (auto index : handleItems)
+	{
+		BluetoothGattCharacteristic characteristicToRead = characteristicsToRead[index];
+
+		auto readCharacteristicCallback = [itemReadCallback, index, characteristicToRead](BluetoothError error, BluetoothGattCharacteristic characteristic) {
+			if (error != BLUETOOTH_ERROR_NONE)
+				itemReadCallback(index, error, characteristicToRead);
+			else
+				itemReadCallback(index, error, characteristic);
+		};
+
+		readRemoteCharacteristic(deviceAddress, BluetoothUuid(), BluetoothUuid(), characteristicToRead.getHandle(), readCharacteristicCallback, priority);
+	}
+
+	return true;
+}
+
+bool BluetoothGattProfileService::writeCharacteristicValues(LSMessage &message)
+{
+	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!mImpl && !getImpl<BluetoothGattProfile>())
+	{
+		LSUtils::respondWithError(request, BT_ERR_PROFILE_UNAVAIL);
+		return true;
+	}
+
+	const std::string schema = STRICT_SCHEMA(PROPS_5(PROP(adapterAddress, string), PROP(serverId, string), PROP(clientId, string),
+	                                                 PROP_WITH_VAL_3(priority, string, "high", "normal", "background"),
+	                                                 OBJARRAY(characteristics, OBJSCHEMA_6(PROP(service, string),
+	                                                                                       PROP(characteristic, string),
+	                                                                                       PROP(instanceId, string),
+	                                                                                       PROP(writeType, string),
+	                                                                                       PROP_WITH_VAL_2(policy, string, "auto", "forward"),
+	                                                                                       OBJECT(value, OBJSCHEMA_3(PROP(string, string),
+	                                                                                                                 PROP(number, integer),
+	                                                                                                                 ARRAY(bytes, integer))))))
+	                                                 REQUIRED_1(characteristics));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+
+		else if (!requestObj.hasKey("characteristics"))
+			LSUtils::respondWithError(request, BT_ERR_GATT_CHARACTERISTICS_PARAM_MISSING);
+
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	auto itemsArray = requestObj["characteristics"];
+	if (itemsArray.arraySize() == 0)
+	{
+		LSUtils::respondWithError(request, BT_ERR_GATT_CHARACTERISTICS_PARAM_MISSING);
+		return true;
+	}
+
+	std::string adapterAddress;
+	if (requestObj.hasKey("adapterAddress"))
+	{
+		adapterAddress = requestObj["adapterAddress"].asString();
+		if (!getManager()->isAdapterAvailable(adapterAddress))
+		{
+			LSUtils::respondWithError(request, BT_ERR_INVALID_ADAPTER_ADDRESS);
+			return true;
+		}
+	}
+	else
+	{
+		adapterAddress = getManager()->getAddress();
+	}
+
+	uint16_t appId = 0;
+	uint16_t connectId = 0;
+	std::string deviceAddress;
+
+	if (requestObj.hasKey("serverId"))
+		appId = idToInt(requestObj["serverId"].asString());
+
+	else if(requestObj.hasKey("clientId"))
+	{
+		appId = idToInt(requestObj["clientId"].asString());
+		if(!getConnectId(appId, connectId, deviceAddress))
+		{
+			LSUtils::respondWithError(request, BT_ERR_DEVICE_NOT_AVAIL);
+			return true;
+		}
+	}
+
+	// Validate every item before the first write is sent so a bad item
+	// never leaves the device with a partially applied batch
+	std::vector<BluetoothGattCharacteristic> characteristicsToWrite;
+	std::vector<std::string> serviceUuids;
+	std::vector<std::string> instanceIds;
+	std::vector<std::string> policies;
+	for (int i = 0; i < itemsArray.arraySize(); i++)
+	{
+		auto itemObj = itemsArray[i];
+		BluetoothGattCharacteristic characteristicToWrite;
+		std::string serviceUuid;
+		std::string instanceId;
+		std::string policy;
+
+		if (!itemObj.hasKey("value"))
+		{
+			LSUtils::respondWithError(request, BT_ERR_GATT_CHARACTERISTC_VALUE_PARAM_MISSING);
+			return true;
+		}
+
+		// The read policy only applies to characteristics of our own servers
+		if (itemObj.hasKey("policy"))
+		{
+			if (!deviceAddress.empty())
+			{
+				LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+				return true;
+			}
+
+			policy = itemObj["policy"].asString();
+		}
+
+		if (itemObj.hasKey("instanceId"))
+		{
+			instanceId = itemObj["instanceId"].asString();
+			if (!isCharacteristicValid(deviceAddress, idToInt(instanceId), &characteristicToWrite))
+			{
+				LSUtils::respondWithError(request, BT_ERR_GATT_INVALID_CHARACTERISTIC);
+				return true;
+			}
+		}
+		else
+		{
+			if (!itemObj.hasKey("service"))
+			{
+				LSUtils::respondWithError(request, BT_ERR_GATT_SERVICE_NAME_PARAM_MISSING);
+				return true;
+			}
+			else if (!itemObj.hasKey("characteristic"))
+			{
+				LSUtils::respondWithError(request, BT_ERR_GATT_CHARACTERISTIC_PARAM_MISSING);
+				return true;
+			}
+
+			serviceUuid = itemObj["service"].asString();
+			if (!isCharacteristicValid(deviceAddress, serviceUuid, itemObj["characteristic"].asString(), &characteristicToWrite))
+			{
+				LSUtils::respondWithError(request, BT_ERR_GATT_INVALID_CHARACTERISTIC);
+				return true;
+			}
+		}
+
+		BluetoothGattValue value;
+		if (!parseValue(itemObj["value"], &value))
+		{
+			LSUtils::respondWithError(request, BT_ERR_GATT_CHARACTERISTC_INVALID_VALUE_PARAM);
+			return true;
+		}
+		characteristicToWrite.setValue(value);
+
+		if (itemObj.hasKey("writeType"))
+		{
+			std::string writeType = itemObj["writeType"].asString();
+			if(writeType == "default")
+				characteristicToWrite.setWriteType(WriteType::DEFAULT);
+			else if(writeType == "noresponse")
+				characteristicToWrite.setWriteType(WriteType::NO_RESPONSE);
+			else if(writeType == "signed")
+				characteristicToWrite.setWriteType(WriteType::SIGNED);
+		}
+
+		characteristicsToWrite.push_back(characteristicToWrite);
+		serviceUuids.push_back(serviceUuid);
+		instanceIds.push_back(instanceId);
+		policies.push_back(policy);
+	}
+
+	BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL;
+	if (requestObj.hasKey("priority"))
+		priority = BluetoothGattOperationQueue::priorityFromString(requestObj["priority"].asString());
+
+	LSMessage *requestMessage = request.get();
+	LSMessageRef(requestMessage);
+
+	BulkGattRequest *bulkRequest = new BulkGattRequest();
+	bulkRequest->requestMessage = requestMessage;
+	bulkRequest->adapterAddress = adapterAddress;
+	bulkRequest->deviceAddress = deviceAddress;
+	bulkRequest->errorCode = BT_ERR_GATT_WRITE_CHARACTERISTIC_FAIL;
+	bulkRequest->remaining = characteristicsToWrite.size();
+	bulkRequest->results.resize(characteristicsToWrite.size());
+
+	// Writes are issued in request order. For a remote device they are
+	// queued back to back and so reach the peer in that order as well.
+	for (unsigned int index = 0; index < characteristicsToWrite.size(); index++)
+	{
+		std::string serviceUuid = serviceUuids[index];
+		std::string instanceId = instanceIds[index];
+		std::string policy = policies[index];
+		BluetoothUuid characteristicUuid = characteristicsToWrite[index].getUuid();
+		uint16_t handle = characteristicsToWrite[index].getHandle();
+		bool local = deviceAddress.empty();
+
+		auto writeCharacteristicCallback = [this, bulkRequest, index, serviceUuid, instanceId, policy, characteristicUuid, handle, local](BluetoothError error) {
+			pbnjson::JValue resultObj = pbnjson::Object();
+			if (!serviceUuid.empty())
+				resultObj.put("service", serviceUuid);
+			if (!instanceId.empty())
+				resultObj.put("instanceId", instanceId);
+			resultObj.put("characteristic", characteristicUuid.toString());
+
+			if (error == BLUETOOTH_ERROR_NONE)
+			{
+				resultObj.put("returnValue", true);
+
+				BluetoothGattStoredValue *storedValue = local ? mValueStore.find(handle) : nullptr;
+				if (storedValue)
+				{
+					if (!policy.empty())
+						storedValue->policy = BluetoothGattValueStore::policyFromString(policy);
+
+					resultObj.put("version", (int64_t) storedValue->version);
+					resultObj.put("policy", BluetoothGattValueStore::policyToString(storedValue->policy));
+				}
+			}
+			else
+			{
+				resultObj.put("returnValue", false);
+				resultObj.put("errorCode", (int) BT_ERR_GATT_WRITE_CHARACTERISTIC_FAIL);
+				resultObj.put("errorText", retrieveErrorText(BT_ERR_GATT_WRITE_CHARACTERISTIC_FAIL));
+			}
+
+			completeBulkItem(bulkRequest, index, resultObj);
+		};
+
+		if (!deviceAddress.empty())
+		{
+			if (instanceId.empty())
+				writeRemoteCharacteristic(deviceAddress, serviceUuid, characteristicsToWrite[index], writeCharacteristicCallback, priority);
+			else
+				writeRemoteCharacteristic(deviceAddress, BluetoothUuid(), characteristicsToWrite[index], writeCharacteristicCallback, priority);
+		}
+		else
+		{
+			if (instanceId.empty())
+				writeLocalCharacteristic(serviceUuid, characteristicsToWrite[index], writeCharacteristicCallback);
+			else
+				writeLocalCharacteristic(characteristicsToWrite[index], writeCharacteristicCallback);
+		}
+	}
+
+	return true;
+}
+
+bool BluetoothGattProfileService::openWriteStream(LSMessage &message)
+{
+	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!mImpl && !getImpl<BluetoothGattProfile>())
+	{
+		LSUtils::respondWithError(request, BT_ERR_PROFILE_UNAVAIL);
+		return true;
+	}
+
+	const std::string schema = STRICT_SCHEMA(PROPS_9(PROP(adapterAddress, string), PROP(clientId, string),
+	                                                 PROP(service, string), PROP(characteristic, string), PROP(instanceId, string),
+	                                                 PROP(chunkSize, integer), PROP(interval, integer), PROP(progressInterval, integer),
+	                                                 PROP(subscribe, boolean))
+	                                                 REQUIRED_2(clientId, subscribe));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+
+		else if (!requestObj.hasKey("clientId"))
+			LSUtils::respondWithError(request, BT_ERR_CLIENTID_PARAM_MISSING);
+
+		else if (!requestObj.hasKey("subscribe"))
+			LSUtils::respondWithError(request, BT_ERR_MTHD_NOT_SUBSCRIBED);
+
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	if (!request.isSubscription())
+	{
+		LSUtils::respondWithError(request, BT_ERR_MTHD_NOT_SUBSCRIBED);
+		return true;
+	}
+
+	if (!requestObj.hasKey("instanceId"))
+	{
+		if (!requestObj.hasKey("service"))
+		{
+			LSUtils::respondWithError(request, BT_ERR_GATT_SERVICE_NAME_PARAM_MISSING);
+			return true;
+		}
+		else if (!requestObj.hasKey("characteristic"))
+		{
+			LSUtils::respondWithError(request, BT_ERR_GATT_CHARACTERISTIC_PARAM_MISSING);
+			return true;
+		}
+	}
+
+	std::string adapterAddress;
+	if (requestObj.hasKey("adapterAddress"))
+	{
+		adapterAddress = requestObj["adapterAddress"].asString();
+		if (!getManager()->isAdapterAvailable(adapterAddress))
+		{
+			LSUtils::respondWithError(request, BT_ERR_INVALID_ADAPTER_ADDRESS);
+			return true;
+		}
+	}
+	else
+	{
+		adapterAddress = getManager()->getAddress();
+	}
+
+	uint16_t appId = idToInt(requestObj["clientId"].asString());
+	uint16_t connectId = 0;
+	std::string deviceAddress;
+	if (!getConnectId(appId, connectId, deviceAddress))
+	{
+		LSUtils::respondWithError(request, BT_ERR_DEVICE_NOT_AVAIL);
+		return true;
+	}
+
+	std::string serviceUuid;
+	BluetoothGattCharacteristic characteristicToWrite;
+	if (requestObj.hasKey("instanceId"))
+	{
+		uint16_t handle = idToInt(requestObj["instanceId"].asString());
+		if (!isCharacteristicValid(deviceAddress, handle, &characteristicToWrite))
+		{
+			LSUtils::respondWithError(request, BT_ERR_GATT_INVALID_CHARACTERISTIC);
+			return true;
+		}
+	}
+	else
+	{
+		serviceUuid = requestObj["service"].asString();
+		if (!isCharacteristicValid(deviceAddress, serviceUuid, requestObj["characteristic"].asString(), &characteristicToWrite))
+		{
+			LSUtils::respondWithError(request, BT_ERR_GATT_INVALID_CHARACTERISTIC);
+			return true;
+		}
+	}
+
+	if (!characteristicToWrite.isPropertySet(BluetoothGattCharacteristic::Property::PROPERTY_WRITE_WITHOUT_RESPONSE))
+	{
+		LSUtils::respondWithError(request, BT_ERR_GATT_WRITE_WITHOUT_RESPONSE_NOT_SUPPORTED);
+		return true;
+	}
+	characteristicToWrite.setWriteType(WriteType::NO_RESPONSE);
+
+	// The SIL doesn't expose the negotiated MTU, so the client which
+	// negotiated it tells us how much fits into one write command
+	uint16_t chunkSize = GATT_WRITE_STREAM_DEFAULT_CHUNK_SIZE;
+	if (requestObj.hasKey("chunkSize"))
+	{
+		int32_t requestedChunkSize = requestObj["chunkSize"].asNumber<int32_t>();
+		if (requestedChunkSize < 1 || requestedChunkSize > GATT_WRITE_STREAM_MAX_CHUNK_SIZE)
+		{
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+			return true;
+		}
+
+		chunkSize = requestedChunkSize;
+	}
+
+	if ((requestObj.hasKey("interval") && requestObj["interval"].asNumber<int32_t>() < 0) ||
+	    (requestObj.hasKey("progressInterval") && requestObj["progressInterval"].asNumber<int32_t>() < 0))
+	{
+		LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+		return true;
+	}
+
+	uint32_t chunkInterval = 0;
+	if (requestObj.hasKey("interval"))
+		chunkInterval = requestObj["interval"].asNumber<int32_t>();
+
+	uint32_t progressInterval = GATT_WRITE_STREAM_DEFAULT_PROGRESS_INTERVAL;
+	if (requestObj.hasKey("progressInterval"))
+		progressInterval = requestObj["progressInterval"].asNumber<int32_t>();
+
+	std::string streamId = idToString(mNextWriteStreamId++);
+
+	// Chunks must not use the background priority: queued background
+	// writes to the same characteristic are coalesced into one.
+	auto writeFunction = [this, streamId, deviceAddress, serviceUuid, characteristicToWrite](const BluetoothGattValue &value, BluetoothResultCallback callback) {
+		BluetoothGattCharacteristic chunk = characteristicToWrite;
+		chunk.setValue(value);
+
+		writeRemoteCharacteristic(deviceAddress, serviceUuid, chunk, [this, streamId, callback](BluetoothError error) {
+			// The stream may have been closed while the chunk was queued
+			if (mWriteStreams.find(streamId) == mWriteStreams.end())
+				return;
+
+			callback(error);
+		}, BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL);
+	};
+
+	BluetoothGattWriteStream *writeStream = new BluetoothGattWriteStream(streamId, chunkSize, chunkInterval, progressInterval, writeFunction,
+	                                                                     std::bind(&BluetoothGattProfileService::handleWriteStreamStatus, this, streamId, _1));
+	if (!writeStream->open())
+	{
+		delete writeStream;
+		LSUtils::respondWithError(request, BT_ERR_GATT_WRITE_STREAM_FAIL);
+		return true;
+	}
+
+	GattWriteStreamSubscription *subscription = new GattWriteStreamSubscription();
+	subscription->writeStream = writeStream;
+	subscription->adapterAddress = adapterAddress;
+	subscription->deviceAddress = deviceAddress;
+	subscription->clientWatch = new LSUtils::ClientWatch(getManager()->get(), request.get(),
+	                                                     std::bind(&BluetoothGattProfileService::closeWriteStream, this, streamId));
+	mWriteStreams.insert(std::pair<std::string, GattWriteStreamSubscription*>(streamId, subscription));
+
+	BT_INFO("BLE", 0, "Write stream %s opened for %s with chunk size %d", streamId.c_str(), deviceAddress.c_str(), writeStream->getChunkSize());
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("subscribed", true);
+	responseObj.put("adapterAddress", adapterAddress);
+	responseObj.put("address", deviceAddress);
+	responseObj.put("streamId", streamId);
+	responseObj.put("path", writeStream->getSocketPath());
+	responseObj.put("chunkSize", (int32_t) writeStream->getChunkSize());
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+void BluetoothGattProfileService::handleWriteStreamStatus(const std::string &streamId, BluetoothError error)
+{
+	auto streamIter = mWriteStreams.find(streamId);
+	if (streamIter == mWriteStreams.end())
+		return;
+
+	GattWriteStreamSubscription *subscription = streamIter->second;
+	LSMessage *requestMessage = subscription->clientWatch->getMessage();
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", error == BLUETOOTH_ERROR_NONE);
+	responseObj.put("subscribed", error == BLUETOOTH_ERROR_NONE);
 	if (error != BLUETOOTH_ERROR_NONE)
+	{
+		responseObj.put("errorCode", (int) BT_ERR_GATT_WRITE_CHARACTERISTIC_FAIL);
+		responseObj.put("errorText", retrieveErrorText(BT_ERR_GATT_WRITE_CHARACTERISTIC_FAIL));
+	}
+	responseObj.put("adapterAddress", subscription->adapterAddress);
+	responseObj.put("address", subscription->deviceAddress);
+	responseObj.put("streamId", streamId);
+	responseObj.put("bytesReceived", (int64_t) subscription->writeStream->getBytesReceived());
+	responseObj.put("bytesWritten", (int64_t) subscription->writeStream->getBytesWritten());
+	responseObj.put("chunksWritten", (int64_t) subscription->writeStream->getChunksWritten());
+
+	LSUtils::postToClient(requestMessage, responseObj);
+
+	if (error != BLUETOOTH_ERROR_NONE)
+		closeWriteStream(streamId);
+}
+
+void BluetoothGattProfileService::closeWriteStream(const std::string &streamId)
+{
+	auto streamIter = mWriteStreams.find(streamId);
+	if (streamIter == mWriteStreams.end())
+		return;
+
+	GattWriteStreamSubscription *subscription = streamIter->second;
+	mWriteStreams.erase(streamIter);
+
+	BT_INFO("BLE", 0, "Write stream %s closed after %llu bytes", streamId.c_str(),
+	        (unsigned long long) subscription->writeStream->getBytesWritten());
+
+	delete subscription->writeStream;
+	delete subscription->clientWatch;
+	delete subscription;
+}
+
+void BluetoothGattProfileService::closeWriteStreams(const std::string &deviceAddress)
+{
+	std::vector<std::string> streamIds;
+	for (auto streamIter : mWriteStreams)
+	{
+		if (streamIter.second->deviceAddress == deviceAddress)
+			streamIds.push_back(streamIter.first);
+	}
+
+	for (auto streamId : streamIds)
+	{
+		GattWriteStreamSubscription *subscription = mWriteStreams[streamId];
+		LSUtils::respondWithError(subscription->clientWatch->getMessage(), BT_ERR_DEVICE_NOT_AVAIL, true);
+		closeWriteStream(streamId);
+	}
+}
+
+bool BluetoothGattProfileService::monitorReadRequests(LSMessage &message)
+{
+	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!mImpl && !getImpl<BluetoothGattProfile>())
+	{
+		LSUtils::respondWithError(request, BT_ERR_PROFILE_UNAVAIL);
+		return true;
+	}
+
+	const std::string schema = STRICT_SCHEMA(PROPS_2(PROP(adapterAddress, string), PROP(subscribe, boolean))
+	                                                 REQUIRED_1(subscribe));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+
+		else if (!requestObj.hasKey("subscribe"))
+			LSUtils::respondWithError(request, BT_ERR_MTHD_NOT_SUBSCRIBED);
+
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	if (!request.isSubscription())
+	{
+		LSUtils::respondWithError(request, BT_ERR_MTHD_NOT_SUBSCRIBED);
+		return true;
+	}
+
+	std::string adapterAddress;
+	if (requestObj.hasKey("adapterAddress"))
+	{
+		adapterAddress = requestObj["adapterAddress"].asString();
+		if (!getManager()->isAdapterAvailable(adapterAddress))
+		{
+			LSUtils::respondWithError(request, BT_ERR_INVALID_ADAPTER_ADDRESS);
+			return true;
+		}
+	}
+	else
+	{
+		adapterAddress = getManager()->getAddress();
+	}
+
+	auto watch = new LSUtils::ClientWatch(getManager()->get(), &message, nullptr);
+	watch->setCallback(std::bind(&BluetoothGattProfileService::handleReadRequestsClientDropped, this, watch));
+	mReadRequestWatches.push_back(watch);
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("subscribed", true);
+	responseObj.put("adapterAddress", adapterAddress);
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+bool BluetoothGattProfileService::respondReadRequest(LSMessage &message)
+{
+	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!mImpl && !getImpl<BluetoothGattProfile>())
+	{
+		LSUtils::respondWithError(request, BT_ERR_PROFILE_UNAVAIL);
+		return true;
+	}
+
+	const std::string schema = STRICT_SCHEMA(PROPS_3(PROP(adapterAddress, string), PROP(requestId, integer),
+	                                                 OBJECT(value, OBJSCHEMA_3(PROP(string, string), PROP(number, integer), ARRAY(bytes, integer))))
+	                                                 REQUIRED_2(requestId, value));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+
+		else if (!requestObj.hasKey("value"))
+			LSUtils::respondWithError(request, BT_ERR_GATT_CHARACTERISTC_VALUE_PARAM_MISSING);
+
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	std::string adapterAddress;
+	if (requestObj.hasKey("adapterAddress"))
+	{
+		adapterAddress = requestObj["adapterAddress"].asString();
+		if (!getManager()->isAdapterAvailable(adapterAddress))
+		{
+			LSUtils::respondWithError(request, BT_ERR_INVALID_ADAPTER_ADDRESS);
+			return true;
+		}
+	}
+	else
+	{
+		adapterAddress = getManager()->getAddress();
+	}
+
+	BluetoothGattValue value;
+	if (!parseValue(requestObj["value"], &value))
+	{
+		LSUtils::respondWithError(request, BT_ERR_GATT_CHARACTERISTC_INVALID_VALUE_PARAM);
+		return true;
+	}
+
+	uint32_t requestId = (uint32_t) requestObj["requestId"].asNumber<int64_t>();
+	if (mForwardedReadRequests.find(requestId) == mForwardedReadRequests.end())
+	{
+		LSUtils::respondWithError(request, BT_ERR_GATT_READ_REQUEST_NOT_FOUND);
+		return true;
+	}
+
+	completeForwardedRead(requestId, &value);
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("adapterAddress", adapterAddress);
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+bool BluetoothGattProfileService::forwardReadRequest(uint32_t requestId, const std::string &address, uint16_t handle, BluetoothGattStoredValue *storedValue)
+{
+	// Without an application listening there is nobody to forward to
+	if (mReadRequestWatches.empty())
+		return false;
+
+	ForwardedReadRequest *forwardedRead = new ForwardedReadRequest();
+	forwardedRead->service = this;
+	forwardedRead->requestId = requestId;
+	forwardedRead->handle = handle;
+	forwardedRead->timeout = g_timeout_add_seconds(GATT_FORWARDED_READ_TIMEOUT, &BluetoothGattProfileService::handleForwardedReadTimeout, forwardedRead);
+	mForwardedReadRequests.insert(std::pair<uint32_t, ForwardedReadRequest*>(requestId, forwardedRead));
+
+	storedValue->forwardedReads++;
+
+	pbnjson::JValue readRequestObj = pbnjson::Object();
+	readRequestObj.put("requestId", (int64_t) requestId);
+	readRequestObj.put("address", address);
+	readRequestObj.put("service", storedValue->service.toString());
+	readRequestObj.put("characteristic", storedValue->characteristic.toString());
+	readRequestObj.put("instanceId", idToString(handle));
+	readRequestObj.put("version", (int64_t) storedValue->version);
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("subscribed", true);
+	responseObj.put("adapterAddress", getManager()->getAddress());
+	responseObj.put("readRequest", readRequestObj);
+
+	for (auto watch : mReadRequestWatches)
+		LSUtils::postToClient(watch->getMessage(), responseObj);
+
+	return true;
+}
+
+void BluetoothGattProfileService::completeForwardedRead(uint32_t requestId, const BluetoothGattValue *value)
+{
+	auto readIter = mForwardedReadRequests.find(requestId);
+	if (readIter == mForwardedReadRequests.end())
+		return;
+
+	ForwardedReadRequest *forwardedRead = readIter->second;
+	mForwardedReadRequests.erase(readIter);
+
+	if (forwardedRead->timeout)
+		g_source_remove(forwardedRead->timeout);
+
+	uint16_t handle = forwardedRead->handle;
+	delete forwardedRead;
+
+	BluetoothGattStoredValue *storedValue = mValueStore.find(handle);
+	if (!storedValue)
+	{
+		// The service went away while the application was asked
+		getImpl<BluetoothGattProfile>()->characteristicValueReadResponse(requestId, BLUETOOTH_ERROR_FAIL, BluetoothGattValue());
+		return;
+	}
+
+	// The application answered with the current value so remember it for
+	// the following reads as well
+	if (value)
+	{
+		mValueStore.update(handle, storedValue->service, storedValue->characteristic, *value);
+
+		auto localService = findLocalServiceByCharId(handle);
+		if (localService)
+		{
+			localService->desc.updateCharacteristicValue(storedValue->characteristic, *value);
+			mServicesPayloadCache.invalidateLocal();
+		}
+	}
+
+	BT_DEBUG("[%s](%d) getImpl<BluetoothGattProfile>()->characteristicValueReadResponse\n", __FUNCTION__, __LINE__);
+	getImpl<BluetoothGattProfile>()->characteristicValueReadResponse(requestId, BLUETOOTH_ERROR_NONE, storedValue->value);
+}
+
+gboolean BluetoothGattProfileService::handleForwardedReadTimeout(gpointer userData)
+{
+	ForwardedReadRequest *forwardedRead = static_cast<ForwardedReadRequest*>(userData);
+	if (!forwardedRead)
+		return FALSE;
+
+	BT_WARNING(MSGID_GATT_OPERATION_TIMEOUT, 0, "Application didn't answer read request %u in time, responding with stored value", forwardedRead->requestId);
+
+	forwardedRead->timeout = 0;
+	forwardedRead->service->completeForwardedRead(forwardedRead->requestId, nullptr);
+
+	return FALSE;
+}
+
+void BluetoothGattProfileService::handleReadRequestsClientDropped(LSUtils::ClientWatch *watch)
+{
+	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	auto watchIter = std::find(mReadRequestWatches.begin(), mReadRequestWatches.end(), watch);
+	if (watchIter == mReadRequestWatches.end())
+		return;
+
+	mReadRequestWatches.erase(watchIter);
+	delete watch;
+
+	// Nobody is left to answer the reads still outstanding
+	if (mReadRequestWatches.empty())
+	{
+		std::vector<uint32_t> requestIds;
+		for (auto readIter : mForwardedReadRequests)
+			requestIds.push_back(readIter.first);
+
+		for (auto requestId : requestIds)
+			completeForwardedRead(requestId, nullptr);
+	}
+}
+
+void BluetoothGattProfileService::releaseLocalServiceState(LocalService *localService)
+{
+	mServicesPayloadCache.invalidateLocal();
+
+	if (!localService)
 		return;
 
-	BluetoothUuid itemUuid;
-	BluetoothGattValue itemValue;
+	for (auto characteristic : localService->desc.getCharacteristics())
+	{
+		mValueStore.remove(characteristic.getHandle());
+		mNotifyEngine->removeHandle(characteristic.getHandle());
+	}
+}
+
+bool BluetoothGattProfileService::getNotificationStatus(LSMessage &message)
+{
+	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!mImpl && !getImpl<BluetoothGattProfile>())
+	{
+		LSUtils::respondWithError(request, BT_ERR_PROFILE_UNAVAIL);
+		return true;
+	}
+
+	const std::string schema = STRICT_SCHEMA(PROPS_2(PROP(adapterAddress, string), PROP(address, string)));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	std::string adapterAddress;
+	if (requestObj.hasKey("adapterAddress"))
+	{
+		adapterAddress = requestObj["adapterAddress"].asString();
+		if (!getManager()->isAdapterAvailable(adapterAddress))
+		{
+			LSUtils::respondWithError(request, BT_ERR_INVALID_ADAPTER_ADDRESS);
+			return true;
+		}
+	}
+	else
+	{
+		adapterAddress = getManager()->getAddress();
+	}
+
+	std::string deviceAddress;
+	if (requestObj.hasKey("address"))
+		deviceAddress = convertToLower(requestObj["address"].asString());
+
+	pbnjson::JValue centralsObj = pbnjson::Array();
+	for (auto centralIter : mNotifyEngine->getCentrals())
+	{
+		BluetoothGattNotifyCentral *central = centralIter.second;
+		if (!deviceAddress.empty() && central->address != deviceAddress)
+			continue;
+
+		pbnjson::JValue subscriptionsObj = pbnjson::Array();
+		for (auto configuration : central->configurations)
+		{
+			pbnjson::JValue subscriptionObj = pbnjson::Object();
+			subscriptionObj.put("instanceId", idToString(configuration.first));
+			subscriptionObj.put("notify", (configuration.second & 0x01) != 0);
+			subscriptionObj.put("indicate", (configuration.second & 0x02) != 0);
+			subscriptionsObj.append(subscriptionObj);
+		}
+
+		pbnjson::JValue centralObj = pbnjson::Object();
+		centralObj.put("address", central->address);
+		centralObj.put("subscriptions", subscriptionsObj);
+		centralObj.put("depth", (int32_t) central->depth);
+		centralObj.put("maxDepth", (int32_t) central->maxDepth);
+		centralObj.put("sent", (int32_t) central->sent);
+		centralObj.put("coalesced", (int32_t) central->coalesced);
+		centralsObj.append(centralObj);
+	}
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("adapterAddress", adapterAddress);
+	responseObj.put("centrals", centralsObj);
+	responseObj.put("depth", (int32_t) mNotifyEngine->getDepth());
+	responseObj.put("enqueued", (int32_t) mNotifyEngine->getEnqueuedCount());
+	responseObj.put("sent", (int32_t) mNotifyEngine->getSentCount());
+	responseObj.put("coalesced", (int32_t) mNotifyEngine->getCoalescedCount());
+	responseObj.put("batches", (int32_t) mNotifyEngine->getBatchCount());
+	responseObj.put("maxBatchSize", (int32_t) mNotifyEngine->getMaxBatchSize());
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+bool BluetoothGattProfileService::getDiscoveryStatus(LSMessage &message)
+{
+	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!mImpl && !getImpl<BluetoothGattProfile>())
+	{
+		LSUtils::respondWithError(request, BT_ERR_PROFILE_UNAVAIL);
+		return true;
+	}
+
+	const std::string schema = STRICT_SCHEMA(PROPS_2(PROP(adapterAddress, string), PROP(address, string)));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	std::string adapterAddress;
+	if (requestObj.hasKey("adapterAddress"))
+	{
+		adapterAddress = requestObj["adapterAddress"].asString();
+		if (!getManager()->isAdapterAvailable(adapterAddress))
+		{
+			LSUtils::respondWithError(request, BT_ERR_INVALID_ADAPTER_ADDRESS);
+			return true;
+		}
+	}
+	else
+	{
+		adapterAddress = getManager()->getAddress();
+	}
+
+	std::string deviceAddress;
+	if (requestObj.hasKey("address"))
+		deviceAddress = convertToLower(requestObj["address"].asString());
+
+	pbnjson::JValue devicesObj = pbnjson::Array();
+	for (auto statsIter : mDiscoveryScheduler->getStats())
+	{
+		if (!deviceAddress.empty() && statsIter.first != deviceAddress)
+			continue;
+
+		const BluetoothGattDiscoveryStats &stats = statsIter.second;
+
+		pbnjson::JValue deviceObj = pbnjson::Object();
+		deviceObj.put("address", statsIter.first);
+		deviceObj.put("completed", (int32_t) stats.completedCount);
+		deviceObj.put("failed", (int32_t) stats.failedCount);
+		deviceObj.put("lastQueueTime", (int32_t) stats.lastQueueTime);
+		deviceObj.put("lastDuration", (int32_t) stats.lastDuration);
+		deviceObj.put("maxDuration", (int32_t) stats.maxDuration);
+		if (mDiscoveryScheduler->isDiscovering(statsIter.first))
+		{
+			deviceObj.put("state", mDiscoveryScheduler->isRunning(statsIter.first) ? "running" : "queued");
+			deviceObj.put("priority", BluetoothGattOperationQueue::priorityToString(mDiscoveryScheduler->getPriority(statsIter.first)));
+		}
+		else
+		{
+			deviceObj.put("state", "idle");
+		}
+		devicesObj.append(deviceObj);
+	}
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("adapterAddress", adapterAddress);
+	responseObj.put("maxConcurrent", (int32_t) mDiscoveryScheduler->getMaxConcurrent());
+	responseObj.put("running", (int32_t) mDiscoveryScheduler->getRunningCount());
+	responseObj.put("queued", (int32_t) mDiscoveryScheduler->getQueuedCount());
+	responseObj.put("maxQueued", (int32_t) mDiscoveryScheduler->getMaxQueuedCount());
+	responseObj.put("devices", devicesObj);
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+bool BluetoothGattProfileService::getOperationQueueStatus(LSMessage &message)
+{
+	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!mImpl && !getImpl<BluetoothGattProfile>())
+	{
+		LSUtils::respondWithError(request, BT_ERR_PROFILE_UNAVAIL);
+		return true;
+	}
+
+	const std::string schema = STRICT_SCHEMA(PROPS_2(PROP(adapterAddress, string), PROP(address, string)));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	std::string adapterAddress;
+	if (requestObj.hasKey("adapterAddress"))
+	{
+		adapterAddress = requestObj["adapterAddress"].asString();
+		if (!getManager()->isAdapterAvailable(adapterAddress))
+		{
+			LSUtils::respondWithError(request, BT_ERR_INVALID_ADAPTER_ADDRESS);
+			return true;
+		}
+	}
+	else
+	{
+		adapterAddress = getManager()->getAddress();
+	}
+
+	std::string deviceAddress;
+	if (requestObj.hasKey("address"))
+		deviceAddress = convertToLower(requestObj["address"].asString());
+
+	pbnjson::JValue queuesObj = pbnjson::Array();
+	for (auto queueIter : mOperationQueues)
+	{
+		BluetoothGattOperationQueue *queue = queueIter.second;
+		if (!deviceAddress.empty() && queue->getAddress() != deviceAddress)
+			continue;
+
+		pbnjson::JValue depthObj = pbnjson::Object();
+		for (int priority = 0; priority < BLUETOOTH_GATT_OPERATION_PRIORITY_MAX; priority++)
+		{
+			BluetoothGattOperationPriority queuePriority = static_cast<BluetoothGattOperationPriority>(priority);
+			depthObj.put(BluetoothGattOperationQueue::priorityToString(queuePriority), (int32_t) queue->getDepth(queuePriority));
+		}
+
+		pbnjson::JValue queueObj = pbnjson::Object();
+		queueObj.put("address", queue->getAddress());
+		queueObj.put("busy", queue->isBusy());
+		queueObj.put("depth", (int32_t) queue->getDepth());
+		queueObj.put("depthByPriority", depthObj);
+		queueObj.put("maxDepth", (int32_t) queue->getMaxDepth());
+		queueObj.put("enqueued", (int32_t) queue->getEnqueuedCount());
+		queueObj.put("completed", (int32_t) queue->getCompletedCount());
+		queueObj.put("timedOut", (int32_t) queue->getTimedOutCount());
+		queueObj.put("deduplicated", (int32_t) queue->getDeduplicatedCount());
+		queueObj.put("coalesced", (int32_t) queue->getCoalescedCount());
+		queuesObj.append(queueObj);
+	}
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("adapterAddress", adapterAddress);
+	responseObj.put("queues", queuesObj);
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+bool BluetoothGattProfileService::getConnectionPoolStatus(LSMessage &message)
+{
+	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!mImpl && !getImpl<BluetoothGattProfile>())
+	{
+		LSUtils::respondWithError(request, BT_ERR_PROFILE_UNAVAIL);
+		return true;
+	}
+
+	const std::string schema = STRICT_SCHEMA(PROPS_1(PROP(adapterAddress, string)));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
 
-	if (newService->descIt != newService->descriptors.end())
+	std::string adapterAddress;
+	if (requestObj.hasKey("adapterAddress"))
 	{
-		itemUuid = LocalService::buildDescriptorKey((*newService->charIt).getUuid(),
-				(*newService->descIt).getUuid());
-		itemValue = (*newService->descIt).getValue();
+		adapterAddress = requestObj["adapterAddress"].asString();
+		if (!getManager()->isAdapterAvailable(adapterAddress))
+		{
+			LSUtils::respondWithError(request, BT_ERR_INVALID_ADAPTER_ADDRESS);
+			return true;
+		}
 	}
 	else
 	{
-		itemUuid = (*newService->charIt).getUuid();
-		itemValue = (*newService->charIt).getValue();
+		adapterAddress = getManager()->getAddress();
+	}
+
+	pbnjson::JValue connectionsObj = pbnjson::Array();
+	for (auto connectionIter : mConnectionPool.getConnections())
+	{
+		BluetoothGattPooledConnection *connection = connectionIter.second;
+
+		pbnjson::JValue clientsObj = pbnjson::Array();
+		for (auto clientId : connection->clientIds)
+			clientsObj.append(idToString(clientId));
+
+		pbnjson::JValue connectionObj = pbnjson::Object();
+		connectionObj.put("address", connection->address);
+		connectionObj.put("appId", (int32_t) connection->appId);
+		connectionObj.put("connectId", (int32_t) connection->connectId);
+		connectionObj.put("connected", connection->connected);
+		connectionObj.put("clients", clientsObj);
+		connectionObj.put("pendingRequests", (int32_t) connection->pendingRequests.size());
+		connectionsObj.append(connectionObj);
+	}
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("adapterAddress", adapterAddress);
+	responseObj.put("connections", connectionsObj);
+	responseObj.put("clients", (int32_t) mConnectionPool.getClientCount());
+	responseObj.put("stackConnects", (int32_t) mConnectionPool.getStackConnectCount());
+	responseObj.put("sharedConnects", (int32_t) mConnectionPool.getSharedConnectCount());
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+#define safe_callback(callback, ...) do { if (callback) callback(__VA_ARGS__); } while(0)
+
+bool BluetoothGattProfileService::addLocalServer(const BluetoothUuid applicationUuid, LocalServer* newServer)
+{
+	BT_DEBUG("[%s](%d) getImpl->addApplication\n", __FUNCTION__, __LINE__);
+	uint16_t server_if = getImpl<BluetoothGattProfile>()->addApplication(BluetoothUuid(applicationUuid), ApplicationType::SERVER);
+	if (server_if == static_cast<uint16_t>(0))
+		return false;
+
+	newServer->id = server_if;
+	mLocalServer.insert({applicationUuid, newServer});
+	return true;
+}
+
+void BluetoothGattProfileService::addLocalService(const BluetoothUuid applicationUuid, const BluetoothGattService &service, BluetoothResultCallback callback)
+{
+	BT_DEBUG("[%s](%d) called\n", __FUNCTION__, __LINE__);
+	auto server = findLocalServer(applicationUuid);
+	if (server == nullptr)
+	{
+		BT_ERROR("GATT_SERVER_NOT_FOUND", 0,
+		             "Server %s not exist",
+					 applicationUuid.toString().c_str());
+		LocalServer* newServer = new LocalServer;
+		if(!addLocalServer(applicationUuid, newServer))
+		{
+			BT_ERROR("GATT_SERVICE_ALREADY_REGISTERED", 0, "addLocalServer is failed");
+			safe_callback(callback, BLUETOOTH_ERROR_FAIL);
+			return;
+		}
+		server = newServer;
+	}
+
+	if (service.getCharacteristics().size() == 0)
+	{
+		BT_ERROR("GATT_SERVICE_WITHOUT_CHARACTERISTICS", 0,
+		              "Can't register service %s without any characteristics",
+		              service.getUuid().toString().c_str());
+		safe_callback(callback, BLUETOOTH_ERROR_PARAM_INVALID);
+		return;
+	}
+
+	if (isLocalServiceRegistered(service.getUuid()))
+	{
+		BT_ERROR("GATT_SERVICE_ALREADY_REGISTERED", 0,
+		              "Service %s is already registered",
+		              service.getUuid().toString().c_str());
+		safe_callback(callback, BLUETOOTH_ERROR_PARAM_INVALID);
+		return;
+	}
+
+	BT_DEBUG("Starting to register service %s with %d characteristics",
+	              service.getUuid().toString().c_str(),
+	              service.getCharacteristics().size());
+
+	// NOTE: We need to add the service item before we call BSA_BleSeCreateService
+	// as the corresponding event can be recieved while we're still in the call or
+	// afterwards. If we receive it while still in the call and don't have the item
+	// added yet we will never tell our caller the result of the operation.
+	LocalService* newService = new LocalService;
+	newService->desc = service; // TODO: Change to pointer assign
+	newService->addServiceCallback = callback;
+	newService->registrationStarted = g_get_monotonic_time();
+
+	auto addServiceCallback = [this, server, newService](BluetoothError error, uint16_t serviceId) {
+
+		if (error != BLUETOOTH_ERROR_NONE)
+		{
+			safe_callback(newService->addServiceCallback, error);
+			delete newService;
+			return;
+		}
+
+		BT_INFO("BLE", 0, "add serviceId:%d complete\n", serviceId);
+		newService->id = serviceId;
+		prepareLocalServiceRegistration(newService);
+		addLocalCharacteristics(server, newService);
+	};
+	BT_DEBUG("[%s](%d) getImpl->addService server:%d service:%s\n", __FUNCTION__, __LINE__, server->id, service.getUuid().toString().c_str());
+	// TODO: Needs server_if, uuid, handles, primary
+	getImpl<BluetoothGattProfile>()->addService(server->id, service, addServiceCallback);
+}
+
+void BluetoothGattProfileService::prepareLocalServiceRegistration(LocalService* newService)
+{
+	// The stack attaches a descriptor to the characteristic added last, so
+	// every characteristic is directly followed by its descriptors.
+	newService->characteristics = newService->desc.getCharacteristics();
+	newService->characteristicsRegistered.assign(newService->characteristics.size(), false);
+	newService->registrationItems.clear();
+	for (unsigned int index = 0; index < newService->characteristics.size(); index++)
+	{
+		newService->registrationItems.push_back(LocalService::RegistrationItem(index));
+		for (auto descriptor : newService->characteristics[index].getDescriptors())
+			newService->registrationItems.push_back(LocalService::RegistrationItem(index, descriptor));
+	}
+
+	newService->nextItemToRegister = 0;
+	newService->itemsLeftToRegister = newService->registrationItems.size();
+	newService->registrationError = BLUETOOTH_ERROR_NONE;
+}
+
+void BluetoothGattProfileService::addLocalCharacteristics(LocalServer* server, LocalService* newService)
+{
+	// The stack may answer from within the add call. The loop below then
+	// submits the following items instead of recursing through the callback.
+	if (newService->submitting)
+		return;
+
+	newService->submitting = true;
+
+	while (newService->nextItemToRegister < newService->registrationItems.size())
+	{
+		unsigned int itemsDone = newService->registrationItems.size() - newService->itemsLeftToRegister;
+		if (newService->nextItemToRegister - itemsDone >= GATT_SERVICE_REGISTRATION_WINDOW)
+			break;
+
+		// A descriptor submitted before its characteristic is known to the
+		// stack would end up on whichever characteristic it registered last
+		const LocalService::RegistrationItem &nextItem = newService->registrationItems[newService->nextItemToRegister];
+		if (nextItem.isDescriptor && !newService->characteristicsRegistered[nextItem.characteristicIndex])
+			break;
+
+		unsigned int itemIndex = newService->nextItemToRegister++;
+		const LocalService::RegistrationItem &item = newService->registrationItems[itemIndex];
+
+		if (!item.isDescriptor)
+		{
+			BT_DEBUG("[%s](%d) getImpl->addCharacteristic\n", __FUNCTION__, __LINE__);
+			getImpl<BluetoothGattProfile>()->addCharacteristic(
+					server->id,
+					newService->id,
+					newService->characteristics[item.characteristicIndex],
+					std::bind(&BluetoothGattProfileService::addCharacteristicCallback, this, server, newService, itemIndex, _1, _2));
+		}
+		else
+		{
+			BT_DEBUG("[%s](%d) getImpl->addDescriptor\n", __FUNCTION__, __LINE__);
+			getImpl<BluetoothGattProfile>()->addDescriptor(
+					server->id,
+					newService->id,
+					item.descriptor,
+					std::bind(&BluetoothGattProfileService::addCharacteristicCallback, this, server, newService, itemIndex, _1, _2));
+		}
 	}
 
-	BT_DEBUG("Storing item %s with handle %d", itemUuid.toString().c_str(), charId);
+	newService->submitting = false;
+
+	if (newService->itemsLeftToRegister == 0)
+		completeLocalServiceRegistration(server, newService);
+}
+
+void BluetoothGattProfileService::addCharacteristicCallback(LocalServer* server, LocalService* newService, unsigned int itemIndex, BluetoothError error, uint16_t charId)
+{
+	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	const LocalService::RegistrationItem &item = newService->registrationItems[itemIndex];
+	const BluetoothGattCharacteristic &characteristic = newService->characteristics[item.characteristicIndex];
 
-	// To be able to process the characteristic/descriptor later we need to
-	// store it's handle as that is the only way we can access it
-	// once it is registered with the server.
-	if (newService->descIt != newService->descriptors.end())
+	if (error != BLUETOOTH_ERROR_NONE)
 	{
-		newService->desc.updateDescriptorValue((*newService->charIt).getUuid(), (*newService->descIt).getUuid(), itemValue);
-		newService->desc.updateDescriptorHandle((*newService->charIt), (*newService->descIt), charId);
+		BT_ERROR("GATT_ADD_ATTRIBUTE_FAILED", 0, "Failed to register item %u of service %s: %d", itemIndex,
+		         newService->desc.getUuid().toString().c_str(), error);
+		newService->registrationError = error;
+	}
+	else if (item.isDescriptor)
+	{
+		// To be able to process the descriptor later we need to store its
+		// handle as that is the only way we can access it once it is
+		// registered with the server.
+		BT_DEBUG("Storing item %s with handle %d", LocalService::buildDescriptorKey(characteristic.getUuid(), item.descriptor.getUuid()).c_str(), charId);
+		newService->desc.updateDescriptorValue(characteristic.getUuid(), item.descriptor.getUuid(), item.descriptor.getValue());
+		newService->desc.updateDescriptorHandle(characteristic, item.descriptor, charId);
 	}
 	else
 	{
-		newService->desc.updateCharacteristicValue(itemUuid, itemValue);
-		newService->desc.updateCharacteristicHandle((*newService->charIt), charId);
+		BT_DEBUG("Storing item %s with handle %d", characteristic.getUuid().toString().c_str(), charId);
+		newService->desc.updateCharacteristicValue(characteristic.getUuid(), characteristic.getValue());
+		newService->desc.updateCharacteristicHandle(characteristic, charId);
+	}
+
+	if (!item.isDescriptor)
+		newService->characteristicsRegistered[item.characteristicIndex] = true;
+
+	if (newService->itemsLeftToRegister > 0)
+		newService->itemsLeftToRegister--;
+
+	if (newService->itemsLeftToRegister > 0)
+	{
+		addLocalCharacteristics(server, newService);
+		return;
 	}
 
-	BT_DEBUG("Storing value for item %s of service %s:",
-				  itemUuid.toString().c_str(), service.getUuid().toString().c_str());
-	//BT_DEBUG(formatGattValue(itemValue).c_str());
+	// Completion is picked up by the submit loop when we got called from it
+	if (!newService->submitting)
+		completeLocalServiceRegistration(server, newService);
+}
 
-	// We always override store values for new characteristics/descriptors here.
-	// Generally that shouldn't happen but is the better way to do here.
+void BluetoothGattProfileService::completeLocalServiceRegistration(LocalServer* server, LocalService* newService)
+{
+	newService->characteristics.clear();
+	newService->characteristicsRegistered.clear();
+	newService->registrationItems.clear();
 
-	if (hasNext(newService))
+	if (newService->registrationError != BLUETOOTH_ERROR_NONE)
 	{
-		addLocalCharacteristic(server, newService);
+		BluetoothError error = newService->registrationError;
+		BT_DEBUG("[%s](%d) getImpl->removeService\n", __FUNCTION__, __LINE__);
+		getImpl<BluetoothGattProfile>()->removeService(server->id, newService->id, [](BluetoothError removeError) {});
+
+		safe_callback(newService->addServiceCallback, error);
+		delete newService;
 		return;
 	}
 
@@ -3152,8 +5229,11 @@ void BluetoothGattProfileService::addCharacteristicCallback(LocalServer* server,
 		if (serviceError != BLUETOOTH_ERROR_NONE)
 			return;
 
-		BT_INFO("BLE", 0, "startService complete \n");
+		newService->registrationTime = g_get_monotonic_time() - newService->registrationStarted;
+		BT_INFO("BLE", 0, "startService complete, service %s up after %lld ms\n",
+		        newService->desc.getUuid().toString().c_str(), (long long) (newService->registrationTime / 1000));
 		server->addLocalService(newService);
+		mServicesPayloadCache.invalidateLocal();
 		safe_callback(newService->addServiceCallback, serviceError);
 	};
 
@@ -3170,6 +5250,9 @@ bool BluetoothGattProfileService::removeLocalServer(BluetoothUuid Uuid)
 		return false;
 	}
 
+	for (auto serviceIter : server->mLocalServices)
+		releaseLocalServiceState(serviceIter.second);
+
 	BT_DEBUG("[%s](%d) getImpl->removeApplication\n", __FUNCTION__, __LINE__);
 	if(!getImpl<BluetoothGattProfile>()->removeApplication(server->id, ApplicationType::SERVER))
 		server->removeAllLocalService();
@@ -3194,6 +5277,9 @@ bool BluetoothGattProfileService::removeLocalServer(uint16_t serverId)
 	{
 		if(serverIter.second->id == serverId)
 		{
+			for (auto serviceIter : server->mLocalServices)
+				releaseLocalServiceState(serviceIter.second);
+
 			BT_DEBUG("[%s](%d) getImpl->removeApplication\n", __FUNCTION__, __LINE__);
 			if(!getImpl<BluetoothGattProfile>()->removeApplication(server->id, ApplicationType::SERVER))
 				server->removeAllLocalService();
@@ -3222,6 +5308,7 @@ bool BluetoothGattProfileService::removeLocalService(uint16_t serverId, const Bl
 		return false;
 
 	auto callback = [this, server, uuid](BluetoothError error) {
+		releaseLocalServiceState(server->findLocalService(uuid));
 		server->removeLocalService(uuid);
 	};
 	BT_DEBUG("[%s](%d) getImpl->removeService\n", __FUNCTION__, __LINE__);
@@ -3244,6 +5331,7 @@ bool BluetoothGattProfileService::removeLocalService(const BluetoothUuid &uuid)
 			continue;
 
 		auto callback = [this, server, uuid](BluetoothError error) {
+			releaseLocalServiceState(server->findLocalService(uuid));
 			server->removeLocalService(uuid);
 		};
 		BT_DEBUG("[%s](%d) getImpl->removeService\n", __FUNCTION__, __LINE__);
@@ -3547,54 +5635,17 @@ void BluetoothGattProfileService::writeLocalCharacteristic(
 	if (localService)
 	{
 		localService->desc.updateCharacteristicValue(characteristic.getUuid(), characteristic.getValue());
+		mValueStore.update(characteristic.getHandle(), localService->desc.getUuid(), characteristic.getUuid(), characteristic.getValue());
+		mServicesPayloadCache.invalidateLocal();
 		safe_callback(callback, BLUETOOTH_ERROR_NONE);
+
+		// Characteristics written without their service are notified
+		// without a server id right away, as before; a change still queued
+		// for the handle is older and must not follow
+		mNotifyEngine->discard(characteristic.getHandle());
 		BT_DEBUG("[%s](%d) getImpl->notifyCharacteristicValueChanged\n", __FUNCTION__, __LINE__);
 		getImpl<BluetoothGattProfile>()->notifyCharacteristicValueChanged(localService->id, characteristic, characteristic.getHandle());
-		for (auto it = mMonitorCharacteristicSubscriptions.begin() ; it != mMonitorCharacteristicSubscriptions.end(); ++it)
-		{
-			auto subscriptionValue = it->second;
-
-			bool foundCharacteristic = false;
-			if (subscriptionValue.characteristicUuids.size() > 0)
-			{
-				for (auto it2 = subscriptionValue.characteristicUuids.begin(); it2 != subscriptionValue.characteristicUuids.end(); ++it2)
-				{
-					if ((*it2) == characteristic.getUuid())
-					{
-						foundCharacteristic = true;
-						break;
-					}
-				}
-			}
-			else if (subscriptionValue.characteristicUuid == characteristic.getUuid())
-			{
-				foundCharacteristic = true;
-			}
-
-			if (!foundCharacteristic)
-				continue;
-
-			auto monitorCharacteristicsWatch = it->first;
-			pbnjson::JValue responseObj = pbnjson::Object();
-			responseObj.put("returnValue", true);
-			responseObj.put("subscribed", true);
-			responseObj.put("adapterAddress", getManager()->getAddress());
-
-			pbnjson::JValue characteristicObj = pbnjson::Object();
-			characteristicObj.put("characteristic", characteristic.getUuid().toString());
-
-			pbnjson::JValue valueObj = pbnjson::Object();
-			BluetoothGattValue values = characteristic.getValue();
-			pbnjson::JValue bytesArray = pbnjson::Array();
-			for (size_t i=0; i < values.size(); i++)
-				bytesArray.append((int32_t) values[i]);
-			valueObj.put("bytes", bytesArray);
-
-			characteristicObj.put("value", valueObj);
-			responseObj.put("changed", characteristicObj);
-
-			LSUtils::postToClient(monitorCharacteristicsWatch->getMessage(), responseObj);
-		}
+		notifyLocalCharacteristicSubscribers(characteristic);
 		return;
 	}
 	BT_ERROR("GATT_FAILED_TO_WRITE_CHAR", 0, "Failed to write local characteristic %s because the service isn't registered",
@@ -3636,11 +5687,18 @@ void BluetoothGattProfileService::writeLocalCharacteristic(
 	// This will override the already stored value or if no one is
 	// stored yet put in the new one.
 	localService->desc.updateCharacteristicValue(characteristic.getUuid(), characteristic.getValue());
+	mValueStore.update(characteristic.getHandle(), service, characteristic.getUuid(), characteristic.getValue());
+	mServicesPayloadCache.invalidateLocal();
 
 	safe_callback(callback, BLUETOOTH_ERROR_NONE);
-	auto localServer = findLocalServerByServiceId(localService->id);
-	BT_DEBUG("[%s](%d) getImpl->notifyCharacteristicValueChanged\n", __FUNCTION__, __LINE__);
-	getImpl<BluetoothGattProfile>()->notifyCharacteristicValueChanged(localServer->id, localService->id, characteristic, characteristic.getHandle());
+	mNotifyEngine->enqueue(characteristic.getHandle(), characteristic.getValue());
+	notifyLocalCharacteristicSubscribers(characteristic);
+}
+
+void BluetoothGattProfileService::notifyLocalCharacteristicSubscribers(const BluetoothGattCharacteristic &characteristic)
+{
+	// The change looks the same to every subscriber so build it only once
+	pbnjson::JValue responseObj;
 
 	for (auto it = mMonitorCharacteristicSubscriptions.begin() ; it != mMonitorCharacteristicSubscriptions.end(); ++it)
 	{
@@ -3663,30 +5721,90 @@ void BluetoothGattProfileService::writeLocalCharacteristic(
 			foundCharacteristic = true;
 		}
 
-		if (!foundCharacteristic)
-			continue;
+		if (!foundCharacteristic)
+			continue;
+
+		if (responseObj.isNull())
+		{
+			responseObj = pbnjson::Object();
+			responseObj.put("returnValue", true);
+			responseObj.put("subscribed", true);
+			responseObj.put("adapterAddress", getManager()->getAddress());
+
+			pbnjson::JValue characteristicObj = pbnjson::Object();
+			characteristicObj.put("characteristic", characteristic.getUuid().toString());
+
+			pbnjson::JValue valueObj = pbnjson::Object();
+			BluetoothGattValue values = characteristic.getValue();
+			pbnjson::JValue bytesArray = pbnjson::Array();
+			for (size_t i=0; i < values.size(); i++)
+				bytesArray.append((int32_t) values[i]);
+			valueObj.put("bytes", bytesArray);
+
+			characteristicObj.put("value", valueObj);
+			responseObj.put("changed", characteristicObj);
+		}
+
+		LSUtils::postToClient(it->first->getMessage(), responseObj);
+	}
+}
 
-		auto monitorCharacteristicsWatch = it->first;
-		pbnjson::JValue responseObj = pbnjson::Object();
-		responseObj.put("returnValue", true);
-		responseObj.put("subscribed", true);
-		responseObj.put("adapterAddress", getManager()->getAddress());
+void BluetoothGattProfileService::notifyLocalCharacteristic(uint16_t handle, const BluetoothGattValue &value)
+{
+	// The service may have been removed while the change was queued
+	auto localService = findLocalServiceByCharId(handle);
+	if (!localService)
+		return;
 
-		pbnjson::JValue characteristicObj = pbnjson::Object();
-		characteristicObj.put("characteristic", characteristic.getUuid().toString());
+	BluetoothGattCharacteristic characteristic;
+	if (!getLocalCharacteristic(handle, characteristic))
+		return;
 
-		pbnjson::JValue valueObj = pbnjson::Object();
-		BluetoothGattValue values = characteristic.getValue();
-		pbnjson::JValue bytesArray = pbnjson::Array();
-		for (size_t i=0; i < values.size(); i++)
-			bytesArray.append((int32_t) values[i]);
-		valueObj.put("bytes", bytesArray);
+	characteristic.setValue(value);
 
-		characteristicObj.put("value", valueObj);
-		responseObj.put("changed", characteristicObj);
+	auto localServer = findLocalServerByServiceId(localService->id);
+	BT_DEBUG("[%s](%d) getImpl->notifyCharacteristicValueChanged\n", __FUNCTION__, __LINE__);
+	if (localServer)
+		getImpl<BluetoothGattProfile>()->notifyCharacteristicValueChanged(localServer->id, localService->id, characteristic, handle);
+	else
+		getImpl<BluetoothGattProfile>()->notifyCharacteristicValueChanged(localService->id, characteristic, handle);
+}
 
-		LSUtils::postToClient(monitorCharacteristicsWatch->getMessage(), responseObj);
+bool BluetoothGattProfileService::updateClientConfiguration(const std::string &address, uint16_t handle, const BluetoothGattValue &value)
+{
+	BluetoothGattDescriptor descriptor;
+	if (!getLocalDescriptor(handle, descriptor))
+		return false;
+
+	if (!(descriptor.getUuid() == BluetoothUuid(GATT_CLIENT_CHARACTERISTIC_CONFIGURATION_UUID)))
+		return false;
+
+	for (auto server : mLocalServer)
+	{
+		for (auto service : server.second->mLocalServices)
+		{
+			auto localService = service.second;
+			if (!localService->hasDescriptor(handle))
+				continue;
+
+			BluetoothGattCharacteristic characteristic = localService->getParentCharacteristic(handle);
+			uint16_t configuration = 0;
+			if (value.size() > 0)
+				configuration = value[0];
+			if (value.size() > 1)
+				configuration |= value[1] << 8;
+
+			BT_INFO("BLE", 0, "[%s](%d) device %s set configuration of characteristic %s to %d\n", __FUNCTION__, __LINE__,
+			        address.c_str(), characteristic.getUuid().toString().c_str(), configuration);
+
+			localService->desc.updateDescriptorValue(characteristic.getUuid(), descriptor.getUuid(), value);
+			mServicesPayloadCache.invalidateLocal();
+			mNotifyEngine->setConfiguration(address, characteristic.getHandle(), configuration);
+			return true;
+		}
 	}
+
+	return false;
 }
 
 void BluetoothGattProfileService::writeLocalDescriptor(
@@ -3704,6 +5822,7 @@ void BluetoothGattProfileService::writeLocalDescriptor(
 			{
 				BluetoothGattCharacteristic characteristic = localService->getParentCharacteristic(descriptor.getHandle());
 				localService->desc.updateDescriptorValue(characteristic.getUuid(), descriptor.getUuid(), descriptor.getValue());
+				mServicesPayloadCache.invalidateLocal();
 				getImpl<BluetoothGattProfile>()->notifyDescriptorValueChanged(server.second->id, localService->id, descriptor.getHandle(), descriptor, characteristic.getHandle());
 				safe_callback(callback, BLUETOOTH_ERROR_NONE);
 			}
@@ -3759,40 +5878,68 @@ void BluetoothGattProfileService::writeLocalDescriptor(
 		getImpl<BluetoothGattProfile>()->notifyDescriptorValueChanged(localServer->id, localService->id, descriptor.getHandle(), descriptor, gattCharacteristic.getHandle());
 	}
 	localService->desc.updateDescriptorValue(characteristic, descriptor.getUuid(), descriptor.getValue());
+	mServicesPayloadCache.invalidateLocal();
 	safe_callback(callback, BLUETOOTH_ERROR_NONE);
 }
 
 void BluetoothGattProfileService::characteristicValueReadRequested(uint32_t requestId, const std::string &address, uint16_t server_if, uint16_t charId)
 {
 	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
-	auto localService = findLocalServiceByCharId(charId);
-	if (!localService)
+	mNotifyEngine->addCentral(address);
+
+	BluetoothGattStoredValue *storedValue = mValueStore.find(charId);
+	if (!storedValue)
 	{
-		BT_ERROR("INVALID_STATE", 0, "Didn't found service id %d to process read request from remote device %s",
-				server_if, address.c_str());
-		// FIXME unsure what status to send here. BSA API doesn't define any
-		// so we send "1" until we know which one to send.
-		getImpl<BluetoothGattProfile>()->characteristicValueReadResponse(requestId, BLUETOOTH_ERROR_FAIL, BluetoothGattValue());
+		auto localService = findLocalServiceByCharId(charId);
+		if (!localService)
+		{
+			BT_ERROR("INVALID_STATE", 0, "Didn't found service id %d to process read request from remote device %s",
+					server_if, address.c_str());
+			// FIXME unsure what status to send here. BSA API doesn't define any
+			// so we send "1" until we know which one to send.
+			getImpl<BluetoothGattProfile>()->characteristicValueReadResponse(requestId, BLUETOOTH_ERROR_FAIL, BluetoothGattValue());
 
-		return;
+			return;
+		}
+
+		BluetoothGattCharacteristic characteristic;
+		if (!getLocalCharacteristic(charId, characteristic))
+		{
+			BT_ERROR("INVALID_STATE", 0, "Didn't found characteristic id %d to process read request from remote device %s",
+					charId, address.c_str());
+			getImpl<BluetoothGattProfile>()->characteristicValueReadResponse(requestId, BLUETOOTH_ERROR_FAIL, BluetoothGattValue());
+			return;
+		}
+
+		// First read of a value which was never written through us; every
+		// later read is answered from the store directly.
+		mValueStore.update(charId, localService->desc.getUuid(), characteristic.getUuid(), characteristic.getValue());
+		storedValue = mValueStore.find(charId);
 	}
 
-	BluetoothGattCharacteristic characteristic;
-	if (!getLocalCharacteristic(charId, characteristic))
-	{
-		BT_ERROR("INVALID_STATE", 0, "Didn't found characteristic id %d to process read request from remote device %s",
-				charId, address.c_str());
-		getImpl<BluetoothGattProfile>()->characteristicValueReadResponse(requestId, BLUETOOTH_ERROR_FAIL, BluetoothGattValue());
+	if (storedValue->policy == BLUETOOTH_GATT_VALUE_POLICY_FORWARD &&
+	    forwardReadRequest(requestId, address, charId, storedValue))
 		return;
-	}
+
+	storedValue->autoResponses++;
 
 	BT_DEBUG("[%s](%d) getImpl<BluetoothGattProfile>()->characteristicValueReadResponse\n", __FUNCTION__, __LINE__);
-	getImpl<BluetoothGattProfile>()->characteristicValueReadResponse(requestId, BLUETOOTH_ERROR_NONE, characteristic.getValue());
+	getImpl<BluetoothGattProfile>()->characteristicValueReadResponse(requestId, BLUETOOTH_ERROR_NONE, storedValue->value);
 }
 
 void BluetoothGattProfileService::characteristicValueWriteRequested(uint32_t requestId, const std::string &address, uint16_t server_if, uint16_t charId, const BluetoothGattValue &value, bool response)
 {
 	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	mNotifyEngine->addCentral(address);
+
+	// Subscriptions of the remote device to one of our characteristics
+	if (updateClientConfiguration(address, charId, value))
+	{
+		if (response)
+			getImpl<BluetoothGattProfile>()->characteristicValueWriteResponse(requestId, BLUETOOTH_ERROR_NONE, value);
+		return;
+	}
+
 	auto localService = findLocalServiceByCharId(charId);
 	if (!localService)
 	{
@@ -3861,6 +6008,11 @@ void BluetoothGattProfileService::characteristicValueWriteRequested(uint32_t req
 		LSUtils::postToClient(monitorCharacteristicsWatch->getMessage(), responseObj);
 	}
 
+	// Keep the value remote devices read back in sync with what was written
+	localService->desc.updateCharacteristicValue(characteristic.getUuid(), value);
+	mValueStore.update(charId, localService->desc.getUuid(), characteristic.getUuid(), value);
+	mServicesPayloadCache.invalidateLocal();
+
 	if (response)
 	{
 		BT_DEBUG("[%s](%d) getImpl->characteristicValueWriteResponse\n", __FUNCTION__, __LINE__);
@@ -3869,29 +6021,160 @@ void BluetoothGattProfileService::characteristicValueWriteRequested(uint32_t req
 
 }
 
-void BluetoothGattProfileService::handleConnectClientDisappeared(const uint16_t &clientId, const uint16_t &connectId, const std::string &adapterAddress, const std::string &address)
+void BluetoothGattProfileService::handleConnectClientDisappeared(const uint16_t &clientId, const std::string &adapterAddress, const std::string &address)
 {
 	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
-	auto watchIter = mConnectWatches.find(address);
-	if (watchIter == mConnectWatches.end())
+	auto watchIter = mPooledConnectWatches.find(clientId);
+	if (watchIter == mPooledConnectWatches.end())
 		return;
 
+	delete watchIter->second;
+	mPooledConnectWatches.erase(watchIter);
+
 	if (!getImpl<BluetoothProfile>())
 		return;
 
-	auto disconnectCallback = [this, clientId, address, adapterAddress](BluetoothError error) {
+	releasePooledClient(clientId, [address](BluetoothError error) {
+		BT_INFO("BLE", 0, "[%s](%d) client of device %s released (error %d)\n", __FUNCTION__, __LINE__, address.c_str(), error);
+	});
+}
+
+void BluetoothGattProfileService::attachPooledClient(BluetoothGattPooledConnection *connection, LSMessage *requestMessage, const std::string &adapterAddress)
+{
+	LS::Message request(requestMessage);
+	std::string address = connection->address;
+	bool subscribed = false;
 
-		BT_INFO("BLE", 0, "[%s](%d) disconnect from device %s complete\n", __FUNCTION__, __LINE__, address.c_str());
-		markDeviceAsNotConnected(address);
-		markDeviceAsNotConnecting(address);
-		mConnectedDevices.erase(clientId);
+	uint16_t clientId = mConnectionPool.addClient(connection);
+	mConnectedDevices.insert(std::pair<uint16_t, connectedDeviceInfo*>(clientId, new connectedDeviceInfo(address, connection->connectId)));
+
+	// If we have a subscription we need to register a watch with the client
+	// and update it once the connection with the remote device is dropped.
+	if (request.isSubscription())
+	{
+		auto watch = new LSUtils::ClientWatch(getManager()->get(), requestMessage,
+							std::bind(&BluetoothGattProfileService::handleConnectClientDisappeared, this, clientId, adapterAddress, address));
+
+		mPooledConnectWatches.insert(std::pair<uint16_t, LSUtils::ClientWatch*>(clientId, watch));
+		subscribed = true;
+	}
+
+	BT_INFO("BLE", 0, "[%s](%d) device %s client %d attached to appId:%d connectId:%d (%zu clients)\n", __FUNCTION__, __LINE__,
+	        address.c_str(), clientId, connection->appId, connection->connectId, connection->clientIds.size());
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+
+	responseObj.put("subscribed", subscribed);
+	responseObj.put("returnValue", true);
+	responseObj.put("adapterAddress", adapterAddress);
+	responseObj.put("address", address);
+	responseObj.put("clientId", idToString(clientId));
+
+	LSUtils::postToClient(request, responseObj);
+}
+
+void BluetoothGattProfileService::failPooledConnection(const std::string &address, BluetoothErrorCode errorCode)
+{
+	BluetoothGattPooledConnection *connection = mConnectionPool.find(address);
+	if (!connection)
+		return;
+
+	for (auto requestMessage : connection->pendingRequests)
+	{
+		LS::Message request(requestMessage);
+		LSUtils::respondWithError(request, errorCode);
+	}
+
+	if (connection->ownsApplication)
+	{
+		BT_DEBUG("[%s](%d) getImpl->removeApplication\n", __FUNCTION__, __LINE__);
+		getImpl<BluetoothGattProfile>()->removeApplication(connection->appId, ApplicationType::CLIENT);
+	}
+
+	// Drops the references to the pending requests as well
+	mConnectionPool.remove(address);
+}
+
+void BluetoothGattProfileService::removePooledConnectWatch(uint16_t clientId, bool disconnected, bool remoteDisconnect)
+{
+	auto watchIter = mPooledConnectWatches.find(clientId);
+	if (watchIter == mPooledConnectWatches.end())
+		return;
+
+	LSUtils::ClientWatch *watch = watchIter->second;
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+
+	responseObj.put("subscribed", false);
+	responseObj.put("returnValue", true);
+	if (disconnected)
+		responseObj.put("disconnectByRemote", remoteDisconnect);
+	responseObj.put("adapterAddress", getManager()->getAddress());
+
+	LSUtils::postToClient(watch->getMessage(), responseObj);
+
+	mPooledConnectWatches.erase(watchIter);
+	delete watch;
+}
+
+void BluetoothGattProfileService::releasePooledClient(uint16_t clientId, BluetoothResultCallback callback)
+{
+	BluetoothGattPooledConnection *connection = mConnectionPool.findByClientId(clientId);
+	if (!connection)
+	{
+		callback(BLUETOOTH_ERROR_PARAM_INVALID);
+		return;
+	}
+
+	auto deviceIter = mConnectedDevices.find(clientId);
+	if (deviceIter != mConnectedDevices.end())
+	{
+		delete deviceIter->second;
+		mConnectedDevices.erase(deviceIter);
+	}
+
+	if (mConnectionPool.removeClient(clientId) > 0)
+	{
+		BT_INFO("BLE", 0, "[%s](%d) connection with %s still in use by %zu clients\n", __FUNCTION__, __LINE__,
+		        connection->address.c_str(), connection->clientIds.size());
+		callback(BLUETOOTH_ERROR_NONE);
+		return;
+	}
+
+	// Last client is gone so tear down the stack level connection
+	std::string address = connection->address;
+	uint16_t appId = connection->appId;
+	uint16_t connectId = connection->connectId;
+	bool ownsApplication = connection->ownsApplication;
+	mConnectionPool.remove(address);
+
+	auto disconnectCallback = [this, address, appId, ownsApplication, callback](BluetoothError error) {
+		if (ownsApplication)
+		{
+			BT_DEBUG("[%s](%d) getImpl->removeApplication\n", __FUNCTION__, __LINE__);
+			getImpl<BluetoothGattProfile>()->removeApplication(appId, ApplicationType::CLIENT);
+		}
+
+		if (error == BLUETOOTH_ERROR_NONE)
+		{
+			BT_INFO("BLE", 0, "[%s](%d) disconnect from device %s complete\n", __FUNCTION__, __LINE__, address.c_str());
+			markDeviceAsNotConnected(address);
+			markDeviceAsNotConnecting(address);
+		}
+
+		callback(error);
 	};
 
-	BT_DEBUG("[%s](%d) getImpl->disconnectGatt\n", __FUNCTION__, __LINE__);
-	if(clientId == 0 && connectId == 0)
+	if (connectId == 0)
+	{
+		BT_DEBUG("[%s](%d) getImpl->disconnect\n", __FUNCTION__, __LINE__);
 		getImpl<BluetoothProfile>()->disconnect(address, disconnectCallback);
+	}
 	else
-		getImpl<BluetoothGattProfile>()->disconnectGatt(clientId, connectId, address, disconnectCallback);
+	{
+		BT_DEBUG("[%s](%d) getImpl->disconnectGatt\n", __FUNCTION__, __LINE__);
+		getImpl<BluetoothGattProfile>()->disconnectGatt(appId, connectId, address, disconnectCallback);
+	}
 }
 
 uint16_t BluetoothGattProfileService::nextClientId()
@@ -3927,6 +6210,8 @@ bool BluetoothGattProfileService::isConnectSchemaAvailable(LS::Message &request,
 void BluetoothGattProfileService::connectionStateChanged(const std::string &address, bool connected)
 {
 	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
+	getManager()->getSilTraceWriter()->recordGattConnection(address, connected);
+
 	uint16_t appId = getImpl<BluetoothGattProfile>()->getAppId(address);
 	uint16_t connectId = getImpl<BluetoothGattProfile>()->getConnectId(address);
 
@@ -3943,6 +6228,19 @@ void BluetoothGattProfileService::connectionStateChanged(const std::string &addr
 		}
 		else
 			mConnectedDevices.insert(std::pair<uint16_t, connectedDeviceInfo*>(appId, new connectedDeviceInfo(address, connectId)));
+
+		// A reconnect (e.g. autoConnect) may hand out a new connection id
+		BluetoothGattPooledConnection *connection = mConnectionPool.find(address);
+		if (connection && connection->connected && connectId > 0)
+		{
+			connection->connectId = connectId;
+			for (auto clientId : connection->clientIds)
+			{
+				auto clientIter = mConnectedDevices.find(clientId);
+				if (clientIter != mConnectedDevices.end())
+					clientIter->second->setConnectId(connectId);
+			}
+		}
 	}
 	else
 	{
@@ -3952,6 +6250,38 @@ void BluetoothGattProfileService::connectionStateChanged(const std::string &addr
 		auto iterDevice = mConnectedDevices.find(appId);
 		if(iterDevice != mConnectedDevices.end())
 			mConnectedDevices.erase(appId);
+
+		closeWriteStreams(address);
+		mNotifyEngine->removeCentral(address);
+		mDiscoveryScheduler->cancel(address, BLUETOOTH_ERROR_DEVICE_NOT_AVAILABLE);
+		mServicesPayloadCache.invalidate(address);
+		pruneOperationQueues();
+
+		// The link is gone for every client sharing it. Connections still being
+		// set up are answered from their own connect callback instead.
+		BluetoothGattPooledConnection *connection = mConnectionPool.find(address);
+		if (connection && connection->connected)
+		{
+			for (auto clientId : connection->clientIds)
+			{
+				removePooledConnectWatch(clientId, true, true);
+
+				auto clientIter = mConnectedDevices.find(clientId);
+				if (clientIter != mConnectedDevices.end())
+				{
+					delete clientIter->second;
+					mConnectedDevices.erase(clientIter);
+				}
+			}
+
+			if (connection->ownsApplication)
+			{
+				BT_DEBUG("[%s](%d) getImpl->removeApplication\n", __FUNCTION__, __LINE__);
+				getImpl<BluetoothGattProfile>()->removeApplication(connection->appId, ApplicationType::CLIENT);
+			}
+
+			mConnectionPool.remove(address);
+		}
 	}
 }
 
@@ -3959,6 +6289,24 @@ void BluetoothGattProfileService::connectToStack(LS::Message &request, pbnjson::
 {
 	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
 	std::string address = requestObj["address"].asString();
+
+	// Every client connecting to the same device shares one stack level
+	// connection and only gets a virtual client id of its own
+	BluetoothGattPooledConnection *connection = mConnectionPool.find(address);
+	if (connection)
+	{
+		if (connection->connected)
+		{
+			attachPooledClient(connection, request.get(), adapterAddress);
+			return;
+		}
+
+		BT_INFO("BLE", 0, "[%s](%d) connect to device %s already in progress\n", __FUNCTION__, __LINE__, address.c_str());
+		LSMessageRef(request.get());
+		connection->pendingRequests.push_back(request.get());
+		return;
+	}
+
 	if (isDeviceConnected(address))
 	{
 		uint16_t appId = getImpl<BluetoothGattProfile>()->getAppId(address);
@@ -3967,34 +6315,12 @@ void BluetoothGattProfileService::connectToStack(LS::Message &request, pbnjson::
 		if(appId > 0 && connectId > 0)
 		{
 			BT_INFO("BLE", 0, "[%s](%d) device %s already connected appId:%d connectId:%d\n", __FUNCTION__, __LINE__, address.c_str(), appId, connectId);
-			bool subscribed = false;
-			if (request.isSubscription())
-			{
-				auto watch = new LSUtils::ClientWatch(getManager()->get(), request.get(),
-									std::bind(&BluetoothGattProfileService::handleConnectClientDisappeared, this, 0, 0, adapterAddress, address));
-
-				mConnectWatches.insert(std::pair<std::string, LSUtils::ClientWatch*>(address, watch));
-				subscribed = true;
-			}
 			markDeviceAsConnected(address);
-			auto iterDevice = mConnectedDevices.find(appId);
-			if(iterDevice != mConnectedDevices.end())
-			{
-				iterDevice->second->setAddress(address);
-				iterDevice->second->setConnectId(connectId);
-			}
-			else
-				mConnectedDevices.insert(std::pair<uint16_t, connectedDeviceInfo*>(appId, new connectedDeviceInfo(address, connectId)));
-
-			pbnjson::JValue responseObj = pbnjson::Object();
-
-			responseObj.put("subscribed", subscribed);
-			responseObj.put("returnValue", true);
-			responseObj.put("adapterAddress", adapterAddress);
-			responseObj.put("address", address);
-			responseObj.put("clientId", idToString(appId));
 
-			LSUtils::postToClient(request, responseObj);
+			connection = mConnectionPool.add(address, appId, false);
+			connection->connectId = connectId;
+			connection->connected = true;
+			attachPooledClient(connection, request.get(), adapterAddress);
 			return;
 		}
 	}
@@ -4008,22 +6334,42 @@ void BluetoothGattProfileService::connectToStack(LS::Message &request, pbnjson::
 		return;
 	}
 
-	LSMessage *requestMessage = request.get();
-	LSMessageRef(requestMessage);
+	LSMessageRef(request.get());
+	connection = mConnectionPool.add(address, appId, true);
+	connection->pendingRequests.push_back(request.get());
 
 	bool autoConnect = false;
 	if(requestObj.hasKey("autoConnect"))
 		autoConnect = requestObj["autoConnect"].asBool();
 
-	auto isConnectedCallback = [this, requestMessage, appId, autoConnect, adapterAddress, address](BluetoothError connectedError, const BluetoothProperty &property) {
-		LS::Message request(requestMessage);
+	// Called once the stack connection is up. Answers every connect request
+	// which queued up on the pooled connection in the meantime.
+	auto connectionEstablished = [this, adapterAddress, address](uint16_t connectId) {
+		BluetoothGattPooledConnection *connection = mConnectionPool.find(address);
+		if (!connection)
+			return;
+
+		connection->connectId = connectId;
+		connection->connected = true;
+		markDeviceAsConnected(address);
+
+		std::vector<LSMessage*> pendingRequests;
+		pendingRequests.swap(connection->pendingRequests);
+
+		for (auto requestMessage : pendingRequests)
+		{
+			attachPooledClient(connection, requestMessage, adapterAddress);
+
+			// We're done with sending out the first response to the client so
+			// no use anymore for the message object
+			LSMessageUnref(requestMessage);
+		}
+	};
 
+	auto isConnectedCallback = [this, appId, autoConnect, adapterAddress, address, connectionEstablished](BluetoothError connectedError, const BluetoothProperty &property) {
 		if (connectedError != BLUETOOTH_ERROR_NONE)
 		{
-			BT_DEBUG("[%s](%d) getImpl->removeApplication\n", __FUNCTION__, __LINE__);
-			getImpl<BluetoothGattProfile>()->removeApplication(appId, ApplicationType::CLIENT);
-			LSUtils::respondWithError(request, BT_ERR_PROFILE_CONNECT_FAIL);
-			LSMessageUnref(request.get());
+			failPooledConnection(address, BT_ERR_PROFILE_CONNECT_FAIL);
 			return;
 		}
 
@@ -4031,32 +6377,20 @@ void BluetoothGattProfileService::connectToStack(LS::Message &request, pbnjson::
 
 		if (connected)
 		{
-			BT_DEBUG("[%s](%d) getImpl->removeApplication\n", __FUNCTION__, __LINE__);
-			getImpl<BluetoothGattProfile>()->removeApplication(appId, ApplicationType::CLIENT);
-			LSUtils::respondWithError(request, BT_ERR_PROFILE_CONNECTED);
-			LSMessageUnref(request.get());
+			failPooledConnection(address, BT_ERR_PROFILE_CONNECTED);
 			return;
 		}
 
 		markDeviceAsConnecting(address);
 		notifyStatusSubscribers(adapterAddress, address, false);
 
-		auto connectCallback = [this, requestMessage, appId, adapterAddress, address](BluetoothError error, uint16_t connectId) {
-			LS::Message request(requestMessage);
-			bool subscribed = false;
-
+		auto connectCallback = [this, appId, adapterAddress, address, connectionEstablished](BluetoothError error, uint16_t connectId) {
 			if (error == BLUETOOTH_ERROR_UNSUPPORTED)
 			{
-				auto connectCallback = [this, requestMessage, appId, adapterAddress, address](BluetoothError connectError) {
-					LS::Message request(requestMessage);
-					bool subscribed = false;
-
+				auto connectCallback = [this, appId, adapterAddress, address, connectionEstablished](BluetoothError connectError) {
 					if (connectError != BLUETOOTH_ERROR_NONE)
 					{
-						BT_DEBUG("[%s](%d) getImpl->removeApplication\n", __FUNCTION__, __LINE__);
-						getImpl<BluetoothGattProfile>()->removeApplication(appId, ApplicationType::CLIENT);
-						LSUtils::respondWithError(request, BT_ERR_PROFILE_CONNECT_FAIL);
-						LSMessageUnref(request.get());
+						failPooledConnection(address, BT_ERR_PROFILE_CONNECT_FAIL);
 
 						markDeviceAsNotConnecting(address);
 						notifyStatusSubscribers(adapterAddress, address, false);
@@ -4066,35 +6400,8 @@ void BluetoothGattProfileService::connectToStack(LS::Message &request, pbnjson::
 					// NOTE: At this point we're successfully connected but we will notify
 					// possible subscribers once we get the update from the SIL through the
 					// observer that the device is connected.
-
-					// If we have a subscription we need to register a watch with the device
-					// and update the client once the connection with the remote device is
-					// dropped.
-					if (request.isSubscription())
-					{
-						auto watch = new LSUtils::ClientWatch(getManager()->get(), request.get(),
-											std::bind(&BluetoothGattProfileService::handleConnectClientDisappeared, this, 0, 0, adapterAddress, address));
-
-						mConnectWatches.insert(std::pair<std::string, LSUtils::ClientWatch*>(address, watch));
-						subscribed = true;
-					}
-					markDeviceAsConnected(address);
-					mConnectedDevices.insert(std::pair<uint16_t, connectedDeviceInfo*>(appId, new connectedDeviceInfo(address, 0)));
-
-					pbnjson::JValue responseObj = pbnjson::Object();
-
-					responseObj.put("subscribed", subscribed);
-					responseObj.put("returnValue", true);
-					responseObj.put("adapterAddress", adapterAddress);
-					responseObj.put("address", address);
-					responseObj.put("clientId", idToString(appId));
-
 					BT_INFO("BLE", 0, "[%s](%d) device %s connected appId:%d \n", __FUNCTION__, __LINE__, address.c_str(), appId);
-					LSUtils::postToClient(request, responseObj);
-
-					// We're done with sending out the first response to the client so
-					// no use anymore for the message object
-					LSMessageUnref(request.get());
+					connectionEstablished(0);
 				};
 				getImpl<BluetoothProfile>()->connect(address, connectCallback);
 				return;
@@ -4102,10 +6409,7 @@ void BluetoothGattProfileService::connectToStack(LS::Message &request, pbnjson::
 
 			if (error != BLUETOOTH_ERROR_NONE)
 			{
-				BT_DEBUG("[%s](%d) getImpl->removeApplication\n", __FUNCTION__, __LINE__);
-				getImpl<BluetoothGattProfile>()->removeApplication(appId, ApplicationType::CLIENT);
-				LSUtils::respondWithError(request, BT_ERR_PROFILE_CONNECT_FAIL);
-				LSMessageUnref(request.get());
+				failPooledConnection(address, BT_ERR_PROFILE_CONNECT_FAIL);
 
 				markDeviceAsNotConnecting(address);
 				notifyStatusSubscribers(adapterAddress, address, false);
@@ -4115,35 +6419,8 @@ void BluetoothGattProfileService::connectToStack(LS::Message &request, pbnjson::
 			// NOTE: At this point we're successfully connected but we will notify
 			// possible subscribers once we get the update from the SIL through the
 			// observer that the device is connected.
-
-			// If we have a subscription we need to register a watch with the device
-			// and update the client once the connection with the remote device is
-			// dropped.
-			if (request.isSubscription())
-			{
-				auto watch = new LSUtils::ClientWatch(getManager()->get(), request.get(),
-									std::bind(&BluetoothGattProfileService::handleConnectClientDisappeared, this, appId, connectId, adapterAddress, address));
-
-				mConnectWatches.insert(std::pair<std::string, LSUtils::ClientWatch*>(address, watch));
-				subscribed = true;
-			}
-			markDeviceAsConnected(address);
-			mConnectedDevices.insert(std::pair<uint16_t, connectedDeviceInfo*>(appId, new connectedDeviceInfo(address, connectId)));
-
 			BT_INFO("BLE", 0, "[%s](%d) device %s connected appId:%d connectId:%d\n", __FUNCTION__, __LINE__, address.c_str(), appId, connectId);
-			pbnjson::JValue responseObj = pbnjson::Object();
-
-			responseObj.put("subscribed", subscribed);
-			responseObj.put("returnValue", true);
-			responseObj.put("adapterAddress", adapterAddress);
-			responseObj.put("address", address);
-			responseObj.put("clientId", idToString(appId));
-
-			LSUtils::postToClient(request, responseObj);
-
-			// We're done with sending out the first response to the client so
-			// no use anymore for the message object
-			LSMessageUnref(request.get());
+			connectionEstablished(connectId);
 		};
 		BT_DEBUG("[%s](%d) getImpl->connectGatt\n", __FUNCTION__, __LINE__);
 		getImpl<BluetoothGattProfile>()->connectGatt(appId, autoConnect, address, connectCallback);
@@ -4179,19 +6456,21 @@ bool BluetoothGattProfileService::isDisconnectSchemaAvailable(LS::Message &reque
 void BluetoothGattProfileService::disconnectToStack(LS::Message &request, pbnjson::JValue &requestObj, const std::string &adapterAddress)
 {
 	BT_INFO("BLE", 0, "[%s](%d) called\n", __FUNCTION__, __LINE__);
-	LSMessage *requestMessage = request.get();
-	LSMessageRef(requestMessage);
-
-	uint16_t appId = idToInt(requestObj["clientId"].asString());
-	uint16_t connectId = 0;
-	std::string deviceAddress;
-	if(!getConnectId(appId, connectId, deviceAddress))
+	uint16_t clientId = idToInt(requestObj["clientId"].asString());
+	BluetoothGattPooledConnection *connection = mConnectionPool.findByClientId(clientId);
+	if (!connection)
 	{
 		LSUtils::respondWithError(request, BT_ERR_PROFILE_NOT_CONNECTED);
 		return;
 	}
 
-	auto disconnectCallback = [this, requestMessage, appId, adapterAddress, deviceAddress](BluetoothError error) {
+	std::string deviceAddress = connection->address;
+	removePooledConnectWatch(clientId, true, false);
+
+	LSMessage *requestMessage = request.get();
+	LSMessageRef(requestMessage);
+
+	auto disconnectCallback = [this, requestMessage, clientId, adapterAddress, deviceAddress](BluetoothError error) {
 		LS::Message request(requestMessage);
 
 		if (error != BLUETOOTH_ERROR_NONE)
@@ -4201,22 +6480,14 @@ void BluetoothGattProfileService::disconnectToStack(LS::Message &request, pbnjso
 			return;
 		}
 
-		BT_INFO("BLE", 0, "[%s](%d) device %s disconnected appId:%d\n", __FUNCTION__, __LINE__, deviceAddress.c_str(), appId);
+		BT_INFO("BLE", 0, "[%s](%d) device %s disconnected clientId:%d\n", __FUNCTION__, __LINE__, deviceAddress.c_str(), clientId);
 		pbnjson::JValue responseObj = pbnjson::Object();
 		responseObj.put("returnValue", true);
 		responseObj.put("adapterAddress", adapterAddress);
 		responseObj.put("address", deviceAddress);
 		LSUtils::postToClient(request, responseObj);
-
-		BT_DEBUG("[%s](%d) getImpl->removeApplication\n", __FUNCTION__, __LINE__);
-		getImpl<BluetoothGattProfile>()->removeApplication(appId, ApplicationType::CLIENT);
-		removeConnectWatchForDevice(deviceAddress, true, false);
-		mConnectedDevices.erase(appId);
-		markDeviceAsNotConnected(deviceAddress);
-		markDeviceAsNotConnecting(deviceAddress);
 		LSMessageUnref(request.get());
 	};
 
-	BT_DEBUG("[%s](%d) getImpl->disconnectGatt\n", __FUNCTION__, __LINE__);
-	getImpl<BluetoothGattProfile>()->disconnectGatt(appId, connectId, deviceAddress, disconnectCallback);
+	releasePooledClient(clientId, disconnectCallback);
 }
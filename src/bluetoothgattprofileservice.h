@@ -27,6 +27,15 @@
 class BluetoothGattAncsProfile;
 
 #include "clientwatch.h"
+#include "bluetootherrors.h"
+#include "bluetoothgattoperationqueue.h"
+#include "bluetoothgattwritestream.h"
+#include "bluetoothgattconnectionpool.h"
+#include "bluetoothgattvaluestore.h"
+#include "bluetoothgattnotifyengine.h"
+#include "bluetoothgattservicecache.h"
+#include "bluetoothgattdiscoveryscheduler.h"
+#include "bluetoothgattservicespayloadcache.h"
 
 namespace pbnjson
 {
@@ -48,7 +57,7 @@ typedef struct
 {
 	std::string deviceAddress;
 	BluetoothUuid serviceUuid;
-	uint16_t handle;
+	uint16_t handle = 0;
 	BluetoothUuid characteristicUuid;
 	BluetoothUuidList characteristicUuids;
 } MonitorCharacteristicSubscriptionInfo;
@@ -57,9 +66,10 @@ class CharacteristicWatch
 {
 public:
 	CharacteristicWatch() :
-	    mRefCount(0),
+		handle(0),
+		mRefCount(0),
 		mRegistered(false),
-		handle(0)
+		mRegistering(false)
 	{
 	}
 
@@ -68,8 +78,11 @@ public:
 
 	bool isUsed() { return mRefCount > 0; }
 
-	void markRegistered() { mRegistered = true; }
+	void markRegistering() { mRegistering = true; }
+	void markRegistered() { mRegistered = true; mRegistering = false; }
+	void markRegistrationFailed() { mRegistering = false; }
 	bool isRegistered ()  { return mRegistered; }
+	bool isRegistering() { return mRegistering; }
 	std::string deviceAddress;
 	BluetoothUuid serviceId;
 	BluetoothUuid characteristicId;
@@ -78,6 +91,7 @@ public:
 private:
 	unsigned int mRefCount;
 	bool mRegistered;
+	bool mRegistering;
 };
 
 class connectedDeviceInfo
@@ -103,6 +117,92 @@ private:
 	uint16_t connectId;
 };
 
+class PendingGattOperation
+{
+public:
+	PendingGattOperation() :
+		started(false),
+		queueOperationId(0),
+		priority(BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL)
+	{
+	}
+
+	std::string key;
+	bool started;
+	// Operation in the device's BluetoothGattOperationQueue
+	uint32_t queueOperationId;
+	BluetoothGattOperationPriority priority;
+	BluetoothGattCharacteristic characteristic;
+	BluetoothGattDescriptor descriptor;
+	std::vector<BluetoothResultCallback> writeCallbacks;
+	std::vector<BluetoothGattReadCharacteristicCallback> readCharacteristicCallbacks;
+	std::vector<BluetoothGattReadDescriptorCallback> readDescriptorCallbacks;
+};
+
+/*
+ * Collects the per-item results of readCharacteristicValuesBulk and
+ * writeCharacteristicValues. The combined response is posted once the
+ * last item has completed.
+ */
+class BulkGattRequest
+{
+public:
+	BulkGattRequest() :
+		requestMessage(nullptr),
+		errorCode(BT_ERR_GATT_READ_CHARACTERISTIC_FAIL),
+		remaining(0),
+		failed(0)
+	{
+	}
+
+	LSMessage *requestMessage;
+	std::string adapterAddress;
+	std::string deviceAddress;
+	BluetoothErrorCode errorCode;
+	unsigned int remaining;
+	unsigned int failed;
+	std::vector<pbnjson::JValue> results;
+};
+
+class GattWriteStreamSubscription
+{
+public:
+	GattWriteStreamSubscription() :
+		writeStream(nullptr),
+		clientWatch(nullptr)
+	{
+	}
+
+	BluetoothGattWriteStream *writeStream;
+	LSUtils::ClientWatch *clientWatch;
+	std::string adapterAddress;
+	std::string deviceAddress;
+};
+
+// Characteristics and descriptors of a local service which are submitted
+// to the stack without waiting for the previous one to be registered.
+// Descriptors still wait until their characteristic is registered.
+#define GATT_SERVICE_REGISTRATION_WINDOW 16
+
+class BluetoothGattProfileService;
+
+class ForwardedReadRequest
+{
+public:
+	ForwardedReadRequest() :
+		service(nullptr),
+		requestId(0),
+		handle(0),
+		timeout(0)
+	{
+	}
+
+	BluetoothGattProfileService *service;
+	uint32_t requestId;
+	uint16_t handle;
+	guint timeout;
+};
+
 class BluetoothGattProfileService : public BluetoothProfileService,
                                     public BluetoothGattProfileStatusObserver
 {
@@ -110,10 +210,37 @@ class BluetoothGattProfileService : public BluetoothProfileService,
 	class LocalService
 	{
 	public:
+		// One characteristic or descriptor to register with the stack
+		class RegistrationItem
+		{
+		public:
+			RegistrationItem(unsigned int characteristicIndex) :
+				characteristicIndex(characteristicIndex),
+				isDescriptor(false)
+			{
+			}
+
+			RegistrationItem(unsigned int characteristicIndex, const BluetoothGattDescriptor &descriptor) :
+				characteristicIndex(characteristicIndex),
+				isDescriptor(true),
+				descriptor(descriptor)
+			{
+			}
+
+			unsigned int characteristicIndex;
+			bool isDescriptor;
+			BluetoothGattDescriptor descriptor;
+		};
+
 		LocalService() :
 			id(0),
 			started(false),
-			itemsLeftToRegister(0)
+			nextItemToRegister(0),
+			itemsLeftToRegister(0),
+			submitting(false),
+			registrationError(BLUETOOTH_ERROR_NONE),
+			registrationStarted(0),
+			registrationTime(0)
 		{
 		}
 
@@ -189,16 +316,19 @@ class BluetoothGattProfileService : public BluetoothProfileService,
 		// Callback provided from the SIL API user to addService
 		BluetoothResultCallback addServiceCallback;
 
-		BluetoothGattCharacteristic lastRegisteredCharacteristic;
-		BluetoothGattDescriptor lastRegisteredDescriptor;
-		unsigned int itemsLeftToRegister;
-
-		// TODO: Change not to copy
+		// Attributes in the order they are handed to the stack. Up to
+		// GATT_SERVICE_REGISTRATION_WINDOW of them are in flight at once.
 		BluetoothGattCharacteristicList characteristics;
-		BluetoothGattDescriptorList descriptors;
+		std::vector<bool> characteristicsRegistered;
+		std::vector<RegistrationItem> registrationItems;
+		unsigned int nextItemToRegister;
+		unsigned int itemsLeftToRegister;
+		bool submitting;
+		BluetoothError registrationError;
 
-		BluetoothGattCharacteristicList::iterator charIt;
-		BluetoothGattDescriptorList::iterator descIt;
+		// Monotonic time (us) registration started and how long it took
+		gint64 registrationStarted;
+		gint64 registrationTime;
 	};
 
 	class LocalServer
@@ -307,10 +437,10 @@ class BluetoothGattProfileService : public BluetoothProfileService,
 	bool addLocalServer(const BluetoothUuid applicationUuid, LocalServer* newServer);
 	void addLocalService(const BluetoothUuid applicationUuid, const BluetoothGattService &service, BluetoothResultCallback callback);
 	void addLocalService(const BluetoothGattService &service, BluetoothResultCallback callback);
-	void initCharacteristic(LocalService* newService); // TODO: Change name
-	bool hasNext(LocalService* newService);
-	void addLocalCharacteristic(LocalServer* server, LocalService* newService);
-	void addCharacteristicCallback(LocalServer* server, LocalService* newService, BluetoothError error, uint16_t charId);
+	void prepareLocalServiceRegistration(LocalService* newService);
+	void addLocalCharacteristics(LocalServer* server, LocalService* newService);
+	void addCharacteristicCallback(LocalServer* server, LocalService* newService, unsigned int itemIndex, BluetoothError error, uint16_t charId);
+	void completeLocalServiceRegistration(LocalServer* server, LocalService* newService);
 	bool removeLocalServer(BluetoothUuid Uuid);
 	bool removeLocalServer(uint16_t appId);
 	bool removeLocalService(uint16_t serverId, const BluetoothUuid &uuid);
@@ -391,19 +521,28 @@ public:
 	bool readDescriptorValue(LSMessage &message);
 	bool readDescriptorValues(LSMessage &message);
 	bool writeDescriptorValue(LSMessage &message);
+	bool readCharacteristicValuesBulk(LSMessage &message);
+	bool writeCharacteristicValues(LSMessage &message);
+	bool openWriteStream(LSMessage &message);
+	bool getOperationQueueStatus(LSMessage &message);
+	bool getConnectionPoolStatus(LSMessage &message);
+	bool monitorReadRequests(LSMessage &message);
+	bool respondReadRequest(LSMessage &message);
+	bool getNotificationStatus(LSMessage &message);
+	bool getDiscoveryStatus(LSMessage &message);
 
 	bool writeRemoteCharacteristic(const std::string deviceAddress, const BluetoothUuid &serviceUuid, const BluetoothGattCharacteristic &characteristicToWrite,
-			BluetoothResultCallback callback);
+			BluetoothResultCallback callback, BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL);
 	bool readRemoteCharacteristic(const std::string deviceAddress, const BluetoothUuid &serviceUuid, const BluetoothUuid &characteristicUuid, const uint16_t characteristicHandle,
-			BluetoothGattReadCharacteristicCallback callback);
+			BluetoothGattReadCharacteristicCallback callback, BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL);
 	bool readRemoteCharacteristics(const std::string deviceAddress, const BluetoothUuid &serviceUuid, const BluetoothUuidList &characteristicUuids,
-			BluetoothGattReadCharacteristicsCallback callback);
-	bool writeRemoteCharacteristic(const std::string deviceAddress, const BluetoothUuid &serviceUuid, const BluetoothUuid &characteristicUuid, const BluetoothGattDescriptor &descriptorToWrite,
-				BluetoothResultCallback callback);
+			BluetoothGattReadCharacteristicsCallback callback, BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL);
+	bool writeRemoteDescriptor(const std::string deviceAddress, const BluetoothUuid &serviceUuid, const BluetoothUuid &characteristicUuid, const BluetoothGattDescriptor &descriptorToWrite,
+			BluetoothResultCallback callback, BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL);
 	bool readRemoteDescriptor(const std::string deviceAddress, const BluetoothUuid &serviceUuid, const BluetoothUuid &characteristicUuid, const BluetoothUuid &descriptorUuid, const uint16_t descriptorHandle,
-			BluetoothGattReadDescriptorCallback callback);
+			BluetoothGattReadDescriptorCallback callback, BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL);
 	bool readRemoteDescriptors(const std::string deviceAddress, const BluetoothUuid &serviceUuid, const BluetoothUuid &characteristicUuid, const BluetoothUuidList &descriptorUuids,
-				BluetoothGattReadDescriptorsCallback callback);
+			BluetoothGattReadDescriptorsCallback callback, BluetoothGattOperationPriority priority = BLUETOOTH_GATT_OPERATION_PRIORITY_NORMAL);
 
 	virtual bool isConnectSchemaAvailable(LS::Message &request, pbnjson::JValue &requestObj);
 	virtual void connectToStack(LS::Message &request, pbnjson::JValue &requestObj, const std::string &adapterAddress);
@@ -417,6 +556,7 @@ public:
 	void characteristicValueChanged(const BluetoothUuid &service, const BluetoothGattCharacteristic &characteristic);
 	void descriptorValueChanged(const BluetoothUuid &service, const BluetoothUuid &characteristic, BluetoothGattDescriptor &descriptor);
 	void incomingLeConnectionRequest(const std::string &address, bool state);
+	void deviceUnpaired(const std::string &address);
 
 	//Register the Service implementations with GattProfileService
 	void registerGattStatusObserver(BluetoothGattProfileService *statusObserver);
@@ -428,26 +568,85 @@ protected:
 
 	virtual pbnjson::JValue buildGetStatusResp(bool connected, bool connecting, bool subscribed, bool returnValue,
 		                                               std::string adapterAddress, std::string deviceAddress);
-	void handleConnectClientDisappeared(const uint16_t &appId, const uint16_t &connectId, const std::string &adapterAddress, const std::string &address);
+	void handleConnectClientDisappeared(const uint16_t &clientId, const std::string &adapterAddress, const std::string &address);
 private:
-	void appendServiceResponse(bool localAdapterServices, pbnjson::JValue responseObj, BluetoothGattServiceList serviceList);
+	void appendServiceResponse(bool localAdapterServices, pbnjson::JValue responseObj, const BluetoothGattServiceList &serviceList);
+	std::string serializeServices(bool localAdapterServices, const BluetoothGattServiceList &serviceList);
 	pbnjson::JValue buildDescriptor(const BluetoothGattDescriptor &descriptor, bool localAdapterServices = false);
 	pbnjson::JValue buildDescriptors(const BluetoothGattDescriptorList &descriptorsList, bool localAdapterServices = false);
 	pbnjson::JValue buildCharacteristic(bool localAdapterServices, const BluetoothGattCharacteristic &characteristic);
 	pbnjson::JValue buildCharacteristics(bool localAdapterServices, const BluetoothGattCharacteristicList &characteristicsList);
-	void notifyGetServicesSubscribers(bool localAdapterChanged, const std::string &adapterAddress, const std::string &deviceAddress, BluetoothGattServiceList serviceList);
+	void notifyGetServicesSubscribers(bool localAdapterChanged, const std::string &adapterAddress, const std::string &deviceAddress,
+	                                  const BluetoothGattServiceList &serviceList, bool completeList);
 	bool parseValue(pbnjson::JValue valueObj, BluetoothGattValue *value);
 	void handleMonitorCharacteristicClientDropped(MonitorCharacteristicSubscriptionInfo subscriptionInfo, LSUtils::ClientWatch *monitorCharacteristicsWatch);
 	void handleMonitorCharacteristicsClientDropped(MonitorCharacteristicSubscriptionInfo subscriptionInfo, LSUtils::ClientWatch *monitorCharacteristicsWatch);
+	CharacteristicWatch* refCharacteristicWatch(const std::string &deviceAddress, const BluetoothUuid &serviceUuid,
+	                                            const BluetoothUuid &characteristicUuid, uint16_t handle);
+	void unrefCharacteristicWatch(const std::string &deviceAddress, const BluetoothUuid &serviceUuid,
+	                              const BluetoothUuid &characteristicUuid, uint16_t handle);
+	void registerCharacteristicWatch(CharacteristicWatch *watch, LSMessage *requestMessage);
 	bool isDescriptorValid(const std::string &address, const uint16_t &handle, BluetoothGattDescriptor &descriptor);
 	bool isDescriptorValid(const std::string &address, const std::string &serviceUuid, const std::string &descriptorUuuid,
 	                       const std::string &characteristicUuid, BluetoothGattDescriptor &descriptor);
+	BluetoothGattOperationQueue* getOperationQueue(const std::string &address);
+	void pruneOperationQueues();
+	std::string buildOperationKey(const std::string &operation, const std::string &address, const BluetoothUuid &serviceUuid,
+	                              const BluetoothUuid &characteristicUuid, const BluetoothUuid &descriptorUuid, const uint16_t handle);
+	uint32_t addPendingOperation(const std::string &key);
+	PendingGattOperation* findPendingOperation(const std::string &key);
+	void queuePendingOperation(BluetoothGattOperationQueue *queue, uint32_t operationId, BluetoothGattOperationPriority priority,
+	                           BluetoothGattOperationHandler handler, BluetoothGattOperationTimeoutCallback timeoutCallback);
+	void joinPendingOperation(BluetoothGattOperationQueue *queue, PendingGattOperation *pendingOperation,
+	                          BluetoothGattOperationPriority priority);
+	void forgetPendingOperationKey(const std::string &key);
+	PendingGattOperation* takePendingOperation(uint32_t operationId);
+	void completeBulkItem(BulkGattRequest *bulkRequest, unsigned int index, pbnjson::JValue result);
+	void handleWriteStreamStatus(const std::string &streamId, BluetoothError error);
+	void closeWriteStream(const std::string &streamId);
+	void closeWriteStreams(const std::string &deviceAddress);
+	void sendCharacteristicFrame(BluetoothBinarySocket *binarySocket, const BluetoothGattCharacteristic &characteristic);
+	void attachPooledClient(BluetoothGattPooledConnection *connection, LSMessage *requestMessage, const std::string &adapterAddress);
+	void failPooledConnection(const std::string &address, BluetoothErrorCode errorCode);
+	void releasePooledClient(uint16_t clientId, BluetoothResultCallback callback);
+	void removePooledConnectWatch(uint16_t clientId, bool disconnected, bool remoteDisconnect);
+	void releaseLocalServiceState(LocalService *localService);
+	bool forwardReadRequest(uint32_t requestId, const std::string &address, uint16_t handle, BluetoothGattStoredValue *storedValue);
+	void completeForwardedRead(uint32_t requestId, const BluetoothGattValue *value);
+	void handleReadRequestsClientDropped(LSUtils::ClientWatch *watch);
+	static gboolean handleForwardedReadTimeout(gpointer userData);
+	void notifyLocalCharacteristic(uint16_t handle, const BluetoothGattValue &value);
+	void notifyLocalCharacteristicSubscribers(const BluetoothGattCharacteristic &characteristic);
+	bool updateClientConfiguration(const std::string &address, uint16_t handle, const BluetoothGattValue &value);
+	bool lookupCachedServices(const std::string &address, BluetoothGattServiceList &services);
+	BluetoothGattServiceList getRemoteServices(const std::string &address);
+	BluetoothGattService getRemoteService(const std::string &address, const std::string &serviceUuid);
+	void cacheDiscoveredServices(const std::string &adapterAddress, const std::string &address, bool notifyChanges);
+	void revalidateCachedServices(const std::string &adapterAddress, const std::string &address);
+	void startServiceDiscovery(const std::string &address, BluetoothResultCallback callback);
+	void discoveryStateChanged(const std::string &address, bool discovering);
 
 	std::unordered_map<std::string, LS::SubscriptionPoint*> mGetServicesSubscriptions;
 	std::vector<std::pair<LSUtils::ClientWatch*, MonitorCharacteristicSubscriptionInfo>>  mMonitorCharacteristicSubscriptions;
-	std::unordered_map<std::string, bool> mDiscoveringServices;
-	std::vector<CharacteristicWatch*> mCharacteristicWatchList;
+	std::unordered_map<LSUtils::ClientWatch*, BluetoothBinarySocket*> mMonitorCharacteristicSockets;
+	std::unordered_map<std::string, CharacteristicWatch*> mCharacteristicWatches;
 	std::vector<BluetoothGattProfileService *> mGattObservers;
+	std::unordered_map<std::string, BluetoothGattOperationQueue*> mOperationQueues;
+	std::unordered_map<uint32_t, PendingGattOperation*> mPendingOperations;
+	std::unordered_map<std::string, uint32_t> mPendingOperationKeys;
+	uint32_t mNextPendingOperationId;
+	std::unordered_map<std::string, GattWriteStreamSubscription*> mWriteStreams;
+	uint32_t mNextWriteStreamId;
+	uint32_t mNextMonitorSocketId;
+	BluetoothGattConnectionPool mConnectionPool;
+	std::unordered_map<uint16_t, LSUtils::ClientWatch*> mPooledConnectWatches;
+	BluetoothGattValueStore mValueStore;
+	std::vector<LSUtils::ClientWatch*> mReadRequestWatches;
+	std::unordered_map<uint32_t, ForwardedReadRequest*> mForwardedReadRequests;
+	BluetoothGattNotifyEngine *mNotifyEngine;
+	BluetoothGattServiceCache mServiceCache;
+	BluetoothGattDiscoveryScheduler *mDiscoveryScheduler;
+	BluetoothGattServicesPayloadCache mServicesPayloadCache;
 };
 
 
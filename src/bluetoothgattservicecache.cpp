@@ -0,0 +1,306 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "bluetoothgattservicecache.h"
+#include "ls2utils.h"
+#include "logging.h"
+#include "config.h"
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+BluetoothGattServiceCache::BluetoothGattServiceCache() :
+	mDirectory(WEBOS_BLUETOOTH_GATT_CACHE_DIR),
+	mHitCount(0),
+	mMissCount(0),
+	mInvalidatedCount(0)
+{
+	GDir *directory = g_dir_open(mDirectory.c_str(), 0, nullptr);
+	if (!directory)
+		return;
+
+	const gchar *fileName;
+	while ((fileName = g_dir_read_name(directory)) != nullptr)
+		mFiles.insert(fileName);
+
+	g_dir_close(directory);
+}
+
+BluetoothGattServiceCache::~BluetoothGattServiceCache()
+{
+}
+
+std::string BluetoothGattServiceCache::buildFileName(const std::string &address) const
+{
+	std::string fileName;
+	for (auto c : address)
+	{
+		if (c != ':')
+			fileName += g_ascii_tolower(c);
+	}
+
+	return fileName;
+}
+
+std::string BluetoothGattServiceCache::buildPath(const std::string &address) const
+{
+	return mDirectory + "/" + buildFileName(address);
+}
+
+void BluetoothGattServiceCache::remember(const std::string &address, const std::string &data)
+{
+	if (mEntries.find(address) == mEntries.end())
+	{
+		mEntryOrder.push_back(address);
+		if (mEntryOrder.size() > GATT_SERVICE_CACHE_MAX_ENTRIES)
+		{
+			mEntries.erase(mEntryOrder.front());
+			mEntryOrder.pop_front();
+		}
+	}
+
+	mEntries[address] = data;
+}
+
+void BluetoothGattServiceCache::forget(const std::string &address)
+{
+	if (!mEntries.erase(address))
+		return;
+
+	for (auto orderIter = mEntryOrder.begin(); orderIter != mEntryOrder.end(); orderIter++)
+	{
+		if (*orderIter == address)
+		{
+			mEntryOrder.erase(orderIter);
+			break;
+		}
+	}
+}
+
+bool BluetoothGattServiceCache::load(const std::string &address)
+{
+	gchar *contents = nullptr;
+	gsize length = 0;
+
+	if (mFiles.find(buildFileName(address)) == mFiles.end())
+		return false;
+
+	if (!g_file_get_contents(buildPath(address).c_str(), &contents, &length, nullptr))
+		return false;
+
+	std::string data(contents, length);
+	g_free(contents);
+
+	BluetoothGattServiceList services;
+	if (!deserialize(data, services))
+	{
+		BT_DEBUG("Dropping unreadable GATT cache entry for %s", address.c_str());
+		g_unlink(buildPath(address).c_str());
+		mFiles.erase(buildFileName(address));
+		return false;
+	}
+
+	remember(address, data);
+
+	return true;
+}
+
+bool BluetoothGattServiceCache::lookup(const std::string &address, BluetoothGattServiceList &services)
+{
+	auto entryIter = mEntries.find(address);
+	if (entryIter == mEntries.end())
+	{
+		if (!load(address))
+		{
+			mMissCount++;
+			return false;
+		}
+
+		entryIter = mEntries.find(address);
+	}
+
+	services.clear();
+	if (!deserialize(entryIter->second, services))
+	{
+		mMissCount++;
+		return false;
+	}
+
+	mHitCount++;
+
+	return true;
+}
+
+bool BluetoothGattServiceCache::store(const std::string &address, const BluetoothGattServiceList &services)
+{
+	std::string data = serialize(services);
+
+	auto entryIter = mEntries.find(address);
+	if (entryIter == mEntries.end() && load(address))
+		entryIter = mEntries.find(address);
+
+	if (entryIter != mEntries.end() && entryIter->second == data)
+		return false;
+
+	remember(address, data);
+
+	GError *error = nullptr;
+	if (g_mkdir_with_parents(mDirectory.c_str(), 0700) != 0 ||
+	    !g_file_set_contents(buildPath(address).c_str(), data.c_str(), data.length(), &error))
+	{
+		BT_WARNING(MSGID_GATT_SERVICE_CACHE_WRITE_ERROR, 0, "Failed to write GATT cache entry for %s: %s",
+		           address.c_str(), error ? error->message : "cannot create cache directory");
+		if (error)
+			g_error_free(error);
+	}
+	else
+		mFiles.insert(buildFileName(address));
+
+	BT_DEBUG("Stored %zu GATT services of %s in cache", services.size(), address.c_str());
+
+	return true;
+}
+
+void BluetoothGattServiceCache::invalidate(const std::string &address)
+{
+	bool existed = mEntries.find(address) != mEntries.end();
+	forget(address);
+
+	if (mFiles.erase(buildFileName(address)))
+	{
+		g_unlink(buildPath(address).c_str());
+		existed = true;
+	}
+
+	if (existed)
+	{
+		mInvalidatedCount++;
+		BT_DEBUG("Invalidated GATT cache entry for %s", address.c_str());
+	}
+}
+
+// Short keys keep the files small, values are never written
+std::string BluetoothGattServiceCache::serialize(const BluetoothGattServiceList &services)
+{
+	pbnjson::JValue servicesArray = pbnjson::Array();
+
+	for (auto service : services)
+	{
+		if (!service.isValid())
+			continue;
+
+		pbnjson::JValue serviceObj = pbnjson::Object();
+		serviceObj.put("u", service.getUuid().toString());
+		serviceObj.put("t", (int32_t) service.getType());
+		serviceObj.put("h", (int32_t) service.getHandle());
+
+		pbnjson::JValue includesArray = pbnjson::Array();
+		for (auto include : service.getIncludedServices())
+			includesArray.append(include.toString());
+		serviceObj.put("i", includesArray);
+
+		pbnjson::JValue characteristicsArray = pbnjson::Array();
+		for (auto characteristic : service.getCharacteristics())
+		{
+			pbnjson::JValue characteristicObj = pbnjson::Object();
+			characteristicObj.put("u", characteristic.getUuid().toString());
+			characteristicObj.put("h", (int32_t) characteristic.getHandle());
+			characteristicObj.put("p", (int32_t) characteristic.getProperties());
+			characteristicObj.put("m", (int32_t) characteristic.getPermissions());
+
+			pbnjson::JValue descriptorsArray = pbnjson::Array();
+			for (auto descriptor : characteristic.getDescriptors())
+			{
+				pbnjson::JValue descriptorObj = pbnjson::Object();
+				descriptorObj.put("u", descriptor.getUuid().toString());
+				descriptorObj.put("h", (int32_t) descriptor.getHandle());
+				descriptorObj.put("m", (int32_t) descriptor.getPermissions());
+				descriptorsArray.append(descriptorObj);
+			}
+			characteristicObj.put("d", descriptorsArray);
+
+			characteristicsArray.append(characteristicObj);
+		}
+		serviceObj.put("c", characteristicsArray);
+
+		servicesArray.append(serviceObj);
+	}
+
+	pbnjson::JValue cacheObj = pbnjson::Object();
+	cacheObj.put("v", GATT_SERVICE_CACHE_FORMAT_VERSION);
+	cacheObj.put("s", servicesArray);
+
+	return cacheObj.stringify();
+}
+
+bool BluetoothGattServiceCache::deserialize(const std::string &data, BluetoothGattServiceList &services)
+{
+	pbnjson::JValue cacheObj;
+	if (!LSUtils::parsePayload(data, cacheObj))
+		return false;
+
+	if (!cacheObj.hasKey("v") || cacheObj["v"].asNumber<int32_t>() != GATT_SERVICE_CACHE_FORMAT_VERSION)
+		return false;
+
+	if (!cacheObj.hasKey("s") || !cacheObj["s"].isArray())
+		return false;
+
+	pbnjson::JValue servicesArray = cacheObj["s"];
+	for (int i = 0; i < servicesArray.arraySize(); i++)
+	{
+		pbnjson::JValue serviceObj = servicesArray[i];
+
+		BluetoothGattService service;
+		service.setUuid(BluetoothUuid(serviceObj["u"].asString()));
+		service.setType((BluetoothGattService::Type) serviceObj["t"].asNumber<int32_t>());
+		service.setHandle((uint16_t) serviceObj["h"].asNumber<int32_t>());
+
+		pbnjson::JValue includesArray = serviceObj["i"];
+		for (int j = 0; j < includesArray.arraySize(); j++)
+			service.addIncludedService(BluetoothUuid(includesArray[j].asString()));
+
+		pbnjson::JValue characteristicsArray = serviceObj["c"];
+		for (int j = 0; j < characteristicsArray.arraySize(); j++)
+		{
+			pbnjson::JValue characteristicObj = characteristicsArray[j];
+
+			BluetoothGattCharacteristic characteristic(BluetoothUuid(characteristicObj["u"].asString()),
+			                                           characteristicObj["p"].asNumber<int32_t>(),
+			                                           characteristicObj["m"].asNumber<int32_t>());
+			characteristic.setHandle((uint16_t) characteristicObj["h"].asNumber<int32_t>());
+			characteristic.setServiceHandle(service.getHandle());
+
+			pbnjson::JValue descriptorsArray = characteristicObj["d"];
+			for (int k = 0; k < descriptorsArray.arraySize(); k++)
+			{
+				pbnjson::JValue descriptorObj = descriptorsArray[k];
+
+				BluetoothGattDescriptor descriptor(BluetoothUuid(descriptorObj["u"].asString()),
+				                                   descriptorObj["m"].asNumber<int32_t>());
+				descriptor.setHandle((uint16_t) descriptorObj["h"].asNumber<int32_t>());
+				characteristic.addDescriptor(descriptor);
+			}
+
+			service.addCharacteristic(characteristic);
+		}
+
+		services.push_back(service);
+	}
+
+	return true;
+}
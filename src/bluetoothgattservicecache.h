@@ -0,0 +1,78 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef BLUETOOTHGATTSERVICECACHE_H
+#define BLUETOOTHGATTSERVICECACHE_H
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <bluetooth-sil-api.h>
+
+#define GATT_SERVICE_CHANGED_UUID "00002a05-0000-1000-8000-00805f9b34fb"
+
+// Bumped whenever the layout of the cache files changes
+#define GATT_SERVICE_CACHE_FORMAT_VERSION 1
+// Databases kept in memory; older ones are read from disk again when needed
+#define GATT_SERVICE_CACHE_MAX_ENTRIES 32
+
+/*
+ * Attribute databases of paired devices, kept in memory and in one compact
+ * file per device below WEBOS_BLUETOOTH_GATT_CACHE_DIR. Only the structure
+ * (uuids, handles, properties and permissions) is stored, never values.
+ */
+class BluetoothGattServiceCache
+{
+public:
+	BluetoothGattServiceCache();
+	BluetoothGattServiceCache(const BluetoothGattServiceCache &other) = delete;
+	~BluetoothGattServiceCache();
+
+	bool lookup(const std::string &address, BluetoothGattServiceList &services);
+	bool store(const std::string &address, const BluetoothGattServiceList &services);
+	void invalidate(const std::string &address);
+
+	unsigned int getHitCount() const { return mHitCount; }
+	unsigned int getMissCount() const { return mMissCount; }
+	unsigned int getInvalidatedCount() const { return mInvalidatedCount; }
+
+private:
+	std::string mDirectory;
+	// Serialized database per address, loaded lazily from disk
+	std::unordered_map<std::string, std::string> mEntries;
+	// Addresses in mEntries, oldest first
+	std::deque<std::string> mEntryOrder;
+	// Names of the files in mDirectory, so misses don't touch the disk
+	std::unordered_set<std::string> mFiles;
+
+	unsigned int mHitCount;
+	unsigned int mMissCount;
+	unsigned int mInvalidatedCount;
+
+	std::string buildFileName(const std::string &address) const;
+	std::string buildPath(const std::string &address) const;
+	bool load(const std::string &address);
+	void remember(const std::string &address, const std::string &data);
+	void forget(const std::string &address);
+
+	static std::string serialize(const BluetoothGattServiceList &services);
+	static bool deserialize(const std::string &data, BluetoothGattServiceList &services);
+};
+
+#endif // BLUETOOTHGATTSERVICECACHE_H
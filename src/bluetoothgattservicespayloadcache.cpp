@@ -0,0 +1,69 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "bluetoothgattservicespayloadcache.h"
+#include "logging.h"
+
+BluetoothGattServicesPayloadCache::BluetoothGattServicesPayloadCache() :
+	mHitCount(0),
+	mMissCount(0),
+	mInvalidatedCount(0)
+{
+}
+
+bool BluetoothGattServicesPayloadCache::lookup(const std::string &address, bool localAdapterServices, std::string &payload)
+{
+	std::unordered_map<std::string, std::string> &entries = localAdapterServices ? mLocalEntries : mRemoteEntries;
+
+	auto entryIter = entries.find(address);
+	if (entryIter == entries.end())
+	{
+		mMissCount++;
+		return false;
+	}
+
+	payload = entryIter->second;
+	mHitCount++;
+
+	return true;
+}
+
+void BluetoothGattServicesPayloadCache::store(const std::string &address, bool localAdapterServices, const std::string &payload)
+{
+	std::unordered_map<std::string, std::string> &entries = localAdapterServices ? mLocalEntries : mRemoteEntries;
+	entries[address] = payload;
+}
+
+void BluetoothGattServicesPayloadCache::invalidate(const std::string &address)
+{
+	// serviceFound and friends report the adapter address for local services
+	if (mRemoteEntries.erase(address) + mLocalEntries.erase(address) > 0)
+	{
+		BT_DEBUG("Dropped serialized services of %s", address.c_str());
+		mInvalidatedCount++;
+	}
+}
+
+void BluetoothGattServicesPayloadCache::invalidateLocal()
+{
+	if (mLocalEntries.empty())
+		return;
+
+	mLocalEntries.clear();
+	mInvalidatedCount++;
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef BLUETOOTHGATTSERVICESPAYLOADCACHE_H
+#define BLUETOOTHGATTSERVICESPAYLOADCACHE_H
+
+#include <string>
+#include <unordered_map>
+
+/*
+ * Serialized "services" array of getServices responses, one per remote
+ * device and one per adapter for the local services. Repeated calls only
+ * splice the stored string into the response instead of walking the whole
+ * service tree again. Entries have to be invalidated whenever the services
+ * or the values they carry change.
+ */
+class BluetoothGattServicesPayloadCache
+{
+public:
+	BluetoothGattServicesPayloadCache();
+	BluetoothGattServicesPayloadCache(const BluetoothGattServicesPayloadCache &other) = delete;
+
+	bool lookup(const std::string &address, bool localAdapterServices, std::string &payload);
+	void store(const std::string &address, bool localAdapterServices, const std::string &payload);
+	void invalidate(const std::string &address);
+	void invalidateLocal();
+
+	unsigned int getHitCount() const { return mHitCount; }
+	unsigned int getMissCount() const { return mMissCount; }
+	unsigned int getInvalidatedCount() const { return mInvalidatedCount; }
+
+private:
+	std::unordered_map<std::string, std::string> mRemoteEntries;
+	std::unordered_map<std::string, std::string> mLocalEntries;
+
+	unsigned int mHitCount;
+	unsigned int mMissCount;
+	unsigned int mInvalidatedCount;
+};
+
+#endif // BLUETOOTHGATTSERVICESPAYLOADCACHE_H
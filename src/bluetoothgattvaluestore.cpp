@@ -0,0 +1,97 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "bluetoothgattvaluestore.h"
+#include "logging.h"
+
+BluetoothGattValueStore::BluetoothGattValueStore()
+{
+}
+
+BluetoothGattValueStore::~BluetoothGattValueStore()
+{
+	for (auto valueIter : mValues)
+		delete valueIter.second;
+
+	mValues.clear();
+}
+
+BluetoothGattStoredValue* BluetoothGattValueStore::find(uint16_t handle)
+{
+	auto valueIter = mValues.find(handle);
+	if (valueIter == mValues.end())
+		return nullptr;
+
+	return valueIter->second;
+}
+
+uint32_t BluetoothGattValueStore::update(uint16_t handle, const BluetoothUuid &service, const BluetoothUuid &characteristic, const BluetoothGattValue &value)
+{
+	BluetoothGattStoredValue *storedValue = find(handle);
+	if (!storedValue)
+	{
+		storedValue = new BluetoothGattStoredValue();
+		mValues.insert(std::pair<uint16_t, BluetoothGattStoredValue*>(handle, storedValue));
+	}
+
+	storedValue->service = service;
+	storedValue->characteristic = characteristic;
+	storedValue->value = value;
+	storedValue->version++;
+
+	BT_DEBUG("[%s](%d) characteristic %s (handle %d) now at version %u", __FUNCTION__, __LINE__,
+	         characteristic.toString().c_str(), handle, storedValue->version);
+
+	return storedValue->version;
+}
+
+bool BluetoothGattValueStore::setPolicy(uint16_t handle, BluetoothGattValuePolicy policy)
+{
+	BluetoothGattStoredValue *storedValue = find(handle);
+	if (!storedValue)
+		return false;
+
+	storedValue->policy = policy;
+	return true;
+}
+
+void BluetoothGattValueStore::remove(uint16_t handle)
+{
+	auto valueIter = mValues.find(handle);
+	if (valueIter == mValues.end())
+		return;
+
+	delete valueIter->second;
+	mValues.erase(valueIter);
+}
+
+BluetoothGattValuePolicy BluetoothGattValueStore::policyFromString(const std::string &policy)
+{
+	if (policy == "forward")
+		return BLUETOOTH_GATT_VALUE_POLICY_FORWARD;
+
+	return BLUETOOTH_GATT_VALUE_POLICY_AUTO_RESPOND;
+}
+
+std::string BluetoothGattValueStore::policyToString(BluetoothGattValuePolicy policy)
+{
+	if (policy == BLUETOOTH_GATT_VALUE_POLICY_FORWARD)
+		return "forward";
+
+	return "auto";
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef BLUETOOTHGATTVALUESTORE_H
+#define BLUETOOTHGATTVALUESTORE_H
+
+#include <string>
+#include <unordered_map>
+#include <bluetooth-sil-api.h>
+
+// Seconds an application gets to answer a forwarded read before the
+// stored value is sent instead
+#define GATT_FORWARDED_READ_TIMEOUT 5
+
+enum BluetoothGattValuePolicy
+{
+	// Reads from remote devices are answered right away from the store
+	BLUETOOTH_GATT_VALUE_POLICY_AUTO_RESPOND = 0,
+	// Reads are forwarded to the application which owns the value
+	BLUETOOTH_GATT_VALUE_POLICY_FORWARD
+};
+
+class BluetoothGattStoredValue
+{
+public:
+	BluetoothGattStoredValue() :
+		version(0),
+		policy(BLUETOOTH_GATT_VALUE_POLICY_AUTO_RESPOND),
+		autoResponses(0),
+		forwardedReads(0)
+	{
+	}
+
+	BluetoothUuid service;
+	BluetoothUuid characteristic;
+	BluetoothGattValue value;
+	// Incremented with every update of the value
+	uint32_t version;
+	BluetoothGattValuePolicy policy;
+	unsigned int autoResponses;
+	unsigned int forwardedReads;
+};
+
+/*
+ * Current values of the characteristics provided by our local GATT
+ * servers, indexed by characteristic handle. Read requests from remote
+ * devices are served from here without walking the registered services.
+ */
+class BluetoothGattValueStore
+{
+public:
+	BluetoothGattValueStore();
+	BluetoothGattValueStore(const BluetoothGattValueStore &other) = delete;
+	~BluetoothGattValueStore();
+
+	BluetoothGattStoredValue* find(uint16_t handle);
+	uint32_t update(uint16_t handle, const BluetoothUuid &service, const BluetoothUuid &characteristic, const BluetoothGattValue &value);
+	bool setPolicy(uint16_t handle, BluetoothGattValuePolicy policy);
+	void remove(uint16_t handle);
+
+	const std::unordered_map<uint16_t, BluetoothGattStoredValue*>& getValues() const { return mValues; }
+
+	static BluetoothGattValuePolicy policyFromString(const std::string &policy);
+	static std::string policyToString(BluetoothGattValuePolicy policy);
+
+private:
+	std::unordered_map<uint16_t, BluetoothGattStoredValue*> mValues;
+};
+
+#endif // BLUETOOTHGATTVALUESTORE_H
@@ -0,0 +1,174 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include "bluetoothgattwritestream.h"
+#include "logging.h"
+
+BluetoothGattWriteStream::BluetoothGattWriteStream(const std::string &streamId, uint16_t chunkSize, uint32_t chunkInterval, uint32_t progressInterval,
+                                                   BluetoothGattWriteStreamWriteFunction writeFunction, BluetoothGattWriteStreamStatusCallback statusCallback) :
+	mStreamId(streamId),
+	mChunkSize(chunkSize),
+	mChunkInterval(chunkInterval),
+	mProgressInterval(progressInterval),
+	mWriteFunction(writeFunction),
+	mStatusCallback(statusCallback),
+	mBinarySocket(nullptr),
+	mPendingOffset(0),
+	mChunkInFlight(false),
+	mPacingTimeout(0),
+	mBytesReceived(0),
+	mBytesWritten(0),
+	mBytesReported(0),
+	mChunksWritten(0)
+{
+	if (mChunkSize == 0 || mChunkSize > GATT_WRITE_STREAM_MAX_CHUNK_SIZE)
+		mChunkSize = GATT_WRITE_STREAM_DEFAULT_CHUNK_SIZE;
+}
+
+BluetoothGattWriteStream::~BluetoothGattWriteStream()
+{
+	close();
+}
+
+bool BluetoothGattWriteStream::open()
+{
+	if (mBinarySocket)
+		return true;
+
+	mBinarySocket = new BluetoothBinarySocket();
+	if (!mBinarySocket->createBinarySocket("GattWriteStream" + mStreamId) ||
+	    !mBinarySocket->registerReceiveDataWatch(std::bind(&BluetoothGattWriteStream::handleReceivedData, this,
+	                                                       std::placeholders::_1, std::placeholders::_2)))
+	{
+		mBinarySocket->removeBinarySocket();
+		delete mBinarySocket;
+		mBinarySocket = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+void BluetoothGattWriteStream::close()
+{
+	if (mPacingTimeout)
+	{
+		g_source_remove(mPacingTimeout);
+		mPacingTimeout = 0;
+	}
+
+	if (mBinarySocket)
+	{
+		mBinarySocket->removeBinarySocket();
+		delete mBinarySocket;
+		mBinarySocket = nullptr;
+	}
+
+	mPendingData.clear();
+	mPendingOffset = 0;
+}
+
+std::string BluetoothGattWriteStream::getSocketPath() const
+{
+	if (!mBinarySocket)
+		return std::string();
+
+	return mBinarySocket->getSocketFileName();
+}
+
+void BluetoothGattWriteStream::handleReceivedData(guchar *readBuf, gsize readLen)
+{
+	if (!mBinarySocket || readLen == 0)
+		return;
+
+	mPendingData.insert(mPendingData.end(), readBuf, readBuf + readLen);
+	mBytesReceived += readLen;
+
+	// Don't read more from the client until this data is written
+	mBinarySocket->setWriting(true);
+
+	if (!mChunkInFlight && !mPacingTimeout)
+		writeNextChunk();
+}
+
+void BluetoothGattWriteStream::writeNextChunk()
+{
+	if (!mBinarySocket)
+		return;
+
+	if (mPendingOffset >= mPendingData.size())
+	{
+		mPendingData.clear();
+		mPendingOffset = 0;
+		mBinarySocket->setWriting(false);
+		return;
+	}
+
+	size_t chunkSize = mPendingData.size() - mPendingOffset;
+	if (chunkSize > mChunkSize)
+		chunkSize = mChunkSize;
+
+	BluetoothGattValue value(mPendingData.begin() + mPendingOffset, mPendingData.begin() + mPendingOffset + chunkSize);
+	mPendingOffset += chunkSize;
+	mChunkInFlight = true;
+
+	mWriteFunction(value, std::bind(&BluetoothGattWriteStream::handleChunkWritten, this, chunkSize, std::placeholders::_1));
+}
+
+void BluetoothGattWriteStream::handleChunkWritten(size_t chunkSize, BluetoothError error)
+{
+	mChunkInFlight = false;
+
+	if (error != BLUETOOTH_ERROR_NONE)
+	{
+		BT_DEBUG("Write stream %s failed after %llu bytes", mStreamId.c_str(), (unsigned long long) mBytesWritten);
+		close();
+
+		// The status callback deletes the stream, and with it mStatusCallback
+		// while it is still running; call a copy of it instead.
+		BluetoothGattWriteStreamStatusCallback statusCallback = mStatusCallback;
+		if (statusCallback)
+			statusCallback(error);
+		return;
+	}
+
+	mBytesWritten += chunkSize;
+	mChunksWritten++;
+
+	if (mStatusCallback && mBytesWritten - mBytesReported >= mProgressInterval)
+	{
+		mBytesReported = mBytesWritten;
+		mStatusCallback(BLUETOOTH_ERROR_NONE);
+	}
+
+	if (mChunkInterval > 0 && mPendingOffset < mPendingData.size())
+		mPacingTimeout = g_timeout_add(mChunkInterval, &BluetoothGattWriteStream::handlePacingTimeout, this);
+	else
+		writeNextChunk();
+}
+
+gboolean BluetoothGattWriteStream::handlePacingTimeout(gpointer userData)
+{
+	BluetoothGattWriteStream *writeStream = static_cast<BluetoothGattWriteStream*>(userData);
+	if (!writeStream)
+		return FALSE;
+
+	writeStream->mPacingTimeout = 0;
+	writeStream->writeNextChunk();
+
+	return FALSE;
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef BLUETOOTHGATTWRITESTREAM_H
+#define BLUETOOTHGATTWRITESTREAM_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <bluetooth-sil-api.h>
+#include <glib.h>
+
+#include "bluetoothbinarysocket.h"
+
+// Default ATT_MTU (23) minus the 3 byte ATT write command header
+#define GATT_WRITE_STREAM_DEFAULT_CHUNK_SIZE        20
+// Maximum length of an attribute value (Core spec Vol 3, Part F, 3.2.9)
+#define GATT_WRITE_STREAM_MAX_CHUNK_SIZE            512
+#define GATT_WRITE_STREAM_DEFAULT_PROGRESS_INTERVAL 4096
+
+typedef std::function<void(const BluetoothGattValue &value, BluetoothResultCallback callback)> BluetoothGattWriteStreamWriteFunction;
+typedef std::function<void(BluetoothError error)> BluetoothGattWriteStreamStatusCallback;
+
+/*
+ * Binds a characteristic to a binary socket. Everything the client writes
+ * to the socket is split into chunks of at most chunkSize bytes, which are
+ * passed one at a time to the write function. The socket isn't read again
+ * until all chunks of the data read last have been written, so a fast
+ * writer is throttled to the speed of the link.
+ *
+ * The status callback is called with BLUETOOTH_ERROR_NONE each time another
+ * progressInterval bytes have been written, and with the error of the first
+ * chunk which couldn't be written. In the latter case the stream stops and
+ * the callback may delete it.
+ */
+class BluetoothGattWriteStream
+{
+public:
+	BluetoothGattWriteStream(const std::string &streamId, uint16_t chunkSize, uint32_t chunkInterval, uint32_t progressInterval,
+	                         BluetoothGattWriteStreamWriteFunction writeFunction, BluetoothGattWriteStreamStatusCallback statusCallback);
+	BluetoothGattWriteStream(const BluetoothGattWriteStream &other) = delete;
+	~BluetoothGattWriteStream();
+
+	bool open();
+	void close();
+
+	std::string getStreamId() const { return mStreamId; }
+	std::string getSocketPath() const;
+	uint16_t getChunkSize() const { return mChunkSize; }
+	uint64_t getBytesReceived() const { return mBytesReceived; }
+	uint64_t getBytesWritten() const { return mBytesWritten; }
+	uint32_t getChunksWritten() const { return mChunksWritten; }
+
+private:
+	std::string mStreamId;
+	uint16_t mChunkSize;
+	uint32_t mChunkInterval;
+	uint32_t mProgressInterval;
+	BluetoothGattWriteStreamWriteFunction mWriteFunction;
+	BluetoothGattWriteStreamStatusCallback mStatusCallback;
+	BluetoothBinarySocket *mBinarySocket;
+	std::vector<uint8_t> mPendingData;
+	size_t mPendingOffset;
+	bool mChunkInFlight;
+	guint mPacingTimeout;
+	uint64_t mBytesReceived;
+	uint64_t mBytesWritten;
+	uint64_t mBytesReported;
+	uint32_t mChunksWritten;
+
+	void handleReceivedData(guchar *readBuf, gsize readLen);
+	void writeNextChunk();
+	void handleChunkWritten(size_t chunkSize, BluetoothError error);
+
+	static gboolean handlePacingTimeout(gpointer userData);
+};
+
+#endif // BLUETOOTHGATTWRITESTREAM_H
@@ -28,9 +28,9 @@ BluetoothHfpProfileService::BluetoothHfpProfileService(BluetoothManagerService *
         "0000111e-0000-1000-8000-00805f9b34fb")
 {
 	LS_CREATE_CATEGORY_BEGIN(BluetoothProfileService, base)
-		LS_CATEGORY_METHOD(connect)
-		LS_CATEGORY_METHOD(disconnect)
-		LS_CATEGORY_METHOD(getStatus)
+		BT_CATEGORY_METHOD(connect)
+		BT_CATEGORY_METHOD(disconnect)
+		BT_CATEGORY_METHOD(getStatus)
 		LS_CATEGORY_CLASS_METHOD(BluetoothHfpProfileService, openSCO)
 		LS_CATEGORY_CLASS_METHOD(BluetoothHfpProfileService, closeSCO)
 		LS_CATEGORY_CLASS_METHOD(BluetoothHfpProfileService, receiveAT)
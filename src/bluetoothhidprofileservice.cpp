@@ -17,6 +17,7 @@
 
 #include "bluetoothhidprofileservice.h"
 #include "bluetoothmanagerservice.h"
+#include "bluetootheventtrace.h"
 #include "ls2utils.h"
 #include "utils.h"
 #include "logging.h"
@@ -25,9 +26,9 @@ BluetoothHidProfileService::BluetoothHidProfileService(BluetoothManagerService *
         BluetoothProfileService(manager, "HID", "00000011-0000-1000-8000-00805f9b34fb")
 {
 	LS_CREATE_CATEGORY_BEGIN(BluetoothProfileService, base)
-		LS_CATEGORY_METHOD(connect)
-		LS_CATEGORY_METHOD(disconnect)
-		LS_CATEGORY_METHOD(getStatus)
+		BT_CATEGORY_METHOD(connect)
+		BT_CATEGORY_METHOD(disconnect)
+		BT_CATEGORY_METHOD(getStatus)
 	LS_CREATE_CATEGORY_END
 
 	LS_CREATE_CATEGORY_BEGIN(BluetoothProfileService, internal)
@@ -340,9 +341,12 @@ bool BluetoothHidProfileService::sendData(LSMessage &message)
 		data[n] = (uint8_t)dataObjArray[n].asNumber<int32_t>();
 	}
 
-	BT_INFO("HID", 0, "Service calls SIL API : sendData");
+	BT_DEBUG("Service calls SIL API : sendData");
+	int64_t startTime = g_get_monotonic_time();
 	BluetoothError error = getImpl<BluetoothHidProfile>()->sendData(deviceAddress, (uint8_t*)data, dataSize);
-	BT_INFO("HID", 0, "Return of sendData is %d", error);
+	getEventTrace().record(BLUETOOTH_EVENT_TRACE_HID_SEND_DATA, deviceAddress, 0, dataSize,
+	                       g_get_monotonic_time() - startTime);
+	BT_DEBUG("Return of sendData is %d", error);
 
 	pbnjson::JValue responseObj = pbnjson::Object();
 	if (BLUETOOTH_ERROR_NONE != error)
@@ -0,0 +1,177 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <algorithm>
+
+#include "bluetoothlatencytracker.h"
+#include "bluetoothmainloopwatchdog.h"
+
+BluetoothLatencyTracker::Event::Event(BluetoothLatencyTracker *tracker, BluetoothLatencyEvent event) :
+	mTracker(tracker && tracker->mEnabled ? tracker : nullptr),
+	mPreviousEvent(-1),
+	mPreviousStartTime(0)
+{
+	if (!mTracker)
+		return;
+
+	mPreviousEvent = mTracker->mCurrentEvent;
+	mPreviousStartTime = mTracker->mStartTime;
+
+	mTracker->mCurrentEvent = event;
+	mTracker->mStartTime = g_get_monotonic_time();
+}
+
+BluetoothLatencyTracker::Event::~Event()
+{
+	if (!mTracker)
+		return;
+
+	mTracker->mCurrentEvent = mPreviousEvent;
+	mTracker->mStartTime = mPreviousStartTime;
+}
+
+BluetoothLatencyTracker::BluetoothLatencyTracker() :
+	mEnabled(false),
+	mStartedWatchdog(false),
+	mTransport(nullptr),
+	mCurrentEvent(-1),
+	mStartTime(0)
+{
+}
+
+BluetoothLatencyTracker::~BluetoothLatencyTracker()
+{
+	setEnabled(false);
+}
+
+void BluetoothLatencyTracker::setEnabled(bool enabled)
+{
+	if (enabled == mEnabled)
+		return;
+
+	mEnabled = enabled;
+
+	BluetoothMainLoopWatchdog &watchdog = getMainLoopWatchdog();
+
+	if (enabled)
+	{
+		mTransport = LSUtils::getTransport();
+		LSUtils::setTransport(this);
+
+		if (!watchdog.isEnabled())
+		{
+			watchdog.reset();
+			watchdog.setEnabled(true);
+			mStartedWatchdog = true;
+		}
+	}
+	else
+	{
+		LSUtils::setTransport(mTransport);
+		mTransport = nullptr;
+		mCurrentEvent = -1;
+
+		if (mStartedWatchdog)
+		{
+			watchdog.setEnabled(false);
+			mStartedWatchdog = false;
+		}
+	}
+}
+
+void BluetoothLatencyTracker::reset()
+{
+	for (int event = 0; event < BLUETOOTH_LATENCY_EVENT_MAX; event++)
+		mSamples[event] = BluetoothLatencySamples();
+}
+
+void BluetoothLatencyTracker::recordDelivery()
+{
+	if (!mEnabled || mCurrentEvent < 0)
+		return;
+
+	recordDelivery((BluetoothLatencyEvent) mCurrentEvent, mStartTime);
+}
+
+void BluetoothLatencyTracker::recordDelivery(BluetoothLatencyEvent event, int64_t startTime)
+{
+	if (!mEnabled || startTime <= 0)
+		return;
+
+	int64_t latency = g_get_monotonic_time() - startTime;
+	BluetoothLatencySamples &samples = mSamples[event];
+
+	if (samples.values.size() < BLUETOOTH_LATENCY_MAX_SAMPLES)
+		samples.values.push_back(latency);
+	else
+		samples.values[samples.next] = latency;
+	samples.next = (samples.next + 1) % BLUETOOTH_LATENCY_MAX_SAMPLES;
+
+	samples.count++;
+	if (latency > samples.max)
+		samples.max = latency;
+}
+
+void BluetoothLatencyTracker::respond(LS::Message &message, const std::string &payload)
+{
+	mTransport->respond(message, payload);
+	recordDelivery();
+}
+
+void BluetoothLatencyTracker::post(LS::SubscriptionPoint *subscriptionPoint, const std::string &payload)
+{
+	mTransport->post(subscriptionPoint, payload);
+	recordDelivery();
+}
+
+void BluetoothLatencyTracker::watchClient(LSUtils::ClientWatch *watch)
+{
+	mTransport->watchClient(watch);
+}
+
+void BluetoothLatencyTracker::unwatchClient(LSUtils::ClientWatch *watch)
+{
+	mTransport->unwatchClient(watch);
+}
+
+int64_t BluetoothLatencyTracker::getPercentile(BluetoothLatencyEvent event, unsigned int permille) const
+{
+	std::vector<int64_t> values = mSamples[event].values;
+	if (values.empty())
+		return 0;
+
+	size_t index = std::min(values.size() - 1, values.size() * permille / 1000);
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+
+	return values[index];
+}
+
+std::string BluetoothLatencyTracker::eventToString(BluetoothLatencyEvent event)
+{
+	switch (event)
+	{
+	case BLUETOOTH_LATENCY_EVENT_DEVICE_FOUND:
+		return "deviceFound";
+	case BLUETOOTH_LATENCY_EVENT_CHARACTERISTIC_VALUE_CHANGED:
+		return "characteristicValueChanged";
+	case BLUETOOTH_LATENCY_EVENT_DATA_RECEIVED:
+		return "dataReceived";
+	default:
+		return "unknown";
+	}
+}
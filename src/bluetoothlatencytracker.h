@@ -0,0 +1,124 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef BLUETOOTHLATENCYTRACKER_H
+#define BLUETOOTHLATENCYTRACKER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <glib.h>
+
+#include "ls2transport.h"
+
+// Number of most recent samples kept per event for the percentiles
+#define BLUETOOTH_LATENCY_MAX_SAMPLES 8192
+
+enum BluetoothLatencyEvent
+{
+	BLUETOOTH_LATENCY_EVENT_DEVICE_FOUND = 0,
+	BLUETOOTH_LATENCY_EVENT_CHARACTERISTIC_VALUE_CHANGED,
+	BLUETOOTH_LATENCY_EVENT_DATA_RECEIVED,
+	BLUETOOTH_LATENCY_EVENT_MAX
+};
+
+class BluetoothLatencySamples
+{
+public:
+	BluetoothLatencySamples() :
+		count(0),
+		max(0),
+		next(0)
+	{
+	}
+
+	uint64_t count;
+	int64_t max;
+	// Ring of the latest latencies in microseconds
+	std::vector<int64_t> values;
+	size_t next;
+};
+
+/*
+ * Time from a SIL callback to its payloads leaving the service. While
+ * enabled, the tracker wraps the current Luna transport: every response or
+ * subscription post made while a SIL callback is being handled is a
+ * sample for that callback. Deliveries which do not go through Luna (the
+ * binary sockets) are reported with recordDelivery(). Data delivered after
+ * the callback returned (SPP data queued for readData) keeps the start time
+ * from getStartTime() and is reported with recordDelivery(event, startTime).
+ * Binary socket data is sampled when it is handed to the socket, bytes the
+ * socket has to queue for a slow reader are not followed any further.
+ *
+ * Enabling the tracker starts the main loop watchdog if it is not running
+ * yet, so the longest stall is known for the same period, and disabling
+ * it stops the watchdog again.
+ */
+class BluetoothLatencyTracker : public LSUtils::Transport
+{
+public:
+	class Event
+	{
+	public:
+		Event(BluetoothLatencyTracker *tracker, BluetoothLatencyEvent event);
+		Event(const Event &other) = delete;
+		~Event();
+
+	private:
+		BluetoothLatencyTracker *mTracker;
+		int mPreviousEvent;
+		int64_t mPreviousStartTime;
+	};
+
+	BluetoothLatencyTracker();
+	BluetoothLatencyTracker(const BluetoothLatencyTracker &other) = delete;
+	~BluetoothLatencyTracker();
+
+	void setEnabled(bool enabled);
+	bool isEnabled() const { return mEnabled; }
+	void reset();
+
+	void recordDelivery();
+	void recordDelivery(BluetoothLatencyEvent event, int64_t startTime);
+
+	// Start of the SIL callback being handled, 0 outside of one
+	int64_t getStartTime() const { return mCurrentEvent >= 0 ? mStartTime : 0; }
+
+	void respond(LS::Message &message, const std::string &payload);
+	void post(LS::SubscriptionPoint *subscriptionPoint, const std::string &payload);
+	void watchClient(LSUtils::ClientWatch *watch);
+	void unwatchClient(LSUtils::ClientWatch *watch);
+
+	uint64_t getCount(BluetoothLatencyEvent event) const { return mSamples[event].count; }
+	int64_t getMax(BluetoothLatencyEvent event) const { return mSamples[event].max; }
+	int64_t getPercentile(BluetoothLatencyEvent event, unsigned int permille) const;
+
+	static std::string eventToString(BluetoothLatencyEvent event);
+
+private:
+	bool mEnabled;
+	// The watchdog was started by the tracker and is stopped with it
+	bool mStartedWatchdog;
+	LSUtils::Transport *mTransport;
+	BluetoothLatencySamples mSamples[BLUETOOTH_LATENCY_EVENT_MAX];
+	// -1 while no SIL callback is being handled
+	int mCurrentEvent;
+	int64_t mStartTime;
+};
+
+#endif // BLUETOOTHLATENCYTRACKER_H
@@ -0,0 +1,143 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <algorithm>
+
+#include "bluetoothmainloopwatchdog.h"
+#include "logging.h"
+
+static BluetoothMainLoopWatchdog mainLoopWatchdog;
+
+BluetoothMainLoopWatchdog& getMainLoopWatchdog()
+{
+	return mainLoopWatchdog;
+}
+
+BluetoothMainLoopWatchdog::Activity::Activity(const char *name) :
+	mName(name),
+	mStartTime(mainLoopWatchdog.isEnabled() ? g_get_monotonic_time() : 0)
+{
+}
+
+BluetoothMainLoopWatchdog::Activity::~Activity()
+{
+	if (mStartTime && mainLoopWatchdog.isEnabled())
+		mainLoopWatchdog.reportActivity(mName, g_get_monotonic_time() - mStartTime);
+}
+
+BluetoothMainLoopWatchdog::BluetoothMainLoopWatchdog() :
+	mHeartbeat(0),
+	mLastBeat(0),
+	mThreshold(MAIN_LOOP_WATCHDOG_DEFAULT_THRESHOLD),
+	mMaxStall(0),
+	mStallCount(0),
+	mLongestActivityDuration(0)
+{
+}
+
+BluetoothMainLoopWatchdog::~BluetoothMainLoopWatchdog()
+{
+	setEnabled(false);
+}
+
+void BluetoothMainLoopWatchdog::setEnabled(bool enabled)
+{
+	if (enabled == isEnabled())
+		return;
+
+	if (enabled)
+	{
+		mLastBeat = g_get_monotonic_time();
+		mLongestActivity.clear();
+		mLongestActivityDuration = 0;
+
+		// Above the default priority so the heartbeat is the first source
+		// dispatched once the main loop gets back to polling
+		mHeartbeat = g_timeout_add_full(G_PRIORITY_HIGH, MAIN_LOOP_WATCHDOG_INTERVAL,
+		                                &BluetoothMainLoopWatchdog::handleHeartbeat, this, NULL);
+	}
+	else
+	{
+		g_source_remove(mHeartbeat);
+		mHeartbeat = 0;
+	}
+}
+
+void BluetoothMainLoopWatchdog::reset()
+{
+	mMaxStall = 0;
+	mStallCount = 0;
+	mStalls.clear();
+}
+
+void BluetoothMainLoopWatchdog::reportActivity(const std::string &name, int64_t duration)
+{
+	if (!isEnabled() || duration <= mLongestActivityDuration)
+		return;
+
+	mLongestActivity = name;
+	mLongestActivityDuration = duration;
+}
+
+void BluetoothMainLoopWatchdog::recordStall(int64_t duration)
+{
+	mStallCount++;
+
+	BluetoothMainLoopStall stall;
+	stall.duration = duration;
+	stall.time = g_get_real_time();
+	stall.activity = mLongestActivity;
+	stall.activityDuration = mLongestActivityDuration;
+
+	BT_WARNING(MSGID_MAIN_LOOP_STALL, 0, "Main loop stalled for %lld ms, longest activity: %s (%lld ms)",
+	           (long long) duration / 1000, stall.activity.empty() ? "unknown" : stall.activity.c_str(),
+	           (long long) stall.activityDuration / 1000);
+
+	if (mStalls.size() == MAIN_LOOP_WATCHDOG_MAX_STALLS)
+	{
+		if (duration <= mStalls.back().duration)
+			return;
+		mStalls.pop_back();
+	}
+
+	auto position = std::upper_bound(mStalls.begin(), mStalls.end(), stall,
+	                                 [](const BluetoothMainLoopStall &a, const BluetoothMainLoopStall &b) {
+		return a.duration > b.duration;
+	});
+	mStalls.insert(position, stall);
+}
+
+gboolean BluetoothMainLoopWatchdog::handleHeartbeat(gpointer userData)
+{
+	BluetoothMainLoopWatchdog *watchdog = static_cast<BluetoothMainLoopWatchdog*>(userData);
+
+	int64_t now = g_get_monotonic_time();
+	int64_t stall = now - watchdog->mLastBeat - MAIN_LOOP_WATCHDOG_INTERVAL * 1000;
+
+	if (stall > watchdog->mMaxStall)
+		watchdog->mMaxStall = stall;
+
+	if (stall >= (int64_t) watchdog->mThreshold * 1000)
+		watchdog->recordStall(stall);
+
+	watchdog->mLastBeat = now;
+	watchdog->mLongestActivity.clear();
+	watchdog->mLongestActivityDuration = 0;
+
+	return TRUE;
+}
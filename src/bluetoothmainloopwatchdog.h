@@ -0,0 +1,109 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef BLUETOOTHMAINLOOPWATCHDOG_H
+#define BLUETOOTHMAINLOOPWATCHDOG_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <glib.h>
+
+// Period of the heartbeat (ms)
+#define MAIN_LOOP_WATCHDOG_INTERVAL 10
+// Heartbeats late by at least this much are logged as stalls (ms)
+#define MAIN_LOOP_WATCHDOG_DEFAULT_THRESHOLD 50
+// Number of longest stalls kept
+#define MAIN_LOOP_WATCHDOG_MAX_STALLS 8
+
+class BluetoothMainLoopStall
+{
+public:
+	BluetoothMainLoopStall() :
+		duration(0),
+		time(0),
+		activityDuration(0)
+	{
+	}
+
+	// Lateness of the heartbeat in microseconds
+	int64_t duration;
+	// Wall clock time the stall ended, in microseconds since the epoch
+	int64_t time;
+	// Longest Luna method or SIL callback run since the previous heartbeat
+	std::string activity;
+	int64_t activityDuration;
+};
+
+/*
+ * Everything in the service runs on the main loop, so one slow handler
+ * delays all others. While enabled, a heartbeat source measures how late
+ * the main loop dispatches it. Luna methods and SIL callbacks report how
+ * long they ran, and a late heartbeat is attributed to the longest of them
+ * since the previous heartbeat.
+ */
+class BluetoothMainLoopWatchdog
+{
+public:
+	class Activity
+	{
+	public:
+		Activity(const char *name);
+		Activity(const Activity &other) = delete;
+		~Activity();
+
+	private:
+		const char *mName;
+		int64_t mStartTime;
+	};
+
+	BluetoothMainLoopWatchdog();
+	BluetoothMainLoopWatchdog(const BluetoothMainLoopWatchdog &other) = delete;
+	~BluetoothMainLoopWatchdog();
+
+	void setEnabled(bool enabled);
+	bool isEnabled() const { return mHeartbeat != 0; }
+	void setThreshold(unsigned int threshold) { mThreshold = threshold; }
+	unsigned int getThreshold() const { return mThreshold; }
+	void reset();
+
+	void reportActivity(const std::string &name, int64_t duration);
+
+	int64_t getMaxStall() const { return mMaxStall; }
+	uint64_t getStallCount() const { return mStallCount; }
+	// Longest first
+	const std::vector<BluetoothMainLoopStall>& getStalls() const { return mStalls; }
+
+private:
+	guint mHeartbeat;
+	int64_t mLastBeat;
+	unsigned int mThreshold;
+	int64_t mMaxStall;
+	uint64_t mStallCount;
+	std::vector<BluetoothMainLoopStall> mStalls;
+	std::string mLongestActivity;
+	int64_t mLongestActivityDuration;
+
+	void recordStall(int64_t duration);
+
+	static gboolean handleHeartbeat(gpointer userData);
+};
+
+BluetoothMainLoopWatchdog& getMainLoopWatchdog();
+
+#endif // BLUETOOTHMAINLOOPWATCHDOG_H
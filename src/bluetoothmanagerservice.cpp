@@ -21,6 +21,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <string.h>
 
 #include "bluetoothmanagerservice.h"
 #include "bluetoothdevice.h"
@@ -38,6 +39,9 @@
 #include "bluetoothpanprofileservice.h"
 #include "bluetoothhidprofileservice.h"
 #include "bluetoothgattancsprofile.h"
+#include "bluetoothmainloopwatchdog.h"
+#include "bluetootheventtrace.h"
+#include "bluetoothstartupprofiler.h"
 #include "ls2utils.h"
 #include "clientwatch.h"
 #include "logging.h"
@@ -46,6 +50,9 @@
 
 #define BLUETOOTH_LE_START_SCAN_MAX_ID 999
 #define MAX_ADVERTISING_DATA_BYTES 31
+#define METRICS_DUMP_DEFAULT_INTERVAL 60
+// Period in seconds at which new event trace entries are posted to subscribers
+#define EVENT_TRACE_STREAM_INTERVAL 1
 
 using namespace std::placeholders;
 
@@ -75,6 +82,8 @@ BluetoothManagerService::BluetoothManagerService() :
 	mOutgoingPairingWatch(0),
 	mIncomingPairingWatch(0),
 	mAdvertisingWatch(0),
+	mEventTraceStreamTimer(0),
+	mEventTraceStreamPosition(0),
 	mGattAnsc(0)
 {
 	std::string bluetoothCapability = WEBOS_BLUETOOTH_PAIRING_IO_CAPABILITY;
@@ -93,7 +102,10 @@ BluetoothManagerService::BluetoothManagerService() :
 	mEnabledServiceClasses = split(std::string(WEBOS_BLUETOOTH_ENABLED_SERVICE_CLASSES), ' ');
 
 	mWoBleTriggerDevices.clear();
+
+	int64_t startTime = g_get_monotonic_time();
 	createProfiles();
+	getStartupProfiler().record("createProfiles", startTime);
 
 	BT_DEBUG("Creating SIL for API version %d, capability %s", BLUETOOTH_SIL_API_VERSION, bluetoothCapability.c_str());
 	mSil = BluetoothSILFactory::create(BLUETOOTH_SIL_API_VERSION, mPairingIOCapability);
@@ -101,33 +113,39 @@ BluetoothManagerService::BluetoothManagerService() :
 	if (mSil)
 	{
 		mSil->registerObserver(this);
+
+		startTime = g_get_monotonic_time();
 		assignDefaultAdapter();
+		getStartupProfiler().record("assignDefaultAdapter", startTime);
 	}
 
 	LS_CREATE_CATEGORY_BEGIN(BluetoothManagerService, adapter)
-		LS_CATEGORY_METHOD(setState)
-		LS_CATEGORY_METHOD(getStatus)
-		LS_CATEGORY_METHOD(queryAvailable)
-		LS_CATEGORY_METHOD(startDiscovery)
-		LS_CATEGORY_METHOD(cancelDiscovery)
-		LS_CATEGORY_METHOD(pair)
-		LS_CATEGORY_METHOD(unpair)
-		LS_CATEGORY_METHOD(supplyPasskey)
-		LS_CATEGORY_METHOD(supplyPinCode)
-		LS_CATEGORY_METHOD(supplyPasskeyConfirmation)
-		LS_CATEGORY_METHOD(cancelPairing)
-		LS_CATEGORY_METHOD(awaitPairingRequests)
+		BT_CATEGORY_METHOD(setState)
+		BT_CATEGORY_METHOD(getStatus)
+		BT_CATEGORY_METHOD(queryAvailable)
+		BT_CATEGORY_METHOD(startDiscovery)
+		BT_CATEGORY_METHOD(cancelDiscovery)
+		BT_CATEGORY_METHOD(pair)
+		BT_CATEGORY_METHOD(unpair)
+		BT_CATEGORY_METHOD(supplyPasskey)
+		BT_CATEGORY_METHOD(supplyPinCode)
+		BT_CATEGORY_METHOD(supplyPasskeyConfirmation)
+		BT_CATEGORY_METHOD(cancelPairing)
+		BT_CATEGORY_METHOD(awaitPairingRequests)
 	LS_CREATE_CATEGORY_END
 
 	LS_CREATE_CATEGORY_BEGIN(BluetoothManagerService, adapter_internal)
-		LS_CATEGORY_METHOD(setWoBle)
-		LS_CATEGORY_METHOD(setWoBleTriggerDevices)
-		LS_CATEGORY_METHOD(getWoBleStatus)
-		LS_CATEGORY_METHOD(sendHciCommand)
-		LS_CATEGORY_METHOD(setTrace)
-		LS_CATEGORY_METHOD(getTraceStatus)
-		LS_CATEGORY_METHOD(setKeepAlive)
-		LS_CATEGORY_METHOD(getKeepAliveStatus)
+		BT_CATEGORY_METHOD(setWoBle)
+		BT_CATEGORY_METHOD(setWoBleTriggerDevices)
+		BT_CATEGORY_METHOD(getWoBleStatus)
+		BT_CATEGORY_METHOD(sendHciCommand)
+		BT_CATEGORY_METHOD(setTrace)
+		BT_CATEGORY_METHOD(getTraceStatus)
+		BT_CATEGORY_METHOD(setKeepAlive)
+		BT_CATEGORY_METHOD(getKeepAliveStatus)
+		BT_CATEGORY_METHOD(setLatencyTracking)
+		BT_CATEGORY_METHOD(getLatencyStatus)
+		BT_CATEGORY_METHOD(setSilRecording)
 		LS_CATEGORY_MAPPED_METHOD(startDiscovery, startFilteringDiscovery)
 	LS_CREATE_CATEGORY_END
 
@@ -137,20 +155,29 @@ BluetoothManagerService::BluetoothManagerService() :
 	LS_CREATE_CATEGORY_END
 
 	LS_CREATE_CATEGORY_BEGIN(BluetoothManagerService, device_internal)
-		LS_CATEGORY_METHOD(getLinkKey)
-		LS_CATEGORY_METHOD(startSniff)
-		LS_CATEGORY_METHOD(stopSniff)
+		BT_CATEGORY_METHOD(getLinkKey)
+		BT_CATEGORY_METHOD(startSniff)
+		BT_CATEGORY_METHOD(stopSniff)
+		BT_CATEGORY_METHOD(getRegistryStatus)
 		LS_CATEGORY_MAPPED_METHOD(getStatus, getFilteringDeviceStatus)
 	LS_CREATE_CATEGORY_END
 
 	LS_CREATE_CATEGORY_BEGIN(BluetoothManagerService, le)
-		LS_CATEGORY_METHOD(configureAdvertisement)
-		LS_CATEGORY_METHOD(startAdvertising)
-		LS_CATEGORY_METHOD(updateAdvertising)
-		LS_CATEGORY_METHOD(stopAdvertising)
-		LS_CATEGORY_METHOD(disableAdvertising)
+		BT_CATEGORY_METHOD(configureAdvertisement)
+		BT_CATEGORY_METHOD(startAdvertising)
+		BT_CATEGORY_METHOD(updateAdvertising)
+		BT_CATEGORY_METHOD(stopAdvertising)
+		BT_CATEGORY_METHOD(disableAdvertising)
 		LS_CATEGORY_MAPPED_METHOD(getStatus, getAdvStatus)
-		LS_CATEGORY_METHOD(startScan)
+		BT_CATEGORY_METHOD(startScan)
+	LS_CREATE_CATEGORY_END
+
+	LS_CREATE_CATEGORY_BEGIN(BluetoothManagerService, internal)
+		BT_CATEGORY_METHOD(getMetrics)
+		BT_CATEGORY_METHOD(setMetricsDump)
+		BT_CATEGORY_METHOD(setWatchdog)
+		LS_CATEGORY_MAPPED_METHOD(getEventTrace, dumpEventTrace)
+		BT_CATEGORY_METHOD(getStartupProfile)
 	LS_CREATE_CATEGORY_END
 
 	registerCategory("/adapter", LS_CATEGORY_TABLE_NAME(adapter), NULL, NULL);
@@ -168,17 +195,24 @@ BluetoothManagerService::BluetoothManagerService() :
 	registerCategory("/le", LS_CATEGORY_TABLE_NAME(le), NULL, NULL);
 	setCategoryData("/le", this);
 
+	registerCategory("/internal", LS_CATEGORY_TABLE_NAME(internal), NULL, NULL);
+	setCategoryData("/internal", this);
+
 	mGetStatusSubscriptions.setServiceHandle(this);
 	mGetDevicesSubscriptions.setServiceHandle(this);
 	mQueryAvailableSubscriptions.setServiceHandle(this);
 	mGetAdvStatusSubscriptions.setServiceHandle(this);
 	mGetKeepAliveStatusSubscriptions.setServiceHandle(this);
+	mGetEventTraceSubscriptions.setServiceHandle(this);
 }
 
 BluetoothManagerService::~BluetoothManagerService()
 {
 	BT_DEBUG("Shutting down bluetooth manager service ...");
 
+	if (mEventTraceStreamTimer)
+		g_source_remove(mEventTraceStreamTimer);
+
 	for (auto profile : mProfiles)
 	{
 		if (profile)
@@ -194,6 +228,13 @@ BluetoothManagerService::~BluetoothManagerService()
 	BluetoothSILFactory::freeSILHandle();
 }
 
+void BluetoothManagerService::registerCategory(const char *category, const LSMethod *methods, const LSSignal *signals, const LSProperty *properties)
+{
+	int64_t startTime = g_get_monotonic_time();
+	LS::Handle::registerCategory(category, methods, signals, properties);
+	getStartupProfiler().record("registerCategory", startTime, category);
+}
+
 bool BluetoothManagerService::isServiceClassEnabled(const std::string &serviceClass)
 {
 	for (auto currentServiceClass : mEnabledServiceClasses)
@@ -416,19 +457,35 @@ void BluetoothManagerService::notifySubscribersFilteredDevicesChanged()
 		std::string senderName = watchIter.first;
 		appendFilteringDevices(senderName, responseObj);
 		responseObj.put("returnValue", true);
-		LSUtils::postToClient(watchIter.second->getMessage(), responseObj);
+
+		std::string payload;
+		LSUtils::generatePayload(responseObj, payload);
+		mRegistryStats.countPayload(payload.size(), 1);
+
+		LS::Message request(watchIter.second->getMessage());
+		LSUtils::postToClient(request, payload);
 	}
 }
 
 void BluetoothManagerService::notifySubscribersDevicesChanged()
 {
+	// Serializing the whole registry is the expensive part, skip it when
+	// nobody is listening
+	unsigned int subscribers = mGetDevicesSubscriptions.getSubscribersCount();
+	if (subscribers == 0)
+		return;
+
 	pbnjson::JValue responseObj = pbnjson::Object();
 
 	appendDevices(responseObj);
 
 	responseObj.put("returnValue", true);
 
-	LSUtils::postToSubscriptionPoint(&mGetDevicesSubscriptions, responseObj);
+	std::string payload;
+	LSUtils::generatePayload(responseObj, payload);
+	mRegistryStats.countPayload(payload.size(), subscribers);
+
+	LSUtils::postToSubscriptionPoint(&mGetDevicesSubscriptions, payload);
 }
 
 void BluetoothManagerService::notifySubscriberLeDevicesChanged()
@@ -458,7 +515,12 @@ void BluetoothManagerService::notifySubscriberLeDevicesChangedbyScanId(uint32_t
 
 	responseObj.put("returnValue", true);
 
-	LSUtils::postToClient(watch->getMessage(), responseObj);
+	std::string payload;
+	LSUtils::generatePayload(responseObj, payload);
+	mRegistryStats.countPayload(payload.size(), 1);
+
+	LS::Message request(watch->getMessage());
+	LSUtils::postToClient(request, payload);
 }
 
 void BluetoothManagerService::notifySubscribersAdvertisingChanged(std::string adapterAddress)
@@ -589,6 +651,9 @@ void BluetoothManagerService::adapterStateChanged(bool powered)
 {
 	BT_INFO("MANAGER_SERVICE", 0, "Observer is called : [%s : %d]", __FUNCTION__, __LINE__);
 
+	BluetoothMainLoopWatchdog::Activity activity("SIL adapterStateChanged");
+	mSilTraceWriter.recordState(BLUETOOTH_SIL_TRACE_EVENT_ADAPTER_STATE_CHANGED, powered);
+
 	if (powered == mPowered)
 		return;
 
@@ -600,6 +665,7 @@ void BluetoothManagerService::adapterStateChanged(bool powered)
 	{
 		bt_ready_msg2kernel();
 		write_kernel_log("[bt_time] mPowered is true ");
+		getStartupProfiler().markPoweredOn();
 	}
 
 	notifySubscribersAboutStateChange();
@@ -615,6 +681,8 @@ void BluetoothManagerService::discoveryStateChanged(bool active)
 {
 	BT_INFO("MANAGER_SERVICE", 0, "Observer is called : [%s : %d] active : %d", __FUNCTION__, __LINE__, active);
 
+	mSilTraceWriter.recordState(BLUETOOTH_SIL_TRACE_EVENT_DISCOVERY_STATE_CHANGED, active);
+
 	if (mDiscovering == active)
 		return;
 
@@ -628,6 +696,7 @@ void BluetoothManagerService::discoveryStateChanged(bool active)
 void BluetoothManagerService::adapterPropertiesChanged(BluetoothPropertiesList properties)
 {
 	BT_DEBUG("Bluetooth adapter properties have changed");
+	mSilTraceWriter.recordDevice(BLUETOOTH_SIL_TRACE_EVENT_ADAPTER_PROPERTIES_CHANGED, 0, "", properties);
 	updateFromAdapterProperties(properties);
 }
 
@@ -812,16 +881,31 @@ void BluetoothManagerService::adapterKeepAliveStateChanged(bool enabled)
 
 void BluetoothManagerService::deviceFound(BluetoothPropertiesList properties)
 {
+	BluetoothDeviceRegistryStats::Measurement measurement(mRegistryStats, BLUETOOTH_DEVICE_REGISTRY_EVENT_DEVICE_FOUND);
+	BluetoothLatencyTracker::Event latencyEvent(&mLatencyTracker, BLUETOOTH_LATENCY_EVENT_DEVICE_FOUND);
+	BluetoothMainLoopWatchdog::Activity activity("SIL deviceFound");
+
+	mSilTraceWriter.recordDevice(BLUETOOTH_SIL_TRACE_EVENT_DEVICE_FOUND, 0, "", properties);
+
 	BluetoothDevice *device = new BluetoothDevice(properties);
 	BT_DEBUG("Found a new device");
 	mDevices.insert(std::pair<std::string, BluetoothDevice*>(device->getAddress(), device));
 
+	::getEventTrace().record(BLUETOOTH_EVENT_TRACE_DEVICE_FOUND, device->getAddress());
+
 	notifySubscribersFilteredDevicesChanged();
 	notifySubscribersDevicesChanged();
 }
 
 void BluetoothManagerService::deviceFound(const std::string &address, BluetoothPropertiesList properties)
 {
+	BluetoothDeviceRegistryStats::Measurement measurement(mRegistryStats, BLUETOOTH_DEVICE_REGISTRY_EVENT_DEVICE_FOUND);
+	BluetoothLatencyTracker::Event latencyEvent(&mLatencyTracker, BLUETOOTH_LATENCY_EVENT_DEVICE_FOUND);
+	BluetoothMainLoopWatchdog::Activity activity("SIL deviceFound");
+
+	mSilTraceWriter.recordDevice(BLUETOOTH_SIL_TRACE_EVENT_DEVICE_FOUND, 0, address, properties);
+	::getEventTrace().record(BLUETOOTH_EVENT_TRACE_DEVICE_FOUND, address);
+
     auto device = findDevice(address);
     if (!device) {
         BluetoothDevice *device = new BluetoothDevice(properties);
@@ -837,33 +921,54 @@ void BluetoothManagerService::deviceFound(const std::string &address, BluetoothP
 
 void BluetoothManagerService::devicePropertiesChanged(const std::string &address, BluetoothPropertiesList properties)
 {
+	BluetoothDeviceRegistryStats::Measurement measurement(mRegistryStats, BLUETOOTH_DEVICE_REGISTRY_EVENT_DEVICE_PROPERTIES_CHANGED);
+	BluetoothMainLoopWatchdog::Activity activity("SIL devicePropertiesChanged");
+
 	BT_DEBUG("Properties of device %s have changed", address.c_str());
 
+	mSilTraceWriter.recordDevice(BLUETOOTH_SIL_TRACE_EVENT_DEVICE_PROPERTIES_CHANGED, 0, address, properties);
+
 	auto device = findDevice(address);
+	bool wasPaired = device && device->getPaired();
 	if (device && device->update(properties))
 	{
 		notifySubscribersFilteredDevicesChanged();
 		notifySubscribersDevicesChanged();
 	}
+
+	if (wasPaired && !device->getPaired())
+		notifyDeviceUnpaired(address);
 }
 
 void BluetoothManagerService::deviceRemoved(const std::string &address)
 {
+	BluetoothDeviceRegistryStats::Measurement measurement(mRegistryStats, BLUETOOTH_DEVICE_REGISTRY_EVENT_DEVICE_REMOVED);
+	BluetoothMainLoopWatchdog::Activity activity("SIL deviceRemoved");
+
 	BT_DEBUG("Device %s has disappeared", address.c_str());
 
+	mSilTraceWriter.recordDevice(BLUETOOTH_SIL_TRACE_EVENT_DEVICE_REMOVED, 0, address);
+
 	auto deviceIter = mDevices.find(address);
 	if (deviceIter == mDevices.end())
 		return;
 
 	BluetoothDevice *device = deviceIter->second;
+	bool wasPaired = device->getPaired();
 	mDevices.erase(deviceIter);
 	delete device;
+
+	if (wasPaired)
+		notifyDeviceUnpaired(address);
+
 	notifySubscribersFilteredDevicesChanged();
 	notifySubscribersDevicesChanged();
 }
 
 void BluetoothManagerService::leDeviceFound(const std::string &address, BluetoothPropertiesList properties)
 {
+	mSilTraceWriter.recordDevice(BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_FOUND, 0, address, properties);
+
 	auto device = findLeDevice(address);
 	if (!device)
 	{
@@ -883,6 +988,8 @@ void BluetoothManagerService::leDevicePropertiesChanged(const std::string &addre
 {
 	BT_DEBUG("Properties of device %s have changed", address.c_str());
 
+	mSilTraceWriter.recordDevice(BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_PROPERTIES_CHANGED, 0, address, properties);
+
 	auto device = findLeDevice(address);
 	if (device && device->update(properties))
 		notifySubscriberLeDevicesChanged();
@@ -892,6 +999,8 @@ void BluetoothManagerService::leDeviceRemoved(const std::string &address)
 {
 	BT_DEBUG("Device %s has disappeared", address.c_str());
 
+	mSilTraceWriter.recordDevice(BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_REMOVED, 0, address);
+
 	auto deviceIter = mLeDevices.find(address);
 	if (deviceIter == mLeDevices.end())
 		return;
@@ -905,6 +1014,11 @@ void BluetoothManagerService::leDeviceRemoved(const std::string &address)
 
 void BluetoothManagerService::leDeviceFoundByScanId(uint32_t scanId, BluetoothPropertiesList properties)
 {
+	BluetoothDeviceRegistryStats::Measurement measurement(mRegistryStats, BLUETOOTH_DEVICE_REGISTRY_EVENT_LE_DEVICE_FOUND_BY_SCAN_ID);
+	BluetoothMainLoopWatchdog::Activity activity("SIL leDeviceFoundByScanId");
+
+	mSilTraceWriter.recordDevice(BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_FOUND_BY_SCAN_ID, scanId, "", properties);
+
 	BluetoothDevice *device = new BluetoothDevice(properties);
 	BT_DEBUG("Found a new LE device by %d", scanId);
 
@@ -924,8 +1038,13 @@ void BluetoothManagerService::leDeviceFoundByScanId(uint32_t scanId, BluetoothPr
 
 void BluetoothManagerService::leDevicePropertiesChangedByScanId(uint32_t scanId, const std::string &address, BluetoothPropertiesList properties)
 {
+	BluetoothDeviceRegistryStats::Measurement measurement(mRegistryStats, BLUETOOTH_DEVICE_REGISTRY_EVENT_LE_DEVICE_PROPERTIES_CHANGED_BY_SCAN_ID);
+	BluetoothMainLoopWatchdog::Activity activity("SIL leDevicePropertiesChangedByScanId");
+
 	BT_DEBUG("Properties of device %s have changed by %d", address.c_str(), scanId);
 
+	mSilTraceWriter.recordDevice(BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_PROPERTIES_CHANGED_BY_SCAN_ID, scanId, address, properties);
+
 	auto devicesIter = mLeDevicesByScanId.find(scanId);
 	if (devicesIter == mLeDevicesByScanId.end())
 		return;
@@ -945,6 +1064,8 @@ void BluetoothManagerService::leDeviceRemovedByScanId(uint32_t scanId, const std
 {
 	BT_DEBUG("Device %s has disappeared in %d", address.c_str(), scanId);
 
+	mSilTraceWriter.recordDevice(BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_REMOVED_BY_SCAN_ID, scanId, address);
+
 	auto devicesIter = mLeDevicesByScanId.find(scanId);
 	if (devicesIter == mLeDevicesByScanId.end())
 		return;
@@ -3326,6 +3447,790 @@ bool BluetoothManagerService::getKeepAliveStatus(LSMessage &message)
 	return true;
 }
 
+/**
+Enable or disable tracking the latency from SIL callbacks to the Luna payloads they cause.
+
+The latency of deviceFound, characteristicValueChanged and dataReceived is taken from the
+SIL callback to the post of its payload. SPP data queued for /spp/readData is sampled when
+it is read, data for a binary socket when it is handed to the socket. Enabling the tracking
+also starts the main loop watchdog if it is not running, disabling it stops the watchdog again.
+
+@par Parameters
+
+Name | Required | Type | Description
+-----|--------|------|----------
+enabled | Yes | Boolean | Value is true to track the latency, false to stop tracking it
+reset | No | Boolean | If true, the samples collected so far are dropped
+adapterAddress | No | String | Address of the adapter executing this method. If not specified, the default adapter will be used.
+
+@par Returns(Call)
+
+Name | Required | Type | Description
+-----|--------|------|----------
+returnValue | Yes | Boolean | Value is true if the tracking was changed, false otherwise.
+adapterAddress | Yes | String | Address of the adapter executing this method
+enabled | Yes | Boolean | Value is true while the latency is tracked
+errorText | No | String | errorText contains the error text if the method fails. The method will return errorText only if it fails.
+errorCode | No | Number | errorCode contains the error code if the method fails. The method will return errorCode only if it fails.
+
+@par Returns(Subscription)
+
+Not applicable
+*/
+bool BluetoothManagerService::setLatencyTracking(LSMessage &message)
+{
+	BT_INFO("MANAGER_SERVICE", 0, "Luna API is called : [%s : %d]", __FUNCTION__, __LINE__);
+
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	const std::string schema = STRICT_SCHEMA(PROPS_3(PROP(adapterAddress, string), PROP(enabled, boolean), PROP(reset, boolean)) REQUIRED_1(enabled));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	std::string adapterAddress;
+	if (!isRequestedAdapterAvailable(request, requestObj, adapterAddress))
+		return true;
+
+	if (requestObj.hasKey("reset") && requestObj["reset"].asBool())
+		mLatencyTracker.reset();
+
+	mLatencyTracker.setEnabled(requestObj["enabled"].asBool());
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("adapterAddress", adapterAddress);
+	responseObj.put("enabled", mLatencyTracker.isEnabled());
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+/**
+Return the latency tracked since /adapter/internal/setLatencyTracking was enabled.
+
+@par Parameters
+
+Name | Required | Type | Description
+-----|--------|------|----------
+adapterAddress | No | String | Address of the adapter executing this method. If not specified, the default adapter will be used.
+
+@par Returns(Call)
+
+Name | Required | Type | Description
+-----|--------|------|----------
+returnValue | Yes | Boolean | Value is true if the status was returned, false otherwise.
+adapterAddress | Yes | String | Address of the adapter executing this method
+enabled | Yes | Boolean | Value is true while the latency is tracked
+maxStall | No | Number | Longest main loop stall in microseconds. Only returned while the main loop watchdog runs.
+events | Yes | Object array | Per event "deviceFound", "characteristicValueChanged" and "dataReceived": the sample count and the p50, p99, p999 and max latency in microseconds
+errorText | No | String | errorText contains the error text if the method fails. The method will return errorText only if it fails.
+errorCode | No | Number | errorCode contains the error code if the method fails. The method will return errorCode only if it fails.
+
+@par Returns(Subscription)
+
+Not applicable
+*/
+bool BluetoothManagerService::getLatencyStatus(LSMessage &message)
+{
+	BT_INFO("MANAGER_SERVICE", 0, "Luna API is called : [%s : %d]", __FUNCTION__, __LINE__);
+
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, STRICT_SCHEMA(PROPS_1(PROP(adapterAddress, string))), &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	std::string adapterAddress;
+	if (!isRequestedAdapterAvailable(request, requestObj, adapterAddress))
+		return true;
+
+	pbnjson::JValue eventsObj = pbnjson::Array();
+	for (int event = 0; event < BLUETOOTH_LATENCY_EVENT_MAX; event++)
+	{
+		BluetoothLatencyEvent latencyEvent = (BluetoothLatencyEvent) event;
+
+		pbnjson::JValue eventObj = pbnjson::Object();
+		eventObj.put("event", BluetoothLatencyTracker::eventToString(latencyEvent));
+		eventObj.put("count", (int64_t) mLatencyTracker.getCount(latencyEvent));
+		eventObj.put("p50", (int64_t) mLatencyTracker.getPercentile(latencyEvent, 500));
+		eventObj.put("p99", (int64_t) mLatencyTracker.getPercentile(latencyEvent, 990));
+		eventObj.put("p999", (int64_t) mLatencyTracker.getPercentile(latencyEvent, 999));
+		eventObj.put("max", (int64_t) mLatencyTracker.getMax(latencyEvent));
+		eventsObj.append(eventObj);
+	}
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("adapterAddress", adapterAddress);
+	responseObj.put("enabled", mLatencyTracker.isEnabled());
+	// Only a running watchdog measures stalls
+	if (getMainLoopWatchdog().isEnabled())
+		responseObj.put("maxStall", (int64_t) getMainLoopWatchdog().getMaxStall());
+	responseObj.put("events", eventsObj);
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+/**
+Start or stop recording the SIL callbacks the service receives.
+
+The adapter, device, GATT connection, service, characteristic value and SPP callbacks are
+written to a binary trace in WEBOS_BLUETOOTH_TRACE_DIR, which the virtual controller SIL
+replays through its ReplayTrace setting. Pairing and the HID, A2DP, AVRCP, PAN, OPP, FTP
+and MAP callbacks are not recorded.
+
+@par Parameters
+
+Name | Required | Type | Description
+-----|--------|------|----------
+enabled | Yes | Boolean | Value is true to start recording, false to close the trace
+fileName | No | String | Name of the trace in the trace directory, without a directory. Required if enabled is true.
+adapterAddress | No | String | Address of the adapter executing this method. If not specified, the default adapter will be used.
+
+@par Returns(Call)
+
+Name | Required | Type | Description
+-----|--------|------|----------
+returnValue | Yes | Boolean | Value is true if the recording was changed, false otherwise.
+adapterAddress | Yes | String | Address of the adapter executing this method
+enabled | Yes | Boolean | Value is true while a trace is recorded
+path | Yes | String | Path of the trace recorded last
+records | Yes | Number | Number of callbacks written to the trace
+size | Yes | Number | Size of the trace in bytes
+errorText | No | String | errorText contains the error text if the method fails. The method will return errorText only if it fails.
+errorCode | No | Number | errorCode contains the error code if the method fails. The method will return errorCode only if it fails.
+
+@par Returns(Subscription)
+
+Not applicable
+*/
+bool BluetoothManagerService::setSilRecording(LSMessage &message)
+{
+	BT_INFO("MANAGER_SERVICE", 0, "Luna API is called : [%s : %d]", __FUNCTION__, __LINE__);
+
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	const std::string schema = STRICT_SCHEMA(PROPS_3(PROP(adapterAddress, string), PROP(enabled, boolean), PROP(fileName, string)) REQUIRED_1(enabled));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	std::string adapterAddress;
+	if (!isRequestedAdapterAvailable(request, requestObj, adapterAddress))
+		return true;
+
+	if (requestObj["enabled"].asBool())
+	{
+		if (!requestObj.hasKey("fileName"))
+		{
+			LSUtils::respondWithError(request, BT_ERR_FILE_NAME_PARAM_MISSING);
+			return true;
+		}
+
+		std::string fileName = requestObj["fileName"].asString();
+		if (!isPlainFileName(fileName))
+		{
+			LSUtils::respondWithError(request, BT_ERR_INVALID_FILE_NAME);
+			return true;
+		}
+
+		if (!mSilTraceWriter.open(fileName))
+		{
+			LSUtils::respondWithError(request, BT_ERR_SIL_RECORDING_OPEN_FAIL);
+			return true;
+		}
+	}
+	else
+	{
+		mSilTraceWriter.close();
+	}
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("adapterAddress", adapterAddress);
+	responseObj.put("enabled", mSilTraceWriter.isOpen());
+	responseObj.put("path", mSilTraceWriter.getPath());
+	responseObj.put("records", (int64_t) mSilTraceWriter.getRecordCount());
+	responseObj.put("size", (int64_t) mSilTraceWriter.getSize());
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+/**
+Return the call metrics of every Luna method, per method and per calling application.
+
+@par Parameters
+
+Name | Required | Type | Description
+-----|--------|------|----------
+reset | No | Boolean | If true, the metrics and the main loop stalls are cleared after they were returned
+
+@par Returns(Call)
+
+Name | Required | Type | Description
+-----|--------|------|----------
+returnValue | Yes | Boolean | Value is true if the metrics were returned, false otherwise.
+histogramBuckets | Yes | String array | Names of the latency histogram buckets
+methods | Yes | Object array | Per method: method, calls, errors, totalTime, maxTime and cpuTime of the handlers in microseconds, histogram and the same values per caller in callers
+dumping | Yes | Boolean | Value is true while the metrics are written to a file by /internal/setMetricsDump
+dumpPath | No | String | File the metrics are written to. Only returned while dumping.
+dumpInterval | No | Number | Seconds between two writes of the file. Only returned while dumping.
+mainLoop | Yes | Object | State of the main loop watchdog: watchdogEnabled, threshold in milliseconds, maxStall in microseconds, stallCount and the longest stalls in stalls
+errorText | No | String | errorText contains the error text if the method fails. The method will return errorText only if it fails.
+errorCode | No | Number | errorCode contains the error code if the method fails. The method will return errorCode only if it fails.
+
+@par Returns(Subscription)
+
+Not applicable
+*/
+bool BluetoothManagerService::getMetrics(LSMessage &message)
+{
+	BT_INFO("MANAGER_SERVICE", 0, "Luna API is called : [%s : %d]", __FUNCTION__, __LINE__);
+
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, STRICT_SCHEMA(PROPS_1(PROP(reset, boolean))), &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	LSUtils::MethodMetrics &metrics = LSUtils::getMethodMetrics();
+	BluetoothMainLoopWatchdog &watchdog = getMainLoopWatchdog();
+
+	pbnjson::JValue stallsObj = pbnjson::Array();
+	for (auto stall : watchdog.getStalls())
+	{
+		pbnjson::JValue stallObj = pbnjson::Object();
+		stallObj.put("duration", (int64_t) stall.duration);
+		stallObj.put("time", (int64_t) (stall.time / 1000));
+		stallObj.put("activity", stall.activity);
+		stallObj.put("activityDuration", (int64_t) stall.activityDuration);
+		stallsObj.append(stallObj);
+	}
+
+	pbnjson::JValue mainLoopObj = pbnjson::Object();
+	mainLoopObj.put("watchdogEnabled", watchdog.isEnabled());
+	mainLoopObj.put("threshold", (int32_t) watchdog.getThreshold());
+	mainLoopObj.put("maxStall", (int64_t) watchdog.getMaxStall());
+	mainLoopObj.put("stallCount", (int64_t) watchdog.getStallCount());
+	mainLoopObj.put("stalls", stallsObj);
+
+	pbnjson::JValue responseObj = metrics.toJson();
+	responseObj.put("returnValue", true);
+	responseObj.put("dumping", metrics.isDumping());
+	if (metrics.isDumping())
+	{
+		responseObj.put("dumpPath", metrics.getDumpPath());
+		responseObj.put("dumpInterval", (int32_t) metrics.getDumpInterval());
+	}
+	responseObj.put("mainLoop", mainLoopObj);
+
+	if (requestObj.hasKey("reset") && requestObj["reset"].asBool())
+	{
+		metrics.reset();
+		watchdog.reset();
+	}
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+/**
+Start or stop writing the output of /internal/getMetrics to a file in WEBOS_BLUETOOTH_TRACE_DIR.
+
+@par Parameters
+
+Name | Required | Type | Description
+-----|--------|------|----------
+enabled | Yes | Boolean | Value is true to write the metrics periodically, false to stop writing them
+fileName | No | String | Name of the file in the trace directory, without a directory. Required if enabled is true.
+interval | No | Number | Seconds between two writes of the file, 60 by default
+
+@par Returns(Call)
+
+Name | Required | Type | Description
+-----|--------|------|----------
+returnValue | Yes | Boolean | Value is true if the dump was changed, false otherwise.
+dumping | Yes | Boolean | Value is true while the metrics are written to a file
+dumpPath | No | String | File the metrics are written to. Only returned while dumping.
+dumpInterval | No | Number | Seconds between two writes of the file. Only returned while dumping.
+errorText | No | String | errorText contains the error text if the method fails. The method will return errorText only if it fails.
+errorCode | No | Number | errorCode contains the error code if the method fails. The method will return errorCode only if it fails.
+
+@par Returns(Subscription)
+
+Not applicable
+*/
+bool BluetoothManagerService::setMetricsDump(LSMessage &message)
+{
+	BT_INFO("MANAGER_SERVICE", 0, "Luna API is called : [%s : %d]", __FUNCTION__, __LINE__);
+
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	const std::string schema = STRICT_SCHEMA(PROPS_3(PROP(enabled, boolean), PROP(fileName, string), PROP(interval, integer)) REQUIRED_1(enabled));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	LSUtils::MethodMetrics &metrics = LSUtils::getMethodMetrics();
+
+	if (requestObj["enabled"].asBool())
+	{
+		if (!requestObj.hasKey("fileName"))
+		{
+			LSUtils::respondWithError(request, BT_ERR_FILE_NAME_PARAM_MISSING);
+			return true;
+		}
+
+		std::string fileName = requestObj["fileName"].asString();
+		if (!isPlainFileName(fileName))
+		{
+			LSUtils::respondWithError(request, BT_ERR_INVALID_FILE_NAME);
+			return true;
+		}
+
+		int interval = METRICS_DUMP_DEFAULT_INTERVAL;
+		if (requestObj.hasKey("interval"))
+			interval = requestObj["interval"].asNumber<int32_t>();
+
+		if (interval < 1)
+		{
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+			return true;
+		}
+
+		if (!metrics.startDump(fileName, interval))
+		{
+			LSUtils::respondWithError(request, BT_ERR_METRICS_DUMP_FAIL);
+			return true;
+		}
+	}
+	else
+	{
+		metrics.stopDump();
+	}
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("dumping", metrics.isDumping());
+	if (metrics.isDumping())
+	{
+		responseObj.put("dumpPath", metrics.getDumpPath());
+		responseObj.put("dumpInterval", (int32_t) metrics.getDumpInterval());
+	}
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+/**
+Start or stop the main loop watchdog.
+
+The watchdog runs a 10 ms heartbeat on the main loop. A heartbeat late by threshold
+milliseconds or more is logged as a stall, naming the longest Luna method or SIL callback
+that ran since the previous heartbeat. The longest stalls are reported under mainLoop by
+/internal/getMetrics.
+
+@par Parameters
+
+Name | Required | Type | Description
+-----|--------|------|----------
+enabled | Yes | Boolean | Value is true to start the watchdog, false to stop it
+threshold | No | Number | Delay of a heartbeat in milliseconds from which it is logged as a stall, 50 by default
+reset | No | Boolean | If true, the stalls recorded so far are cleared
+
+@par Returns(Call)
+
+Name | Required | Type | Description
+-----|--------|------|----------
+returnValue | Yes | Boolean | Value is true if the watchdog was changed, false otherwise.
+enabled | Yes | Boolean | Value is true while the watchdog runs
+threshold | Yes | Number | Delay of a heartbeat in milliseconds from which it is logged as a stall
+errorText | No | String | errorText contains the error text if the method fails. The method will return errorText only if it fails.
+errorCode | No | Number | errorCode contains the error code if the method fails. The method will return errorCode only if it fails.
+
+@par Returns(Subscription)
+
+Not applicable
+*/
+bool BluetoothManagerService::setWatchdog(LSMessage &message)
+{
+	BT_INFO("MANAGER_SERVICE", 0, "Luna API is called : [%s : %d]", __FUNCTION__, __LINE__);
+
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	const std::string schema = STRICT_SCHEMA(PROPS_3(PROP(enabled, boolean), PROP(threshold, integer), PROP(reset, boolean)) REQUIRED_1(enabled));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	BluetoothMainLoopWatchdog &watchdog = getMainLoopWatchdog();
+
+	if (requestObj.hasKey("threshold"))
+	{
+		int threshold = requestObj["threshold"].asNumber<int32_t>();
+		if (threshold < 1)
+		{
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+			return true;
+		}
+
+		watchdog.setThreshold(threshold);
+	}
+
+	if (requestObj.hasKey("reset") && requestObj["reset"].asBool())
+		watchdog.reset();
+
+	watchdog.setEnabled(requestObj["enabled"].asBool());
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("enabled", watchdog.isEnabled());
+	responseObj.put("threshold", (int32_t) watchdog.getThreshold());
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+static pbnjson::JValue eventTraceEntriesToJson(const std::vector<BluetoothEventTraceEntry> &entries)
+{
+	static const uint8_t noAddress[6] = { 0, 0, 0, 0, 0, 0 };
+
+	pbnjson::JValue entriesObj = pbnjson::Array();
+	for (auto entry : entries)
+	{
+		pbnjson::JValue entryObj = pbnjson::Object();
+		entryObj.put("type", BluetoothEventTrace::typeToString(entry.type));
+		entryObj.put("timestamp", (int64_t) entry.timestamp);
+		if (memcmp(entry.address, noAddress, sizeof(noAddress)))
+			entryObj.put("address", BluetoothEventTrace::addressToString(entry.address));
+		entryObj.put("handle", (int64_t) entry.handle);
+		entryObj.put("size", (int64_t) entry.size);
+		entryObj.put("latency", (int64_t) entry.latency);
+		entriesObj.append(entryObj);
+	}
+
+	return entriesObj;
+}
+
+/**
+Return the last entries of the event trace ring.
+
+Device discovery, GATT notifications and completed GATT operations, HID sendData and SPP
+reads and writes are always recorded in an in-memory ring of the last 4096 events.
+
+@par Parameters
+
+Name | Required | Type | Description
+-----|--------|------|----------
+count | No | Number | Number of the most recent entries to return, 0 to 4096. All entries in the ring by default.
+subscribe | No | Boolean | If true, the entries recorded after this call are posted every second
+
+@par Returns(Call)
+
+Name | Required | Type | Description
+-----|--------|------|----------
+returnValue | Yes | Boolean | Value is true if the entries were returned, false otherwise.
+subscribed | Yes | Boolean | Value is false if the caller does not subscribe this method.
+recorded | Yes | Number | Number of entries recorded since the service started
+dropped | Yes | Number | Number of the requested entries that were overwritten before they were read
+entries | Yes | Object array | Per entry: type, monotonic timestamp in microseconds, address of the device if any, GATT handle or SPP channel in handle, size of the data and latency in microseconds
+errorText | No | String | errorText contains the error text if the method fails. The method will return errorText only if it fails.
+errorCode | No | Number | errorCode contains the error code if the method fails. The method will return errorCode only if it fails.
+
+@par Returns(Subscription)
+
+As for a successful call, with the entries recorded since the previous post
+*/
+bool BluetoothManagerService::dumpEventTrace(LSMessage &message)
+{
+	BT_INFO("MANAGER_SERVICE", 0, "Luna API is called : [%s : %d]", __FUNCTION__, __LINE__);
+
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+	bool subscribed = false;
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, STRICT_SCHEMA(PROPS_2(PROP(count, integer), PROP(subscribe, boolean))), &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	int count = EVENT_TRACE_SIZE;
+	if (requestObj.hasKey("count"))
+	{
+		count = requestObj["count"].asNumber<int32_t>();
+		if (count < 0 || count > EVENT_TRACE_SIZE)
+		{
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+			return true;
+		}
+	}
+
+	BluetoothEventTrace &trace = getEventTrace();
+	uint64_t position = trace.getPosition();
+	uint64_t since = position > (uint64_t) count ? position - count : 0;
+
+	std::vector<BluetoothEventTraceEntry> entries;
+	uint64_t dropped = 0;
+	position = trace.snapshot(since, entries, dropped);
+
+	if (request.isSubscription())
+	{
+		mGetEventTraceSubscriptions.subscribe(request);
+		subscribed = true;
+
+		// Subscribers get everything recorded after this response
+		if (!mEventTraceStreamTimer)
+		{
+			mEventTraceStreamPosition = position;
+			mEventTraceStreamTimer = g_timeout_add_seconds(EVENT_TRACE_STREAM_INTERVAL,
+			                                               &BluetoothManagerService::handleEventTraceStream, this);
+		}
+	}
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("subscribed", subscribed);
+	responseObj.put("recorded", (int64_t) position);
+	responseObj.put("dropped", (int64_t) dropped);
+	responseObj.put("entries", eventTraceEntriesToJson(entries));
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+gboolean BluetoothManagerService::handleEventTraceStream(gpointer userData)
+{
+	BluetoothManagerService *service = static_cast<BluetoothManagerService*>(userData);
+
+	if (!service->mGetEventTraceSubscriptions.getSubscribersCount())
+	{
+		service->mEventTraceStreamTimer = 0;
+		return FALSE;
+	}
+
+	BluetoothEventTrace &trace = getEventTrace();
+	if (trace.getPosition() == service->mEventTraceStreamPosition)
+		return TRUE;
+
+	std::vector<BluetoothEventTraceEntry> entries;
+	uint64_t dropped = 0;
+	service->mEventTraceStreamPosition = trace.snapshot(service->mEventTraceStreamPosition, entries, dropped);
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("subscribed", true);
+	responseObj.put("recorded", (int64_t) service->mEventTraceStreamPosition);
+	responseObj.put("dropped", (int64_t) dropped);
+	responseObj.put("entries", eventTraceEntriesToJson(entries));
+
+	LSUtils::postToSubscriptionPoint(&service->mGetEventTraceSubscriptions, responseObj);
+
+	return TRUE;
+}
+
+/**
+Return the time the steps of the service startup took.
+
+The steps are the option parsing, creating the profiles, loading the SIL (dlopen) and
+creating it (createBluetoothSIL), assigning the default adapter and registering each Luna
+category. Once the service is on the bus the same times go to the kernel log in a
+"[bt_time] startup ..." line, the first adapter power on adds a "[bt_time] first power on ..." line.
+
+@par Parameters
+
+None
+
+@par Returns(Call)
+
+Name | Required | Type | Description
+-----|--------|------|----------
+returnValue | Yes | Boolean | Value is true if the profile was returned, false otherwise.
+startTime | Yes | Number | Monotonic time of the start of main() in microseconds
+readyTime | Yes | Number | Microseconds from the start of main() until the service was on the bus
+poweredOnTime | No | Number | Microseconds from the start of main() until the adapter was first powered on. Only returned once it was powered on.
+phases | Yes | Object array | Per step: name, category for the registration of a Luna category, start and duration in microseconds since the start of main()
+errorText | No | String | errorText contains the error text if the method fails. The method will return errorText only if it fails.
+errorCode | No | Number | errorCode contains the error code if the method fails. The method will return errorCode only if it fails.
+
+@par Returns(Subscription)
+
+Not applicable
+*/
+bool BluetoothManagerService::getStartupProfile(LSMessage &message)
+{
+	BT_INFO("MANAGER_SERVICE", 0, "Luna API is called : [%s : %d]", __FUNCTION__, __LINE__);
+
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, STRICT_SCHEMA(), &parseError))
+	{
+		if (parseError != JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	BluetoothStartupProfiler &profiler = getStartupProfiler();
+
+	pbnjson::JValue phasesObj = pbnjson::Array();
+	for (auto phase : profiler.getPhases())
+	{
+		pbnjson::JValue phaseObj = pbnjson::Object();
+		phaseObj.put("name", phase.name);
+		if (!phase.detail.empty())
+			phaseObj.put("category", phase.detail);
+		phaseObj.put("start", (int64_t) phase.start);
+		phaseObj.put("duration", (int64_t) phase.duration);
+		phasesObj.append(phaseObj);
+	}
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("startTime", (int64_t) profiler.getStartTime());
+	responseObj.put("readyTime", (int64_t) profiler.getReadyTime());
+	if (profiler.getPoweredOnTime())
+		responseObj.put("poweredOnTime", (int64_t) profiler.getPoweredOnTime());
+	responseObj.put("phases", phasesObj);
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
+bool BluetoothManagerService::getRegistryStatus(LSMessage &message)
+{
+	BT_INFO("MANAGER_SERVICE", 0, "Luna API is called : [%s : %d]", __FUNCTION__, __LINE__);
+
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, STRICT_SCHEMA(PROPS_2(PROP(adapterAddress, string), PROP(reset, boolean))), &parseError))
+	{
+		if (parseError == JSON_PARSE_SCHEMA_ERROR)
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+		else
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+
+		return true;
+	}
+
+	std::string adapterAddress;
+	if (!isRequestedAdapterAvailable(request, requestObj, adapterAddress))
+		return true;
+
+	pbnjson::JValue eventsObj = pbnjson::Array();
+	for (int event = 0; event < BLUETOOTH_DEVICE_REGISTRY_EVENT_MAX; event++)
+	{
+		const BluetoothDeviceRegistryEventStats &stats = mRegistryStats.getEventStats((BluetoothDeviceRegistryEvent) event);
+
+		pbnjson::JValue eventObj = pbnjson::Object();
+		eventObj.put("event", BluetoothDeviceRegistryStats::eventToString((BluetoothDeviceRegistryEvent) event));
+		eventObj.put("count", (int64_t) stats.count);
+		eventObj.put("cpuTime", (int64_t) stats.cpuTime);
+		eventObj.put("maxCpuTime", (int64_t) stats.maxCpuTime);
+		eventObj.put("notifications", (int64_t) stats.notifications);
+		eventObj.put("bytes", (int64_t) stats.bytes);
+		if (stats.count > 0)
+		{
+			eventObj.put("cpuTimePerEvent", (int64_t) (stats.cpuTime / stats.count));
+			eventObj.put("bytesPerEvent", (int64_t) (stats.bytes / stats.count));
+		}
+		eventsObj.append(eventObj);
+	}
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("adapterAddress", adapterAddress);
+	responseObj.put("devices", (int32_t) mDevices.size());
+	responseObj.put("leDevices", (int32_t) mLeDevices.size());
+	responseObj.put("devicesSubscribers", (int32_t) mGetDevicesSubscriptions.getSubscribersCount());
+	responseObj.put("filteredDevicesSubscribers", (int32_t) mGetDevicesWatches.size());
+	responseObj.put("scanSubscribers", (int32_t) mStartScanWatches.size());
+	responseObj.put("events", eventsObj);
+
+	// Reset after reporting so consecutive runs of a load test each get
+	// their own numbers
+	if (requestObj.hasKey("reset") && requestObj["reset"].asBool())
+		mRegistryStats.reset();
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
 void BluetoothManagerService::requestPairingSecret(const std::string &address, BluetoothPairingSecretType type)
 {
 	pbnjson::JValue responseObj = pbnjson::Object();
@@ -4889,4 +5794,17 @@ void BluetoothManagerService::leConnectionRequest(const std::string &address, bo
 	}
 }
 
+void BluetoothManagerService::notifyDeviceUnpaired(const std::string &address)
+{
+	for (auto profile : mProfiles)
+	{
+		if (profile->getName() == "GATT")
+		{
+			auto gattProfile = dynamic_cast<BluetoothGattProfileService *>(profile);
+			if (gattProfile)
+				gattProfile->deviceUnpaired(address);
+		}
+	}
+}
+
 // vim: noai:ts=4:sw=4:ss=4:expandtab
@@ -27,6 +27,9 @@
 #include <luna-service2/lunaservice.hpp>
 #include <bluetooth-sil-api.h>
 #include "bluetoothpairstate.h"
+#include "bluetoothdeviceregistrystats.h"
+#include "bluetoothlatencytracker.h"
+#include "bluetoothsiltracewriter.h"
 
 class BluetoothProfileService;
 class BluetoothDevice;
@@ -96,13 +99,20 @@ public:
 	void displayPairingConfirmation(const std::string &address, BluetoothPasskey passkey);
 	void pairingCanceled();
 	void leConnectionRequest(const std::string &address, bool state);
+	void notifyDeviceUnpaired(const std::string &address);
 	void requestReset();
 
 	bool isDefaultAdapterAvailable() const;
 	bool isDeviceAvailable(const std::string &address) const;
 	BluetoothAdapter* getDefaultAdapter() const;
+	BluetoothLatencyTracker* getLatencyTracker() { return &mLatencyTracker; }
+	BluetoothSilTraceWriter* getSilTraceWriter() { return &mSilTraceWriter; }
 	std::string getAddress() const;
 
+	// Hides LS::Handle::registerCategory so the registration of every
+	// category, including those of the profiles, is timed at startup
+	void registerCategory(const char *category, const LSMethod *methods, const LSSignal *signals, const LSProperty *properties);
+
 	void initializeProfiles();
 	void resetProfiles();
 
@@ -148,8 +158,17 @@ private:
 	bool getLinkKey(LSMessage &message);
 	bool setKeepAlive(LSMessage &message);
 	bool getKeepAliveStatus(LSMessage &message);
+	bool setLatencyTracking(LSMessage &message);
+	bool getLatencyStatus(LSMessage &message);
+	bool setSilRecording(LSMessage &message);
+	bool getMetrics(LSMessage &message);
+	bool setMetricsDump(LSMessage &message);
+	bool setWatchdog(LSMessage &message);
+	bool dumpEventTrace(LSMessage &message);
+	bool getStartupProfile(LSMessage &message);
 	bool startSniff(LSMessage &message);
 	bool stopSniff(LSMessage &message);
+	bool getRegistryStatus(LSMessage &message);
 
 
 #ifdef WBS_UPDATE_FIRMWARE
@@ -218,6 +237,8 @@ private:
 	bool getAdvStatus(LSMessage &message);
 	bool startScan(LSMessage &message);
 private:
+	static gboolean handleEventTraceStream(gpointer userData);
+
 	std::vector<BluetoothProfileService*> mProfiles;
 	std::string mName;
 	std::string mAddress;
@@ -259,10 +280,16 @@ private:
 	LS::SubscriptionPoint mGetDevicesSubscriptions;
 	LS::SubscriptionPoint mQueryAvailableSubscriptions;
 	LS::SubscriptionPoint mGetKeepAliveStatusSubscriptions;
+	LS::SubscriptionPoint mGetEventTraceSubscriptions;
+	guint mEventTraceStreamTimer;
+	uint64_t mEventTraceStreamPosition;
 
 	std::unordered_map<std::string, LSUtils::ClientWatch*> mGetDevicesWatches;
 	std::unordered_map<uint32_t, LSUtils::ClientWatch*> mStartScanWatches;
 	BluetoothGattAncsProfile *mGattAnsc;
+	BluetoothDeviceRegistryStats mRegistryStats;
+	BluetoothLatencyTracker mLatencyTracker;
+	BluetoothSilTraceWriter mSilTraceWriter;
 };
 
 #endif
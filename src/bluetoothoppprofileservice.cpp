@@ -43,9 +43,9 @@ BluetoothOppProfileService::BluetoothOppProfileService(BluetoothManagerService *
         mNextRequestId(1)
 {
 	LS_CREATE_CATEGORY_BEGIN(BluetoothProfileService, base)
-		LS_CATEGORY_METHOD(connect)
-		LS_CATEGORY_METHOD(disconnect)
-		LS_CATEGORY_METHOD(getStatus)
+		BT_CATEGORY_METHOD(connect)
+		BT_CATEGORY_METHOD(disconnect)
+		BT_CATEGORY_METHOD(getStatus)
 		LS_CATEGORY_CLASS_METHOD(BluetoothOppProfileService, pushFile)
 		LS_CATEGORY_CLASS_METHOD(BluetoothOppProfileService, awaitTransferRequest)
 		LS_CATEGORY_CLASS_METHOD(BluetoothOppProfileService, acceptTransferRequest)
@@ -23,6 +23,7 @@
 #include "config.h"
 #include "logging.h"
 #include "bluetoothsilfactory.h"
+#include "bluetoothstartupprofiler.h"
 #include "utils.h"
 
 typedef BluetoothSIL *(*CreateSILFunc)(unsigned int version, BluetoothPairingIOCapability capability);
@@ -58,7 +59,9 @@ BluetoothSIL *BluetoothSILFactory::create(unsigned int version, BluetoothPairing
 
 	BT_INFO("SILFACTORY", 0, "Trying to load SIL from path %s\n", path);
 
+	int64_t startTime = g_get_monotonic_time();
 	SILHandle = dlopen(path, RTLD_NOW);
+	getStartupProfiler().record("dlopen", startTime);
 
 	if (!SILHandle)
 	{
@@ -77,7 +80,9 @@ BluetoothSIL *BluetoothSILFactory::create(unsigned int version, BluetoothPairing
 		return 0;
 	}
 
+	startTime = g_get_monotonic_time();
 	BluetoothSIL *sil = createSIL(version, capability);
+	getStartupProfiler().record("createBluetoothSIL", startTime);
 
 	if (!sil)
 	{
@@ -0,0 +1,152 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef BLUETOOTHSILTRACE_H
+#define BLUETOOTHSILTRACE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <bluetooth-sil-api.h>
+
+/*
+ * Binary trace of SIL observer callbacks. The service records it while
+ * /adapter/internal/setSilRecording is enabled and the virtual controller
+ * SIL replays it. Only the callbacks in BluetoothSilTraceEvent are
+ * recorded; pairing and the HID, A2DP, AVRCP, PAN, OPP, FTP and MAP
+ * callbacks are not, so a replay covers device discovery, GATT
+ * connections, service discovery and notifications and SPP traffic only.
+ *
+ * The file starts with BLUETOOTH_SIL_TRACE_MAGIC and a 32 bit version,
+ * followed by one record per callback: a 32 bit length of the rest of
+ * the record, the event, the timestamp and the event fields. All numbers
+ * are little endian, strings and byte arrays are prefixed with their
+ * length. GATT service records carry the attributes of the service in
+ * their data. Version 2 added the GATT events and still reads version 1.
+ */
+#define BLUETOOTH_SIL_TRACE_MAGIC "BTSILTRC"
+#define BLUETOOTH_SIL_TRACE_MAGIC_LENGTH 8
+#define BLUETOOTH_SIL_TRACE_VERSION 2
+
+enum BluetoothSilTraceEvent
+{
+	BLUETOOTH_SIL_TRACE_EVENT_UNKNOWN = 0,
+	BLUETOOTH_SIL_TRACE_EVENT_ADAPTER_STATE_CHANGED,
+	BLUETOOTH_SIL_TRACE_EVENT_DISCOVERY_STATE_CHANGED,
+	BLUETOOTH_SIL_TRACE_EVENT_ADAPTER_PROPERTIES_CHANGED,
+	BLUETOOTH_SIL_TRACE_EVENT_DEVICE_FOUND,
+	BLUETOOTH_SIL_TRACE_EVENT_DEVICE_PROPERTIES_CHANGED,
+	BLUETOOTH_SIL_TRACE_EVENT_DEVICE_REMOVED,
+	BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_FOUND,
+	BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_PROPERTIES_CHANGED,
+	BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_REMOVED,
+	BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_FOUND_BY_SCAN_ID,
+	BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_PROPERTIES_CHANGED_BY_SCAN_ID,
+	BLUETOOTH_SIL_TRACE_EVENT_LE_DEVICE_REMOVED_BY_SCAN_ID,
+	BLUETOOTH_SIL_TRACE_EVENT_CHARACTERISTIC_VALUE_CHANGED,
+	BLUETOOTH_SIL_TRACE_EVENT_SPP_CHANNEL_STATE_CHANGED,
+	BLUETOOTH_SIL_TRACE_EVENT_SPP_DATA_RECEIVED,
+	BLUETOOTH_SIL_TRACE_EVENT_GATT_CONNECTION_STATE_CHANGED,
+	BLUETOOTH_SIL_TRACE_EVENT_GATT_SERVICE_FOUND,
+	BLUETOOTH_SIL_TRACE_EVENT_GATT_SERVICE_LOST,
+	BLUETOOTH_SIL_TRACE_EVENT_MAX
+};
+
+// How the value of a property is stored in the trace
+enum BluetoothSilTraceValueType
+{
+	BLUETOOTH_SIL_TRACE_VALUE_TYPE_NONE = 0,
+	BLUETOOTH_SIL_TRACE_VALUE_TYPE_STRING,
+	BLUETOOTH_SIL_TRACE_VALUE_TYPE_STRING_LIST,
+	BLUETOOTH_SIL_TRACE_VALUE_TYPE_UINT32,
+	BLUETOOTH_SIL_TRACE_VALUE_TYPE_INT,
+	BLUETOOTH_SIL_TRACE_VALUE_TYPE_BOOL,
+	BLUETOOTH_SIL_TRACE_VALUE_TYPE_BYTES
+};
+
+inline BluetoothSilTraceValueType getSilTraceValueType(BluetoothProperty::Type type)
+{
+	switch (type)
+	{
+	case BluetoothProperty::Type::NAME:
+	case BluetoothProperty::Type::ALIAS:
+	case BluetoothProperty::Type::STACK_NAME:
+	case BluetoothProperty::Type::STACK_VERSION:
+	case BluetoothProperty::Type::FIRMWARE_VERSION:
+	case BluetoothProperty::Type::BDADDR:
+		return BLUETOOTH_SIL_TRACE_VALUE_TYPE_STRING;
+	case BluetoothProperty::Type::UUIDS:
+		return BLUETOOTH_SIL_TRACE_VALUE_TYPE_STRING_LIST;
+	case BluetoothProperty::Type::CLASS_OF_DEVICE:
+	case BluetoothProperty::Type::TYPE_OF_DEVICE:
+	case BluetoothProperty::Type::DISCOVERY_TIMEOUT:
+	case BluetoothProperty::Type::DISCOVERABLE_TIMEOUT:
+	case BluetoothProperty::Type::PAIRABLE_TIMEOUT:
+	case BluetoothProperty::Type::ROLE:
+	case BluetoothProperty::Type::INQUIRY_ACCESS_CODE:
+		return BLUETOOTH_SIL_TRACE_VALUE_TYPE_UINT32;
+	case BluetoothProperty::Type::RSSI:
+		return BLUETOOTH_SIL_TRACE_VALUE_TYPE_INT;
+	case BluetoothProperty::Type::DISCOVERABLE:
+	case BluetoothProperty::Type::PAIRABLE:
+	case BluetoothProperty::Type::PAIRED:
+	case BluetoothProperty::Type::TRUSTED:
+	case BluetoothProperty::Type::BLOCKED:
+	case BluetoothProperty::Type::CONNECTED:
+		return BLUETOOTH_SIL_TRACE_VALUE_TYPE_BOOL;
+	case BluetoothProperty::Type::MANUFACTURER_DATA:
+	case BluetoothProperty::Type::SCAN_RECORD:
+		return BLUETOOTH_SIL_TRACE_VALUE_TYPE_BYTES;
+	default:
+		// Not used by the service, left out of the trace
+		return BLUETOOTH_SIL_TRACE_VALUE_TYPE_NONE;
+	}
+}
+
+class BluetoothSilTraceRecord
+{
+public:
+	BluetoothSilTraceRecord() :
+		event(BLUETOOTH_SIL_TRACE_EVENT_UNKNOWN),
+		timestamp(0),
+		state(false),
+		id(0),
+		handle(0)
+	{
+	}
+
+	BluetoothSilTraceEvent event;
+	// Microseconds since the recording was started
+	uint64_t timestamp;
+	bool state;
+	// Scan id or SPP channel id
+	uint32_t id;
+	std::string address;
+	// SPP uuid or GATT service uuid
+	std::string uuid;
+	std::string characteristicUuid;
+	// Characteristic or GATT service handle
+	uint16_t handle;
+	BluetoothPropertiesList properties;
+	// Characteristic value, SPP data or the encoded GATT service
+	std::vector<uint8_t> data;
+	// Decoded from data by the reader for the GATT service events
+	BluetoothGattService service;
+};
+
+#endif // BLUETOOTHSILTRACE_H
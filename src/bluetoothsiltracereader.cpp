@@ -0,0 +1,299 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <string.h>
+
+#include "bluetoothsiltracereader.h"
+
+// Decodes the fields of one record, every read fails once the data is exhausted
+class BluetoothSilTraceDecoder
+{
+public:
+	BluetoothSilTraceDecoder(const std::vector<uint8_t> &data) :
+		mData(data),
+		mOffset(0)
+	{
+	}
+
+	bool readNumber(uint64_t &value, unsigned int size)
+	{
+		if (mOffset + size > mData.size())
+			return false;
+
+		value = 0;
+		for (unsigned int i = 0; i < size; i++)
+			value |= (uint64_t) mData[mOffset + i] << (8 * i);
+		mOffset += size;
+
+		return true;
+	}
+
+	bool readString(std::string &value)
+	{
+		uint64_t size = 0;
+		if (!readNumber(size, 2) || mOffset + size > mData.size())
+			return false;
+
+		value.assign((const char*) mData.data() + mOffset, size);
+		mOffset += size;
+
+		return true;
+	}
+
+	bool readBytes(std::vector<uint8_t> &value)
+	{
+		uint64_t size = 0;
+		if (!readNumber(size, 4) || mOffset + size > mData.size())
+			return false;
+
+		value.assign(mData.begin() + mOffset, mData.begin() + mOffset + size);
+		mOffset += size;
+
+		return true;
+	}
+
+	bool readProperties(BluetoothPropertiesList &properties)
+	{
+		uint64_t count = 0;
+		if (!readNumber(count, 2))
+			return false;
+
+		for (uint64_t i = 0; i < count; i++)
+		{
+			uint64_t type = 0;
+			if (!readNumber(type, 1))
+				return false;
+
+			BluetoothProperty::Type propertyType = (BluetoothProperty::Type) type;
+			uint64_t number = 0;
+
+			switch (getSilTraceValueType(propertyType))
+			{
+			case BLUETOOTH_SIL_TRACE_VALUE_TYPE_STRING:
+			{
+				std::string value;
+				if (!readString(value))
+					return false;
+				properties.push_back(BluetoothProperty(propertyType, value));
+				break;
+			}
+			case BLUETOOTH_SIL_TRACE_VALUE_TYPE_STRING_LIST:
+			{
+				std::vector<std::string> values;
+				if (!readNumber(number, 2))
+					return false;
+				for (uint64_t j = 0; j < number; j++)
+				{
+					std::string value;
+					if (!readString(value))
+						return false;
+					values.push_back(value);
+				}
+				properties.push_back(BluetoothProperty(propertyType, values));
+				break;
+			}
+			case BLUETOOTH_SIL_TRACE_VALUE_TYPE_UINT32:
+				if (!readNumber(number, 4))
+					return false;
+				properties.push_back(BluetoothProperty(propertyType, (uint32_t) number));
+				break;
+			case BLUETOOTH_SIL_TRACE_VALUE_TYPE_INT:
+				if (!readNumber(number, 4))
+					return false;
+				properties.push_back(BluetoothProperty(propertyType, (int) (int32_t) number));
+				break;
+			case BLUETOOTH_SIL_TRACE_VALUE_TYPE_BOOL:
+				if (!readNumber(number, 1))
+					return false;
+				properties.push_back(BluetoothProperty(propertyType, number != 0));
+				break;
+			case BLUETOOTH_SIL_TRACE_VALUE_TYPE_BYTES:
+			{
+				std::vector<uint8_t> value;
+				if (!readBytes(value))
+					return false;
+				properties.push_back(BluetoothProperty(propertyType, value));
+				break;
+			}
+			default:
+				// The writer never stores these, the trace is corrupt
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool readService(BluetoothGattService &service)
+	{
+		uint64_t type = 0;
+		uint64_t count = 0;
+		if (!readNumber(type, 1) || !readNumber(count, 2))
+			return false;
+
+		service.setType((BluetoothGattService::Type) type);
+
+		for (uint64_t i = 0; i < count; i++)
+		{
+			std::string include;
+			if (!readString(include))
+				return false;
+			service.addIncludedService(BluetoothUuid(include));
+		}
+
+		if (!readNumber(count, 2))
+			return false;
+
+		for (uint64_t i = 0; i < count; i++)
+		{
+			std::string uuid;
+			uint64_t handle = 0;
+			uint64_t properties = 0;
+			uint64_t permissions = 0;
+			uint64_t descriptorCount = 0;
+			if (!readString(uuid) || !readNumber(handle, 2) || !readNumber(properties, 4) ||
+			    !readNumber(permissions, 4) || !readNumber(descriptorCount, 2))
+				return false;
+
+			BluetoothGattCharacteristic characteristic(BluetoothUuid(uuid), properties, permissions);
+			characteristic.setHandle(handle);
+			characteristic.setServiceHandle(service.getHandle());
+
+			for (uint64_t j = 0; j < descriptorCount; j++)
+			{
+				if (!readString(uuid) || !readNumber(handle, 2) || !readNumber(permissions, 4))
+					return false;
+
+				BluetoothGattDescriptor descriptor(BluetoothUuid(uuid), permissions);
+				descriptor.setHandle(handle);
+				characteristic.addDescriptor(descriptor);
+			}
+
+			service.addCharacteristic(characteristic);
+		}
+
+		return true;
+	}
+
+private:
+	const std::vector<uint8_t> &mData;
+	size_t mOffset;
+};
+
+BluetoothSilTraceReader::BluetoothSilTraceReader() :
+	mFile(NULL)
+{
+}
+
+BluetoothSilTraceReader::~BluetoothSilTraceReader()
+{
+	close();
+}
+
+bool BluetoothSilTraceReader::open(const std::string &path)
+{
+	close();
+
+	mFile = fopen(path.c_str(), "rb");
+	if (!mFile)
+		return false;
+
+	std::vector<uint8_t> header(BLUETOOTH_SIL_TRACE_MAGIC_LENGTH + 4);
+	uint64_t version = 0;
+
+	if (fread(header.data(), 1, header.size(), mFile) != header.size() ||
+	    memcmp(header.data(), BLUETOOTH_SIL_TRACE_MAGIC, BLUETOOTH_SIL_TRACE_MAGIC_LENGTH) != 0)
+	{
+		close();
+		return false;
+	}
+
+	for (int i = 0; i < 4; i++)
+		version |= (uint64_t) header[BLUETOOTH_SIL_TRACE_MAGIC_LENGTH + i] << (8 * i);
+
+	if (version == 0 || version > BLUETOOTH_SIL_TRACE_VERSION)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void BluetoothSilTraceReader::close()
+{
+	if (!mFile)
+		return;
+
+	fclose(mFile);
+	mFile = NULL;
+}
+
+bool BluetoothSilTraceReader::read(BluetoothSilTraceRecord &record)
+{
+	if (!mFile)
+		return false;
+
+	uint8_t length[4];
+	if (fread(length, 1, sizeof(length), mFile) != sizeof(length))
+		return false;
+
+	std::vector<uint8_t> body(length[0] | length[1] << 8 | length[2] << 16 | (uint32_t) length[3] << 24);
+	if (fread(body.data(), 1, body.size(), mFile) != body.size())
+		return false;
+
+	BluetoothSilTraceDecoder decoder(body);
+	uint64_t event = 0;
+	uint64_t state = 0;
+	uint64_t id = 0;
+	uint64_t handle = 0;
+
+	record = BluetoothSilTraceRecord();
+
+	if (!decoder.readNumber(event, 1) ||
+	    !decoder.readNumber(record.timestamp, 8) ||
+	    !decoder.readNumber(state, 1) ||
+	    !decoder.readNumber(id, 4) ||
+	    !decoder.readString(record.address) ||
+	    !decoder.readString(record.uuid) ||
+	    !decoder.readString(record.characteristicUuid) ||
+	    !decoder.readNumber(handle, 2) ||
+	    !decoder.readProperties(record.properties) ||
+	    !decoder.readBytes(record.data))
+		return false;
+
+	if (event == BLUETOOTH_SIL_TRACE_EVENT_UNKNOWN || event >= BLUETOOTH_SIL_TRACE_EVENT_MAX)
+		return false;
+
+	record.event = (BluetoothSilTraceEvent) event;
+	record.state = state != 0;
+	record.id = id;
+	record.handle = handle;
+
+	if (record.event == BLUETOOTH_SIL_TRACE_EVENT_GATT_SERVICE_FOUND ||
+	    record.event == BLUETOOTH_SIL_TRACE_EVENT_GATT_SERVICE_LOST)
+	{
+		BluetoothSilTraceDecoder serviceDecoder(record.data);
+		record.service.setUuid(BluetoothUuid(record.uuid));
+		record.service.setHandle(record.handle);
+		if (!serviceDecoder.readService(record.service))
+			return false;
+	}
+
+	return true;
+}
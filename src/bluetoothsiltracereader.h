@@ -0,0 +1,45 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef BLUETOOTHSILTRACEREADER_H
+#define BLUETOOTHSILTRACEREADER_H
+
+#include <string>
+#include <stdio.h>
+
+#include "bluetoothsiltrace.h"
+
+// Reads the records of a trace written by BluetoothSilTraceWriter
+class BluetoothSilTraceReader
+{
+public:
+	BluetoothSilTraceReader();
+	BluetoothSilTraceReader(const BluetoothSilTraceReader &other) = delete;
+	~BluetoothSilTraceReader();
+
+	bool open(const std::string &path);
+	void close();
+
+	// Returns false at the end of the trace or on a truncated record
+	bool read(BluetoothSilTraceRecord &record);
+
+private:
+	FILE *mFile;
+};
+
+#endif // BLUETOOTHSILTRACEREADER_H
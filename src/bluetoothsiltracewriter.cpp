@@ -0,0 +1,309 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <glib.h>
+
+#include "bluetoothsiltracewriter.h"
+#include "logging.h"
+#include "utils.h"
+#include "config.h"
+
+static void appendNumber(std::string &buffer, uint64_t value, unsigned int size)
+{
+	for (unsigned int i = 0; i < size; i++)
+		buffer.push_back((char) ((value >> (8 * i)) & 0xff));
+}
+
+static void appendBytes(std::string &buffer, const uint8_t *data, uint32_t size)
+{
+	appendNumber(buffer, size, 4);
+	buffer.append((const char*) data, size);
+}
+
+static void appendString(std::string &buffer, const std::string &value)
+{
+	appendNumber(buffer, value.size(), 2);
+	buffer.append(value);
+}
+
+static void appendProperties(std::string &buffer, const BluetoothPropertiesList &properties)
+{
+	std::string values;
+	uint16_t count = 0;
+
+	for (auto property : properties)
+	{
+		BluetoothSilTraceValueType valueType = getSilTraceValueType(property.getType());
+		if (valueType == BLUETOOTH_SIL_TRACE_VALUE_TYPE_NONE)
+			continue;
+
+		appendNumber(values, property.getType(), 1);
+
+		switch (valueType)
+		{
+		case BLUETOOTH_SIL_TRACE_VALUE_TYPE_STRING:
+			appendString(values, property.getValue<std::string>());
+			break;
+		case BLUETOOTH_SIL_TRACE_VALUE_TYPE_STRING_LIST:
+		{
+			std::vector<std::string> strings = property.getValue<std::vector<std::string>>();
+			appendNumber(values, strings.size(), 2);
+			for (auto string : strings)
+				appendString(values, string);
+			break;
+		}
+		case BLUETOOTH_SIL_TRACE_VALUE_TYPE_UINT32:
+			appendNumber(values, property.getValue<uint32_t>(), 4);
+			break;
+		case BLUETOOTH_SIL_TRACE_VALUE_TYPE_INT:
+			appendNumber(values, (uint32_t) property.getValue<int>(), 4);
+			break;
+		case BLUETOOTH_SIL_TRACE_VALUE_TYPE_BOOL:
+			appendNumber(values, property.getValue<bool>() ? 1 : 0, 1);
+			break;
+		case BLUETOOTH_SIL_TRACE_VALUE_TYPE_BYTES:
+		{
+			std::vector<uint8_t> bytes = property.getValue<std::vector<uint8_t>>();
+			appendBytes(values, bytes.data(), bytes.size());
+			break;
+		}
+		default:
+			break;
+		}
+
+		count++;
+	}
+
+	appendNumber(buffer, count, 2);
+	buffer.append(values);
+}
+
+// Only the attributes, values are left to the characteristic records
+static void appendService(std::string &buffer, const BluetoothGattService &service)
+{
+	appendNumber(buffer, service.getType(), 1);
+
+	BluetoothUuidList includes = service.getIncludedServices();
+	appendNumber(buffer, includes.size(), 2);
+	for (auto include : includes)
+		appendString(buffer, include.toString());
+
+	BluetoothGattCharacteristicList characteristics = service.getCharacteristics();
+	appendNumber(buffer, characteristics.size(), 2);
+	for (auto characteristic : characteristics)
+	{
+		appendString(buffer, characteristic.getUuid().toString());
+		appendNumber(buffer, characteristic.getHandle(), 2);
+		appendNumber(buffer, characteristic.getProperties(), 4);
+		appendNumber(buffer, characteristic.getPermissions(), 4);
+
+		BluetoothGattDescriptorList descriptors = characteristic.getDescriptors();
+		appendNumber(buffer, descriptors.size(), 2);
+		for (auto descriptor : descriptors)
+		{
+			appendString(buffer, descriptor.getUuid().toString());
+			appendNumber(buffer, descriptor.getHandle(), 2);
+			appendNumber(buffer, descriptor.getPermissions(), 4);
+		}
+	}
+}
+
+BluetoothSilTraceWriter::BluetoothSilTraceWriter() :
+	mFile(NULL),
+	mStartTime(0),
+	mRecordCount(0),
+	mSize(0)
+{
+}
+
+BluetoothSilTraceWriter::~BluetoothSilTraceWriter()
+{
+	close();
+}
+
+bool BluetoothSilTraceWriter::open(const std::string &fileName)
+{
+	close();
+
+	if (!isPlainFileName(fileName))
+		return false;
+
+	if (g_mkdir_with_parents(WEBOS_BLUETOOTH_TRACE_DIR, 0700) != 0)
+	{
+		BT_ERROR(MSGID_SIL_TRACE_ERROR, 0, "Failed to create trace directory %s", WEBOS_BLUETOOTH_TRACE_DIR);
+		return false;
+	}
+
+	std::string path = std::string(WEBOS_BLUETOOTH_TRACE_DIR) + "/" + fileName;
+	mFile = fopen(path.c_str(), "wb");
+	if (!mFile)
+	{
+		BT_ERROR(MSGID_SIL_TRACE_ERROR, 0, "Failed to open SIL trace %s", path.c_str());
+		return false;
+	}
+
+	std::string header(BLUETOOTH_SIL_TRACE_MAGIC, BLUETOOTH_SIL_TRACE_MAGIC_LENGTH);
+	appendNumber(header, BLUETOOTH_SIL_TRACE_VERSION, 4);
+	fwrite(header.data(), 1, header.size(), mFile);
+
+	mPath = path;
+	mStartTime = g_get_monotonic_time();
+	mRecordCount = 0;
+	mSize = header.size();
+
+	BT_INFO("MANAGER_SERVICE", 0, "Recording SIL callbacks to %s", path.c_str());
+
+	return true;
+}
+
+void BluetoothSilTraceWriter::close()
+{
+	if (!mFile)
+		return;
+
+	fclose(mFile);
+	mFile = NULL;
+
+	BT_INFO("MANAGER_SERVICE", 0, "Recorded %llu SIL callbacks to %s", (unsigned long long) mRecordCount, mPath.c_str());
+}
+
+void BluetoothSilTraceWriter::recordState(BluetoothSilTraceEvent event, bool state)
+{
+	if (!mFile)
+		return;
+
+	BluetoothSilTraceRecord record;
+	record.event = event;
+	record.state = state;
+	write(record);
+}
+
+void BluetoothSilTraceWriter::recordDevice(BluetoothSilTraceEvent event, uint32_t scanId, const std::string &address,
+                                           const BluetoothPropertiesList &properties)
+{
+	if (!mFile)
+		return;
+
+	BluetoothSilTraceRecord record;
+	record.event = event;
+	record.id = scanId;
+	record.address = address;
+	record.properties = properties;
+	write(record);
+}
+
+void BluetoothSilTraceWriter::recordCharacteristic(const std::string &address, const BluetoothUuid &service,
+                                                   const BluetoothGattCharacteristic &characteristic)
+{
+	if (!mFile)
+		return;
+
+	BluetoothSilTraceRecord record;
+	record.event = BLUETOOTH_SIL_TRACE_EVENT_CHARACTERISTIC_VALUE_CHANGED;
+	record.address = address;
+	record.uuid = service.toString();
+	record.characteristicUuid = characteristic.getUuid().toString();
+	record.handle = characteristic.getHandle();
+	record.data = characteristic.getValue();
+	write(record);
+}
+
+void BluetoothSilTraceWriter::recordGattConnection(const std::string &address, bool connected)
+{
+	if (!mFile)
+		return;
+
+	BluetoothSilTraceRecord record;
+	record.event = BLUETOOTH_SIL_TRACE_EVENT_GATT_CONNECTION_STATE_CHANGED;
+	record.address = address;
+	record.state = connected;
+	write(record);
+}
+
+void BluetoothSilTraceWriter::recordGattService(BluetoothSilTraceEvent event, const std::string &address,
+                                                const BluetoothGattService &service)
+{
+	if (!mFile)
+		return;
+
+	std::string attributes;
+	appendService(attributes, service);
+
+	BluetoothSilTraceRecord record;
+	record.event = event;
+	record.address = address;
+	record.uuid = service.getUuid().toString();
+	record.handle = service.getHandle();
+	record.data.assign(attributes.begin(), attributes.end());
+	write(record);
+}
+
+void BluetoothSilTraceWriter::recordSppChannel(const std::string &address, const std::string &uuid, uint32_t channelId, bool state)
+{
+	if (!mFile)
+		return;
+
+	BluetoothSilTraceRecord record;
+	record.event = BLUETOOTH_SIL_TRACE_EVENT_SPP_CHANNEL_STATE_CHANGED;
+	record.address = address;
+	record.uuid = uuid;
+	record.id = channelId;
+	record.state = state;
+	write(record);
+}
+
+void BluetoothSilTraceWriter::recordSppData(uint32_t channelId, const uint8_t *data, uint32_t size)
+{
+	if (!mFile)
+		return;
+
+	BluetoothSilTraceRecord record;
+	record.event = BLUETOOTH_SIL_TRACE_EVENT_SPP_DATA_RECEIVED;
+	record.id = channelId;
+	record.data.assign(data, data + size);
+	write(record);
+}
+
+void BluetoothSilTraceWriter::write(const BluetoothSilTraceRecord &record)
+{
+	std::string body;
+	appendNumber(body, record.event, 1);
+	appendNumber(body, g_get_monotonic_time() - mStartTime, 8);
+	appendNumber(body, record.state ? 1 : 0, 1);
+	appendNumber(body, record.id, 4);
+	appendString(body, record.address);
+	appendString(body, record.uuid);
+	appendString(body, record.characteristicUuid);
+	appendNumber(body, record.handle, 2);
+	appendProperties(body, record.properties);
+	appendBytes(body, record.data.data(), record.data.size());
+
+	std::string length;
+	appendNumber(length, body.size(), 4);
+
+	if (fwrite(length.data(), 1, length.size(), mFile) != length.size() ||
+	    fwrite(body.data(), 1, body.size(), mFile) != body.size())
+	{
+		BT_ERROR(MSGID_SIL_TRACE_ERROR, 0, "Failed to write SIL trace %s, stopping the recording", mPath.c_str());
+		close();
+		return;
+	}
+
+	mRecordCount++;
+	mSize += length.size() + body.size();
+}
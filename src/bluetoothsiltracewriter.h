@@ -0,0 +1,67 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef BLUETOOTHSILTRACEWRITER_H
+#define BLUETOOTHSILTRACEWRITER_H
+
+#include <string>
+#include <stdio.h>
+
+#include "bluetoothsiltrace.h"
+
+/*
+ * Records SIL observer callbacks into a trace file below
+ * WEBOS_BLUETOOTH_TRACE_DIR. All record methods return right away while
+ * no file is open, so observers can call them unconditionally.
+ */
+class BluetoothSilTraceWriter
+{
+public:
+	BluetoothSilTraceWriter();
+	BluetoothSilTraceWriter(const BluetoothSilTraceWriter &other) = delete;
+	~BluetoothSilTraceWriter();
+
+	// fileName must not contain a directory, see isPlainFileName()
+	bool open(const std::string &fileName);
+	void close();
+
+	bool isOpen() const { return mFile != NULL; }
+	std::string getPath() const { return mPath; }
+	uint64_t getRecordCount() const { return mRecordCount; }
+	uint64_t getSize() const { return mSize; }
+
+	void recordState(BluetoothSilTraceEvent event, bool state);
+	void recordDevice(BluetoothSilTraceEvent event, uint32_t scanId, const std::string &address,
+	                  const BluetoothPropertiesList &properties = BluetoothPropertiesList());
+	void recordCharacteristic(const std::string &address, const BluetoothUuid &service, const BluetoothGattCharacteristic &characteristic);
+	void recordGattConnection(const std::string &address, bool connected);
+	void recordGattService(BluetoothSilTraceEvent event, const std::string &address, const BluetoothGattService &service);
+	void recordSppChannel(const std::string &address, const std::string &uuid, uint32_t channelId, bool state);
+	void recordSppData(uint32_t channelId, const uint8_t *data, uint32_t size);
+
+private:
+	FILE *mFile;
+	std::string mPath;
+	int64_t mStartTime;
+	uint64_t mRecordCount;
+	uint64_t mSize;
+
+	void write(const BluetoothSilTraceRecord &record);
+};
+
+#endif // BLUETOOTHSILTRACEWRITER_H
@@ -16,6 +16,8 @@
 
 
 #include "bluetoothsppprofileservice.h"
+#include "bluetoothmainloopwatchdog.h"
+#include "bluetootheventtrace.h"
 #include "bluetoothmanagerservice.h"
 #include "bluetootherrors.h"
 #include "logging.h"
@@ -29,16 +31,29 @@ BluetoothSppProfileService::BluetoothSppProfileService(BluetoothManagerService *
         BluetoothProfileService(manager, "SPP", "00001101-0000-1000-8000-00805f9b34fb")
 {
 	LS_CREATE_CATEGORY_BEGIN(BluetoothProfileService, base)
-		LS_CATEGORY_METHOD(connect)
-		LS_CATEGORY_METHOD(disconnect)
-		LS_CATEGORY_METHOD(getStatus)
+		BT_CATEGORY_METHOD(connect)
+		BT_CATEGORY_METHOD(disconnect)
+		BT_CATEGORY_METHOD(getStatus)
 		LS_CATEGORY_CLASS_METHOD(BluetoothSppProfileService, createChannel)
 		LS_CATEGORY_CLASS_METHOD(BluetoothSppProfileService, writeData)
 		LS_CATEGORY_CLASS_METHOD(BluetoothSppProfileService, readData)
 	LS_CREATE_CATEGORY_END
 
+	LS_CREATE_CATEGORY_BEGIN(BluetoothProfileService, internal)
+		LS_CATEGORY_CLASS_METHOD(BluetoothSppProfileService, getThroughputStatus)
+	LS_CREATE_CATEGORY_END
+
 	manager->registerCategory("/spp", LS_CATEGORY_TABLE_NAME(base), NULL, NULL);
 	manager->setCategoryData("/spp", this);
+
+	manager->registerCategory("/spp/internal", LS_CATEGORY_TABLE_NAME(internal), NULL, NULL);
+	manager->setCategoryData("/spp/internal", this);
+
+	mChannelManager.setDataDeliveredCallback([this](uint32_t size, int64_t receivedTime, uint64_t cpuTime) {
+		mThroughputStats.addPacket(BLUETOOTH_SPP_THROUGHPUT_PATH_RECEIVE_LUNA, size);
+		mThroughputStats.addCpuTime(BLUETOOTH_SPP_THROUGHPUT_PATH_RECEIVE_LUNA, cpuTime);
+		getManager()->getLatencyTracker()->recordDelivery(BLUETOOTH_LATENCY_EVENT_DATA_RECEIVED, receivedTime);
+	});
 }
 
 BluetoothSppProfileService::~BluetoothSppProfileService()
@@ -482,11 +497,17 @@ bool BluetoothSppProfileService::writeData(LSMessage &message)
 		return true;
 	}
 
+	BluetoothSppThroughputStats::Measurement measurement(mThroughputStats, BLUETOOTH_SPP_THROUGHPUT_PATH_SEND_LUNA, outLen);
+
 	LSMessage *requestMessage = request.get();
 	LSMessageRef(requestMessage);
-	auto writeDataCallback = [this, requestMessage, adapterAddress](BluetoothError error) {
+	int64_t startTime = g_get_monotonic_time();
+	auto writeDataCallback = [this, requestMessage, adapterAddress, stackChannelId, outLen, startTime](BluetoothError error) {
 		LS::Message request(requestMessage);
 
+		getEventTrace().record(BLUETOOTH_EVENT_TRACE_SPP_WRITE_DATA, stackChannelId, outLen,
+		                       g_get_monotonic_time() - startTime);
+
 		if (error != BLUETOOTH_ERROR_NONE)
 		{
 			LSUtils::respondWithError(request, BT_ERR_SPP_WRITE_DATA_FAILED);
@@ -604,16 +625,22 @@ bool BluetoothSppProfileService::readData(LSMessage &message)
 	if (subscribed)
 		addReadDataSubscription(request, channelId, timeout);
 
+	BluetoothSppThroughputStats::Measurement measurement(mThroughputStats, BLUETOOTH_SPP_THROUGHPUT_PATH_RECEIVE_LUNA, 0);
+
 	pbnjson::JValue responseObj = pbnjson::Object();
 	responseObj.put("adapterAddress", adapterAddress);
 	responseObj.put("subscribed", subscribed);
 	responseObj.put("channelId", channelId);
 
 	int size = 0;
+	uint32_t dataSize = 0;
+	int64_t receivedTime = 0;
 	gchar *gdata = NULL;
 	const ChannelManager::DataBuffer *dataBuffer = mChannelManager.getChannelBufferData(channelId, appName);
 	if (dataBuffer)
 	{
+		dataSize = dataBuffer->size;
+		receivedTime = dataBuffer->receivedTime;
 		gdata = g_base64_encode(dataBuffer->buffer, dataBuffer->size);
 		if (gdata)
 		{
@@ -642,6 +669,12 @@ bool BluetoothSppProfileService::readData(LSMessage &message)
 		LSUtils::postToClient(request, responseObj);
 	}
 
+	if (size > 0)
+	{
+		mThroughputStats.addPacket(BLUETOOTH_SPP_THROUGHPUT_PATH_RECEIVE_LUNA, dataSize);
+		getManager()->getLatencyTracker()->recordDelivery(BLUETOOTH_LATENCY_EVENT_DATA_RECEIVED, receivedTime);
+	}
+
 	g_free(gdata);
 
 	return true;
@@ -663,6 +696,8 @@ void BluetoothSppProfileService::channelStateChanged(const std::string &address,
 	// If the callers(i.e. com.lge.service.watchmanager and com.lge.service.mashupmanager) should use the
         // binary socket to send/receive the data, WBS handles the binary socket.
 
+	getManager()->getSilTraceWriter()->recordSppChannel(address, uuid, channelId, state);
+
 	std::string userChannelId = EMPTY_STRING;
 	if (state)
 	{
@@ -690,17 +725,39 @@ void BluetoothSppProfileService::channelStateChanged(const std::string &address,
 
 void BluetoothSppProfileService::dataReceived(const BluetoothSppChannelId channelId, const uint8_t *data, const uint32_t size)
 {
+	BluetoothLatencyTracker::Event latencyEvent(getManager()->getLatencyTracker(), BLUETOOTH_LATENCY_EVENT_DATA_RECEIVED);
+	BluetoothMainLoopWatchdog::Activity activity("SIL spp dataReceived");
+
+	getManager()->getSilTraceWriter()->recordSppData(channelId, data, size);
+	getEventTrace().record(BLUETOOTH_EVENT_TRACE_SPP_DATA_RECEIVED, channelId, size);
+
 	// If caller used the binary socket, WBS does not support Luna APIs to read the data.
 	// After receiving the data from the stack, it will be sent to the binary socket directly.
 	std::string userChannelId = mChannelManager.getUserChannelId(channelId);
-	if (isCallerUsingBinarySocket(userChannelId))
+	bool usingBinarySocket = isCallerUsingBinarySocket(userChannelId);
+
+	// Data is counted once it was delivered, only the CPU time is taken here
+	BluetoothSppThroughputStats::Measurement measurement(mThroughputStats, usingBinarySocket ?
+	        BLUETOOTH_SPP_THROUGHPUT_PATH_RECEIVE_SOCKET : BLUETOOTH_SPP_THROUGHPUT_PATH_RECEIVE_LUNA, 0);
+
+	if (usingBinarySocket)
 	{
 		auto binarySocket = findBinarySocket(userChannelId);
 		if (binarySocket)
-			binarySocket->sendData(data, size);
+		{
+			if (binarySocket->sendData(data, size))
+			{
+				mThroughputStats.addPacket(BLUETOOTH_SPP_THROUGHPUT_PATH_RECEIVE_SOCKET, size);
+				getManager()->getLatencyTracker()->recordDelivery();
+			}
+			else
+				BT_WARNING(MSGID_SPP_SOCKET_DATA_LOST, 0, "Failed to write %u bytes of channel %s to its binary socket",
+				           size, userChannelId.c_str());
+		}
 	}
 	else
-		mChannelManager.addReceiveQueue(getManager()->getAddress(), channelId, data, size);
+		mChannelManager.addReceiveQueue(getManager()->getAddress(), channelId, data, size,
+		        getManager()->getLatencyTracker()->getStartTime());
 }
 
 BluetoothBinarySocket* BluetoothSppProfileService::findBinarySocket(const std::string &channelId) const
@@ -755,6 +812,8 @@ bool BluetoothSppProfileService::isCallerUsingBinarySocket(const std::string &ch
 
 void BluetoothSppProfileService::handleBinarySocketRecieveRequest(const std::string &channelId, guchar *readBuf, gsize readLen)
 {
+	BluetoothMainLoopWatchdog::Activity activity("spp binary socket receive");
+
 	auto binarySocket = findBinarySocket(channelId);
 	if (binarySocket)
 		sendDataToStack(channelId, readBuf, readLen);
@@ -779,7 +838,13 @@ void BluetoothSppProfileService::sendDataToStack(const std::string &channelId, g
 		return;
 	}
 
-	auto writeDataCallback = [binarySocket](BluetoothError error) {
+	BluetoothSppThroughputStats::Measurement measurement(mThroughputStats, BLUETOOTH_SPP_THROUGHPUT_PATH_SEND_SOCKET, outLen);
+
+	int64_t startTime = g_get_monotonic_time();
+	auto writeDataCallback = [binarySocket, stackChannelId, outLen, startTime](BluetoothError error) {
+		getEventTrace().record(BLUETOOTH_EVENT_TRACE_SPP_WRITE_DATA, stackChannelId, outLen,
+		                       g_get_monotonic_time() - startTime);
+
 		if (error != BLUETOOTH_ERROR_NONE)
 		{
 			BT_DEBUG("Failed to write the binary socket data to stack");
@@ -792,6 +857,97 @@ void BluetoothSppProfileService::sendDataToStack(const std::string &channelId, g
 	getImpl<BluetoothSppProfile>()->writeData(stackChannelId, data, outLen, writeDataCallback);
 }
 
+/**
+Return the throughput of the SPP data paths.
+
+The paths are "receiveLuna" (dataReceived to /spp/readData), "receiveSocket" (dataReceived
+to the binary socket), "sendLuna" (/spp/writeData) and "sendSocket" (binary socket to the
+stack). receiveLuna counts data when it is read, one packet per buffer handed to the reader,
+so data still waiting in the channel queue is not included.
+
+@par Parameters
+
+Name | Required | Type | Description
+-----|--------|------|----------
+reset | No | Boolean | If true, the counters are cleared after they were returned
+adapterAddress | No | String | Address of the adapter executing this method. If not specified, the default adapter will be used.
+
+@par Returns(Call)
+
+Name | Required | Type | Description
+-----|--------|------|----------
+returnValue | Yes | Boolean | Value is true if the status was returned, false otherwise.
+adapterAddress | Yes | String | Address of the adapter executing this method
+paths | Yes | Object array | Per path: path, bytes, packets, maxPacketSize and cpuTime in microseconds. bytesPerSecond and packetsPerSecond once two packets were counted, cpuTimePerMB once any data was counted.
+errorText | No | String | errorText contains the error text if the method fails. The method will return errorText only if it fails.
+errorCode | No | Number | errorCode contains the error code if the method fails. The method will return errorCode only if it fails.
+
+@par Returns(Subscription)
+
+Not applicable
+*/
+bool BluetoothSppProfileService::getThroughputStatus(LSMessage &message)
+{
+	BT_INFO("SPP", 0, "Luna API is called : [%s : %d]", __FUNCTION__, __LINE__);
+
+	LS::Message request(&message);
+	pbnjson::JValue requestObj;
+	int parseError = 0;
+
+	const std::string schema = STRICT_SCHEMA(PROPS_2(PROP(adapterAddress, string), PROP(reset, boolean)));
+
+	if (!LSUtils::parsePayload(request.getPayload(), requestObj, schema, &parseError))
+	{
+		if (JSON_PARSE_SCHEMA_ERROR != parseError)
+			LSUtils::respondWithError(request, BT_ERR_BAD_JSON);
+		else
+			LSUtils::respondWithError(request, BT_ERR_SCHEMA_VALIDATION_FAIL);
+
+		return true;
+	}
+
+	std::string adapterAddress;
+	if (!getManager()->isRequestedAdapterAvailable(request, requestObj, adapterAddress))
+		return true;
+
+	pbnjson::JValue pathsObj = pbnjson::Array();
+	for (int path = 0; path < BLUETOOTH_SPP_THROUGHPUT_PATH_MAX; path++)
+	{
+		const BluetoothSppThroughputCounters &counters = mThroughputStats.getCounters((BluetoothSppThroughputPath) path);
+
+		pbnjson::JValue pathObj = pbnjson::Object();
+		pathObj.put("path", BluetoothSppThroughputStats::pathToString((BluetoothSppThroughputPath) path));
+		pathObj.put("bytes", (int64_t) counters.bytes);
+		pathObj.put("packets", (int64_t) counters.packets);
+		pathObj.put("maxPacketSize", (int32_t) counters.maxPacketSize);
+		pathObj.put("cpuTime", (int64_t) counters.cpuTime);
+
+		// Rates need at least two packets to span some time
+		int64_t duration = counters.lastTime - counters.firstTime;
+		if (duration > 0)
+		{
+			pathObj.put("bytesPerSecond", (int64_t) (counters.bytes * 1000000 / duration));
+			pathObj.put("packetsPerSecond", (int64_t) (counters.packets * 1000000 / duration));
+		}
+		if (counters.bytes > 0)
+			pathObj.put("cpuTimePerMB", (int64_t) (counters.cpuTime * 1048576 / counters.bytes));
+
+		pathsObj.append(pathObj);
+	}
+
+	pbnjson::JValue responseObj = pbnjson::Object();
+	responseObj.put("returnValue", true);
+	responseObj.put("adapterAddress", adapterAddress);
+	responseObj.put("paths", pathsObj);
+
+	if (requestObj.hasKey("reset") && requestObj["reset"].asBool())
+		mThroughputStats.reset();
+
+	LSUtils::postToClient(request, responseObj);
+
+	return true;
+}
+
 pbnjson::JValue BluetoothSppProfileService::buildGetStatusResp(bool connected, bool connecting, bool subscribed, bool returnValue,
         std::string adapterAddress, std::string deviceAddress)
 {
@@ -28,6 +28,7 @@
 #include "bluetoothprofileservice.h"
 #include "bluetoothbinarysocket.h"
 #include "channelmanager.h"
+#include "bluetoothsppthroughputstats.h"
 
 namespace pbnjson
 {
@@ -55,6 +56,7 @@ public:
 	bool createChannel(LSMessage &message);
 	bool writeData(LSMessage &message);
 	bool readData(LSMessage &message);
+	bool getThroughputStatus(LSMessage &message);
 
 	virtual void notifyStatusSubscribers(const std::string &adapterAddress, const std::string &address, const std::string &uuid,
 	        bool connected);
@@ -71,6 +73,7 @@ public:
 private:
 	ChannelManager mChannelManager;
 	std::unordered_map<std::string, BluetoothBinarySocket*> mBinarySockets;
+	BluetoothSppThroughputStats mThroughputStats;
 
 private:
 	void handleConnectClientDisappeared(const std::string &adapterAddress, const std::string &address,
@@ -0,0 +1,75 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <glib.h>
+
+#include "bluetoothsppthroughputstats.h"
+#include "utils.h"
+
+BluetoothSppThroughputStats::Measurement::Measurement(BluetoothSppThroughputStats &stats, BluetoothSppThroughputPath path, uint32_t size) :
+	mCounters(stats.mCounters[path]),
+	mStartTime(getThreadCpuTime())
+{
+	stats.addPacket(path, size);
+}
+
+BluetoothSppThroughputStats::Measurement::~Measurement()
+{
+	mCounters.cpuTime += getThreadCpuTime() - mStartTime;
+}
+
+void BluetoothSppThroughputStats::addPacket(BluetoothSppThroughputPath path, uint32_t size)
+{
+	if (size == 0)
+		return;
+
+	BluetoothSppThroughputCounters &counters = mCounters[path];
+
+	int64_t now = g_get_monotonic_time();
+	if (counters.packets == 0)
+		counters.firstTime = now;
+	counters.lastTime = now;
+
+	counters.packets++;
+	counters.bytes += size;
+	if (size > counters.maxPacketSize)
+		counters.maxPacketSize = size;
+}
+
+void BluetoothSppThroughputStats::reset()
+{
+	for (int path = 0; path < BLUETOOTH_SPP_THROUGHPUT_PATH_MAX; path++)
+		mCounters[path] = BluetoothSppThroughputCounters();
+}
+
+std::string BluetoothSppThroughputStats::pathToString(BluetoothSppThroughputPath path)
+{
+	switch (path)
+	{
+	case BLUETOOTH_SPP_THROUGHPUT_PATH_RECEIVE_LUNA:
+		return "receiveLuna";
+	case BLUETOOTH_SPP_THROUGHPUT_PATH_RECEIVE_SOCKET:
+		return "receiveSocket";
+	case BLUETOOTH_SPP_THROUGHPUT_PATH_SEND_LUNA:
+		return "sendLuna";
+	case BLUETOOTH_SPP_THROUGHPUT_PATH_SEND_SOCKET:
+		return "sendSocket";
+	default:
+		return "unknown";
+	}
+}
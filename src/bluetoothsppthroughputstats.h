@@ -0,0 +1,97 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef BLUETOOTHSPPTHROUGHPUTSTATS_H
+#define BLUETOOTHSPPTHROUGHPUTSTATS_H
+
+#include <string>
+#include <stdint.h>
+
+enum BluetoothSppThroughputPath
+{
+	// dataReceived -> ChannelManager -> readData, counted when the data is read
+	BLUETOOTH_SPP_THROUGHPUT_PATH_RECEIVE_LUNA = 0,
+	// dataReceived -> binary socket
+	BLUETOOTH_SPP_THROUGHPUT_PATH_RECEIVE_SOCKET,
+	// writeData -> SIL
+	BLUETOOTH_SPP_THROUGHPUT_PATH_SEND_LUNA,
+	// binary socket -> sendDataToStack -> SIL
+	BLUETOOTH_SPP_THROUGHPUT_PATH_SEND_SOCKET,
+	BLUETOOTH_SPP_THROUGHPUT_PATH_MAX
+};
+
+class BluetoothSppThroughputCounters
+{
+public:
+	BluetoothSppThroughputCounters() :
+		bytes(0),
+		packets(0),
+		maxPacketSize(0),
+		cpuTime(0),
+		firstTime(0),
+		lastTime(0)
+	{
+	}
+
+	uint64_t bytes;
+	uint64_t packets;
+	uint32_t maxPacketSize;
+	// Thread CPU time spent on the path in microseconds
+	uint64_t cpuTime;
+	// Monotonic time of the first and last packet in microseconds
+	int64_t firstTime;
+	int64_t lastTime;
+};
+
+/*
+ * Data moved over the SPP paths of the service and the CPU time it cost,
+ * so throughput (bytes and packets per second between the first and the
+ * last packet) and CPU per MB can be derived for each path. Data queued
+ * for readData is counted when it is read, one packet per buffer handed
+ * to the readers. Heap allocations per packet are not tracked here, the
+ * registry benchmark shows how to count them with malloc wrappers.
+ */
+class BluetoothSppThroughputStats
+{
+public:
+	class Measurement
+	{
+	public:
+		// size 0 only accounts CPU time, e.g. for readData
+		Measurement(BluetoothSppThroughputStats &stats, BluetoothSppThroughputPath path, uint32_t size);
+		Measurement(const Measurement &other) = delete;
+		~Measurement();
+
+	private:
+		BluetoothSppThroughputCounters &mCounters;
+		uint64_t mStartTime;
+	};
+
+	void addPacket(BluetoothSppThroughputPath path, uint32_t size);
+	void addCpuTime(BluetoothSppThroughputPath path, uint64_t cpuTime) { mCounters[path].cpuTime += cpuTime; }
+	void reset();
+
+	const BluetoothSppThroughputCounters& getCounters(BluetoothSppThroughputPath path) const { return mCounters[path]; }
+
+	static std::string pathToString(BluetoothSppThroughputPath path);
+
+private:
+	BluetoothSppThroughputCounters mCounters[BLUETOOTH_SPP_THROUGHPUT_PATH_MAX];
+};
+
+#endif // BLUETOOTHSPPTHROUGHPUTSTATS_H
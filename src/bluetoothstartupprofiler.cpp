@@ -0,0 +1,127 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <algorithm>
+#include <stdio.h>
+#include <glib.h>
+
+#include "bluetoothstartupprofiler.h"
+#include "logging.h"
+#include "utils.h"
+
+static BluetoothStartupProfiler startupProfiler;
+
+BluetoothStartupProfiler& getStartupProfiler()
+{
+	return startupProfiler;
+}
+
+BluetoothStartupProfiler::BluetoothStartupProfiler() :
+	mStartTime(0),
+	mReadyTime(0),
+	mPoweredOnTime(0)
+{
+}
+
+void BluetoothStartupProfiler::start()
+{
+	mStartTime = g_get_monotonic_time();
+	mReadyTime = 0;
+	mPoweredOnTime = 0;
+	mPhases.clear();
+}
+
+void BluetoothStartupProfiler::record(const std::string &name, int64_t startTime, const std::string &detail)
+{
+	if (!mStartTime || mReadyTime)
+		return;
+
+	BluetoothStartupPhase phase;
+	phase.name = name;
+	phase.detail = detail;
+	phase.start = startTime - mStartTime;
+	phase.duration = g_get_monotonic_time() - startTime;
+
+	mPhases.push_back(phase);
+}
+
+void BluetoothStartupProfiler::finish()
+{
+	if (!mStartTime || mReadyTime)
+		return;
+
+	mReadyTime = g_get_monotonic_time() - mStartTime;
+
+	// Nested phases complete before the phase around them
+	std::stable_sort(mPhases.begin(), mPhases.end(), [](const BluetoothStartupPhase &a, const BluetoothStartupPhase &b) {
+		return a.start < b.start;
+	});
+
+	for (auto phase : mPhases)
+		BT_DEBUG("Startup phase %s %s at %lld us took %lld us", phase.name.c_str(), phase.detail.c_str(),
+		         (long long) phase.start, (long long) phase.duration);
+
+	std::string summary = getSummary();
+	BT_INFO("STARTUP", 0, "%s", summary.c_str());
+
+	write_kernel_log(("[bt_time] " + summary + " ").c_str());
+}
+
+void BluetoothStartupProfiler::markPoweredOn()
+{
+	if (!mStartTime || mPoweredOnTime)
+		return;
+
+	mPoweredOnTime = g_get_monotonic_time() - mStartTime;
+
+	char message[128];
+	snprintf(message, sizeof(message), "[bt_time] first power on %lld ms after start ",
+	         (long long) (mPoweredOnTime / 1000));
+	BT_INFO("STARTUP", 0, "%s", message);
+	write_kernel_log(message);
+}
+
+std::string BluetoothStartupProfiler::getSummary() const
+{
+	// Phases recorded more than once (one per category) are summed up
+	std::vector<std::pair<std::string, int64_t>> totals;
+	for (auto phase : mPhases)
+	{
+		auto totalIter = std::find_if(totals.begin(), totals.end(), [&phase](const std::pair<std::string, int64_t> &total) {
+			return total.first == phase.name;
+		});
+
+		if (totalIter == totals.end())
+			totals.push_back(std::make_pair(phase.name, phase.duration));
+		else
+			totalIter->second += phase.duration;
+	}
+
+	std::string summary = "startup";
+	char entry[96];
+	for (auto total : totals)
+	{
+		snprintf(entry, sizeof(entry), " %s:%lld.%03lldms", total.first.c_str(),
+		         (long long) (total.second / 1000), (long long) (total.second % 1000));
+		summary += entry;
+	}
+
+	snprintf(entry, sizeof(entry), " ready:%lld.%03lldms", (long long) (mReadyTime / 1000), (long long) (mReadyTime % 1000));
+	summary += entry;
+
+	return summary;
+}
@@ -0,0 +1,81 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#ifndef BLUETOOTHSTARTUPPROFILER_H
+#define BLUETOOTHSTARTUPPROFILER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+class BluetoothStartupPhase
+{
+public:
+	BluetoothStartupPhase() :
+		start(0),
+		duration(0)
+	{
+	}
+
+	std::string name;
+	// Category path for registerCategory phases
+	std::string detail;
+	// Microseconds since the start of main()
+	int64_t start;
+	int64_t duration;
+};
+
+/*
+ * Times the steps between the start of main() and the service being
+ * registered on the bus, and the time until the adapter is first powered.
+ * Phases nest: profiles register their categories while they are created.
+ * Both a summary in the kernel log and the individual phases are kept for
+ * getStartupProfile.
+ */
+class BluetoothStartupProfiler
+{
+public:
+	BluetoothStartupProfiler();
+	BluetoothStartupProfiler(const BluetoothStartupProfiler &other) = delete;
+
+	void start();
+	// Records a phase from startTime (monotonic) until now. Ignored once
+	// the service is ready, so phases which run again later (e.g. an
+	// adapter appearing) do not skew the report.
+	void record(const std::string &name, int64_t startTime, const std::string &detail = "");
+	void finish();
+	void markPoweredOn();
+
+	int64_t getStartTime() const { return mStartTime; }
+	// Microseconds since the start of main(), 0 until reached
+	int64_t getReadyTime() const { return mReadyTime; }
+	int64_t getPoweredOnTime() const { return mPoweredOnTime; }
+	// Ordered by start
+	const std::vector<BluetoothStartupPhase>& getPhases() const { return mPhases; }
+
+private:
+	int64_t mStartTime;
+	int64_t mReadyTime;
+	int64_t mPoweredOnTime;
+	std::vector<BluetoothStartupPhase> mPhases;
+
+	std::string getSummary() const;
+};
+
+BluetoothStartupProfiler& getStartupProfiler();
+
+#endif // BLUETOOTHSTARTUPPROFILER_H
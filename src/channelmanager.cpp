@@ -20,6 +20,7 @@
 #include "ls2utils.h"
 #include "logging.h"
 #include "clientwatch.h"
+#include "utils.h"
 
 #define BLUETOOTH_PROFILE_SPP_MAX_CHANNEL_ID 999
 
@@ -93,6 +94,7 @@ void ChannelManager::notifyReceivedData(const std::string &adapterAddress, const
 		return;
 
 	std::lock_guard<std::mutex> guard(cmMutex);
+	uint64_t startCpuTime = getThreadCpuTime();
 	bool found = false;
 	for (auto itMap = mReadDataSubscriptions.begin(); itMap != mReadDataSubscriptions.end(); itMap++)
 	{
@@ -111,7 +113,13 @@ void ChannelManager::notifyReceivedData(const std::string &adapterAddress, const
 	}
 
 	if (found)
+	{
+		if (mDataDeliveredCallback && channelInfo->dataBuffer.size > 0)
+			mDataDeliveredCallback(channelInfo->dataBuffer.size, channelInfo->dataBuffer.receivedTime,
+			        getThreadCpuTime() - startCpuTime);
+
 		channelInfo->dataBuffer.size = 0;
+	}
 }
 
 void ChannelManager::makeDataBuffer(ChannelInfo *channelInfo)
@@ -132,6 +140,9 @@ void ChannelManager::makeDataBuffer(ChannelInfo *channelInfo)
 
 			if (queue->data)
 			{
+				if (channelInfo->dataBuffer.size == 0)
+					channelInfo->dataBuffer.receivedTime = queue->receivedTime;
+
 				memcpy(channelInfo->dataBuffer.buffer + channelInfo->dataBuffer.size, queue->data, queue->size);
 				channelInfo->dataBuffer.size += queue->size;
 
@@ -541,6 +552,7 @@ const ChannelManager::DataBuffer *ChannelManager::getChannelBufferData(std::stri
 				if (channelInfo->dataBuffer.size == 0)
 					makeDataBuffer(channelInfo);
 				dataBuffer->size = channelInfo->dataBuffer.size;
+				dataBuffer->receivedTime = channelInfo->dataBuffer.receivedTime;
 				memcpy(dataBuffer->buffer, channelInfo->dataBuffer.buffer, channelInfo->dataBuffer.size);
 				channelInfo->dataBuffer.size = 0;
 				break;
@@ -555,6 +567,7 @@ const ChannelManager::DataBuffer *ChannelManager::getChannelBufferData(std::stri
 				if (channelInfo->dataBuffer.size == 0)
 					makeDataBuffer(channelInfo);
 				dataBuffer->size = channelInfo->dataBuffer.size;
+				dataBuffer->receivedTime = channelInfo->dataBuffer.receivedTime;
 				memcpy(dataBuffer->buffer, channelInfo->dataBuffer.buffer, channelInfo->dataBuffer.size);
 				channelInfo->dataBuffer.size = 0;
 				break;
@@ -566,7 +579,7 @@ const ChannelManager::DataBuffer *ChannelManager::getChannelBufferData(std::stri
 }
 
 void ChannelManager::addReceiveQueue(const std::string &adapterAddress, const BluetoothSppChannelId channelId,
-        const uint8_t *data, const uint32_t size)
+        const uint8_t *data, const uint32_t size, const int64_t receivedTime)
 {
 	if (0 == size)
 		return;
@@ -584,6 +597,7 @@ void ChannelManager::addReceiveQueue(const std::string &adapterAddress, const Bl
 			QueueData *queue = new QueueData();
 			queue->data = new uint8_t[size];
 			queue->size = size;
+			queue->receivedTime = receivedTime;
 			memcpy(queue->data, data, size);
 			std::lock_guard<std::mutex> guard(cmMutex);
 			channelInfo->receiveQueue.push(queue);
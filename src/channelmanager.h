@@ -22,6 +22,7 @@
 #include <unordered_map>
 #include <map>
 #include <mutex>
+#include <functional>
 
 #include <pbnjson.hpp>
 #include <bluetooth-sil-api.h>
@@ -30,6 +31,10 @@
 #define MAX_BUFFER_SIZE (1024*5)
 #define EMPTY_STRING ""
 
+// Called once the queued data of a channel was handed to its subscribers,
+// cpuTime is the thread CPU time the delivery took in microseconds
+typedef std::function<void(uint32_t size, int64_t receivedTime, uint64_t cpuTime)> ChannelDataDeliveredCallback;
+
 namespace pbnjson
 {
 	class JValue;
@@ -53,6 +58,8 @@ public:
 
 	typedef struct {
 		uint32_t size;
+		// Monotonic time the oldest data in the buffer was received, 0 if unknown
+		int64_t receivedTime;
 		uint8_t buffer[MAX_BUFFER_SIZE];
 	} DataBuffer;
 
@@ -70,7 +77,8 @@ public:
 	std::string markChannelAsNotConnected(const BluetoothSppChannelId channelId, const std::string &adapterAddress);
 	pbnjson::JValue getConnectedChannels(const std::string &address);
 	void addReceiveQueue(const std::string &adapterAddress, const BluetoothSppChannelId channelId, const uint8_t *data,
-	        const uint32_t size);
+	        const uint32_t size, const int64_t receivedTime = 0);
+	void setDataDeliveredCallback(ChannelDataDeliveredCallback callback) { mDataDeliveredCallback = callback; }
 	const DataBuffer *getChannelBufferData(std::string &channelId, const std::string &appName);
 	void notifyReceivedData(const std::string &adapterAddress, const BluetoothSppChannelId channelId);
 	std::string getMessageOwner(LSMessage *message);
@@ -86,6 +94,7 @@ public:
 private:
 	typedef struct {
 		uint32_t size;
+		int64_t receivedTime;
 		uint8_t *data;
 	} QueueData;
 
@@ -117,6 +126,7 @@ private:
 	std::vector<ReadDataInfo *> mReadDataSubscriptions;
 	std::vector<std::string> mConnectingChannels;
 	std::mutex cmMutex;
+	ChannelDataDeliveredCallback mDataDeliveredCallback;
 
 	void postToReadDataSubscriber(const uint8_t *data, const uint32_t size, const LSUtils::ClientWatch *watch,
 	        const std::string &adapterAddress, const std::string &channelId);
@@ -16,6 +16,7 @@
 
 
 #include "clientwatch.h"
+#include "ls2transport.h"
 
 namespace LSUtils
 {
@@ -31,7 +32,7 @@ ClientWatch::ClientWatch(LSHandle *handle, LSMessage *message, ClientWatchStatus
 		return;
 
 	LSMessageRef(mMessage);
-	startWatching();
+	getTransport()->watchClient(this);
 }
 
 ClientWatch::~ClientWatch()
@@ -40,18 +41,11 @@ ClientWatch::~ClientWatch()
 	if (mNotificationTimeout)
 		g_source_remove(mNotificationTimeout);
 
-	if (mCookie)
-	{
-		LS::Error error;
-
-		if (!LSCancelServerStatus(mHandle, mCookie, error.get()))
-			error.log(PmLogGetLibContext(), "LS_FAILED_TO_UNREG_SRV_STAT");
-	}
-
 	if (mMessage)
+	{
+		getTransport()->unwatchClient(this);
 		LSMessageUnref(mMessage);
-
-	LSCallCancelNotificationRemove(mHandle, &ClientWatch::clientCanceledCallback, this, NULL);
+	}
 }
 
 bool ClientWatch::serverStatusCallback(LSHandle *, const char *, bool connected, void *context)
@@ -95,6 +89,21 @@ void ClientWatch::startWatching()
 		throw error;
 }
 
+void ClientWatch::stopWatching()
+{
+	if (mCookie)
+	{
+		LS::Error error;
+
+		if (!LSCancelServerStatus(mHandle, mCookie, error.get()))
+			error.log(PmLogGetLibContext(), "LS_FAILED_TO_UNREG_SRV_STAT");
+
+		mCookie = 0;
+	}
+
+	LSCallCancelNotificationRemove(mHandle, &ClientWatch::clientCanceledCallback, this, NULL);
+}
+
 gboolean ClientWatch::sendClientDroppedNotification(gpointer user_data)
 {
 	ClientWatch *watch = static_cast<ClientWatch*>(user_data);
@@ -37,6 +37,9 @@ public:
 	void setCallback(ClientWatchStatusCallback callback) { mCallback = callback; }
 
 private:
+	friend class Transport;
+	friend class RecordingTransport;
+
 	LSHandle *mHandle;
 	LSMessage *mMessage;
 	void *mCookie;
@@ -44,6 +47,7 @@ private:
 	guint mNotificationTimeout;
 
 	void startWatching();
+	void stopWatching();
 	void cleanup();
 	void triggerClientDroppedNotification();
 
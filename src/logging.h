@@ -48,5 +48,11 @@ extern PmLogContext logContext;
 #define MSGID_SUBSCRIPTION_CLIENT_DROPPED           "SUBSCRIPTION_CLIENT_DROPPED"
 #define MSGID_INCOMING_PAIR_REQ_FAIL                "INCOMING_PAIR_REQ_FAIL"
 #define MSGID_UNPAIR_FROM_ANCS_FAILED               "OUTGOING_UNPAIR_FROM_ANCS_FAIL"
+#define MSGID_GATT_OPERATION_TIMEOUT                "GATT_OPERATION_TIMEOUT"
+#define MSGID_GATT_SERVICE_CACHE_WRITE_ERROR        "GATT_SERVICE_CACHE_WRITE_ERR"
+#define MSGID_SIL_TRACE_ERROR                       "SIL_TRACE_ERR"
+#define MSGID_METRICS_DUMP_ERROR                    "METRICS_DUMP_ERR"
+#define MSGID_MAIN_LOOP_STALL                       "MAIN_LOOP_STALL"
+#define MSGID_SPP_SOCKET_DATA_LOST                  "SPP_SOCKET_DATA_LOST"
 
 #endif // LOGGING_H
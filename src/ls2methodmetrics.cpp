@@ -0,0 +1,242 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "ls2methodmetrics.h"
+#include "ls2utils.h"
+#include "logging.h"
+#include "utils.h"
+#include "bluetoothmainloopwatchdog.h"
+#include "config.h"
+
+namespace LSUtils
+{
+
+static const uint64_t bucketLimits[METHOD_METRICS_BUCKETS - 1] = { 10, 100, 1000, 10000, 100000, 1000000 };
+static const char* const bucketNames[METHOD_METRICS_BUCKETS] = { "<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s" };
+
+static MethodMetrics methodMetrics;
+
+MethodMetrics& getMethodMetrics()
+{
+	return methodMetrics;
+}
+
+MethodCallStats::MethodCallStats() :
+	calls(0),
+	errors(0),
+	totalTime(0),
+	maxTime(0),
+	cpuTime(0)
+{
+	for (int bucket = 0; bucket < METHOD_METRICS_BUCKETS; bucket++)
+		histogram[bucket] = 0;
+}
+
+void MethodCallStats::add(uint64_t time, uint64_t cpuTime, bool failed)
+{
+	calls++;
+	if (failed)
+		errors++;
+
+	totalTime += time;
+	this->cpuTime += cpuTime;
+	if (time > maxTime)
+		maxTime = time;
+
+	int bucket = 0;
+	while (bucket < METHOD_METRICS_BUCKETS - 1 && time >= bucketLimits[bucket])
+		bucket++;
+	histogram[bucket]++;
+}
+
+static pbnjson::JValue buildStatsObject(const MethodCallStats &stats)
+{
+	pbnjson::JValue statsObj = pbnjson::Object();
+	statsObj.put("calls", (int64_t) stats.calls);
+	statsObj.put("errors", (int64_t) stats.errors);
+	statsObj.put("totalTime", (int64_t) stats.totalTime);
+	statsObj.put("maxTime", (int64_t) stats.maxTime);
+	statsObj.put("cpuTime", (int64_t) stats.cpuTime);
+
+	pbnjson::JValue histogramObj = pbnjson::Array();
+	for (int bucket = 0; bucket < METHOD_METRICS_BUCKETS; bucket++)
+		histogramObj.append((int64_t) stats.histogram[bucket]);
+	statsObj.put("histogram", histogramObj);
+
+	return statsObj;
+}
+
+MethodMetrics::Call::Call(LSMessage *message) :
+	mMessage(message),
+	mPrevious(getMethodMetrics().mCurrentCall),
+	mStartTime(g_get_monotonic_time()),
+	mStartCpuTime(getThreadCpuTime()),
+	mFailed(false)
+{
+	getMethodMetrics().mCurrentCall = this;
+}
+
+MethodMetrics::Call::~Call()
+{
+	getMethodMetrics().finish(this);
+}
+
+MethodMetrics::MethodMetrics() :
+	mCurrentCall(nullptr),
+	mDumpInterval(0),
+	mDumpTimer(0)
+{
+}
+
+MethodMetrics::~MethodMetrics()
+{
+	stopDump();
+}
+
+void MethodMetrics::finish(Call *call)
+{
+	uint64_t time = g_get_monotonic_time() - call->mStartTime;
+	uint64_t cpuTime = getThreadCpuTime() - call->mStartCpuTime;
+
+	mCurrentCall = call->mPrevious;
+
+	const char *category = LSMessageGetCategory(call->mMessage);
+	const char *method = LSMessageGetMethod(call->mMessage);
+	std::string name = std::string(category ? category : "") + "/" + (method ? method : "");
+
+	const char *caller = LSMessageGetApplicationID(call->mMessage);
+	if (!caller)
+		caller = LSMessageGetSenderServiceName(call->mMessage);
+	if (!caller)
+		caller = "unknown";
+
+	Method &entry = mMethods[name];
+	entry.total.add(time, cpuTime, call->mFailed);
+	entry.callers[caller].add(time, cpuTime, call->mFailed);
+
+	getMainLoopWatchdog().reportActivity(name, time);
+}
+
+void MethodMetrics::countError(LSMessage *message)
+{
+	for (Call *call = mCurrentCall; call; call = call->mPrevious)
+	{
+		if (call->mMessage == message)
+		{
+			call->mFailed = true;
+			return;
+		}
+	}
+}
+
+void MethodMetrics::reset()
+{
+	mMethods.clear();
+}
+
+pbnjson::JValue MethodMetrics::toJson() const
+{
+	pbnjson::JValue bucketsObj = pbnjson::Array();
+	for (int bucket = 0; bucket < METHOD_METRICS_BUCKETS; bucket++)
+		bucketsObj.append(std::string(bucketNames[bucket]));
+
+	pbnjson::JValue methodsObj = pbnjson::Array();
+	for (auto methodIter : mMethods)
+	{
+		pbnjson::JValue methodObj = buildStatsObject(methodIter.second.total);
+		methodObj.put("method", methodIter.first);
+
+		pbnjson::JValue callersObj = pbnjson::Array();
+		for (auto callerIter : methodIter.second.callers)
+		{
+			pbnjson::JValue callerObj = buildStatsObject(callerIter.second);
+			callerObj.put("caller", callerIter.first);
+			callersObj.append(callerObj);
+		}
+		methodObj.put("callers", callersObj);
+
+		methodsObj.append(methodObj);
+	}
+
+	pbnjson::JValue metricsObj = pbnjson::Object();
+	metricsObj.put("histogramBuckets", bucketsObj);
+	metricsObj.put("methods", methodsObj);
+
+	return metricsObj;
+}
+
+bool MethodMetrics::startDump(const std::string &fileName, unsigned int interval)
+{
+	stopDump();
+
+	if (!isPlainFileName(fileName))
+		return false;
+
+	if (g_mkdir_with_parents(WEBOS_BLUETOOTH_TRACE_DIR, 0700) != 0)
+	{
+		BT_ERROR(MSGID_METRICS_DUMP_ERROR, 0, "Failed to create trace directory %s", WEBOS_BLUETOOTH_TRACE_DIR);
+		return false;
+	}
+
+	mDumpPath = std::string(WEBOS_BLUETOOTH_TRACE_DIR) + "/" + fileName;
+	mDumpInterval = interval;
+
+	if (!dump())
+		return false;
+
+	mDumpTimer = g_timeout_add_seconds(interval, &MethodMetrics::handleDumpTimeout, this);
+
+	return true;
+}
+
+void MethodMetrics::stopDump()
+{
+	if (!mDumpTimer)
+		return;
+
+	g_source_remove(mDumpTimer);
+	mDumpTimer = 0;
+}
+
+bool MethodMetrics::dump()
+{
+	std::string payload;
+	generatePayload(toJson(), payload);
+
+	GError *error = 0;
+	if (!g_file_set_contents(mDumpPath.c_str(), payload.c_str(), payload.length(), &error))
+	{
+		BT_ERROR(MSGID_METRICS_DUMP_ERROR, 0, "Failed to write metrics to %s: %s", mDumpPath.c_str(), error->message);
+		g_error_free(error);
+		return false;
+	}
+
+	return true;
+}
+
+gboolean MethodMetrics::handleDumpTimeout(gpointer userData)
+{
+	MethodMetrics *metrics = static_cast<MethodMetrics*>(userData);
+	if (metrics->dump())
+		return TRUE;
+
+	metrics->mDumpTimer = 0;
+	return FALSE;
+}
+
+} // namespace LSUtils
@@ -0,0 +1,126 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef LS2_METHOD_METRICS_H_
+#define LS2_METHOD_METRICS_H_
+
+#include <string>
+#include <map>
+#include <stdint.h>
+#include <glib.h>
+#include <pbnjson.hpp>
+#include <luna-service2/lunaservice.hpp>
+
+// Handler latency buckets: <10us, <100us, <1ms, <10ms, <100ms, <1s, >=1s
+#define METHOD_METRICS_BUCKETS 7
+
+namespace LSUtils
+{
+
+class MethodCallStats
+{
+public:
+	MethodCallStats();
+
+	void add(uint64_t time, uint64_t cpuTime, bool failed);
+
+	uint64_t calls;
+	uint64_t errors;
+	// Wall clock and thread CPU time of the handlers in microseconds
+	uint64_t totalTime;
+	uint64_t maxTime;
+	uint64_t cpuTime;
+	uint64_t histogram[METHOD_METRICS_BUCKETS];
+};
+
+/*
+ * Call counts, error responses and handler latencies of every Luna method,
+ * in total and per caller. Methods registered through the LS_CATEGORY_*
+ * macros are dispatched through methodWrapper() which feeds these metrics.
+ * A call counts as failed when the handler responded with an error before
+ * returning; errors sent later from asynchronous callbacks are not seen.
+ */
+class MethodMetrics
+{
+public:
+	class Call
+	{
+	public:
+		Call(LSMessage *message);
+		Call(const Call &other) = delete;
+		~Call();
+
+	private:
+		LSMessage *mMessage;
+		Call *mPrevious;
+		int64_t mStartTime;
+		uint64_t mStartCpuTime;
+		bool mFailed;
+
+		friend class MethodMetrics;
+	};
+
+	MethodMetrics();
+	MethodMetrics(const MethodMetrics &other) = delete;
+	~MethodMetrics();
+
+	void countError(LSMessage *message);
+	void reset();
+
+	pbnjson::JValue toJson() const;
+
+	// Writes the metrics to fileName below WEBOS_BLUETOOTH_TRACE_DIR every
+	// interval seconds, fileName must not contain a directory
+	bool startDump(const std::string &fileName, unsigned int interval);
+	void stopDump();
+	bool isDumping() const { return mDumpTimer != 0; }
+	std::string getDumpPath() const { return mDumpPath; }
+	unsigned int getDumpInterval() const { return mDumpInterval; }
+
+private:
+	class Method
+	{
+	public:
+		MethodCallStats total;
+		std::map<std::string, MethodCallStats> callers;
+	};
+
+	std::map<std::string, Method> mMethods;
+	Call *mCurrentCall;
+	std::string mDumpPath;
+	unsigned int mDumpInterval;
+	guint mDumpTimer;
+
+	void finish(Call *call);
+	bool dump();
+
+	static gboolean handleDumpTimeout(gpointer userData);
+};
+
+MethodMetrics& getMethodMetrics();
+
+template<class Class, bool (Class::*Handler)(LSMessage&)>
+bool methodWrapper(LSHandle *handle, LSMessage *message, void *context)
+{
+	MethodMetrics::Call call(message);
+	return LS::Handle::methodWraper<Class, Handler>(handle, message, context);
+}
+
+} // namespace LSUtils
+
+#endif // LS2_METHOD_METRICS_H_
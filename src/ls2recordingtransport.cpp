@@ -0,0 +1,112 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include <algorithm>
+
+#include "ls2recordingtransport.h"
+#include "clientwatch.h"
+
+namespace LSUtils
+{
+
+RecordingTransport::RecordingTransport() :
+	mRecording(true),
+	mPostCount(0),
+	mPostedBytes(0)
+{
+}
+
+void RecordingTransport::respond(LS::Message &message, const std::string &payload)
+{
+	mPostCount++;
+	mPostedBytes += payload.size();
+
+	if (!mRecording)
+		return;
+
+	RecordedPost post;
+	post.message = message.get();
+	post.payload = payload;
+	mPosts.push_back(post);
+}
+
+void RecordingTransport::post(LS::SubscriptionPoint *subscriptionPoint, const std::string &payload)
+{
+	mPostCount++;
+	mPostedBytes += payload.size();
+
+	if (!mRecording)
+		return;
+
+	RecordedPost post;
+	post.subscriptionPoint = subscriptionPoint;
+	post.payload = payload;
+	mPosts.push_back(post);
+}
+
+void RecordingTransport::watchClient(ClientWatch *watch)
+{
+	mWatches.push_back(watch);
+}
+
+void RecordingTransport::unwatchClient(ClientWatch *watch)
+{
+	mWatches.erase(std::remove(mWatches.begin(), mWatches.end(), watch), mWatches.end());
+}
+
+ClientWatch* RecordingTransport::findWatch(LSMessage *message) const
+{
+	for (auto watch : mWatches)
+	{
+		if (watch->getMessage() == message)
+			return watch;
+	}
+
+	return nullptr;
+}
+
+bool RecordingTransport::dropClient(LSMessage *message)
+{
+	ClientWatch *watch = findWatch(message);
+	if (!watch)
+		return false;
+
+	watch->notifyClientDisconnected();
+
+	return true;
+}
+
+bool RecordingTransport::cancelClient(LSMessage *message)
+{
+	ClientWatch *watch = findWatch(message);
+	if (!watch)
+		return false;
+
+	watch->notifyClientCanceled(LSMessageGetUniqueToken(message));
+
+	return true;
+}
+
+void RecordingTransport::clear()
+{
+	mPosts.clear();
+	mPostCount = 0;
+	mPostedBytes = 0;
+}
+
+} // namespace LSUtils
@@ -0,0 +1,87 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef LS2_RECORDING_TRANSPORT_H_
+#define LS2_RECORDING_TRANSPORT_H_
+
+#include <string>
+#include <vector>
+
+#include "ls2transport.h"
+
+namespace LSUtils
+{
+
+class RecordedPost
+{
+public:
+	RecordedPost() :
+		message(nullptr),
+		subscriptionPoint(nullptr)
+	{
+	}
+
+	LSMessage *message;
+	LS::SubscriptionPoint *subscriptionPoint;
+	std::string payload;
+};
+
+/*
+ * In-process transport which never touches the hub. Responses and
+ * subscription posts are recorded instead of sent, and watched clients
+ * can be dropped or canceled on demand to drive the cleanup paths. With
+ * recording disabled only posts and bytes are counted, so measurements
+ * don't include the copies of the payloads.
+ */
+class RecordingTransport : public Transport
+{
+public:
+	RecordingTransport();
+	RecordingTransport(const RecordingTransport &other) = delete;
+
+	void respond(LS::Message &message, const std::string &payload);
+	void post(LS::SubscriptionPoint *subscriptionPoint, const std::string &payload);
+
+	void watchClient(ClientWatch *watch);
+	void unwatchClient(ClientWatch *watch);
+
+	// Both return false if no watch exists for the message
+	bool dropClient(LSMessage *message);
+	bool cancelClient(LSMessage *message);
+
+	void setRecording(bool recording) { mRecording = recording; }
+
+	const std::vector<RecordedPost>& getPosts() const { return mPosts; }
+	unsigned long long getPostCount() const { return mPostCount; }
+	unsigned long long getPostedBytes() const { return mPostedBytes; }
+	unsigned int getWatchCount() const { return mWatches.size(); }
+	void clear();
+
+private:
+	std::vector<RecordedPost> mPosts;
+	std::vector<ClientWatch*> mWatches;
+	bool mRecording;
+	unsigned long long mPostCount;
+	unsigned long long mPostedBytes;
+
+	ClientWatch* findWatch(LSMessage *message) const;
+};
+
+} // namespace LSUtils
+
+#endif // LS2_RECORDING_TRANSPORT_H_
@@ -0,0 +1,66 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#include "ls2transport.h"
+#include "clientwatch.h"
+#include "logging.h"
+
+namespace LSUtils
+{
+
+static Transport defaultTransport;
+static Transport *currentTransport = &defaultTransport;
+
+Transport* getTransport()
+{
+	return currentTransport;
+}
+
+void setTransport(Transport *transport)
+{
+	currentTransport = transport ? transport : &defaultTransport;
+}
+
+void Transport::respond(LS::Message &message, const std::string &payload)
+{
+	try
+	{
+		message.respond(payload.c_str());
+	}
+	catch (LS::Error &error)
+	{
+		BT_ERROR(MSGID_LS2_FAILED_TO_SEND, 0, "Failed to submit response: %s", error.what());
+	}
+}
+
+void Transport::post(LS::SubscriptionPoint *subscriptionPoint, const std::string &payload)
+{
+	subscriptionPoint->post(payload.c_str());
+}
+
+void Transport::watchClient(ClientWatch *watch)
+{
+	watch->startWatching();
+}
+
+void Transport::unwatchClient(ClientWatch *watch)
+{
+	watch->stopWatching();
+}
+
+} // namespace LSUtils
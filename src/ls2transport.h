@@ -0,0 +1,54 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+
+#ifndef LS2_TRANSPORT_H_
+#define LS2_TRANSPORT_H_
+
+#include <string>
+#include <luna-service2/lunaservice.hpp>
+
+namespace LSUtils
+{
+
+class ClientWatch;
+
+/*
+ * Everything the service sends to its clients, and every client it
+ * watches, goes through the current transport. The default one talks to
+ * the hub; another implementation can be installed with setTransport() to
+ * run request paths in-process, e.g. to profile them.
+ */
+class Transport
+{
+public:
+	virtual ~Transport() {}
+
+	virtual void respond(LS::Message &message, const std::string &payload);
+	virtual void post(LS::SubscriptionPoint *subscriptionPoint, const std::string &payload);
+
+	virtual void watchClient(ClientWatch *watch);
+	virtual void unwatchClient(ClientWatch *watch);
+};
+
+Transport* getTransport();
+// Passing nullptr restores the default transport
+void setTransport(Transport *transport);
+
+} // namespace LSUtils
+
+#endif // LS2_TRANSPORT_H_
@@ -22,6 +22,8 @@
 #include <pbnjson.hpp>
 #include <luna-service2/lunaservice.hpp>
 #include "bluetootherrors.h"
+#include "ls2transport.h"
+#include "ls2methodmetrics.h"
 
 #define LS_CATEGORY_TABLE_NAME(name) name##_table
 
@@ -32,12 +34,15 @@
 	typedef cl cl_t; \
 	constexpr static const LSMethod LS_CATEGORY_TABLE_NAME(name)[] = {
 
+// Route every method through LSUtils::methodWrapper to collect call metrics
+#define BT_CATEGORY_METHOD(name) LS_CATEGORY_MAPPED_METHOD(name, name)
+
 #define LS_CATEGORY_MAPPED_METHOD(name, func) { #name, \
-	&LS::Handle::methodWraper<cl_t, &cl_t::func>, \
+	&LSUtils::methodWrapper<cl_t, &cl_t::func>, \
 	static_cast<LSMethodFlags>(0) },
 
 #define LS_CATEGORY_CLASS_METHOD(cls, name) { #name, \
-	&LS::Handle::methodWraper<cls, &cls::name>, \
+	&LSUtils::methodWrapper<cls, &cls::name>, \
 	static_cast<LSMethodFlags>(0) },
 
 #define LS_CREATE_CATEGORY_END \
@@ -69,6 +74,7 @@
 #define PROP(name, type)                              "\"" #name "\":{\"type\":\"" #type "\"}"
 #define PROP_WITH_VAL_1(name, type, v1)               "\"" #name "\":{\"type\":\"" #type "\", \"enum\": [" #v1 "]}"
 #define PROP_WITH_VAL_2(name, type, v1, v2)           "\"" #name "\":{\"type\":\"" #type "\", \"enum\": [" #v1 ", " #v2 "]}"
+#define PROP_WITH_VAL_3(name, type, v1, v2, v3)       "\"" #name "\":{\"type\":\"" #type "\", \"enum\": [" #v1 ", " #v2 ", " #v3 "]}"
 #define ARRAY(name, type)                             "\"" #name "\":{\"type\":\"array\", \"items\":{\"type\":\"" #type "\"}}"
 #define OBJARRAY(name, objschema)                     "\"" #name "\":{\"type\":\"array\", \"items\": " objschema "}"
 #define OBJSCHEMA_1(param)                            "{\"type\":\"object\",\"properties\":{" param "}}"
@@ -148,7 +154,8 @@ inline void respondWithError(LS::Message &message, const std::string& errorText,
 	std::string payload;
 	generatePayload(responseObj, payload);
 
-	message.respond(payload.c_str());
+	getMethodMetrics().countError(message.get());
+	getTransport()->respond(message, payload);
 }
 
 inline void respondWithError(LSMessage *message, const std::string& errorText, unsigned int errorCode = -1)
@@ -190,10 +197,16 @@ inline void postToSubscriptionPoint(LS::SubscriptionPoint *subscriptionPoint, pb
 	std::string payload;
 	LSUtils::generatePayload(object, payload);
 
-	subscriptionPoint->post(payload.c_str());
+	getTransport()->post(subscriptionPoint, payload);
+}
+
+inline void postToSubscriptionPoint(LS::SubscriptionPoint *subscriptionPoint, const std::string &payload)
+{
+	getTransport()->post(subscriptionPoint, payload);
 }
 
 void postToClient(LS::Message &message, pbnjson::JValue &object);
+void postToClient(LS::Message &message, const std::string &payload);
 
 inline void postToClient(LSMessage *message, pbnjson::JValue &object)
 {
@@ -16,6 +16,7 @@
 
 #include "bluetoothpairstate.h"
 #include "bluetoothmanagerservice.h"
+#include "bluetoothstartupprofiler.h"
 #include "config.h"
 #include "logging.h"
 #include "utils.h"
@@ -64,6 +65,7 @@ int main(int argc, char **argv)
 		GOptionContext *context;
 		GError *err = NULL;
 
+		getStartupProfiler().start();
 		write_kernel_log("[bt_time] execute main ");
 
 		context = g_option_context_new(NULL);
@@ -79,6 +81,7 @@ int main(int argc, char **argv)
 		}
 
 		g_option_context_free(context);
+		getStartupProfiler().record("parseOptions", getStartupProfiler().getStartTime());
 
 		if (option_version == TRUE) {
 			printf("%s\n", VERSION);
@@ -98,8 +101,11 @@ int main(int argc, char **argv)
 
 		BT_DEBUG("Starting bluetooth manager service");
 
+		int64_t startTime = g_get_monotonic_time();
 		BluetoothManagerService manager; // manager creator throw the LS:Error but can't {}
         manager.attachToLoop(mainLoop);
+		getStartupProfiler().record("createManagerService", startTime);
+		getStartupProfiler().finish();
 
 		g_main_loop_run(mainLoop);
 
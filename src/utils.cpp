@@ -93,6 +93,14 @@ bool checkFileIsValid(const std::string &path)
 	return  g_file_test(testPath.c_str(), (GFileTest)(G_FILE_TEST_EXISTS | G_FILE_TEST_IS_REGULAR));
 }
 
+bool isPlainFileName(const std::string &name)
+{
+	if (name.empty() || name == "." || name == "..")
+		return false;
+
+	return name.find('/') == std::string::npos;
+}
+
 /**
 *      write_klog
 *
@@ -103,7 +111,7 @@ bool checkFileIsValid(const std::string &path)
 void write_kernel_log(const char *message)
 {
    int fd;
-   char buffer[1024];
+   char buffer[1024] = "";
 
 
 	fd = open("/dev/kmsg", O_RDWR);
@@ -139,3 +147,12 @@ void bt_ready_msg2kernel(void)
 	BT_DEBUG("Get BTUSB_READY %ld.%ld PerfType:BtMngr PerfGroup:BT_INITIALIZED \n", (long)sec, msec );
 	write_kernel_log(logBuf);
 }
+
+uint64_t getThreadCpuTime()
+{
+	struct timespec ts;
+	if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+		return 0;
+
+	return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
@@ -19,6 +19,7 @@
 
 #include <string>
 #include <vector>
+#include <stdint.h>
 
 std::vector<std::string> split(const std::string &s, char delim);
 std::string convertToLower(const std::string &input);
@@ -26,7 +27,12 @@ std::string convertToUpper(const std::string &input);
 
 bool checkPathExists(const std::string &path);
 bool checkFileIsValid(const std::string &path);
+// True for a file name without any directory part
+bool isPlainFileName(const std::string &name);
 
 void write_kernel_log(const char *message);
 void bt_ready_msg2kernel(void);
+
+// CPU time consumed by the calling thread in microseconds
+uint64_t getThreadCpuTime();
 #endif // UTILS_H
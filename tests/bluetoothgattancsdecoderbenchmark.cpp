@@ -0,0 +1,104 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include "bluetoothgattancsdecoder.h"
+
+/*
+ * Measures how long BluetoothGattAncsDecoder takes per attribute for a
+ * typical Get Notification Attributes answer, once as a single block and
+ * once in the 20 byte pieces a default ATT MTU delivers.
+ */
+
+#define DEFAULT_ITERATIONS 200000
+#define DEFAULT_MTU_PAYLOAD 20
+
+class CountingSink : public BluetoothGattAncsAttributeSink
+{
+public:
+	void attributeStarted(uint8_t attrId, uint16_t length) { started++; }
+	void attributeData(uint8_t attrId, const uint8_t *data, size_t length) { bytes += length; }
+	void attributeCompleted(uint8_t attrId) { completed++; }
+
+	unsigned long long started = 0;
+	unsigned long long bytes = 0;
+	unsigned long long completed = 0;
+};
+
+static void appendAttribute(std::vector<uint8_t> &block, uint8_t id, const std::string &value)
+{
+	block.push_back(id);
+	block.push_back(value.size() & 0xff);
+	block.push_back((value.size() >> 8) & 0xff);
+	block.insert(block.end(), value.begin(), value.end());
+}
+
+static double now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void run(const char *name, const std::vector<uint8_t> &block, size_t fragmentSize, unsigned int iterations)
+{
+	BluetoothGattAncsDecoder decoder;
+	CountingSink sink;
+
+	double start = now();
+
+	for (unsigned int n = 0; n < iterations; n++)
+	{
+		for (size_t offset = 0; offset < block.size(); offset += fragmentSize)
+		{
+			size_t length = block.size() - offset;
+			if (length > fragmentSize)
+				length = fragmentSize;
+			decoder.feed(block.data() + offset, length, sink);
+		}
+	}
+
+	double elapsed = now() - start;
+
+	printf("%-10s %8u answers %10llu attributes %8.1f ns/attribute %8.1f MB/s\n", name, iterations,
+	       sink.completed, elapsed * 1e9 / sink.completed, block.size() * (double) iterations / elapsed / 1e6);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int iterations = DEFAULT_ITERATIONS;
+	if (argc > 1)
+		iterations = strtoul(argv[1], 0, 10);
+
+	std::vector<uint8_t> block;
+	appendAttribute(block, 0, "com.apple.MobileSMS");
+	appendAttribute(block, 1, "John Appleseed");
+	appendAttribute(block, 2, "");
+	appendAttribute(block, 3, std::string(120, 'm'));
+	appendAttribute(block, 4, "14");
+	appendAttribute(block, 5, "20180101T100000");
+
+	run("block", block, block.size(), iterations);
+	run("fragments", block, DEFAULT_MTU_PAYLOAD, iterations);
+
+	return 0;
+}
@@ -0,0 +1,197 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "bluetoothgattancsdecoder.h"
+
+/*
+ * Feeds a corpus of Data Source answers to BluetoothGattAncsDecoder split
+ * at every offset, at every pair of offsets and byte by byte, and checks
+ * that the same attributes come out each time.
+ */
+
+typedef struct
+{
+	uint8_t id;
+	uint16_t length;
+	std::string value;
+	bool completed;
+} DecodedAttribute;
+
+class RecordingSink : public BluetoothGattAncsAttributeSink
+{
+public:
+	void attributeStarted(uint8_t attrId, uint16_t length)
+	{
+		DecodedAttribute attribute;
+		attribute.id = attrId;
+		attribute.length = length;
+		attribute.completed = false;
+		attributes.push_back(attribute);
+	}
+
+	void attributeData(uint8_t attrId, const uint8_t *data, size_t length)
+	{
+		if (attributes.empty() || attributes.back().id != attrId || attributes.back().completed)
+		{
+			errors++;
+			return;
+		}
+
+		attributes.back().value.append(reinterpret_cast<const char*>(data), length);
+	}
+
+	void attributeCompleted(uint8_t attrId)
+	{
+		if (attributes.empty() || attributes.back().id != attrId || attributes.back().completed)
+		{
+			errors++;
+			return;
+		}
+
+		attributes.back().completed = true;
+	}
+
+	std::vector<DecodedAttribute> attributes;
+	unsigned int errors = 0;
+};
+
+static void appendAttribute(std::vector<uint8_t> &block, std::vector<DecodedAttribute> &expected,
+                            uint8_t id, const std::string &value)
+{
+	block.push_back(id);
+	block.push_back(value.size() & 0xff);
+	block.push_back((value.size() >> 8) & 0xff);
+	block.insert(block.end(), value.begin(), value.end());
+
+	DecodedAttribute attribute;
+	attribute.id = id;
+	attribute.length = value.size();
+	attribute.value = value;
+	attribute.completed = true;
+	expected.push_back(attribute);
+}
+
+static bool matches(const RecordingSink &sink, const std::vector<DecodedAttribute> &expected)
+{
+	if (sink.errors > 0 || sink.attributes.size() != expected.size())
+		return false;
+
+	for (size_t n = 0; n < expected.size(); n++)
+	{
+		const DecodedAttribute &decoded = sink.attributes[n];
+		if (decoded.id != expected[n].id || decoded.length != expected[n].length ||
+		    decoded.value != expected[n].value || !decoded.completed)
+			return false;
+	}
+
+	return true;
+}
+
+static bool decodeSplit(const std::vector<uint8_t> &block, const std::vector<DecodedAttribute> &expected,
+                        const std::vector<size_t> &offsets)
+{
+	BluetoothGattAncsDecoder decoder;
+	RecordingSink sink;
+	size_t start = 0;
+
+	for (size_t offset : offsets)
+	{
+		decoder.feed(block.data() + start, offset - start, sink);
+		start = offset;
+	}
+	decoder.feed(block.data() + start, block.size() - start, sink);
+
+	return matches(sink, expected) && decoder.isBetweenAttributes() &&
+	       decoder.getDecodedAttributeCount() == expected.size();
+}
+
+static bool checkCorpusEntry(const char *name, const std::vector<uint8_t> &block,
+                             const std::vector<DecodedAttribute> &expected)
+{
+	unsigned int failures = 0;
+
+	if (!decodeSplit(block, expected, std::vector<size_t>()))
+		failures++;
+
+	for (size_t first = 0; first <= block.size(); first++)
+	{
+		for (size_t second = first; second <= block.size(); second++)
+		{
+			if (!decodeSplit(block, expected, std::vector<size_t>{first, second}))
+				failures++;
+		}
+	}
+
+	std::vector<size_t> bytewise;
+	for (size_t offset = 1; offset < block.size(); offset++)
+		bytewise.push_back(offset);
+	if (!decodeSplit(block, expected, bytewise))
+		failures++;
+
+	printf("%-24s %4zu bytes %2zu attributes: %s\n", name, block.size(), expected.size(),
+	       failures ? "FAILED" : "ok");
+
+	return failures == 0;
+}
+
+int main()
+{
+	bool success = true;
+
+	{
+		// Get Notification Attributes: title, subtitle, message, date
+		std::vector<uint8_t> block;
+		std::vector<DecodedAttribute> expected;
+		appendAttribute(block, expected, 1, "Mail");
+		appendAttribute(block, expected, 2, "Re: meeting");
+		appendAttribute(block, expected, 3, "See you at ten");
+		appendAttribute(block, expected, 5, "20180101T100000");
+		success &= checkCorpusEntry("notification", block, expected);
+	}
+
+	{
+		std::vector<uint8_t> block;
+		std::vector<DecodedAttribute> expected;
+		appendAttribute(block, expected, 0, "com.apple.mobilemail");
+		appendAttribute(block, expected, 1, "");
+		appendAttribute(block, expected, 2, "");
+		appendAttribute(block, expected, 3, "x");
+		success &= checkCorpusEntry("empty values", block, expected);
+	}
+
+	{
+		// Values longer than 255 bytes use the high length byte
+		std::vector<uint8_t> block;
+		std::vector<DecodedAttribute> expected;
+		appendAttribute(block, expected, 3, std::string(300, 'm'));
+		appendAttribute(block, expected, 1, "Title");
+		success &= checkCorpusEntry("long value", block, expected);
+	}
+
+	{
+		std::vector<uint8_t> block;
+		std::vector<DecodedAttribute> expected;
+		appendAttribute(block, expected, 0, "");
+		success &= checkCorpusEntry("single empty value", block, expected);
+	}
+
+	return success ? 0 : 1;
+}
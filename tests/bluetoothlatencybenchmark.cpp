@@ -0,0 +1,317 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <luna-service2/lunaservice.hpp>
+
+#include "bluetoothmanagerservice.h"
+#include "ls2recordingtransport.h"
+#include "ls2utils.h"
+#include "logging.h"
+#include "virtualdevice.h"
+
+/*
+ * Measures the latency from SIL callbacks to the Luna posts of an
+ * in-process BluetoothManagerService running on the virtual controller
+ * SIL. The virtual controller reports deviceFound for a discovery and
+ * characteristicValueChanged for one monitored characteristic, both at
+ * the given rate, while /device/getStatus and /gatt/monitorCharacteristics
+ * are subscribed. The p50/p99/p999 and maximum latency per event and the
+ * longest main loop stall of /adapter/internal/getLatencyStatus are
+ * written as JSON.
+ *
+ * The intervals of the virtual controller are whole milliseconds, so the
+ * rate is rounded to 1000 / interval events per second and is at most
+ * 1000. SPP dataReceived is not driven; bluetoothsppbenchmark covers SPP.
+ *
+ * Like bluetoothregistrybenchmark it registers com.webos.service.bluetooth2,
+ * so the installed service has to be stopped first.
+ */
+
+#define SERVICE_URI "luna://com.webos.service.bluetooth2"
+#define REQUEST_TIMEOUT 10 // seconds
+#define DEFAULT_RATE 100 // events per second
+#define DEFAULT_DURATION 10 // seconds
+// Discovery keeps reporting new devices for the measurement and the set up
+#define DISCOVERY_MARGIN 10 // seconds
+#define MAX_VIRTUAL_DEVICES 65536
+
+PmLogContext logContext;
+
+class LatencyBenchmark
+{
+public:
+	LatencyBenchmark(LS::Handle *client, LSUtils::RecordingTransport *transport, unsigned int interval, unsigned int duration) :
+		mClient(client),
+		mTransport(transport),
+		mInterval(interval),
+		mDuration(duration)
+	{
+	}
+
+	bool setUp();
+	bool run(pbnjson::JValue &resultObj);
+
+private:
+	LS::Handle *mClient;
+	LSUtils::RecordingTransport *mTransport;
+	unsigned int mInterval;
+	unsigned int mDuration;
+	std::vector<LS::Call> mSubscriptions;
+
+	bool call(const std::string &method, const std::string &payload, bool subscribe, pbnjson::JValue &responseObj);
+	bool poll(const std::string &method, const std::string &payload, std::function<bool(pbnjson::JValue&)> condition);
+	void iterate(unsigned int duration);
+};
+
+bool LatencyBenchmark::call(const std::string &method, const std::string &payload, bool subscribe,
+                            pbnjson::JValue &responseObj)
+{
+	size_t first = mTransport->getPosts().size();
+	std::string uri = std::string(SERVICE_URI) + method;
+	LS::Call call = mClient->callMultiReply(uri.c_str(), payload.c_str());
+
+	// Responses are taken from the transport; the client never gets them
+	gint64 deadline = g_get_monotonic_time() + REQUEST_TIMEOUT * G_USEC_PER_SEC;
+	while (g_get_monotonic_time() < deadline)
+	{
+		const std::vector<LSUtils::RecordedPost> &posts = mTransport->getPosts();
+		for (size_t n = first; n < posts.size(); n++)
+		{
+			if (!posts[n].message)
+				continue;
+
+			if (!LSUtils::parsePayload(posts[n].payload, responseObj))
+				return false;
+
+			// Keeping the call open keeps the subscription alive
+			if (subscribe)
+				mSubscriptions.push_back(std::move(call));
+
+			mTransport->clear();
+
+			return true;
+		}
+
+		if (!g_main_context_iteration(nullptr, FALSE))
+			g_usleep(1000);
+	}
+
+	fprintf(stderr, "No response to %s %s\n", method.c_str(), payload.c_str());
+	return false;
+}
+
+bool LatencyBenchmark::poll(const std::string &method, const std::string &payload,
+                            std::function<bool(pbnjson::JValue&)> condition)
+{
+	gint64 deadline = g_get_monotonic_time() + REQUEST_TIMEOUT * G_USEC_PER_SEC;
+	while (g_get_monotonic_time() < deadline)
+	{
+		pbnjson::JValue responseObj;
+		if (call(method, payload, false, responseObj) && responseObj["returnValue"].asBool() && condition(responseObj))
+			return true;
+
+		iterate(10);
+	}
+
+	fprintf(stderr, "Timed out waiting on %s %s\n", method.c_str(), payload.c_str());
+	return false;
+}
+
+void LatencyBenchmark::iterate(unsigned int duration)
+{
+	gint64 deadline = g_get_monotonic_time() + (gint64) duration * 1000;
+	while (g_get_monotonic_time() < deadline)
+	{
+		if (!g_main_context_iteration(nullptr, FALSE))
+			g_usleep(100);
+	}
+}
+
+bool LatencyBenchmark::setUp()
+{
+	pbnjson::JValue responseObj;
+
+	// The adapter address is known once the SIL reported its properties
+	if (!poll("/device/internal/getRegistryStatus", "{}", [](pbnjson::JValue &responseObj) { return true; }))
+		return false;
+
+	if (!call("/adapter/setState", "{\"powered\":true}", false, responseObj))
+		return false;
+
+	if (!poll("/adapter/getStatus", "{}", [](pbnjson::JValue &responseObj) {
+		return responseObj["adapters"].arraySize() > 0 && responseObj["adapters"][0]["powered"].asBool();
+	}))
+		return false;
+
+	// Every new device is posted to this subscriber
+	if (!call("/device/getStatus", "{\"subscribe\":true}", true, responseObj) ||
+	    !call("/adapter/startDiscovery", "{}", false, responseObj) || !responseObj["returnValue"].asBool())
+	{
+		fprintf(stderr, "Failed to start the discovery\n");
+		return false;
+	}
+
+	// The first LE device is the second one the virtual controller reports
+	std::string address = "02:1e:00:00:00:00";
+	std::string connectPayload = "{\"address\":\"" + address + "\"}";
+	std::string clientId;
+	if (!poll("/gatt/connect", connectPayload, [&clientId](pbnjson::JValue &responseObj) {
+		clientId = responseObj["clientId"].asString();
+		return true;
+	}))
+		return false;
+
+	if (!call("/gatt/discoverServices", connectPayload, false, responseObj) || !responseObj["returnValue"].asBool())
+	{
+		fprintf(stderr, "Failed to discover the services of %s\n", address.c_str());
+		return false;
+	}
+
+	gchar *characteristic = g_strdup_printf(VIRTUAL_LOAD_CHARACTERISTIC_FORMAT, 1);
+	std::string monitorPayload = std::string("{\"clientId\":\"") + clientId + "\",\"service\":\"" VIRTUAL_LOAD_SERVICE_UUID "\","
+	                             "\"characteristics\":[\"" + characteristic + "\"],\"subscribe\":true}";
+	g_free(characteristic);
+
+	if (!call("/gatt/monitorCharacteristics", monitorPayload, true, responseObj) || !responseObj["returnValue"].asBool())
+	{
+		fprintf(stderr, "Failed to monitor %s: %s\n", address.c_str(), monitorPayload.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool LatencyBenchmark::run(pbnjson::JValue &resultObj)
+{
+	pbnjson::JValue responseObj;
+
+	// Samples of the set up are dropped
+	if (!call("/adapter/internal/setLatencyTracking", "{\"enabled\":true,\"reset\":true}", false, responseObj) ||
+	    !responseObj["returnValue"].asBool())
+	{
+		fprintf(stderr, "Failed to enable latency tracking\n");
+		return false;
+	}
+
+	mTransport->setRecording(false);
+	iterate(mDuration * 1000);
+	mTransport->setRecording(true);
+	mTransport->clear();
+
+	if (!call("/adapter/internal/getLatencyStatus", "{}", false, responseObj) || !responseObj["returnValue"].asBool())
+	{
+		fprintf(stderr, "Failed to get the latency status\n");
+		return false;
+	}
+
+	resultObj = pbnjson::Object();
+	resultObj.put("rate", (int32_t) (1000 / mInterval));
+	resultObj.put("interval", (int32_t) mInterval);
+	resultObj.put("duration", (int32_t) mDuration);
+	resultObj.put("events", responseObj["events"]);
+	if (responseObj.hasKey("maxStall"))
+		resultObj.put("maxStall", responseObj["maxStall"]);
+
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int rate = argc > 1 ? strtoul(argv[1], 0, 10) : DEFAULT_RATE;
+	unsigned int duration = argc > 2 ? strtoul(argv[2], 0, 10) : DEFAULT_DURATION;
+	const char *outputPath = argc > 3 ? argv[3] : nullptr;
+
+	if (rate == 0 || duration == 0)
+	{
+		fprintf(stderr, "Usage: %s [events per second] [seconds] [output file]\n", argv[0]);
+		return 1;
+	}
+
+	if (PmLogGetContext("webos-bluetooth-service", &logContext) != kPmLogErr_None)
+	{
+		fprintf(stderr, "Failed to setup up log context\n");
+		return 1;
+	}
+
+	unsigned int interval = rate < 1000 ? 1000 / rate : 1;
+	unsigned int devices = std::min<unsigned int>((1000 / interval) * (duration + DISCOVERY_MARGIN), MAX_VIRTUAL_DEVICES);
+
+	// Virtual controller reporting one new device and one notification per interval
+	gchar *configPath = g_build_filename(g_get_tmp_dir(), "bluetoothlatencybenchmark.conf", NULL);
+	gchar *config = g_strdup_printf("[Controller]\nBrEdrDevices=%u\nLeDevices=1\nDiscoveryInterval=%u\nRssiInterval=0\n"
+	                                "ServiceDiscoveryDelay=0\nGattCharacteristics=1\nNotifyInterval=%u\nSppRate=0\n",
+	                                devices, interval, interval);
+	bool written = g_file_set_contents(configPath, config, -1, nullptr);
+	g_free(config);
+	if (!written)
+	{
+		fprintf(stderr, "Failed to write %s\n", configPath);
+		g_free(configPath);
+		return 1;
+	}
+
+	g_setenv("WEBOS_BLUETOOTH_VIRTUAL_SIL_CONFIG", configPath, TRUE);
+	g_setenv("WEBOS_BLUETOOTH_SIL", "virtual", TRUE);
+	g_setenv("WEBOS_BLUETOOTH_SIL_BASE_PATH", VIRTUAL_SIL_BUILD_DIR, FALSE);
+
+	LSUtils::RecordingTransport transport;
+	LSUtils::setTransport(&transport);
+
+	GMainLoop *mainLoop = g_main_loop_new(NULL, FALSE);
+	bool success = false;
+
+	try
+	{
+		BluetoothManagerService manager;
+		manager.attachToLoop(mainLoop);
+
+		LS::Handle client = LS::registerService();
+		client.attachToLoop(mainLoop);
+
+		LatencyBenchmark benchmark(&client, &transport, interval, duration);
+		pbnjson::JValue resultObj;
+		success = benchmark.setUp() && benchmark.run(resultObj);
+
+		if (success)
+		{
+			std::string result = resultObj.stringify() + "\n";
+			if (outputPath)
+				success = g_file_set_contents(outputPath, result.c_str(), -1, nullptr);
+			else
+				fputs(result.c_str(), stdout);
+		}
+	}
+	catch (const LS::Error &error)
+	{
+		fprintf(stderr, "Failed to register on the bus, is the service still running? %s\n", error.what());
+	}
+
+	LSUtils::setTransport(nullptr);
+	g_main_loop_unref(mainLoop);
+	g_unlink(configPath);
+	g_free(configPath);
+
+	return success ? 0 : 1;
+}
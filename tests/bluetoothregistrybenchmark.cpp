@@ -0,0 +1,434 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <luna-service2/lunaservice.hpp>
+
+#include "bluetoothmanagerservice.h"
+#include "ls2recordingtransport.h"
+#include "ls2utils.h"
+#include "logging.h"
+
+/*
+ * Drives the device registry of an in-process BluetoothManagerService
+ * through its SIL observer callbacks and measures the CPU time, heap
+ * allocations and payload bytes per event for registries of 10 to 5000
+ * devices and 1 to 50 /device/getStatus subscribers. leDeviceFoundByScanId
+ * is measured against a scan started through /le/startScan, so the whole
+ * startScan -> leDeviceFoundByScanId -> post path runs.
+ *
+ * The service registers com.webos.service.bluetooth2 on the hub, so the
+ * installed service has to be stopped first. Responses and subscription
+ * posts go to a RecordingTransport and never reach the client. The adapter
+ * is the virtual controller SIL without simulated devices.
+ */
+
+#define SERVICE_URI "luna://com.webos.service.bluetooth2"
+#define REQUEST_TIMEOUT 10 // seconds
+#define DEFAULT_EVENTS_PER_MEASUREMENT 100
+
+PmLogContext logContext;
+
+static const unsigned int deviceCounts[] = { 10, 100, 1000, 5000 };
+static const unsigned int subscriberCounts[] = { 1, 10, 50 };
+
+static std::atomic<unsigned long long> allocationCount(0);
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+// Every heap allocation of the process, including the ones made by
+// pbnjson and glib, goes through these
+extern "C" void *malloc(size_t size)
+{
+	allocationCount++;
+	return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+	allocationCount++;
+	return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+	allocationCount++;
+	return __libc_realloc(ptr, size);
+}
+
+typedef struct
+{
+	uint64_t cpuTime;
+	unsigned long long allocations;
+	unsigned long long posts;
+	unsigned long long bytes;
+} Sample;
+
+static std::string buildAddress(unsigned int prefix, unsigned int index)
+{
+	char address[18];
+	snprintf(address, sizeof(address), "02:%02x:00:%02x:%02x:%02x", prefix & 0xff,
+	         (index >> 16) & 0xff, (index >> 8) & 0xff, index & 0xff);
+	return address;
+}
+
+static BluetoothPropertiesList buildDeviceProperties(const std::string &address, BluetoothDeviceType type)
+{
+	BluetoothPropertiesList properties;
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::BDADDR, address));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::NAME, "Device " + address));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::TYPE_OF_DEVICE, (uint32_t) type));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::CLASS_OF_DEVICE, (uint32_t) (type == BLUETOOTH_DEVICE_TYPE_BLE ? 0 : 0x1f00)));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::RSSI, -50));
+	return properties;
+}
+
+class RegistryBenchmark
+{
+public:
+	RegistryBenchmark(BluetoothManagerService *manager, LS::Handle *client, LSUtils::RecordingTransport *transport,
+	                  unsigned int eventsPerMeasurement) :
+		mManager(manager),
+		mClient(client),
+		mTransport(transport),
+		mEvents(eventsPerMeasurement),
+		mDevices(0),
+		mNextScanId(1),
+		mScanId(0),
+		mScanMessage(nullptr)
+	{
+	}
+
+	bool setUp();
+	bool run();
+
+private:
+	BluetoothManagerService *mManager;
+	LS::Handle *mClient;
+	LSUtils::RecordingTransport *mTransport;
+	unsigned int mEvents;
+	unsigned int mDevices;
+	std::vector<int> mRssi;
+	std::vector<LS::Call> mSubscriptions;
+	uint32_t mNextScanId;
+	uint32_t mScanId;
+	LSMessage *mScanMessage;
+
+	bool call(const std::string &method, const std::string &payload, bool subscribe, LSUtils::RecordedPost &response);
+	bool poll(const std::string &method, std::function<bool(pbnjson::JValue&)> condition);
+
+	bool addDevices(unsigned int count);
+	bool startScan(unsigned int devices);
+	bool addSubscribers(unsigned int count);
+	bool removeSubscribers();
+
+	void measure(unsigned int subscribers);
+	Sample takeSample() const;
+	void printResult(const char *event, unsigned int subscribers, const Sample &start, const Sample &end) const;
+};
+
+bool RegistryBenchmark::call(const std::string &method, const std::string &payload, bool subscribe,
+                             LSUtils::RecordedPost &response)
+{
+	size_t first = mTransport->getPosts().size();
+	std::string uri = std::string(SERVICE_URI) + method;
+	LS::Call call = mClient->callMultiReply(uri.c_str(), payload.c_str());
+
+	// Responses are taken from the transport; the client never gets them
+	gint64 deadline = g_get_monotonic_time() + REQUEST_TIMEOUT * G_USEC_PER_SEC;
+	while (g_get_monotonic_time() < deadline)
+	{
+		const std::vector<LSUtils::RecordedPost> &posts = mTransport->getPosts();
+		for (size_t n = first; n < posts.size(); n++)
+		{
+			if (!posts[n].message)
+				continue;
+
+			response = posts[n];
+
+			// Keeping the call open keeps the subscription alive
+			if (subscribe)
+				mSubscriptions.push_back(std::move(call));
+
+			return true;
+		}
+
+		if (!g_main_context_iteration(nullptr, FALSE))
+			g_usleep(1000);
+	}
+
+	fprintf(stderr, "No response to %s %s\n", method.c_str(), payload.c_str());
+	return false;
+}
+
+bool RegistryBenchmark::poll(const std::string &method, std::function<bool(pbnjson::JValue&)> condition)
+{
+	gint64 deadline = g_get_monotonic_time() + REQUEST_TIMEOUT * G_USEC_PER_SEC;
+	while (g_get_monotonic_time() < deadline)
+	{
+		LSUtils::RecordedPost response;
+		pbnjson::JValue responseObj;
+		if (call(method, "{}", false, response) &&
+		    LSUtils::parsePayload(response.payload, responseObj) &&
+		    responseObj["returnValue"].asBool() && condition(responseObj))
+			return true;
+
+		mTransport->clear();
+		g_usleep(10000);
+	}
+
+	fprintf(stderr, "Timed out waiting on %s\n", method.c_str());
+	return false;
+}
+
+bool RegistryBenchmark::setUp()
+{
+	// The adapter address is known once the SIL reported its properties
+	if (!poll("/device/internal/getRegistryStatus", [](pbnjson::JValue &responseObj) { return true; }))
+		return false;
+
+	LSUtils::RecordedPost response;
+	if (!call("/adapter/setState", "{\"powered\":true}", false, response))
+		return false;
+
+	return poll("/adapter/getStatus", [](pbnjson::JValue &responseObj) {
+		return responseObj["adapters"].arraySize() > 0 && responseObj["adapters"][0]["powered"].asBool();
+	});
+}
+
+bool RegistryBenchmark::addDevices(unsigned int count)
+{
+	// Nobody is subscribed here, so growing the registry stays cheap
+	while (mDevices < count)
+	{
+		mManager->deviceFound(buildDeviceProperties(buildAddress(0, mDevices), BLUETOOTH_DEVICE_TYPE_BREDR));
+		mRssi.push_back(-50);
+		mDevices++;
+	}
+
+	return true;
+}
+
+bool RegistryBenchmark::startScan(unsigned int devices)
+{
+	// The virtual adapter numbers scans from 1. The devices of the next
+	// scan are added before it starts so no watch has to be notified.
+	uint32_t scanId = mNextScanId++;
+	for (unsigned int n = 0; n < devices; n++)
+		mManager->leDeviceFoundByScanId(scanId, buildDeviceProperties(buildAddress(scanId, n), BLUETOOTH_DEVICE_TYPE_BLE));
+
+	LSUtils::RecordedPost response;
+	pbnjson::JValue responseObj;
+	if (!call("/le/startScan", "{\"subscribe\":true}", true, response) ||
+	    !LSUtils::parsePayload(response.payload, responseObj) || !responseObj["returnValue"].asBool())
+	{
+		fprintf(stderr, "Failed to start a scan: %s\n", response.payload.c_str());
+		return false;
+	}
+
+	mScanId = scanId;
+	mScanMessage = response.message;
+	mTransport->clear();
+
+	return true;
+}
+
+bool RegistryBenchmark::addSubscribers(unsigned int count)
+{
+	while (mSubscriptions.size() < count + 1)
+	{
+		LSUtils::RecordedPost response;
+		if (!call("/device/getStatus", "{\"subscribe\":true}", true, response))
+			return false;
+	}
+
+	mTransport->clear();
+
+	return true;
+}
+
+bool RegistryBenchmark::removeSubscribers()
+{
+	// Dropping the calls cancels the subscriptions, including the scan
+	mSubscriptions.clear();
+	mTransport->cancelClient(mScanMessage);
+	mScanMessage = nullptr;
+
+	bool done = poll("/device/internal/getRegistryStatus", [](pbnjson::JValue &responseObj) {
+		return responseObj["devicesSubscribers"].asNumber<int32_t>() == 0 &&
+		       responseObj["scanSubscribers"].asNumber<int32_t>() == 0;
+	});
+
+	mTransport->clear();
+
+	return done;
+}
+
+Sample RegistryBenchmark::takeSample() const
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+	Sample sample;
+	sample.cpuTime = (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	sample.allocations = allocationCount;
+	sample.posts = mTransport->getPostCount();
+	sample.bytes = mTransport->getPostedBytes();
+
+	return sample;
+}
+
+void RegistryBenchmark::printResult(const char *event, unsigned int subscribers, const Sample &start, const Sample &end) const
+{
+	printf("%-24s %5u %5u %12.1f %12.1f %8.2f %12.1f\n", event, mDevices, subscribers,
+	       (double) (end.cpuTime - start.cpuTime) / mEvents,
+	       (double) (end.allocations - start.allocations) / mEvents,
+	       (double) (end.posts - start.posts) / mEvents,
+	       (double) (end.bytes - start.bytes) / mEvents);
+}
+
+void RegistryBenchmark::measure(unsigned int subscribers)
+{
+	mTransport->setRecording(false);
+
+	Sample start = takeSample();
+	for (unsigned int n = 0; n < mEvents; n++)
+		mManager->deviceFound(buildDeviceProperties(buildAddress(0xff, n), BLUETOOTH_DEVICE_TYPE_BREDR));
+	Sample end = takeSample();
+	printResult("deviceFound", subscribers, start, end);
+
+	for (unsigned int n = 0; n < mEvents; n++)
+		mManager->deviceRemoved(buildAddress(0xff, n));
+
+	start = takeSample();
+	for (unsigned int n = 0; n < mEvents; n++)
+	{
+		unsigned int index = n % mDevices;
+		mRssi[index] = mRssi[index] == -60 ? -40 : -60;
+
+		BluetoothPropertiesList properties;
+		properties.push_back(BluetoothProperty(BluetoothProperty::Type::RSSI, mRssi[index]));
+		mManager->devicePropertiesChanged(buildAddress(0, index), properties);
+	}
+	end = takeSample();
+	printResult("devicePropertiesChanged", subscribers, start, end);
+
+	start = takeSample();
+	for (unsigned int n = 0; n < mEvents; n++)
+		mManager->leDeviceFoundByScanId(mScanId, buildDeviceProperties(buildAddress(0xff, n), BLUETOOTH_DEVICE_TYPE_BLE));
+	end = takeSample();
+	printResult("leDeviceFoundByScanId", subscribers, start, end);
+
+	for (unsigned int n = 0; n < mEvents; n++)
+		mManager->leDeviceRemovedByScanId(mScanId, buildAddress(0xff, n));
+
+	mTransport->setRecording(true);
+	mTransport->clear();
+}
+
+bool RegistryBenchmark::run()
+{
+	printf("%-24s %5s %5s %12s %12s %8s %12s\n", "event", "devs", "subs", "cpu us", "allocations", "posts", "bytes");
+
+	for (unsigned int devices : deviceCounts)
+	{
+		if (!addDevices(devices) || !startScan(devices))
+			return false;
+
+		for (unsigned int subscribers : subscriberCounts)
+		{
+			// The scan is the first entry of mSubscriptions
+			if (!addSubscribers(subscribers))
+				return false;
+
+			measure(subscribers);
+		}
+
+		if (!removeSubscribers())
+			return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int eventsPerMeasurement = DEFAULT_EVENTS_PER_MEASUREMENT;
+	if (argc > 1)
+		eventsPerMeasurement = strtoul(argv[1], 0, 10);
+	if (eventsPerMeasurement == 0)
+		eventsPerMeasurement = DEFAULT_EVENTS_PER_MEASUREMENT;
+
+	if (PmLogGetContext("webos-bluetooth-service", &logContext) != kPmLogErr_None)
+	{
+		fprintf(stderr, "Failed to setup up log context\n");
+		return 1;
+	}
+
+	// Virtual controller without simulated devices, loaded from the build tree
+	gchar *configPath = g_build_filename(g_get_tmp_dir(), "bluetoothregistrybenchmark.conf", NULL);
+	const char *config = "[Controller]\nBrEdrDevices=0\nLeDevices=0\nSppRate=0\n";
+	if (!g_file_set_contents(configPath, config, -1, nullptr))
+	{
+		fprintf(stderr, "Failed to write %s\n", configPath);
+		g_free(configPath);
+		return 1;
+	}
+
+	g_setenv("WEBOS_BLUETOOTH_VIRTUAL_SIL_CONFIG", configPath, TRUE);
+	g_setenv("WEBOS_BLUETOOTH_SIL", "virtual", TRUE);
+	g_setenv("WEBOS_BLUETOOTH_SIL_BASE_PATH", VIRTUAL_SIL_BUILD_DIR, FALSE);
+
+	LSUtils::RecordingTransport transport;
+	LSUtils::setTransport(&transport);
+
+	GMainLoop *mainLoop = g_main_loop_new(NULL, FALSE);
+	bool success = false;
+
+	try
+	{
+		BluetoothManagerService manager;
+		manager.attachToLoop(mainLoop);
+
+		LS::Handle client = LS::registerService();
+		client.attachToLoop(mainLoop);
+
+		RegistryBenchmark benchmark(&manager, &client, &transport, eventsPerMeasurement);
+		success = benchmark.setUp() && benchmark.run();
+	}
+	catch (const LS::Error &error)
+	{
+		fprintf(stderr, "Failed to register on the bus, is the service still running? %s\n", error.what());
+	}
+
+	LSUtils::setTransport(nullptr);
+	g_main_loop_unref(mainLoop);
+	g_unlink(configPath);
+	g_free(configPath);
+
+	return success ? 0 : 1;
+}
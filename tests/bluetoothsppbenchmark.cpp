@@ -0,0 +1,485 @@
+// Copyright (c) 2015-2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <luna-service2/lunaservice.hpp>
+
+#include "bluetoothmanagerservice.h"
+#include "bluetoothbinarysocket.h"
+#include "ls2recordingtransport.h"
+#include "ls2utils.h"
+#include "logging.h"
+
+/*
+ * Measures the SPP data paths of an in-process BluetoothManagerService on
+ * the virtual controller SIL in loopback mode, where every write to a
+ * channel comes back through dataReceived:
+ *
+ *  luna   /spp/writeData -> dataReceived -> receive queue -> /spp/readData
+ *  socket binary socket -> sendDataToStack -> dataReceived -> binary socket
+ *
+ * Each packet is written and read back before the next one, for several
+ * chunk sizes. MB/s and packets/s count the payload once. CPU time and heap
+ * allocations are those of the whole main loop thread, so they include the
+ * benchmark's clients.
+ *
+ * SPP only serves named callers and only com.lge.watchmanager and
+ * com.lge.service.mashupmanager get a binary socket, so the clients register
+ * as com.webos.service.bluetoothsppbenchmark and com.lge.watchmanager. The
+ * hub has to allow both names and the service's
+ * com.webos.service.bluetooth2, the installed service and watchmanager have
+ * to be stopped, and BINARY_SOCKET_DIRECTORY has to be writable.
+ */
+
+#define SERVICE_URI "luna://com.webos.service.bluetooth2"
+#define REQUEST_TIMEOUT 10 // seconds
+#define DEFAULT_PACKETS_PER_MEASUREMENT 1000
+#define LUNA_CLIENT_NAME "com.webos.service.bluetoothsppbenchmark"
+#define SOCKET_CLIENT_NAME "com.lge.watchmanager"
+#define DEVICE_ADDRESS "02:be:00:00:00:00"
+#define LUNA_CHANNEL_UUID "00001101-0000-1000-8000-00805f9b34fb"
+#define SOCKET_CHANNEL_UUID "5e1d1101-7a5c-4b8e-9c6f-7669727475a1"
+
+PmLogContext logContext;
+
+static const unsigned int chunkSizes[] = { 20, 128, 512, 990, 4096 };
+
+static std::atomic<unsigned long long> allocationCount(0);
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+// Every heap allocation of the process, including the ones made by
+// pbnjson and glib, goes through these
+extern "C" void *malloc(size_t size)
+{
+	allocationCount++;
+	return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+	allocationCount++;
+	return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+	allocationCount++;
+	return __libc_realloc(ptr, size);
+}
+
+typedef struct
+{
+	int64_t time;
+	uint64_t cpuTime;
+	unsigned long long allocations;
+} Sample;
+
+class SppBenchmark
+{
+public:
+	SppBenchmark(BluetoothManagerService *manager, LS::Handle *lunaClient, LS::Handle *socketClient,
+	             LSUtils::RecordingTransport *transport, unsigned int packets) :
+		mManager(manager),
+		mLunaClient(lunaClient),
+		mSocketClient(socketClient),
+		mTransport(transport),
+		mPackets(packets),
+		mCreateChannelMessage(nullptr),
+		mSocketFd(-1)
+	{
+	}
+
+	~SppBenchmark()
+	{
+		if (mSocketFd >= 0)
+			close(mSocketFd);
+	}
+
+	bool setUp();
+	bool run();
+
+private:
+	BluetoothManagerService *mManager;
+	LS::Handle *mLunaClient;
+	LS::Handle *mSocketClient;
+	LSUtils::RecordingTransport *mTransport;
+	unsigned int mPackets;
+	std::vector<LS::Call> mSubscriptions;
+	LSMessage *mCreateChannelMessage;
+	std::string mLunaChannelId;
+	int mSocketFd;
+
+	bool call(LS::Handle *client, const std::string &method, const std::string &payload, bool subscribe,
+	          pbnjson::JValue &responseObj);
+	bool poll(const std::string &method, std::function<bool(pbnjson::JValue&)> condition);
+	bool connectChannel(LS::Handle *client, const std::string &uuid, std::string &channelId);
+	bool connectSocket(const std::string &channelId);
+
+	bool transferLuna(const std::string &data, unsigned int size);
+	bool transferSocket(const std::vector<char> &data);
+
+	Sample takeSample() const;
+	void printResult(const char *path, unsigned int chunkSize, const Sample &start, const Sample &end) const;
+};
+
+bool SppBenchmark::call(LS::Handle *client, const std::string &method, const std::string &payload, bool subscribe,
+                        pbnjson::JValue &responseObj)
+{
+	size_t first = mTransport->getPosts().size();
+	std::string uri = std::string(SERVICE_URI) + method;
+	LS::Call call = client->callMultiReply(uri.c_str(), payload.c_str());
+
+	// Responses are taken from the transport; the clients never get them
+	gint64 deadline = g_get_monotonic_time() + REQUEST_TIMEOUT * G_USEC_PER_SEC;
+	while (g_get_monotonic_time() < deadline)
+	{
+		const std::vector<LSUtils::RecordedPost> &posts = mTransport->getPosts();
+		for (size_t n = first; n < posts.size(); n++)
+		{
+			// Channel state updates go to the createChannel subscription
+			if (!posts[n].message || posts[n].message == mCreateChannelMessage)
+				continue;
+
+			bool parsed = LSUtils::parsePayload(posts[n].payload, responseObj);
+
+			// Keeping the call open keeps the subscription alive
+			if (subscribe)
+			{
+				mCreateChannelMessage = posts[n].message;
+				mSubscriptions.push_back(std::move(call));
+			}
+
+			mTransport->clear();
+
+			return parsed;
+		}
+
+		if (!g_main_context_iteration(nullptr, FALSE))
+			g_usleep(100);
+	}
+
+	fprintf(stderr, "No response to %s %s\n", method.c_str(), payload.c_str());
+	return false;
+}
+
+bool SppBenchmark::poll(const std::string &method, std::function<bool(pbnjson::JValue&)> condition)
+{
+	gint64 deadline = g_get_monotonic_time() + REQUEST_TIMEOUT * G_USEC_PER_SEC;
+	while (g_get_monotonic_time() < deadline)
+	{
+		pbnjson::JValue responseObj;
+		if (call(mLunaClient, method, "{}", false, responseObj) &&
+		    responseObj["returnValue"].asBool() && condition(responseObj))
+			return true;
+
+		g_usleep(10000);
+	}
+
+	fprintf(stderr, "Timed out waiting on %s\n", method.c_str());
+	return false;
+}
+
+bool SppBenchmark::connectChannel(LS::Handle *client, const std::string &uuid, std::string &channelId)
+{
+	pbnjson::JValue responseObj;
+	std::string payload = "{\"address\":\"" DEVICE_ADDRESS "\",\"uuid\":\"" + uuid + "\"}";
+
+	if (!call(client, "/spp/connect", payload, false, responseObj) || !responseObj["returnValue"].asBool())
+	{
+		fprintf(stderr, "Failed to connect %s: %s\n", uuid.c_str(), responseObj.stringify().c_str());
+		return false;
+	}
+
+	channelId = responseObj["channelId"].asString();
+
+	return true;
+}
+
+bool SppBenchmark::connectSocket(const std::string &channelId)
+{
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	snprintf(address.sun_path, sizeof(address.sun_path), "%s/%s%s",
+	         BINARY_SOCKET_DIRECTORY, BINARY_SOCKET_FILE_NAME_PREFIX, channelId.c_str());
+
+	mSocketFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (mSocketFd < 0 || connect(mSocketFd, (struct sockaddr *) &address, sizeof(address)) < 0)
+	{
+		fprintf(stderr, "Failed to connect to %s: %s\n", address.sun_path, strerror(errno));
+		return false;
+	}
+
+	fcntl(mSocketFd, F_SETFL, fcntl(mSocketFd, F_GETFL) | O_NONBLOCK);
+
+	return true;
+}
+
+bool SppBenchmark::setUp()
+{
+	pbnjson::JValue responseObj;
+
+	// The adapter address is known once the SIL reported its properties
+	if (!poll("/device/internal/getRegistryStatus", [](pbnjson::JValue &responseObj) { return true; }))
+		return false;
+
+	if (!call(mLunaClient, "/adapter/setState", "{\"powered\":true}", false, responseObj))
+		return false;
+
+	if (!poll("/adapter/getStatus", [](pbnjson::JValue &responseObj) {
+		return responseObj["adapters"].arraySize() > 0 && responseObj["adapters"][0]["powered"].asBool();
+	}))
+		return false;
+
+	// SPP only connects paired devices, the virtual controller has no pairing
+	BluetoothPropertiesList properties;
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::BDADDR, std::string(DEVICE_ADDRESS)));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::NAME, std::string("Device " DEVICE_ADDRESS)));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::TYPE_OF_DEVICE, (uint32_t) BLUETOOTH_DEVICE_TYPE_BREDR));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::CLASS_OF_DEVICE, (uint32_t) 0x1f00));
+	properties.push_back(BluetoothProperty(BluetoothProperty::Type::PAIRED, true));
+	mManager->deviceFound(properties);
+
+	if (!connectChannel(mLunaClient, LUNA_CHANNEL_UUID, mLunaChannelId))
+		return false;
+
+	// The channel gets a binary socket when its uuid was created by watchmanager
+	if (!call(mSocketClient, "/spp/createChannel", "{\"name\":\"benchmark\",\"uuid\":\"" SOCKET_CHANNEL_UUID "\","
+	          "\"subscribe\":true}", true, responseObj) || !responseObj["returnValue"].asBool())
+	{
+		fprintf(stderr, "Failed to create the channel: %s\n", responseObj.stringify().c_str());
+		return false;
+	}
+
+	std::string socketChannelId;
+	if (!connectChannel(mSocketClient, SOCKET_CHANNEL_UUID, socketChannelId) || !connectSocket(socketChannelId))
+		return false;
+
+	return true;
+}
+
+bool SppBenchmark::transferLuna(const std::string &data, unsigned int size)
+{
+	pbnjson::JValue responseObj;
+	std::string writePayload = "{\"channelId\":\"" + mLunaChannelId + "\",\"data\":\"" + data + "\"}";
+	std::string readPayload = "{\"channelId\":\"" + mLunaChannelId + "\"}";
+
+	if (!call(mLunaClient, "/spp/writeData", writePayload, false, responseObj) || !responseObj["returnValue"].asBool())
+	{
+		fprintf(stderr, "Failed to write %u bytes: %s\n", size, responseObj.stringify().c_str());
+		return false;
+	}
+
+	// readData fails until the echo is queued
+	unsigned int received = 0;
+	gint64 deadline = g_get_monotonic_time() + REQUEST_TIMEOUT * G_USEC_PER_SEC;
+	while (received < size && g_get_monotonic_time() < deadline)
+	{
+		if (!call(mLunaClient, "/spp/readData", readPayload, false, responseObj))
+			return false;
+
+		if (!responseObj["returnValue"].asBool())
+			continue;
+
+		gsize length = 0;
+		guchar *decoded = g_base64_decode(responseObj["data"].asString().c_str(), &length);
+		g_free(decoded);
+		received += length;
+	}
+
+	if (received < size)
+	{
+		fprintf(stderr, "Read %u of %u bytes through /spp/readData\n", received, size);
+		return false;
+	}
+
+	return true;
+}
+
+bool SppBenchmark::transferSocket(const std::vector<char> &data)
+{
+	if (write(mSocketFd, data.data(), data.size()) != (ssize_t) data.size())
+	{
+		fprintf(stderr, "Failed to write %zu bytes to the binary socket: %s\n", data.size(), strerror(errno));
+		return false;
+	}
+
+	char buffer[4096];
+	size_t received = 0;
+	gint64 deadline = g_get_monotonic_time() + REQUEST_TIMEOUT * G_USEC_PER_SEC;
+	while (received < data.size() && g_get_monotonic_time() < deadline)
+	{
+		ssize_t length = read(mSocketFd, buffer, sizeof(buffer));
+		if (length > 0)
+		{
+			received += length;
+			continue;
+		}
+
+		if (length == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+			break;
+
+		g_main_context_iteration(nullptr, FALSE);
+	}
+
+	if (received < data.size())
+	{
+		fprintf(stderr, "Read %zu of %zu bytes through the binary socket\n", received, data.size());
+		return false;
+	}
+
+	return true;
+}
+
+Sample SppBenchmark::takeSample() const
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+	Sample sample;
+	sample.time = g_get_monotonic_time();
+	sample.cpuTime = (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	sample.allocations = allocationCount;
+
+	return sample;
+}
+
+void SppBenchmark::printResult(const char *path, unsigned int chunkSize, const Sample &start, const Sample &end) const
+{
+	double seconds = (double) (end.time - start.time) / G_USEC_PER_SEC;
+	double megabytes = (double) chunkSize * mPackets / 1048576;
+
+	printf("%-8s %6u %10.2f %12.1f %14.1f %12.1f\n", path, chunkSize,
+	       megabytes / seconds, mPackets / seconds,
+	       (double) (end.cpuTime - start.cpuTime) / 1000 / megabytes,
+	       (double) (end.allocations - start.allocations) / mPackets);
+}
+
+bool SppBenchmark::run()
+{
+	printf("%-8s %6s %10s %12s %14s %12s\n", "path", "chunk", "MB/s", "packets/s", "cpu ms per MB", "allocations");
+
+	for (unsigned int chunkSize : chunkSizes)
+	{
+		std::vector<char> data(chunkSize);
+		for (unsigned int n = 0; n < chunkSize; n++)
+			data[n] = (char) n;
+
+		gchar *encoded = g_base64_encode((const guchar *) data.data(), data.size());
+		std::string encodedData = encoded;
+		g_free(encoded);
+
+		Sample start = takeSample();
+		for (unsigned int n = 0; n < mPackets; n++)
+		{
+			if (!transferLuna(encodedData, chunkSize))
+				return false;
+		}
+		Sample end = takeSample();
+		printResult("luna", chunkSize, start, end);
+
+		start = takeSample();
+		for (unsigned int n = 0; n < mPackets; n++)
+		{
+			if (!transferSocket(data))
+				return false;
+		}
+		end = takeSample();
+		printResult("socket", chunkSize, start, end);
+	}
+
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int packetsPerMeasurement = DEFAULT_PACKETS_PER_MEASUREMENT;
+	if (argc > 1)
+		packetsPerMeasurement = strtoul(argv[1], 0, 10);
+	if (packetsPerMeasurement == 0)
+		packetsPerMeasurement = DEFAULT_PACKETS_PER_MEASUREMENT;
+
+	if (PmLogGetContext("webos-bluetooth-service", &logContext) != kPmLogErr_None)
+	{
+		fprintf(stderr, "Failed to setup up log context\n");
+		return 1;
+	}
+
+	// Virtual controller with one BR/EDR device echoing every SPP write
+	gchar *configPath = g_build_filename(g_get_tmp_dir(), "bluetoothsppbenchmark.conf", NULL);
+	const char *config = "[Controller]\nBrEdrDevices=1\nLeDevices=0\nRssiInterval=0\nServiceDiscoveryDelay=0\n"
+	                     "SppRate=0\nSppLoopback=1\n";
+	if (!g_file_set_contents(configPath, config, -1, nullptr))
+	{
+		fprintf(stderr, "Failed to write %s\n", configPath);
+		g_free(configPath);
+		return 1;
+	}
+
+	g_setenv("WEBOS_BLUETOOTH_VIRTUAL_SIL_CONFIG", configPath, TRUE);
+	g_setenv("WEBOS_BLUETOOTH_SIL", "virtual", TRUE);
+	g_setenv("WEBOS_BLUETOOTH_SIL_BASE_PATH", VIRTUAL_SIL_BUILD_DIR, FALSE);
+
+	LSUtils::RecordingTransport transport;
+	LSUtils::setTransport(&transport);
+
+	GMainLoop *mainLoop = g_main_loop_new(NULL, FALSE);
+	bool success = false;
+
+	try
+	{
+		BluetoothManagerService manager;
+		manager.attachToLoop(mainLoop);
+
+		LS::Handle lunaClient = LS::registerService(LUNA_CLIENT_NAME);
+		lunaClient.attachToLoop(mainLoop);
+
+		LS::Handle socketClient = LS::registerService(SOCKET_CLIENT_NAME);
+		socketClient.attachToLoop(mainLoop);
+
+		SppBenchmark benchmark(&manager, &lunaClient, &socketClient, &transport, packetsPerMeasurement);
+		success = benchmark.setUp() && benchmark.run();
+	}
+	catch (const LS::Error &error)
+	{
+		fprintf(stderr, "Failed to register on the bus, are the names allowed and free? %s\n", error.what());
+	}
+
+	LSUtils::setTransport(nullptr);
+	g_main_loop_unref(mainLoop);
+	g_unlink(configPath);
+	g_free(configPath);
+
+	return success ? 0 : 1;
+}